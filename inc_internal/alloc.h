@@ -0,0 +1,64 @@
+// Copyright NetFoundry Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZITI_SDK_ALLOC_H
+#define ZITI_SDK_ALLOC_H
+
+#include <stdint.h>
+#include <ziti/ziti_alloc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// subsystem allocations are accounted to (ziti_alloc_tracking())
+typedef enum {
+    ziti_alloc_other,
+    ziti_alloc_channel,
+    ziti_alloc_connection,
+    ziti_alloc_model,
+    ziti_alloc_ctrl,
+    ziti_alloc_posture,
+    ziti_alloc_bridge,
+    ziti_alloc_tags,
+} ziti_alloc_tag;
+
+// source file defines ZITI_ALLOC_TAG before includes to account its allocations to a subsystem
+#ifndef ZITI_ALLOC_TAG
+#define ZITI_ALLOC_TAG ziti_alloc_other
+#endif
+
+#define ziti_malloc(size) ziti_alloc_malloc(ZITI_ALLOC_TAG, (size))
+#define ziti_calloc(count, size) ziti_alloc_calloc(ZITI_ALLOC_TAG, (count), (size))
+#define ziti_realloc(ptr, size) ziti_alloc_realloc(ZITI_ALLOC_TAG, (ptr), (size))
+#define ziti_strdup(s) ziti_alloc_strndup(ZITI_ALLOC_TAG, (s), SIZE_MAX)
+#define ziti_strndup(s, n) ziti_alloc_strndup(ZITI_ALLOC_TAG, (s), (n))
+// can be used as a function pointer
+#define ziti_free ziti_mem_free
+
+extern void *ziti_alloc_malloc(ziti_alloc_tag tag, size_t size);
+extern void *ziti_alloc_calloc(ziti_alloc_tag tag, size_t count, size_t size);
+extern void *ziti_alloc_realloc(ziti_alloc_tag tag, void *ptr, size_t size);
+extern char *ziti_alloc_strndup(ziti_alloc_tag tag, const char *s, size_t n);
+
+extern const char *ziti_alloc_tag_name(ziti_alloc_tag tag);
+
+// returns false if tracking is not enabled
+extern bool ziti_alloc_stats(ziti_alloc_tag tag, int64_t *live_bytes, uint64_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ZITI_SDK_ALLOC_H
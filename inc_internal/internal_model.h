@@ -35,10 +35,10 @@ XX(service_hosting_costs, model_number, map, serviceHostingCosts, __VA_ARGS__)
 
 // add other protocols when we support them
 #define ZITI_ER_PROTOCOLS(XX, ...) \
-XX(tls, model_string, none, tls, __VA_ARGS__)
+XX(tls, model_istring, none, tls, __VA_ARGS__)
 
 #define ZITI_EDGE_ROUTER_MODEL(XX, ...)\
-XX(name, model_string, none, name, __VA_ARGS__)\
+XX(name, model_istring, none, name, __VA_ARGS__)\
 XX(protocols, ziti_er_protocols, none, supportedProtocols, __VA_ARGS__)
 
 #define ZITI_SERVICE_EDGE_ROUTERS_MODEL(XX, ...) \
@@ -47,7 +47,7 @@ XX(routers, ziti_edge_router, array, edgeRouters, __VA_ARGS__)
 #define ZITI_SESSION_MODEL(XX, ...) \
 XX(token, model_string, none, token, __VA_ARGS__)\
 XX(id, model_string, none, id, __VA_ARGS__)      \
-XX(api_session_id, model_string, none, apiSessionId, __VA_ARGS__) \
+XX(api_session_id, model_istring, none, apiSessionId, __VA_ARGS__) \
 XX(edge_routers, ziti_edge_router, list, edgeRouters, __VA_ARGS__) \
 XX(service_id, model_string, none, serviceId, __VA_ARGS__) \
 XX(refresh, model_bool, none, , __VA_ARGS__)
@@ -240,6 +240,12 @@ XX(offline_time, model_number, none, , __VA_ARGS__) \
 XX(cert_pem, model_string, none, certPem, __VA_ARGS__) \
 XX(fingerprint, model_string, none, fingerprint, __VA_ARGS__)
 
+#define ZITI_BOOTSTRAP_CACHE_MODEL(XX, ...) \
+XX(controllers, model_string, list, controllers, __VA_ARGS__) \
+XX(services, ziti_service, array, services, __VA_ARGS__) \
+XX(edge_routers, ziti_edge_router, array, edgeRouters, __VA_ARGS__) \
+XX(saved_at, timestamp, none, savedAt, __VA_ARGS__)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -319,6 +325,8 @@ DECLARE_MODEL(ziti_controller_detail, ZITI_CONTROLLER_DETAIL)
 
 DECLARE_MODEL(ziti_pr_base, ZITI_PR_BASE)
 
+DECLARE_MODEL(ziti_bootstrap_cache, ZITI_BOOTSTRAP_CACHE_MODEL)
+
 bool ziti_has_capability(const ziti_version *v, ziti_ctrl_cap c);
 
 #ifdef __cplusplus
@@ -18,6 +18,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <ziti/enums.h>
+#include <ziti/ziti_metrics.h>
 
 #ifdef __cplusplus
 #include <atomic>
@@ -59,6 +60,7 @@ struct rate_s {
 
     uint64_t last_tick;
     void (*tick_fn)(struct rate_s *);
+    void (*idle_fn)(struct rate_s *, uint64_t ticks);
 
     atomic_long init;
     bool active;
@@ -77,9 +79,42 @@ extern void metrics_init(long interval_secs, time_fn, void *time_ctx);
 extern int metrics_rate_init(rate_t *r, rate_type type);
 extern void metrics_rate_close(rate_t* r);
 
+// updates only accumulate delta, rate is computed by the owner calling metrics_rate_tick()
+// every metrics_tick_interval() milliseconds
 extern void metrics_rate_update(rate_t *r, long delta);
 extern int metrics_rate_get(rate_t *r, double *rate);
 
+extern uint64_t metrics_tick_interval(void);
+extern void metrics_rate_tick(rate_t *r, uint64_t now);
+
+// labelled counters, gauges and histograms
+// registry is owned by a ziti context and only used on its loop
+typedef struct metrics_registry_s metrics_registry;
+typedef struct metric_s metric_t;
+
+extern metrics_registry *metrics_registry_new(void);
+extern void metrics_registry_free(metrics_registry *reg);
+
+// find or create metric, unused labels are NULL
+extern metric_t *metrics_get(metrics_registry *reg, ziti_metric_type type, const char *name,
+                             const char *label, const char *value,
+                             const char *label2, const char *value2);
+
+extern void metric_add(metric_t *m, int64_t delta);
+extern void metric_set(metric_t *m, int64_t value);
+extern void metric_record(metric_t *m, uint64_t value);
+
+extern int metrics_snapshot(metrics_registry *reg, ziti_metrics_snapshot *snapshot);
+
+// text exposition, metric names are prefixed with `ziti_`
+typedef int (*metrics_printer)(void *ctx, const char *fmt, ...);
+
+extern void metrics_write_type(metrics_printer p, void *ctx, const char *name, ziti_metric_type type);
+extern void metrics_write_sample(metrics_printer p, void *ctx, ziti_metrics_format fmt,
+                                 const char *name, ziti_metric_type type,
+                                 const char *label, const char *value, double v);
+extern int metrics_write(metrics_registry *reg, ziti_metrics_format fmt, metrics_printer p, void *ctx);
+
 #ifdef __cplusplus
 }
 #endif
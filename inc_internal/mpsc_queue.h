@@ -0,0 +1,66 @@
+//
+// 	Copyright NetFoundry Inc.
+//
+// 	Licensed under the Apache License, Version 2.0 (the "License");
+// 	you may not use this file except in compliance with the License.
+// 	You may obtain a copy of the License at
+//
+// 	https://www.apache.org/licenses/LICENSE-2.0
+//
+// 	Unless required by applicable law or agreed to in writing, software
+// 	distributed under the License is distributed on an "AS IS" BASIS,
+// 	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// 	See the License for the specific language governing permissions and
+// 	limitations under the License.
+//
+
+#ifndef ZITI_SDK_MPSC_QUEUE_H
+#define ZITI_SDK_MPSC_QUEUE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Lock-free multi-producer/single-consumer FIFO queue.
+ *
+ * Elements are fixed size and come from a preallocated freelist of `capacity` nodes,
+ * queue falls back to heap allocated nodes when the freelist is exhausted.
+ * Any thread may [mpsc_queue_alloc] and [mpsc_queue_push], only one thread may [mpsc_queue_drain].
+ */
+typedef struct mpsc_queue_s mpsc_queue_t;
+
+typedef void (*mpsc_handler_f)(void *elem, void *ctx);
+
+mpsc_queue_t *mpsc_queue_new(size_t elem_size, size_t capacity);
+
+// not thread-safe, elements remaining in the queue are discarded without calling any handler
+void mpsc_queue_free(mpsc_queue_t *q);
+
+void *mpsc_queue_alloc(mpsc_queue_t *q);
+
+// same as [mpsc_queue_alloc] but never falls back to heap, returns NULL when all `capacity` nodes are in use
+void *mpsc_queue_try_alloc(mpsc_queue_t *q);
+
+/**
+ * Enqueue element obtained with [mpsc_queue_alloc].
+ * @return true if consumer has to be woken up, false if a wakeup is already pending
+ */
+bool mpsc_queue_push(mpsc_queue_t *q, void *elem);
+
+/**
+ * Run handler for every element queued when the call started in FIFO order and return elements to the freelist.
+ * Re-arms wakeup notification before processing, so that producers signal consumer for the next batch:
+ * elements pushed while draining (e.g. by the handler) are left for the next call.
+ * @return number of processed elements
+ */
+size_t mpsc_queue_drain(mpsc_queue_t *q, mpsc_handler_f handler, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ZITI_SDK_MPSC_QUEUE_H
@@ -45,6 +45,11 @@ void pool_return_obj(void *obj);
 
 size_t pool_mem_size(pool_t *pool);
 
+// number of objects currently allocated from the pool
+size_t pool_in_use(pool_t *pool);
+
+size_t pool_capacity(pool_t *pool);
+
 size_t pool_obj_size(void *obj);
 
 #ifdef __cplusplus
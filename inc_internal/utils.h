@@ -23,6 +23,7 @@
 #include <tlsuv/queue.h>
 #include <ziti/ziti_log.h>
 #include "ziti/model_collections.h"
+#include "alloc.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -87,9 +88,9 @@ typedef int *(*cond_error_t)(int);
 #define TO_STRING(m) to_string_(m)
 #define to_string_(m) #m
 
-#define NEWP(var, type) type *var = calloc(1, sizeof(type))
+#define NEWP(var, type) type *var = ziti_calloc(1, sizeof(type))
 #define VAL_OR_ELSE(v, def) ((v) != NULL ? (v) : (def))
-#define FREE(v)  do { if ((v) != NULL) { free((void*)(v)); (v) = NULL; } } while(0)
+#define FREE(v)  do { if ((v) != NULL) { ziti_free((void*)(v)); (v) = NULL; } } while(0)
 #define FIELD_OR_ELSE(obj, field, def) ((obj) ? ((obj)->field) : (def))
 #define FIELD_OR_NULL(obj, field) FIELD_OR_ELSE(obj, field, (z_typeof((obj)->field))0)
 
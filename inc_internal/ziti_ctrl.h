@@ -32,6 +32,10 @@ typedef void (*ctrl_version_cb)(const ziti_version *, const ziti_error *, void *
 
 typedef void(*routers_cb)(ziti_service_routers *srv_routers, const ziti_error *, void *);
 
+// invoked with each list element before it is parsed, return false to skip it
+// fingerprint is a hash of the element's raw JSON bytes, 0 if it could not be computed
+typedef bool (*ziti_ctrl_list_filter)(const char *id, const char *name, uint64_t fingerprint, void *ctx);
+
 typedef struct ziti_controller_s {
     uv_loop_t *loop;
     tlsuv_http_t *client;
@@ -43,6 +47,8 @@ typedef struct ziti_controller_s {
 
     // tuning options
     unsigned int page_size;
+    // page size for the rest of the list, once the first page revealed the total
+    unsigned int max_page_size;
 
     bool is_ha;
     ziti_version version;
@@ -53,6 +59,19 @@ typedef struct ziti_controller_s {
     bool has_token;
     char *instance_id;
 
+    // interns repeated strings (router names/URLs, policy types, etc) in responses
+    model_string_pool *strings;
+
+    // in-flight requests by single-flight key; eligible and coalesced call counts
+    model_map inflight;
+    unsigned long req_count;
+    unsigned long coalesced_count;
+
+    // ETag of service updates whose service list was applied, sent as If-None-Match
+    char *services_etag;
+    // ETag of the latest service updates, committed once its service list is applied
+    char *pending_services_etag;
+
     ziti_ctrl_change_cb change_cb;
     ziti_ctrl_redirect_cb redirect_cb;
     void *cb_ctx;
@@ -66,6 +85,8 @@ int ziti_ctrl_cancel(ziti_controller *ctrl);
 
 void ziti_ctrl_set_page_size(ziti_controller *ctrl, unsigned int size);
 
+void ziti_ctrl_set_max_page_size(ziti_controller *ctrl, unsigned int size);
+
 void ziti_ctrl_set_callbacks(ziti_controller *ctrl, void *ctx,
                              ziti_ctrl_redirect_cb redirect_cb,
                              ziti_ctrl_change_cb change_cb);
@@ -102,6 +123,7 @@ void ziti_ctrl_create_api_certificate(ziti_controller *ctrl, const char *csr_pem
 
 void ziti_ctrl_current_identity(ziti_controller *ctrl, void(*cb)(ziti_identity_data *, const ziti_error *, void *), void *ctx);
 
+// routers are allocated from an arena and are only valid for the duration of the callback
 void ziti_ctrl_current_edge_routers(ziti_controller *ctrl, void(*cb)(ziti_edge_router_array, const ziti_error *, void *),
                                     void *ctx);
 
@@ -110,9 +132,19 @@ void ziti_ctrl_logout(ziti_controller *ctrl, void(*cb)(void *, const ziti_error
 void ziti_ctrl_get_services_update(ziti_controller *ctrl, void (*cb)(ziti_service_update *, const ziti_error *, void *),
                                    void *ctx);
 
+// service list of the last update was applied: make its ETag conditional for the next poll
+void ziti_ctrl_commit_services_etag(ziti_controller *ctrl);
+
+// next service updates poll is unconditional
+void ziti_ctrl_reset_services_etag(ziti_controller *ctrl);
+
 void ziti_ctrl_get_services(ziti_controller *ctrl, void (*srv_cb)(ziti_service_array, const ziti_error *, void *),
                             void *ctx);
 
+// same as ziti_ctrl_get_services(), services rejected by the filter are not parsed or returned
+void ziti_ctrl_get_services_filtered(ziti_controller *ctrl, ziti_ctrl_list_filter filter,
+                                     void (*srv_cb)(ziti_service_array, const ziti_error *, void *), void *ctx);
+
 void ziti_ctrl_get_service(ziti_controller *ctrl, const char *service_name,
                            void (*srv_cb)(ziti_service *, const ziti_error *, void *), void *ctx);
 
@@ -0,0 +1,49 @@
+//
+// 	Copyright NetFoundry Inc.
+//
+// 	Licensed under the Apache License, Version 2.0 (the "License");
+// 	you may not use this file except in compliance with the License.
+// 	You may obtain a copy of the License at
+//
+// 	https://www.apache.org/licenses/LICENSE-2.0
+//
+// 	Unless required by applicable law or agreed to in writing, software
+// 	distributed under the License is distributed on an "AS IS" BASIS,
+// 	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// 	See the License for the specific language governing permissions and
+// 	limitations under the License.
+//
+
+#ifndef ZITI_SDK_ZITI_TRACE_H
+#define ZITI_SDK_ZITI_TRACE_H
+
+/**
+ * Static tracepoints (USDT) under provider `ziti`, a single nop instruction unless a tracer is attached.
+ * Compiled in on Linux when building with ZITI_USDT and sys/sdt.h is available, removed otherwise.
+ *
+ * probe            arguments
+ * msg_recv         ch_id, content_type, seq, body_len
+ * msg_dispatch     ch_id, content_type, seq, is_reply
+ * msg_send         ch_id, content_type, seq, msg_len, out_q
+ * msg_sent         ch_id, content_type, seq, write_delay_ms, status
+ * dial_start       conn_id, service
+ * dial_done        conn_id, service, code, latency_ms
+ * bind_dial        conn_id, service, client_conn_id
+ * accept_done      conn_id, latency_ms
+ * client_stall     conn_id, service, buffered_bytes
+ *
+ * see programs/usdt for bpftrace scripts
+ */
+
+#if defined(ZITI_USDT) && defined(__linux__) && defined(__has_include)
+# if __has_include(<sys/sdt.h>)
+#  include <sys/sdt.h>
+#  define ZITI_TRACE(probe, ...) STAP_PROBEV(ziti, probe, __VA_ARGS__)
+# endif
+#endif
+
+#ifndef ZITI_TRACE
+# define ZITI_TRACE(probe, ...) do {} while(0)
+#endif
+
+#endif //ZITI_SDK_ZITI_TRACE_H
@@ -29,6 +29,7 @@
 #include "authenticators.h"
 #include "auth_method.h"
 #include "deadline.h"
+#include "mpsc_queue.h"
 
 #include <sodium.h>
 
@@ -92,6 +93,7 @@ struct ziti_channel {
     uint64_t last_read;
     uint64_t last_write;
     uint64_t last_write_delay;
+    metric_t *write_delay_metric;
     size_t out_q;
     size_t out_q_bytes;
 
@@ -231,6 +233,8 @@ struct ziti_conn {
             uint64_t last_activity;
             uint64_t sent;
             uint64_t received;
+            metric_t *bytes_in;
+            metric_t *bytes_out;
         };
     };
 
@@ -250,11 +254,8 @@ typedef void (*ztx_work_f)(ziti_context ztx, void *w_ctx);
 struct ztx_work_s {
     ztx_work_f w;
     void *w_data;
-    STAILQ_ENTRY(ztx_work_s) _next;
 };
 
-typedef STAILQ_HEAD(work_q, ztx_work_s) ztx_work_q;
-
 struct tls_credentials {
     tlsuv_private_key_t key;
     tlsuv_certificate_t cert;
@@ -297,10 +298,16 @@ struct ziti_ctx {
     model_map services;
     // map<service_id,ziti_session>
     model_map sessions;
+    // names of most recently dialed services, for session prefetch
+    model_list dial_mru;
 
     // map<service_id,*bool>
     model_map service_forced_updates;
 
+    // map<name,uint64_t*> fingerprints of services in the current list, and the list being fetched
+    model_map service_fps;
+    model_map pending_fps;
+
     char *last_update;
 
     // map<erUrl,ziti_channel>
@@ -318,6 +325,9 @@ struct ziti_ctx {
     uint64_t start;
     rate_t up_rate;
     rate_t down_rate;
+    deadline_t rates_deadline;
+    metrics_registry *metrics;
+    struct loop_monitor_s *loop_monitor;
 
     /* posture check support */
     struct posture_checks *posture_checks;
@@ -328,13 +338,17 @@ struct ziti_ctx {
     deadline_t refresh_deadline;
     deadline_list_t deadlines;
 
+    /* warm start support */
+    // running on cached services/routers until controller data is refreshed
+    bool warm_start;
+    deadline_t cache_deadline;
+
     uv_loop_t *loop;
     uv_timer_t deadline_timer;
 
     uv_prepare_t prepper;
 
-    ztx_work_q w_queue;
-    uv_mutex_t w_lock;
+    mpsc_queue_t *w_queue;
     uv_async_t w_async;
 };
 
@@ -346,6 +360,11 @@ ziti_controller *ztx_get_controller(ziti_context ztx);
 
 void ziti_invalidate_session(ziti_context ztx, const char *service_id, ziti_session_type type);
 
+void ztx_prefetch_sessions(ziti_context ztx);
+
+// moves [service] to the front of the recently dialed list used by session prefetch
+void ztx_record_dial(ziti_context ztx, const char *service);
+
 void ziti_on_channel_event(ziti_channel_t *ch, ziti_router_status status, int err, ziti_context ztx);
 
 void ziti_force_api_session_refresh(ziti_context ztx);
@@ -434,8 +453,38 @@ ziti_channel_t * ztx_get_channel(ziti_context ztx, const ziti_edge_router *er);
 #define ztx_set_deadline(ztx, timeout, d, cb, ctx) do_ztx_set_deadline((ztx), (timeout), (d), (cb), (FILE_BASENAME":"#cb), (ctx))
 void do_ztx_set_deadline(ziti_context ztx, uint64_t timeout, deadline_t *d, void (*cb)(void *), const char *cb_name, void *ctx);
 
+// runs expired deadlines and prepares channels for IO, [ztx->prepper] callback
+void ztx_prepare(uv_prepare_t *prep);
+
 int ch_send_conn_closed(ziti_channel_t *ch, uint32_t conn_id);
 
+// bootstrap cache (ziti_options.cache_path)
+int ztx_cache_load(ziti_context ztx, ziti_bootstrap_cache *cache);
+
+// coalesces updates and writes the cache shortly after
+void ztx_cache_update(ziti_context ztx);
+
+void ztx_cache_save(ziti_context ztx);
+
+// event loop monitor (ziti_options.loop_stall_threshold_ms)
+enum ztx_cb_kind {
+    ztx_data_cb,
+    ztx_conn_cb,
+    ztx_event_cb,
+    ztx_cb_kinds,
+};
+
+void loop_monitor_start(ziti_context ztx);
+
+void loop_monitor_stop(ziti_context ztx);
+
+// returns 0 if monitor is not enabled
+static inline uint64_t ztx_cb_start(ziti_context ztx) {
+    return ztx->loop_monitor ? uv_hrtime() : 0;
+}
+
+void ztx_cb_done(ziti_context ztx, enum ztx_cb_kind kind, void *cb, uint64_t start);
+
 #ifdef __cplusplus
 }
 #endif
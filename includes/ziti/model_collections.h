@@ -26,12 +26,35 @@ extern "C" {
 
 typedef void *model_map_iter;
 
+/**
+ * Bump allocator for model object graphs.
+ *
+ * Memory is handed out from a small number of large blocks and released all at once by [model_arena_free].
+ * Individual allocations are never freed.
+ */
+typedef struct model_arena_s model_arena;
+
+ZITI_FUNC model_arena *model_arena_new(size_t block_size);
+
+// returns zeroed memory
+ZITI_FUNC void *model_arena_alloc(model_arena *arena, size_t size);
+
+ZITI_FUNC char *model_arena_strdup(model_arena *arena, const char *str);
+
+// total bytes handed out by the arena
+ZITI_FUNC size_t model_arena_used(const model_arena *arena);
+
+ZITI_FUNC void model_arena_free(model_arena *arena);
+
 typedef struct model_map {
     struct model_impl_s *impl;
 } model_map;
 
 ZITI_FUNC size_t model_map_size(const model_map *map);
 
+// all entries of the (empty) map will be allocated from the arena and released with it
+ZITI_FUNC int model_map_init_arena(model_map *map, model_arena *arena);
+
 ZITI_FUNC void *model_map_set_key(model_map *m, const void *key, size_t key_len, const void *val);
 
 ZITI_FUNC void *model_map_set(model_map *map, const char *key, const void *val);
@@ -102,6 +125,9 @@ typedef void *model_list_iter;
 
 ZITI_FUNC size_t model_list_size(const model_list *l);
 
+// all elements of the (empty) list will be allocated from the arena and released with it
+ZITI_FUNC int model_list_init_arena(model_list *l, model_arena *arena);
+
 // insert at the head
 ZITI_FUNC void model_list_push(model_list *l, const void *el);
 
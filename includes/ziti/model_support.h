@@ -40,6 +40,7 @@
 
 #include "externs.h"
 #include "model_collections.h"
+#include "ziti_alloc.h"
 #include "types.h"
 
 #if !defined(__DEFINED_ssize_t) && !defined(__ssize_t_defined)
@@ -68,10 +69,15 @@ typedef intptr_t ssize_t;
  * The following functions are generated:
  * - int parse_TYPE(TYPE*, json, len) -- parses json into an allocated struct, returns 0 if successful, -1 otherwise
  *
+ * - int parse_TYPE_arena(TYPE*, json, len, arena) -- same as parse_TYPE, all memory is allocated from `arena`
+ *
  * - void free_TYPE(TYPE *obj)   -- frees struct
  *
  * - int dump_TYPE(TYPE *obj, int indent) -- prints the struct to `stdout`,
  *              `indent` is used for printing nested model objects
+ *
+ * When building the SDK (ZITI_MODEL_GEN), IMPL_MODEL also generates static compare/to_json/from_json/free
+ * functions for the type and installs them into its type_meta.
  */
 
 #define MODEL_VISIBILITY
@@ -97,7 +103,7 @@ typedef T ** T##_array; \
 MODEL_VISIBILITY const type_meta* get_##T##_meta();\
 static inline ptr(T) alloc_##T(){ return (ptr(T))model_alloc(get_##T##_meta()); }\
 static inline void free_##T(ptr(T) v) { model_free(v, get_##T##_meta()); }     \
-static inline void free_##T##_ptr(ptr(T) v) { model_free(v, get_##T##_meta()); free(v); }; \
+static inline void free_##T##_ptr(ptr(T) v) { model_free(v, get_##T##_meta()); ziti_mem_free(v); }; \
 static inline int cmp_##T(const ptr(T) lh, const ptr(T) rh) { return model_cmp(lh, rh, get_##T##_meta()); } \
 MODEL_VISIBILITY void free_##T##_array(array(T) *ap);\
 MODEL_VISIBILITY int parse_##T(ptr(T) v, const char* json, size_t len);\
@@ -115,7 +121,9 @@ static inline int T##_ptr_from_json(ptr(T) *v, struct json_object *j) {      \
     return rc;\
 } \
 static inline int T##_list_from_json(list(T) *l, struct json_object *j) { return model_list_from_json(l, j, get_##T##_meta()); } \
-static inline int T##_array_from_json(array(T) *a, struct json_object *j) { return model_array_from_json((void***)a, j, get_##T##_meta()); }
+static inline int T##_array_from_json(array(T) *a, struct json_object *j) { return model_array_from_json((void***)a, j, get_##T##_meta()); } \
+static inline int parse_##T##_arena(ptr(T) v, const char* json, size_t len, model_arena *a) { return model_parse_arena(v, json, len, get_##T##_meta(), a); } \
+static inline int parse_##T##_array_arena(array(T) *ap, const char* json, size_t len, model_arena *a) { return model_parse_array_arena((void***)ap, json, len, get_##T##_meta(), a); }
 
 #define gen_field_meta(n, memtype, modifier, p, partype) {\
 .name = #n, \
@@ -125,25 +133,122 @@ static inline int T##_array_from_json(array(T) *a, struct json_object *j) { retu
 .meta = get_##memtype##_meta, \
 },
 
+#if defined(ZITI_MODEL_GEN)
+/*
+ * Plain primitive fields (model_string, model_number, model_bool) call their
+ * <memtype>_field_*() helpers directly. Other fields (nested models, enums, other primitives,
+ * ptr/array/map/list members) go through model_<mod>_field_*() with the member's type_meta,
+ * which dispatches to the member type's installed functions.
+ */
+#define MODEL_GEN_DIRECT_none_model_string ~, direct
+#define MODEL_GEN_DIRECT_none_model_number ~, direct
+#define MODEL_GEN_DIRECT_none_model_bool ~, direct
+
+#define MODEL_GEN_SECOND(a, b, ...) b
+#define MODEL_GEN_PICK(...) MODEL_GEN_SECOND(__VA_ARGS__)
+#define MODEL_GEN_CAT(a, b) MODEL_GEN_CAT_(a, b)
+#define MODEL_GEN_CAT_(a, b) a##b
+// `direct` if MODEL_GEN_DIRECT_<mod>_<memtype> is defined, `generic` otherwise
+#define MODEL_GEN_KIND(memtype, modifier) MODEL_GEN_PICK(MODEL_GEN_DIRECT_##modifier##_##memtype, generic, ~)
+#define MODEL_GEN_FIELD(op, memtype, modifier) MODEL_GEN_CAT(gen_field_##op##_, MODEL_GEN_KIND(memtype, modifier))
+
+#define gen_field_cmp(n, memtype, modifier, p, partype) MODEL_GEN_FIELD(cmp, memtype, modifier)(n, memtype, modifier, p)
+#define gen_field_cmp_generic(n, memtype, modifier, p) \
+if (rc == 0) { rc = model_##modifier##_field_cmp(&lh->n, &rh->n, get_##memtype##_meta()); }
+#define gen_field_cmp_direct(n, memtype, modifier, p) \
+if (rc == 0) { rc = memtype##_field_cmp(&lh->n, &rh->n); }
+
+#define gen_field_to_json(n, memtype, modifier, p, partype) \
+if (sizeof(#p) > 1) { \
+    int f_rc = MODEL_GEN_FIELD(to_json, memtype, modifier)(n, memtype, modifier, p); \
+    if (f_rc != 0) { return f_rc; } \
+}
+#define gen_field_to_json_generic(n, memtype, modifier, p) \
+model_##modifier##_field_to_json(#p, &obj->n, get_##memtype##_meta(), buf, indent, flags, &comma)
+#define gen_field_to_json_direct(n, memtype, modifier, p) \
+memtype##_field_to_json(#p, &obj->n, buf, indent, flags, &comma)
+
+#define gen_field_from_json(n, memtype, modifier, p, partype) \
+if (rc == 0 && sizeof(#p) > 1) { rc = MODEL_GEN_FIELD(from_json, memtype, modifier)(n, memtype, modifier, p); }
+#define gen_field_from_json_generic(n, memtype, modifier, p) \
+model_##modifier##_field_from_json(&obj->n, json_object_object_get(j, #p), get_##memtype##_meta())
+#define gen_field_from_json_direct(n, memtype, modifier, p) \
+memtype##_field_from_json(&obj->n, json_object_object_get(j, #p))
+
+#define gen_field_free(n, memtype, modifier, p, partype) MODEL_GEN_FIELD(free, memtype, modifier)(n, memtype, modifier, p)
+#define gen_field_free_generic(n, memtype, modifier, p) \
+model_##modifier##_field_free(&obj->n, get_##memtype##_meta());
+#define gen_field_free_direct(n, memtype, modifier, p) \
+memtype##_field_free(&obj->n);
+
+/*
+ * specialized functions generated from the model definition, installed into the type_meta
+ * so that model_cmp/model_to_json/model_from_json/model_free skip the field_meta interpretation loop.
+ * Only plain primitive fields are dispatched without a type_meta, see gen_field_cmp() above.
+ * type##_FIELDS is still generated for reflection.
+ */
 #define IMPL_MODEL(type, model) \
 static field_meta type##_FIELDS[] =  {\
     model(gen_field_meta, type) \
     };                          \
+static int type##_cmp_gen(const type *lh, const type *rh) { \
+    if (lh == rh) { return 0; } \
+    if (lh == NULL) { return -1; } \
+    if (rh == NULL) { return 1; } \
+    int rc = 0; \
+    model(gen_field_cmp, type) \
+    return rc; \
+} \
+static int type##_to_json_gen(const type *obj, void *buf, int indent, int flags) { \
+    bool comma = false; \
+    int rc = model_obj_json_begin(buf); \
+    if (rc != 0) { return rc; } \
+    model(gen_field_to_json, type) \
+    return model_obj_json_end(buf, indent, flags); \
+} \
+static void type##_free_gen(type *obj) { \
+    model(gen_field_free, type) \
+} \
+static int type##_from_json_gen(type *obj, struct json_object *j, const type_meta *m) { \
+    (void) m; \
+    if (json_object_get_type(j) != json_type_object) { return -1; } \
+    int rc = 0; \
+    model(gen_field_from_json, type) \
+    return rc; \
+} \
 static type_meta type##_META = { \
 .name = #type, \
 .size = sizeof(type),\
 .field_count = sizeof(type##_FIELDS) / sizeof(field_meta),\
 .fields = type##_FIELDS,\
+.comparer = (_cmp_f) type##_cmp_gen, \
+.jsonifier = (_to_json_f) type##_to_json_gen, \
+.destroyer = (_free_f) type##_free_gen, \
+.from_json = (from_json_func) type##_from_json_gen, \
+.arena_aware = true, \
 };                              \
 IMPL_MODEL_FUNCS(type)
+#else
+#define IMPL_MODEL(type, model) \
+static field_meta type##_FIELDS[] =  {\
+    model(gen_field_meta, type) \
+    };                          \
+static type_meta type##_META = { \
+.name = #type, \
+.size = sizeof(type),\
+.field_count = sizeof(type##_FIELDS) / sizeof(field_meta),\
+.fields = type##_FIELDS,\
+};                              \
+IMPL_MODEL_FUNCS(type)
+#endif
 
 #define IMPL_MODEL_FUNCS(T)  \
 const type_meta* get_##T##_meta() { return &T##_META; }\
 int parse_##T(ptr(T) v, const char* json, size_t len) { return model_parse(v, json, len, get_##T##_meta()); } \
 int parse_##T##_ptr(ptr(T) *p, const char* json, size_t len) {\
-*p = (ptr(T))calloc(1, sizeof(T)); \
+*p = (ptr(T))ziti_mem_calloc(1, sizeof(T)); \
 int rc = parse_##T(*p, json, len); \
-if (rc < 0) { free_##T(*p); free(*p); *p = NULL; } \
+if (rc < 0) { free_##T(*p); ziti_mem_free(*p); *p = NULL; } \
 return rc;\
 }\
 int parse_##T##_array(array(T) *a, const char *json, size_t len) { return model_parse_array((void***)a, json, len, get_##T##_meta()); }\
@@ -156,6 +261,9 @@ extern "C" {
 typedef const char *model_string;
 
 typedef model_string *model_string_array;
+// interned string, see model_intern()
+typedef const char *model_istring;
+typedef model_istring *model_istring_array;
 typedef int64_t model_number;
 typedef model_number **model_number_array;
 typedef bool model_bool;
@@ -197,6 +305,8 @@ typedef struct type_meta {
     _free_f destroyer;
     from_json_func from_json;
     to_json_func to_json;
+    // [from_json] only allocates through model parsing (or not at all), so it can be used in arena mode
+    bool arena_aware;
 } type_meta;
 
 #define MODEL_PARSE_INVALID (-2)
@@ -219,6 +329,92 @@ ZITI_FUNC int model_parse_array(void ***arp, const char *json, size_t len, const
 
 ZITI_FUNC int model_parse_list(model_list *list, const char *json, size_t len, const type_meta *meta);
 
+#if defined(ZITI_MODEL_GEN)
+/*
+ * per-field helpers used by the functions generated in IMPL_MODEL() and the generic field_meta path
+ * `f_addr` is the address of the struct member, `ftm` is the meta of the member's type.
+ * SDK internal, not exported.
+ */
+#define MODEL_FIELD_FUNCS(mod) \
+int model_##mod##_field_cmp(const void *lf, const void *rf, const type_meta *ftm); \
+int model_##mod##_field_to_json(const char *path, const void *f_addr, const type_meta *ftm, \
+                                void *buf, int indent, int flags, bool *comma); \
+int model_##mod##_field_from_json(void *f_addr, struct json_object *j, const type_meta *ftm); \
+void model_##mod##_field_free(void *f_addr, const type_meta *ftm);
+
+MODEL_FIELD_FUNCS(none)
+MODEL_FIELD_FUNCS(ptr)
+MODEL_FIELD_FUNCS(array)
+MODEL_FIELD_FUNCS(map)
+MODEL_FIELD_FUNCS(list)
+
+int model_obj_json_begin(void *buf);
+int model_obj_json_end(void *buf, int indent, int flags);
+
+// plain primitive fields, see gen_field_cmp()
+int model_string_field_cmp(const model_string *lf, const model_string *rf);
+int model_string_field_to_json(const char *path, const model_string *f, void *buf, int indent, int flags, bool *comma);
+int model_string_field_from_json(model_string *f, struct json_object *j);
+void model_string_field_free(model_string *f);
+
+int model_number_field_cmp(const model_number *lf, const model_number *rf);
+int model_number_field_to_json(const char *path, const model_number *f, void *buf, int indent, int flags, bool *comma);
+int model_number_field_from_json(model_number *f, struct json_object *j);
+static inline void model_number_field_free(model_number *f) { (void) f; }
+
+int model_bool_field_cmp(const model_bool *lf, const model_bool *rf);
+int model_bool_field_to_json(const char *path, const model_bool *f, void *buf, int indent, int flags, bool *comma);
+int model_bool_field_from_json(model_bool *f, struct json_object *j);
+static inline void model_bool_field_free(model_bool *f) { (void) f; }
+#endif
+
+/**
+ * Arena parsing mode.
+ *
+ * All memory of the resulting object graph (strings, nested objects, arrays, list and map entries)
+ * is allocated from `arena`. The result must not be passed to `model_free()`/`free_TYPE_array()`,
+ * it is released with `model_arena_free(arena)`. Partial results of a failed parse are released the same way.
+ * Types with a custom `from_json` that is not `arena_aware` fail to parse in arena mode.
+ */
+ZITI_FUNC int model_parse_arena(void *obj, const char *json, size_t len, const type_meta *meta, model_arena *arena);
+
+ZITI_FUNC int model_parse_array_arena(void ***arrp, const char *json, size_t len, const type_meta *meta, model_arena *arena);
+
+ZITI_FUNC int model_from_json_arena(void *obj, struct json_object *json, const type_meta *meta, model_arena *arena);
+
+ZITI_FUNC int model_array_from_json_arena(void ***arr, struct json_object *json, const type_meta *meta, model_arena *arena);
+
+/** sets the arena used by model parsing on the current thread (NULL for heap), returns the previous one */
+ZITI_FUNC model_arena *model_arena_use(model_arena *arena);
+
+/**
+ * String interning.
+ *
+ * `model_istring` fields hold refcounted strings: equal values parsed while a pool is active
+ * share a single copy (and compare by pointer). Values of such fields must only be set
+ * with model_intern()/model_istring_ref(), they are released by model_free().
+ * Reference counts are atomic, so interned values may be shared across threads, but the pool
+ * itself is not thread-safe: intern and release pooled strings on the pool's loop thread.
+ */
+typedef struct model_string_pool_s model_string_pool;
+
+ZITI_FUNC model_string_pool *model_string_pool_new(void);
+
+/** frees the pool, interned strings still in use stay valid until released */
+ZITI_FUNC void model_string_pool_free(model_string_pool *pool);
+
+ZITI_FUNC size_t model_string_pool_size(const model_string_pool *pool);
+
+/** sets the pool used by model parsing on the current thread, returns the previous one */
+ZITI_FUNC model_string_pool *model_string_pool_use(model_string_pool *pool);
+
+/** returns interned copy of `str`, if `pool` is NULL result is a standalone refcounted string */
+ZITI_FUNC model_istring model_intern(model_string_pool *pool, const char *str);
+
+ZITI_FUNC model_istring model_istring_ref(model_istring s);
+
+ZITI_FUNC void model_istring_release(model_istring s);
+
 ZITI_FUNC char *model_to_json(const void *obj, const type_meta *meta, int flags, size_t *len);
 
 ZITI_FUNC ssize_t model_to_json_r(const void *obj, const type_meta *meta, int flags, char *outbuf, size_t max);
@@ -229,6 +425,8 @@ ZITI_FUNC extern const type_meta *get_model_number_meta();
 
 ZITI_FUNC extern const type_meta *get_model_string_meta();
 
+ZITI_FUNC extern const type_meta *get_model_istring_meta();
+
 ZITI_FUNC extern const type_meta *get_timestamp_meta();
 
 ZITI_FUNC extern const type_meta *get_json_meta();
@@ -344,6 +542,7 @@ static type_meta Enum##_meta = {\
         .destroyer = NULL, \
         .from_json = (from_json_func) Enum##_from_json,         \
         .to_json = (to_json_func) Enum##_to_json, \
+        .arena_aware = true, \
         };           \
 const type_meta* get_##Enum##_meta() { return &Enum##_meta; }\
 
@@ -30,6 +30,9 @@
 #include "enums.h"
 #include "ziti_events.h"
 #include "enroll.h"
+#include "ziti_metrics.h"
+#include "ziti_alloc.h"
+#include "ziti_buffer.h"
 
 
 #ifdef __cplusplus
@@ -243,6 +246,7 @@ typedef struct ziti_options_s {
     const char **config_types;
 
     unsigned int api_page_size;
+    unsigned int api_max_page_size; // page size for the rest of large lists, fetched concurrently after the first page
     long refresh_interval; //the duration in seconds between checking for updates from the controller
     rate_type metrics_type; //an enum describing the metrics to collect
 
@@ -275,6 +279,39 @@ typedef struct ziti_options_s {
      * To enable certificate extension the value must be greater than 0
      */
     unsigned int cert_extension_window;
+
+    /**
+     * \brief path to bootstrap cache file (optional).
+     *
+     * When set, SDK persists the last known controllers, services, and edge routers to this file
+     * and restores them on the next start: services are published and edge router connections are
+     * started before the controller responds, dials wait for authentication instead of service/router lookups.
+     * The cache is reconciled with controller data once it arrives.
+     * A cache that cannot be parsed or was saved more than 7 days ago is ignored.
+     * The file must not be shared between identities.
+     */
+    const char *cache_path;
+
+    /**
+     * \brief background fetch of Dial sessions (optional).
+     *
+     * When set, SDK requests Dial sessions ahead of time so that dials do not wait for the controller:
+     * - negative value: for all dialable services
+     * - N > 0: for N most recently dialed services
+     *
+     * Sessions are fetched when services are loaded, and re-fetched when the API session
+     * is renewed or the edge router list changes.
+     */
+    int session_prefetch;
+
+    /**
+     * \brief event loop stall threshold in milliseconds (optional).
+     *
+     * When set, SDK monitors the event loop and times application callbacks (data_cb, conn_cb, event_cb).
+     * A callback or loop iteration taking longer than the threshold is logged
+     * and reported with [ZitiLoopStallEvent].
+     */
+    unsigned int loop_stall_threshold_ms;
 } ziti_options;
 
 typedef struct ziti_dial_opts_s {
@@ -539,6 +576,59 @@ extern int ziti_use_ext_jwt_signer(ziti_context ztx, const char *name);
 ZITI_FUNC
 extern int ziti_get_transfer_rates(ziti_context ztx, double *up, double *down);
 
+/**
+ * @brief Capture current values of the context metrics.
+ *
+ * Metrics are labelled by service or edge router:
+ * - `dial_latency_ms` (histogram, service): time to establish dialed connection
+ * - `dial_failures` (counter, service and error): failed dials
+ * - `bytes_in`, `bytes_out` (counter, service): application payload
+ * - `channel_write_delay_ms` (histogram, router): time for a message to get on the wire
+ * - `channel_rtt_ms` (histogram, router): latency probe round trip
+ * - `inbound_pool_exhausted` (counter, router): times reading paused for lack of message buffers
+ *
+ * With `ziti_options.loop_stall_threshold_ms` set:
+ * - `loop_lag_ms` (histogram): delay of the loop watchdog timer
+ * - `loop_busy_ms` (histogram): loop iteration time outside of I/O polling
+ * - `callback_ms` (histogram, callback): time spent in application callbacks
+ *
+ * With allocation tracking enabled (see ziti_alloc_tracking()), process wide:
+ * - `alloc_live_bytes` (gauge, subsystem): memory currently allocated by the SDK subsystem
+ * - `allocations` (counter, subsystem): number of allocations made by the SDK subsystem
+ *
+ * Must be called on the context loop thread.
+ * The snapshot must be released with ziti_metrics_snapshot_free().
+ * @param ztx ziti context
+ * @param snapshot captured metrics
+ * @return ZITI_OK or error code
+ */
+ZITI_FUNC
+extern int ziti_get_metrics(ziti_context ztx, ziti_metrics_snapshot *snapshot);
+
+/**
+ * @brief Render context metrics in Prometheus/OpenMetrics text exposition format.
+ *
+ * In addition to the metrics listed in ziti_get_metrics() the output includes
+ * transfer rates, number of connections, edge router channel latency and queue sizes,
+ * and controller request counts. All metric names are prefixed with `ziti_`.
+ *
+ * Output is produced line by line without an intermediate copy of the metrics.
+ * Must be called on the context loop thread.
+ * \code
+ *     string_buf_t *buf = new_string_buf();
+ *     ziti_metrics_write(ztx, ziti_metrics_prometheus, (int (*)(void *, const char *, ...)) string_buf_fmt, buf);
+ * \endcode
+ *
+ * @param ztx ziti context
+ * @param format exposition format
+ * @param printer function to be called for output
+ * @param ctx first argument passed into `printer` function
+ * @return ZITI_OK or error code
+ */
+ZITI_FUNC
+extern int ziti_metrics_write(ziti_context ztx, ziti_metrics_format format,
+                              int (*printer)(void *ctx, const char *fmt, ...), void *ctx);
+
 /**
  * @brief Shutdown Ziti Edge identity context and reclaim the memory from the provided #ziti_context.
  * 
@@ -567,6 +657,36 @@ extern int ziti_shutdown(ziti_context ztx);
 ZITI_FUNC
 extern void ziti_dump(ziti_context ztx, int (*printer)(void *ctx, const char *fmt, ...), void *ctx);
 
+/**
+ * @brief Write compact JSON snapshot of the context state.
+ *
+ * Machine-readable counterpart of ziti_dump() intended for periodic polling:
+ * only counters and state kept by the SDK are written (no certificates, configs, or posture data).
+ * \code
+ * {"id":1,"enabled":true,"uptime_ms":60000,"identity":{"name":"..","id":".."},
+ *  "controller":{"url":"..","version":"..","ha":false,"requests":10,"coalesced":2},
+ *  "services":12,"sessions":3,
+ *  "channels":[{"id":1,"name":"..","url":"..","version":"..","connected":true,"latency_ms":12,
+ *               "out_q":0,"out_q_bytes":0,"pool_in_use":3,"pool_capacity":32,"reconnects":0}],
+ *  "connections":[{"id":3,"marker":"..","type":"transport","parent":null,"service":"..","state":"Connected",
+ *                  "channel":1,"age_ms":5000,"idle_ms":20,"sent":1024,"received":4096,"inbound_bytes":0}]}
+ * \endcode
+ * Accepted connections of a server have `"type":"accepted"` and `parent` set to the server connection id.
+ *
+ * Must be called on the context loop thread.
+ * \code
+ *     string_buf_t *buf = new_string_buf();
+ *     ziti_dump_json(ztx, buf);
+ *     char *json = string_buf_to_string(buf, NULL);
+ * \endcode
+ *
+ * @param ztx ziti context
+ * @param out string buffer to append output to
+ * @return ZITI_OK or error code
+ */
+ZITI_FUNC
+extern int ziti_dump_json(ziti_context ztx, string_buf_t *out);
+
 ZITI_FUNC
 const char *ziti_get_appdata_raw(ziti_context ztx, const char *key);
 
@@ -0,0 +1,89 @@
+// Copyright (c) 2025.  NetFoundry Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZITI_SDK_ZITI_ALLOC_H
+#define ZITI_SDK_ZITI_ALLOC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "externs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief memory allocation functions used by the SDK.
+ *
+ * All functions must be set and behave like their standard library counterparts.
+ * They may be called from any thread.
+ */
+typedef struct ziti_allocator_s {
+    void *(*malloc_fn)(size_t size);
+    void *(*calloc_fn)(size_t count, size_t size);
+    void *(*realloc_fn)(void *ptr, size_t size);
+    void (*free_fn)(void *ptr);
+} ziti_allocator;
+
+/**
+ * @brief Replace memory allocation functions used by the SDK.
+ *
+ * Must be called before any other SDK function, the allocator cannot be changed
+ * once the SDK allocated memory with it.
+ * Memory returned to the application (model objects, strings) is allocated with these functions
+ * and must be released with [ziti_mem_free()] or the allocator's [free_fn].
+ *
+ * @note memory allocated by third party libraries (libuv, TLS, JSON) is not affected.
+ *
+ * @param alloc allocator functions, NULL restores standard library functions
+ * @return ZITI_OK, ZITI_INVALID_STATE if the SDK already allocated memory
+ */
+ZITI_FUNC
+extern int ziti_set_allocator(const ziti_allocator *alloc);
+
+/**
+ * @brief Enable allocation accounting by SDK subsystem (debugging aid).
+ *
+ * Live allocated bytes and number of allocations made by each subsystem
+ * (channel, connection, model, ctrl, posture, bridge, other) are reported with context metrics:
+ * - `alloc_live_bytes` (gauge, subsystem)
+ * - `allocations` (counter, subsystem)
+ *
+ * Tracking adds a lookup to every allocation, and should not be enabled in production.
+ * Can also be enabled with `ZITI_ALLOC_TRACKING=1` environment variable.
+ * Must be called before any other SDK function.
+ *
+ * @return ZITI_OK, ZITI_INVALID_STATE if the SDK already allocated memory
+ */
+ZITI_FUNC
+extern int ziti_alloc_tracking(bool enable);
+
+/** @brief allocate memory with the SDK allocator */
+ZITI_FUNC
+extern void *ziti_mem_alloc(size_t size);
+
+/** @brief allocate zeroed memory with the SDK allocator */
+ZITI_FUNC
+extern void *ziti_mem_calloc(size_t count, size_t size);
+
+/** @brief release memory allocated by the SDK */
+ZITI_FUNC
+extern void ziti_mem_free(void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ZITI_SDK_ZITI_ALLOC_H
@@ -35,6 +35,7 @@ typedef enum {
     ZitiServiceEvent = 1 << 2,
     ZitiAuthEvent = 1 << 3,
     ZitiConfigEvent = 1 << 4,
+    ZitiLoopStallEvent = 1 << 5,
 } ziti_event_type;
 
 /**
@@ -135,6 +136,19 @@ struct ziti_auth_event {
     ziti_jwt_signer_array providers;
 };
 
+/**
+ * \brief Event notifying the app that the event loop was blocked longer than `ziti_options.loop_stall_threshold_ms`.
+ *
+ * [source] is the application callback that held the loop (`"data_cb"`, `"conn_cb"`, `"event_cb"`),
+ * or `"loop"` if the delay was not caused by a ziti callback.
+ * [callback] is the symbol name of the callback function if it could be resolved, otherwise its address.
+ */
+struct ziti_loop_stall_event {
+    const char *source;
+    const char *callback;
+    uint64_t duration_ms;
+};
+
 /**
  * \brief Object passed to `ziti_options.event_cb`.
  *
@@ -149,6 +163,7 @@ typedef struct ziti_event_s {
         struct ziti_service_event service;
         struct ziti_auth_event auth;
         struct ziti_config_event cfg;
+        struct ziti_loop_stall_event stall;
     };
 } ziti_event_t;
 
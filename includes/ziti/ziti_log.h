@@ -23,6 +23,19 @@
 
 #include "externs.h"
 
+// call site cache and log generation are read and written by any logging thread
+#ifdef __cplusplus
+#include <atomic>
+typedef std::atomic<unsigned int> ziti_log_atomic_uint;
+#define ziti_log_atomic_load(p) (p)->load(std::memory_order_relaxed)
+#define ziti_log_atomic_store(p, v) (p)->store((v), std::memory_order_relaxed)
+#else
+#include <stdatomic.h>
+typedef atomic_uint ziti_log_atomic_uint;
+#define ziti_log_atomic_load(p) atomic_load_explicit((p), memory_order_relaxed)
+#define ziti_log_atomic_store(p, v) atomic_store_explicit((p), (v), memory_order_relaxed)
+#endif
+
 #ifdef SOURCE_PATH_SIZE
 #define __FILENAME__ (&__FILE__[SOURCE_PATH_SIZE])
 #else
@@ -57,9 +70,17 @@ enum DebugLevel {
 #define ZITI_LOG_MODULE NULL
 #endif
 
+// least severe level compiled in, statements above it are removed by the compiler
+#ifndef ZITI_LOG_MIN_LEVEL
+#define ZITI_LOG_MIN_LEVEL TRACE
+#endif
+
+// every statement caches its effective runtime level, see ziti_log_site_level()
 #define ZITI_LOG(level, fmt, ...) do { \
-if (level <= ziti_log_level(ZITI_LOG_MODULE, __FILENAME__)) { ziti_logger(level, ZITI_LOG_MODULE, __FILENAME__, __LINE__, __func__, fmt, ##__VA_ARGS__); }\
-} while(0)
+if ((level) <= ZITI_LOG_MIN_LEVEL) { \
+static ziti_log_atomic_uint _ziti_log_site; \
+if ((level) <= ziti_log_site_level(&_ziti_log_site, ZITI_LOG_MODULE, __FILENAME__)) { ziti_logger(level, ZITI_LOG_MODULE, __FILENAME__, __LINE__, __func__, fmt, ##__VA_ARGS__); }\
+}} while(0)
 
 #ifdef __cplusplus
 extern "C" {
@@ -104,8 +125,39 @@ ZITI_FUNC extern void ziti_log_set_level(int level, const char *marker);
 // don't use directly
 ZITI_FUNC extern int ziti_log_level(const char *module, const char *file);
 
+// don't use directly: incremented every time log levels change, invalidating cached call site levels
+ZITI_FUNC extern ziti_log_atomic_uint ziti_log_generation;
+
+// don't use directly: resolves and caches call site level
+ZITI_FUNC extern int ziti_log_resolve_site(ziti_log_atomic_uint *site, const char *module, const char *file);
+
+#define ZITI_LOG_SITE_LEVEL_BITS 3
+
+// call site cache holds generation and level in one word
+static inline int ziti_log_site_level(ziti_log_atomic_uint *site, const char *module, const char *file) {
+    unsigned int s = ziti_log_atomic_load(site);
+    if ((s >> ZITI_LOG_SITE_LEVEL_BITS) == ziti_log_atomic_load(&ziti_log_generation)) {
+        return (int) (s & ((1u << ZITI_LOG_SITE_LEVEL_BITS) - 1));
+    }
+    return ziti_log_resolve_site(site, module, file);
+}
+
 ZITI_FUNC extern void ziti_log_set_level_by_label(const char *log_level);
 
+/**
+ * Switch to asynchronous logging: calling threads format messages into a lock-free queue of [capacity] records,
+ * a background thread formats the location and hands records to the log writer in batches.
+ * Messages that do not fit in the queue are dropped and counted (see ziti_log_dropped()), logging never blocks.
+ * Use capacity = 0 to flush pending messages and return to synchronous logging.
+ * Asynchronous logging can also be enabled with `ZITI_LOG_ASYNC=<capacity>` environment variable.
+ *
+ * Should not be called concurrently with logging from other threads.
+ */
+ZITI_FUNC extern int ziti_log_set_async(size_t capacity);
+
+// number of messages dropped in asynchronous mode because the queue was full
+ZITI_FUNC extern uint64_t ziti_log_dropped(void);
+
 ZITI_FUNC extern const char *ziti_log_level_label();
 
 /**
@@ -0,0 +1,94 @@
+// Copyright (c) 2025.  NetFoundry Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZITI_SDK_ZITI_METRICS_H
+#define ZITI_SDK_ZITI_METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "externs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZITI_METRIC_MAX_LABELS 2
+
+typedef enum {
+    ziti_metric_counter,
+    ziti_metric_gauge,
+    ziti_metric_histogram,
+} ziti_metric_type;
+
+typedef struct ziti_metric_label_s {
+    const char *name;
+    const char *value;
+} ziti_metric_label;
+
+/**
+ * @brief histogram bucket: number of recorded values less or equal to [upper_bound]
+ * and greater than the previous bucket's bound.
+ */
+typedef struct ziti_metric_bucket_s {
+    uint64_t upper_bound;
+    uint64_t count;
+} ziti_metric_bucket;
+
+typedef struct ziti_metric_s {
+    const char *name;
+    ziti_metric_type type;
+    ziti_metric_label labels[ZITI_METRIC_MAX_LABELS]; // unused labels have NULL name
+    int64_t value; // counter/gauge value, number of recorded values for histograms
+
+    // histogram only
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+    size_t bucket_count; // only non-empty buckets, in ascending order
+    ziti_metric_bucket *buckets;
+} ziti_metric;
+
+/**
+ * @brief text exposition formats
+ *
+ * @see ziti_metrics_write()
+ */
+typedef enum {
+    ziti_metrics_prometheus, // Prometheus text format 0.0.4
+    ziti_metrics_openmetrics, // OpenMetrics 1.0 text format
+} ziti_metrics_format;
+
+typedef struct ziti_metrics_snapshot_s {
+    size_t count;
+    ziti_metric *metrics;
+} ziti_metrics_snapshot;
+
+/**
+ * @brief release memory held by the snapshot.
+ *
+ * @see ziti_get_metrics()
+ */
+ZITI_FUNC
+extern void ziti_metrics_snapshot_free(ziti_metrics_snapshot *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ZITI_SDK_ZITI_METRICS_H
@@ -23,9 +23,20 @@ extern "C" {
 
 #include "externs.h"
 #include "errors.h"
+#include "ziti_alloc.h"
 
 #include <stdint.h>
 
+#if !defined(__DEFINED_ssize_t) && !defined(__ssize_t_defined)
+#if _WIN32
+typedef intptr_t ssize_t;
+#define __DEFINED_ssize_t
+#define __ssize_t_defined
+#else
+#include <unistd.h>
+#endif
+#endif
+
 typedef uint32_t ziti_handle_t;
 #define ZITI_INVALID_HANDLE ((ziti_handle_t)-1)
 
@@ -46,6 +57,21 @@ typedef int ziti_socket_t;
 ZITI_FUNC
 void Ziti_lib_init(void);
 
+/**
+ * @brief Initialize Ziti library with multiple processing threads.
+ *
+ * Creates `threads` background loop threads. Each loaded context (and its connections)
+ * is pinned to one of the threads, assigned round-robin, so work for different identities
+ * runs in parallel.
+ *
+ * If `threads` is zero or negative the value of `ZITI_LIB_THREADS` environment variable is used,
+ * defaulting to a single thread, same as [Ziti_lib_init].
+ * Only the first initialization call takes effect.
+ * @param threads number of loop threads
+ */
+ZITI_FUNC
+void Ziti_lib_init_ex(int threads);
+
 /**
  * @brief return Ziti error code for last failed operation.
  * Use [ziti_errorstr] to get error message.
@@ -59,7 +85,7 @@ int Ziti_last_error(void);
  * @param jwt enrollment token
  * @param key private key (required for third party CA enrollment, otherwise optional)
  * @param cert identity x.509 certificate (required for third party CA enrollment, otherwise ignored)
- * @param id_json (output) identity in JSON format, caller is responsible for freeing it
+ * @param id_json (output) identity in JSON format, caller is responsible for freeing it with ziti_mem_free()
  * @param id_json_len (output) length of id_json
  * @return ZITI_OK on success, error code on failures
  */
@@ -131,7 +157,7 @@ const char * const *  Ziti_get_ext_signers(ziti_handle_t ztx);
  * This method is used to start the external login process for the given Ziti context.
  * It will return a URL that the application should prompt user to open in their browser to complete the authentication.
  *
- * the returned URL must be freed with free().
+ * the returned URL must be freed with ziti_mem_free().
  *
  * @param ztx Ziti context handle
  * @param signer_name name of the external JWT signer to use
@@ -174,6 +200,39 @@ int Ziti_wait_for_auth(ziti_handle_t ztx, int timeout_ms);
 ZITI_FUNC
 ziti_socket_t Ziti_socket(int type);
 
+/**
+ * @brief creates a direct Ziti socket that bypasses OS socket I/O
+ *
+ * Socket is connected with [Ziti_connect()] or [Ziti_connect_addr()] like a regular one,
+ * but data must be transferred with [Ziti_send()] and [Ziti_recv()]: payloads are handed to/from
+ * the Ziti loop thread through in-memory rings instead of crossing a socket pair.
+ *
+ * Returned descriptor can be polled, it becomes readable when data or EOF is available to [Ziti_recv()].
+ * At most one thread may send and one thread may receive on the socket at the same time.
+ * Not supported on Windows.
+ * @return descriptor or -1 on error, see [Ziti_last_error()]
+ */
+ZITI_FUNC
+ziti_socket_t Ziti_direct_socket(void);
+
+/**
+ * @brief send data over a socket created with [Ziti_direct_socket()]
+ *
+ * Blocks while the send queue is full unless [flags] has `MSG_DONTWAIT`.
+ * @return number of bytes queued or -1 on error, see [Ziti_last_error()]
+ */
+ZITI_FUNC
+ssize_t Ziti_send(ziti_socket_t socket, const void *buf, size_t len, int flags);
+
+/**
+ * @brief receive data from a socket created with [Ziti_direct_socket()]
+ *
+ * Blocks until data is available unless [flags] has `MSG_DONTWAIT`.
+ * @return number of bytes received, 0 on EOF, or -1 on error, see [Ziti_last_error()]
+ */
+ZITI_FUNC
+ssize_t Ziti_recv(ziti_socket_t socket, void *buf, size_t len, int flags);
+
 /**
  * @brief close the given socket handle/file descriptor.
  * This method facilitates faster cleanup of Ziti socket. Calling standard close()/closesocket() methods still works but may lead to
@@ -212,6 +271,39 @@ int Ziti_connect(ziti_socket_t socket, ziti_handle_t ztx, const char *service, c
 ZITI_FUNC
 int Ziti_connect_addr(ziti_socket_t socket, const char *host, unsigned int port);
 
+/**
+ * A single dial submitted with [Ziti_connect_many()].
+ * If [ztx] is [ZITI_INVALID_HANDLE] the dial is made by intercept address ([host], [port]) like [Ziti_connect_addr()],
+ * otherwise to [service] of [ztx] like [Ziti_connect()].
+ */
+typedef struct ziti_connect_req_s {
+    ziti_socket_t socket;
+    ziti_handle_t ztx;
+    const char *service;
+    const char *terminator;
+    const char *host;
+    unsigned int port;
+    int status; // output: EINPROGRESS while dial is pending, 0 when connected, or error code
+} ziti_connect_req;
+
+/**
+ * @brief Connect multiple sockets with a single submission
+ *
+ * Dials are started from the event loop(s) without a round trip per socket.
+ * If [notify_fd] is NULL the call blocks until all dials complete.
+ * Otherwise the call returns immediately and a readable descriptor is returned in [notify_fd];
+ * it becomes readable as dials complete and should be polled along with the application sockets.
+ * The caller owns [notify_fd] and must close it, [reqs] must remain valid until every request completes.
+ * Non-blocking submission is not supported on Windows.
+ *
+ * @param reqs array of dial requests, [status] of each is updated on completion
+ * @param count number of requests
+ * @param notify_fd (optional) completion notification descriptor
+ * @return number of failed dials in blocking mode, 0 if batch was submitted, -1 on invalid input
+ */
+ZITI_FUNC
+int Ziti_connect_many(ziti_connect_req *reqs, size_t count, ziti_socket_t *notify_fd);
+
 /**
  * @brief Bind socket to a Ziti service
  * @param socket socket handle created with [Ziti_socket()]
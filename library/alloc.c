@@ -0,0 +1,270 @@
+//
+// 	Copyright NetFoundry Inc.
+//
+// 	Licensed under the Apache License, Version 2.0 (the "License");
+// 	you may not use this file except in compliance with the License.
+// 	You may obtain a copy of the License at
+//
+// 	https://www.apache.org/licenses/LICENSE-2.0
+//
+// 	Unless required by applicable law or agreed to in writing, software
+// 	distributed under the License is distributed on an "AS IS" BASIS,
+// 	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// 	See the License for the specific language governing permissions and
+// 	limitations under the License.
+//
+
+#include "alloc.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uv.h>
+
+#include <ziti/errors.h>
+
+// tracking table: sharded to limit lock contention between threads
+#define TRACK_SHARDS 64
+#define TRACK_BUCKETS 4096
+
+struct alloc_entry_s {
+    void *ptr;
+    size_t size;
+    ziti_alloc_tag tag;
+    struct alloc_entry_s *next;
+};
+
+struct track_shard_s {
+    uv_mutex_t lock;
+    struct alloc_entry_s *buckets[TRACK_BUCKETS];
+};
+
+static const char *const tag_names[ziti_alloc_tags] = {
+        [ziti_alloc_other] = "other",
+        [ziti_alloc_channel] = "channel",
+        [ziti_alloc_connection] = "connection",
+        [ziti_alloc_model] = "model",
+        [ziti_alloc_ctrl] = "ctrl",
+        [ziti_alloc_posture] = "posture",
+        [ziti_alloc_bridge] = "bridge",
+};
+
+static ziti_allocator hooks = {
+        .malloc_fn = malloc,
+        .calloc_fn = calloc,
+        .realloc_fn = realloc,
+        .free_fn = free,
+};
+
+static uv_once_t init_once = UV_ONCE_INIT;
+static atomic_bool alloc_used;
+
+// both are only set before first allocation
+static bool tracking_requested;
+static struct track_shard_s *shards;
+
+static struct {
+    atomic_int_fast64_t live;
+    atomic_uint_fast64_t count;
+} tag_stats[ziti_alloc_tags];
+
+static void alloc_init(void) {
+    const char *env = getenv("ZITI_ALLOC_TRACKING");
+    if (env && *env && strcmp(env, "0") != 0) {
+        tracking_requested = true;
+    }
+
+    if (tracking_requested) {
+        struct track_shard_s *s = hooks.calloc_fn(TRACK_SHARDS, sizeof(struct track_shard_s));
+        for (int i = 0; s && i < TRACK_SHARDS; i++) {
+            uv_mutex_init(&s[i].lock);
+        }
+        shards = s;
+    }
+    atomic_store_explicit(&alloc_used, true, memory_order_release);
+}
+
+static inline void alloc_ready(void) {
+    if (!atomic_load_explicit(&alloc_used, memory_order_acquire)) {
+        uv_once(&init_once, alloc_init);
+    }
+}
+
+static struct track_shard_s *track_shard(const void *p, size_t *bucket) {
+    uint64_t h = (uint64_t) (uintptr_t) p >> 4;
+    h ^= h >> 17;
+    h *= 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 32;
+    *bucket = (size_t) ((h >> 6) % TRACK_BUCKETS);
+    return &shards[h % TRACK_SHARDS];
+}
+
+static void track_add(void *p, size_t size, ziti_alloc_tag tag) {
+    struct alloc_entry_s *e = hooks.malloc_fn(sizeof(*e));
+    if (e == NULL) {
+        return;
+    }
+    e->ptr = p;
+    e->size = size;
+    e->tag = tag;
+
+    size_t b;
+    struct track_shard_s *s = track_shard(p, &b);
+    uv_mutex_lock(&s->lock);
+    e->next = s->buckets[b];
+    s->buckets[b] = e;
+    uv_mutex_unlock(&s->lock);
+
+    atomic_fetch_add_explicit(&tag_stats[tag].live, (int_fast64_t) size, memory_order_relaxed);
+    atomic_fetch_add_explicit(&tag_stats[tag].count, 1, memory_order_relaxed);
+}
+
+// returns false for memory not allocated by the SDK
+static bool track_remove(void *p, ziti_alloc_tag *tag, size_t *size) {
+    size_t b;
+    struct track_shard_s *s = track_shard(p, &b);
+    uv_mutex_lock(&s->lock);
+    struct alloc_entry_s **link = &s->buckets[b];
+    while (*link && (*link)->ptr != p) {
+        link = &(*link)->next;
+    }
+    struct alloc_entry_s *e = *link;
+    if (e) {
+        *link = e->next;
+    }
+    uv_mutex_unlock(&s->lock);
+
+    if (e == NULL) {
+        return false;
+    }
+
+    atomic_fetch_sub_explicit(&tag_stats[e->tag].live, (int_fast64_t) e->size, memory_order_relaxed);
+    if (tag) {
+        *tag = e->tag;
+    }
+    if (size) {
+        *size = e->size;
+    }
+    hooks.free_fn(e);
+    return true;
+}
+
+int ziti_set_allocator(const ziti_allocator *alloc) {
+    if (atomic_load(&alloc_used)) {
+        return ZITI_INVALID_STATE;
+    }
+
+    if (alloc == NULL) {
+        hooks = (ziti_allocator) {malloc, calloc, realloc, free};
+        return ZITI_OK;
+    }
+
+    if (!alloc->malloc_fn || !alloc->calloc_fn || !alloc->realloc_fn || !alloc->free_fn) {
+        return ZITI_INVALID_CONFIG;
+    }
+    hooks = *alloc;
+    return ZITI_OK;
+}
+
+int ziti_alloc_tracking(bool enable) {
+    if (atomic_load(&alloc_used)) {
+        return ZITI_INVALID_STATE;
+    }
+    tracking_requested = enable;
+    return ZITI_OK;
+}
+
+void *ziti_alloc_malloc(ziti_alloc_tag tag, size_t size) {
+    alloc_ready();
+    void *p = hooks.malloc_fn(size);
+    if (p && shards) {
+        track_add(p, size, tag);
+    }
+    return p;
+}
+
+void *ziti_alloc_calloc(ziti_alloc_tag tag, size_t count, size_t size) {
+    alloc_ready();
+    void *p = hooks.calloc_fn(count, size);
+    if (p && shards) {
+        track_add(p, count * size, tag);
+    }
+    return p;
+}
+
+void *ziti_alloc_realloc(ziti_alloc_tag tag, void *ptr, size_t size) {
+    if (ptr == NULL) {
+        return ziti_alloc_malloc(tag, size);
+    }
+
+    if (shards == NULL) {
+        return hooks.realloc_fn(ptr, size);
+    }
+
+    // untrack first: once released the address may be handed out to another thread
+    size_t old_size = 0;
+    bool known = track_remove(ptr, &tag, &old_size);
+    void *p = hooks.realloc_fn(ptr, size);
+    if (p) {
+        track_add(p, size, tag);
+    } else if (known && size > 0) {
+        // failed: original block is still allocated
+        track_add(ptr, old_size, tag);
+    }
+    return p;
+}
+
+char *ziti_alloc_strndup(ziti_alloc_tag tag, const char *s, size_t n) {
+    if (s == NULL) {
+        return NULL;
+    }
+
+    size_t len = 0;
+    while (len < n && s[len] != '\0') {
+        len++;
+    }
+
+    char *copy = ziti_alloc_malloc(tag, len + 1);
+    if (copy) {
+        memcpy(copy, s, len);
+        copy[len] = '\0';
+    }
+    return copy;
+}
+
+void *ziti_mem_alloc(size_t size) {
+    return ziti_alloc_malloc(ziti_alloc_other, size);
+}
+
+void *ziti_mem_calloc(size_t count, size_t size) {
+    return ziti_alloc_calloc(ziti_alloc_other, count, size);
+}
+
+void ziti_mem_free(void *ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    if (shards) {
+        track_remove(ptr, NULL, NULL);
+    }
+    hooks.free_fn(ptr);
+}
+
+const char *ziti_alloc_tag_name(ziti_alloc_tag tag) {
+    return tag < ziti_alloc_tags ? tag_names[tag] : NULL;
+}
+
+bool ziti_alloc_stats(ziti_alloc_tag tag, int64_t *live_bytes, uint64_t *count) {
+    if (shards == NULL || tag >= ziti_alloc_tags) {
+        return false;
+    }
+
+    if (live_bytes) {
+        *live_bytes = atomic_load_explicit(&tag_stats[tag].live, memory_order_relaxed);
+    }
+    if (count) {
+        *count = atomic_load_explicit(&tag_stats[tag].count, memory_order_relaxed);
+    }
+    return true;
+}
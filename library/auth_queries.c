@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_ctrl
+
 #include "auth_queries.h"
 
 const char *AUTH_QUERY_TYPE_MFA = "MFA";
@@ -208,7 +210,7 @@ void ziti_mfa_remove(ziti_context ztx, const char *code, ziti_mfa_cb remove_cb,
     mfa_cb_ctx->ztx = ztx;
     mfa_cb_ctx->cb = remove_cb;
     mfa_cb_ctx->cb_ctx = ctx;
-    mfa_cb_ctx->code = strdup(code);
+    mfa_cb_ctx->code = ziti_strdup(code);
 
     ziti_ctrl_delete_mfa(ztx_get_controller(ztx), mfa_cb_ctx->code, ziti_mfa_remove_internal_cb, mfa_cb_ctx);
 }
@@ -272,7 +274,7 @@ void ziti_mfa_get_recovery_codes(ziti_context ztx, const char *code, ziti_mfa_re
     mfa_rc_cb_ctx->ztx = ztx;
     mfa_rc_cb_ctx->cb = get_cb;
     mfa_rc_cb_ctx->cb_ctx = ctx;
-    mfa_rc_cb_ctx->code = strdup(code);
+    mfa_rc_cb_ctx->code = ziti_strdup(code);
 
     ziti_ctrl_get_mfa_recovery_codes(ztx_get_controller(ztx), mfa_rc_cb_ctx->code, ziti_mfa_get_recovery_codes_internal_cb, mfa_rc_cb_ctx);
 }
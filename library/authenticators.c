@@ -14,6 +14,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#define ZITI_ALLOC_TAG ziti_alloc_ctrl
+
 #include "authenticators.h"
 
 typedef struct authenticator_ctx_s {
@@ -93,8 +95,8 @@ int ziti_extend_cert_authenticator(ziti_context ztx, const char *csr_pem, ziti_e
 //    wrapped_ctx->ztx = ztx;
 //    wrapped_ctx->ctx = ctx;
 //    wrapped_ctx->extend_cb = cb;
-//    wrapped_ctx->authenticator_id = strdup(ztx->api_session->authenticator_id);
-//    wrapped_ctx->csr_pem = strdup(csr_pem);
+//    wrapped_ctx->authenticator_id = ziti_strdup(ztx->api_session->authenticator_id);
+//    wrapped_ctx->csr_pem = ziti_strdup(csr_pem);
 
     return ZITI_WTF;
 }
@@ -115,7 +117,7 @@ int ziti_verify_extend_cert_authenticator(ziti_context ztx, const char *new_cert
 //    wrapped_ctx->ztx = ztx;
 //    wrapped_ctx->ctx = ctx;
 //    wrapped_ctx->verify_cb = cb;
-//    wrapped_ctx->authenticator_id = strdup(ztx->api_session->authenticator_id);
+//    wrapped_ctx->authenticator_id = ziti_strdup(ztx->api_session->authenticator_id);
 //
 //    ziti_ctrl_verify_extend_cert_authenticator(&ztx->controller, wrapped_ctx->authenticator_id, new_cert, verify_cb, wrapped_ctx);
 //
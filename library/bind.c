@@ -13,6 +13,8 @@
 // limitations under the License.
 
 
+#define ZITI_ALLOC_TAG ziti_alloc_connection
+
 #include <assert.h>
 #include <inttypes.h>
 
@@ -24,6 +26,7 @@
 #include "zt_internal.h"
 
 #include "connect.h"
+#include "ziti_trace.h"
 
 #define DEFAULT_MAX_BINDINGS 3
 #define REBIND_DELAY 1000
@@ -68,7 +71,7 @@ static void session_cb(ziti_session *session, const ziti_error *err, void *ctx);
 static void notify_status(struct ziti_conn *conn, int err);
 
 static void free_binding(struct binding_s *b) {
-    free(b);
+    ziti_free(b);
 }
 
 int ziti_bind(ziti_connection conn, const char *service, const ziti_listen_opts *listen_opts,
@@ -81,7 +84,7 @@ int ziti_bind(ziti_connection conn, const char *service, const ziti_listen_opts
 
     conn->type = Server;
     conn->disposer = dispose;
-    conn->service = strdup(service);
+    conn->service = ziti_strdup(service);
     uv_random(NULL, NULL, conn->server.listener_id, sizeof(conn->server.listener_id), 0 , NULL);
     conn->server.cost = get_terminator_cost(listen_opts, service, conn->ziti_ctx);
     conn->server.precedence = get_terminator_precedence(listen_opts, service, conn->ziti_ctx);
@@ -90,9 +93,9 @@ int ziti_bind(ziti_connection conn, const char *service, const ziti_listen_opts
 
     if (listen_opts) {
         if (listen_opts->bind_using_edge_identity) {
-            conn->server.identity = strdup(conn->ziti_ctx->identity_data->name);
+            conn->server.identity = ziti_strdup(conn->ziti_ctx->identity_data->name);
         } else if (listen_opts->identity) {
-            conn->server.identity = strdup(listen_opts->identity);
+            conn->server.identity = ziti_strdup(listen_opts->identity);
         }
     }
     conn->server.listen_cb = listen_cb;
@@ -379,8 +382,8 @@ static int dispose(ziti_connection server) {
     FREE(server->server.token);
     free_ziti_session_ptr(server->server.session);
     model_list_clear(&server->server.routers, (void (*)(void *)) free_ziti_edge_router_ptr);
-    free(server->service);
-    free(server);
+    ziti_free(server->service);
+    ziti_free(server);
     return 1;
 }
 
@@ -447,6 +450,7 @@ static void process_dial(struct binding_s *b, message *msg) {
     model_map_setl(&conn->server.children, (long) client->conn_id, client);
 
     client->dial_req_seq = msg->header.seq;
+    ZITI_TRACE(bind_dial, conn->conn_id, conn->service, client->conn_id);
     const uint8_t *source_identity = NULL;
     size_t source_identity_sz = 0;
     bool caller_id_sent = message_get_bytes_header(msg, CallerIdHeader, &source_identity, &source_identity_sz);
@@ -454,7 +458,7 @@ static void process_dial(struct binding_s *b, message *msg) {
     ziti_client_ctx clt_ctx = {0};
     message_get_bytes_header(msg, AppDataHeader, (const uint8_t **) &clt_ctx.app_data, &clt_ctx.app_data_sz);
     if (caller_id_sent) {
-        client->source_identity = calloc(1, source_identity_sz + 1);
+        client->source_identity = ziti_calloc(1, source_identity_sz + 1);
         memcpy(client->source_identity, source_identity, source_identity_sz);
         clt_ctx.caller_id = client->source_identity;
     }
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_connection
+
 #include <stdint.h>
 #include <stdlib.h>
 #include "utils.h"
@@ -44,7 +46,7 @@ struct buffer_s {
 
 
 buffer *new_buffer() {
-    buffer *b = malloc(sizeof(buffer));
+    buffer *b = ziti_malloc(sizeof(buffer));
     b->head_offset = 0;
     b->available = 0;
     STAILQ_INIT(&b->chunks);
@@ -57,10 +59,10 @@ void free_buffer(buffer* b) {
     while (!STAILQ_EMPTY(&b->chunks)) {
         chunk_t *chunk = STAILQ_FIRST(&b->chunks);
         STAILQ_REMOVE_HEAD(&b->chunks, next);
-        free(chunk->buf);
-        free(chunk);
+        ziti_free(chunk->buf);
+        ziti_free(chunk);
     }
-    free(b);
+    ziti_free(b);
 }
 
 void buffer_cleanup(buffer *b) {
@@ -73,8 +75,8 @@ void buffer_cleanup(buffer *b) {
     if (chunk->len == b->head_offset) {
         STAILQ_REMOVE_HEAD(&b->chunks, next);
         b->head_offset = 0;
-        free(chunk->buf);
-        free(chunk);
+        ziti_free(chunk->buf);
+        ziti_free(chunk);
     }
 }
 
@@ -92,8 +94,8 @@ ssize_t buffer_get_next(buffer* b, size_t want, uint8_t** ptr) {
     if (chunk->len == b->head_offset) {
         STAILQ_REMOVE_HEAD(&b->chunks, next);
         b->head_offset = 0;
-        free(chunk->buf);
-        free(chunk);
+        ziti_free(chunk->buf);
+        ziti_free(chunk);
 
         if (STAILQ_EMPTY(&b->chunks)) {
             return -1;
@@ -110,13 +112,13 @@ ssize_t buffer_get_next(buffer* b, size_t want, uint8_t** ptr) {
 }
 
 void buffer_append_copy(buffer *b, const uint8_t *buf, size_t len) {
-    uint8_t *copy = calloc(len, sizeof(uint8_t));
+    uint8_t *copy = ziti_calloc(len, sizeof(uint8_t));
     memcpy(copy, buf, len);
     buffer_append(b, copy, len);
 }
 
 void buffer_append(buffer* b, uint8_t *buf, size_t len) {
-    chunk_t *e = malloc(sizeof(chunk_t));
+    chunk_t *e = ziti_malloc(sizeof(chunk_t));
     e->buf = buf;
     e->len = len;
     b->available += len;
@@ -133,7 +135,7 @@ size_t buffer_available(buffer *b) {
 void string_buf_init(string_buf_t *wb) {
     wb->fixed = false;
     wb->chunk_size = WRITE_BUF_CHUNK_SIZE;
-    wb->chunk = malloc(wb->chunk_size);
+    wb->chunk = ziti_malloc(wb->chunk_size);
     wb->buf = new_buffer();
     wb->wp = wb->chunk;
 }
@@ -156,7 +158,7 @@ int string_buf_append_byte(string_buf_t *wb, char c) {
         if (wb->fixed) { return -1; }
 
         buffer_append(wb->buf, wb->chunk, wb->wp - wb->chunk);
-        wb->chunk = malloc(wb->chunk_size);
+        wb->chunk = ziti_malloc(wb->chunk_size);
         wb->wp = wb->chunk;
     }
     *wb->wp++ = c;
@@ -180,7 +182,7 @@ int string_buf_appendn(string_buf_t *wb, const char *str, size_t len) {
         if (wb->fixed) { return -1; }
 
         buffer_append(wb->buf, wb->chunk, wb->wp - wb->chunk);
-        wb->chunk = malloc(wb->chunk_size);
+        wb->chunk = ziti_malloc(wb->chunk_size);
         wb->wp = wb->chunk;
         goto copy;
     }
@@ -221,7 +223,7 @@ int string_buf_append(string_buf_t *wb, const char *str) {
         if (wb->fixed) { return -1; }
 
         buffer_append(wb->buf, wb->chunk, wb->wp - wb->chunk);
-        wb->chunk = malloc(wb->chunk_size);
+        wb->chunk = ziti_malloc(wb->chunk_size);
         wb->wp = wb->chunk;
         goto copy;
     }
@@ -231,7 +233,7 @@ int string_buf_append(string_buf_t *wb, const char *str) {
 
 char *string_buf_to_string(string_buf_t *wb, size_t *outlen) {
     size_t bytes_in_buffer = buffer_available(wb->buf);
-    char *result = malloc(bytes_in_buffer + (wb->wp - wb->chunk) + 1);
+    char *result = ziti_malloc(bytes_in_buffer + (wb->wp - wb->chunk) + 1);
 
     size_t copied = 0;
     while (copied < bytes_in_buffer) {
@@ -274,7 +276,7 @@ string_buf_t *new_fixed_string_buf(char *outbuf, size_t max) {
 
 void delete_string_buf(string_buf_t *wb) {
     string_buf_free(wb);
-    free(wb);
+    ziti_free(wb);
 }
 
 int string_buf_fmt(string_buf_t *wb, FORMAT_STRING(const char *fmt), ...) {
@@ -297,7 +299,7 @@ int string_buf_fmt(string_buf_t *wb, FORMAT_STRING(const char *fmt), ...) {
     // current chunk is not empty push into buffer
     if (wb->chunk != wb->wp) {
         buffer_append(wb->buf, wb->chunk, wb->wp - wb->chunk);
-        wb->chunk = malloc(wb->chunk_size);
+        wb->chunk = ziti_malloc(wb->chunk_size);
         wb->wp = wb->chunk;
     }
 
@@ -308,7 +310,7 @@ int string_buf_fmt(string_buf_t *wb, FORMAT_STRING(const char *fmt), ...) {
         wb->wp += len;
     } else {
         // formatted string won't fit into chunk_size -- add directly to the buffer
-        char *s = malloc(len + 1);
+        char *s = ziti_malloc(len + 1);
         len = vsnprintf(s, len + 1, fmt, argp);
         buffer_append(wb->buf, (uint8_t *)s, len);
     }
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_channel
+
 #include <inttypes.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -20,6 +22,7 @@
 #include "zt_internal.h"
 #include "utils.h"
 #include "endian_internal.h"
+#include "ziti_trace.h"
 
 #if _WIN32
 #include "win32_compat.h"
@@ -121,7 +124,7 @@ struct msg_receiver {
 static void ch_init_stream(ziti_channel_t *ch) {
     assert(ch->connection == NULL);
 
-    ch->connection = calloc(1, sizeof(*ch->connection));
+    ch->connection = ziti_calloc(1, sizeof(*ch->connection));
     tlsuv_stream_init(ch->loop, ch->connection, ch->ztx->tlsCtx);
     tlsuv_stream_keepalive(ch->connection, true, 30);
     tlsuv_stream_nodelay(ch->connection, true);
@@ -211,7 +214,7 @@ int ziti_close_channels(struct ziti_ctx *ztx, int err) {
 static void on_tls_close(uv_handle_t *s) {
     tlsuv_stream_t *tls = (tlsuv_stream_t *) s;
     tlsuv_stream_free(tls);
-    free(tls);
+    ziti_free(tls);
 }
 
 int ziti_channel_close(ziti_channel_t *ch, int err) {
@@ -223,7 +226,7 @@ int ziti_channel_close(ziti_channel_t *ch, int err) {
         ziti_on_channel_event(ch, EdgeRouterRemoved, 0, ch->ztx);
 
         ziti_channel_free(ch);
-        free(ch);
+        ziti_free(ch);
     }
     return 0;
 }
@@ -245,7 +248,7 @@ void ziti_channel_rem_receiver(ziti_channel_t *ch, uint32_t id) {
 
     if (r) {
         CH_LOG(DEBUG, "removed receiver[%u]", id);
-        free(r);
+        ziti_free(r);
     }
 }
 
@@ -258,10 +261,10 @@ uint64_t ziti_channel_latency(ziti_channel_t *ch) {
 }
 
 static ziti_channel_t *new_ziti_channel(ziti_context ztx, const ziti_edge_router *er) {
-    ziti_channel_t *ch = calloc(1, sizeof(ziti_channel_t));
+    ziti_channel_t *ch = ziti_calloc(1, sizeof(ziti_channel_t));
     ziti_channel_init(ztx, ch, channel_counter++);
     const ziti_identity *identity = ziti_get_identity(ztx);
-    ch->name = strdup(er->name);
+    ch->name = ziti_strdup(er->name);
     CH_LOG(INFO, "(%s) new channel for ztx[%d] identity[%s]", ch->name, ztx->id, identity->name);
 
     ziti_channel_set_url(ch, er->protocols.tls);
@@ -317,11 +320,11 @@ void ziti_channel_set_url(ziti_channel_t *ch, const char *url) {
 
     FREE(ch->url);
     FREE(ch->host);
-    ch->url = strdup(url);
+    ch->url = ziti_strdup(url);
 
     struct tlsuv_url_s ingress;
     tlsuv_parse_url(&ingress, ch->url);
-    ch->host = calloc(1, ingress.hostname_len + 1);
+    ch->host = ziti_calloc(1, ingress.hostname_len + 1);
     snprintf(ch->host, ingress.hostname_len + 1, "%.*s", (int) ingress.hostname_len, ingress.hostname);
     ch->port = ingress.port;
 }
@@ -355,7 +358,7 @@ int ziti_channel_force_connect(ziti_channel_t *ch) {
         return ZITI_GATEWAY_UNAVAILABLE;
     }
 
-    if (ch->state == Disconnected) {
+    if (ch->state == Initial || ch->state == Disconnected) {
         reconnect_channel(ch, true);
     }
 
@@ -397,6 +400,7 @@ void on_channel_send(uv_write_t *w, int status) {
 
     // time to get on-wire
     uint64_t write_delay = now - zwreq->start_ts;
+    ZITI_TRACE(msg_sent, ch->id, zwreq->message->header.content, zwreq->message->header.seq, write_delay, status);
     if (write_delay > WRITE_DELAY_WARNING && ch->last_write_delay < WRITE_DELAY_WARNING) {
         CH_LOG(WARN, "write delay = %" PRIu64 ".%03" PRIu64 " q=%zd qs=%zd",
                write_delay / 1000L, write_delay % 1000L, ch->out_q, ch->out_q_bytes);
@@ -406,6 +410,11 @@ void on_channel_send(uv_write_t *w, int status) {
     }
     ch->last_write = now;
     ch->last_write_delay = write_delay;
+    if (ch->write_delay_metric == NULL) {
+        ch->write_delay_metric = metrics_get(ch->ztx->metrics, ziti_metric_histogram, "channel_write_delay_ms",
+                                             "router", ch->name, NULL, NULL);
+    }
+    metric_record(ch->write_delay_metric, write_delay);
     ch->out_q--;
     ch->out_q_bytes -= zwreq->message->msgbuflen;
 
@@ -415,7 +424,7 @@ void on_channel_send(uv_write_t *w, int status) {
     if (zwreq->conn) {
         on_write_completed(zwreq->conn, zwreq, status);
     } else {
-        free(zwreq);
+        ziti_free(zwreq);
     }
 
     if (status < 0) {
@@ -425,7 +434,7 @@ void on_channel_send(uv_write_t *w, int status) {
         }
     }
 
-    free(w);
+    ziti_free(w);
 }
 
 int ziti_channel_send_message(ziti_channel_t *ch, message *msg, struct ziti_write_req_s *ziti_write) {
@@ -436,7 +445,7 @@ int ziti_channel_send_message(ziti_channel_t *ch, message *msg, struct ziti_writ
 
     NEWP(req, uv_write_t);
     if (ziti_write == NULL) {
-        ziti_write = calloc(1, sizeof(struct ziti_write_req_s));
+        ziti_write = ziti_calloc(1, sizeof(struct ziti_write_req_s));
     }
     ziti_write->ch = ch;
 
@@ -445,6 +454,7 @@ int ziti_channel_send_message(ziti_channel_t *ch, message *msg, struct ziti_writ
     ziti_write->start_ts = uv_now(ch->loop);
     ch->out_q++;
     ch->out_q_bytes += buf.len;
+    ZITI_TRACE(msg_send, ch->id, msg->header.content, msg->header.seq, buf.len, ch->out_q);
     int rc = tlsuv_stream_write(req, ch->connection, &buf, on_channel_send);
     if (rc != 0) {
         on_channel_send(req, rc);
@@ -468,7 +478,7 @@ void ziti_channel_remove_waiter(ziti_channel_t *ch, struct waiter_s *waiter) {
     if (ch && waiter) {
         struct waiter_s *w = model_map_removel(&ch->waiters, (long)waiter->seq);
         assert(w == waiter);
-        free(waiter);
+        ziti_free(waiter);
     }
 }
 
@@ -532,12 +542,13 @@ static void dispatch_message(ziti_channel_t *ch, message *m) {
     bool is_reply = message_get_int32_header(m, ReplyForHeader, (int32_t*)&reply_to);
 
     uint32_t ct = m->header.content;
+    ZITI_TRACE(msg_dispatch, ch->id, ct, m->header.seq, is_reply);
     if (is_reply) {
         w = model_map_removel(&ch->waiters, (long)reply_to);
 
         if (w) {
             w->cb(w->reply_ctx, m, 0);
-            free(w);
+            ziti_free(w);
             pool_return_obj(m);
             return;
         }
@@ -637,6 +648,7 @@ static void process_inbound(ziti_channel_t *ch) {
 
                 CH_LOG(TRACE, "message is complete seq[%d] ct[%s]",
                        msg->header.seq, content_type_id(msg->header.content));
+                ZITI_TRACE(msg_recv, ch->id, msg->header.content, msg->header.seq, msg->header.body_len);
 
                 rc = parse_hdrs(msg->headers, msg->header.headers_len, &msg->hdrs);
                 if (rc < 0) {
@@ -671,6 +683,8 @@ static void latency_reply_cb(void *ctx, message *reply, int err) {
         message_get_uint64_header(reply, LatencyProbeTime, &ts)) {
         ch->latency = uv_now(ch->loop) - ts;
         CH_LOG(VERBOSE, "latency is now %llu", (unsigned long long)ch->latency);
+        metric_record(metrics_get(ch->ztx->metrics, ziti_metric_histogram, "channel_rtt_ms",
+                                  "router", ch->name, NULL, NULL), ch->latency);
     } else {
         CH_LOG(WARN, "invalid latency probe result ct[%s]", content_type_id(reply->header.content));
     }
@@ -734,7 +748,7 @@ static void hello_reply_cb(void *ctx, message *msg, int err) {
         CH_LOG(INFO, "connected. EdgeRouter version: %.*s", (int) erVersionLen, erVersion);
         ch->state = Connected;
         FREE(ch->version);
-        ch->version = calloc(1, erVersionLen + 1);
+        ch->version = ziti_calloc(1, erVersionLen + 1);
         memcpy(ch->version, erVersion, erVersionLen);
         ch->notify_cb(ch, EdgeRouterConnected, 0, ch->notify_ctx);
         ch->latency = uv_now(ch->loop) - ch->latency;
@@ -793,7 +807,7 @@ static void reconnect_cb(void *data) {
     } else {
         ch->msg_seq = 0;
 
-        uv_connect_t *req = calloc(1, sizeof(uv_connect_t));
+        uv_connect_t *req = ziti_calloc(1, sizeof(uv_connect_t));
         req->data = ch;
 
         ch->state = Connecting;
@@ -860,7 +874,7 @@ static void on_channel_close(ziti_channel_t *ch, int ziti_err, ssize_t uv_err) {
         struct waiter_s *w = model_map_it_value(it);
         it = model_map_it_remove(it);
         w->cb(w->reply_ctx, NULL, ziti_err);
-        free(w);
+        ziti_free(w);
     }
 
     it = model_map_iterator(&ch->receivers);
@@ -868,7 +882,7 @@ static void on_channel_close(ziti_channel_t *ch, int ziti_err, ssize_t uv_err) {
         struct msg_receiver *con = model_map_it_value(it);
         it = model_map_it_remove(it);
         con->receive(con->receiver, NULL, (int) ziti_err);
-        free(con);
+        ziti_free(con);
     }
 
     // dump all buffered data
@@ -894,7 +908,7 @@ static void channel_alloc_cb(uv_handle_t *handle, size_t suggested_size, uv_buf_
     tlsuv_stream_t *tls = (tlsuv_stream_t *) handle;
     ziti_channel_t *ch = tls->data;
     if (ch->in_next || pool_has_available(ch->in_msg_pool)) {
-        buf->base = (char *) malloc(suggested_size);
+        buf->base = (char *) ziti_malloc(suggested_size);
         if (buf->base == NULL) {
             ZITI_LOG(ERROR, "failed to allocate %zd bytes. Prepare for crash", suggested_size);
             buf->len = 0;
@@ -903,6 +917,8 @@ static void channel_alloc_cb(uv_handle_t *handle, size_t suggested_size, uv_buf_
         }
     } else {
         CH_LOG(DEBUG, "message pool is empty. stop reading until available");
+        metric_add(metrics_get(ch->ztx->metrics, ziti_metric_counter, "inbound_pool_exhausted",
+                               "router", ch->name, NULL, NULL), 1);
 
         buf->len = 0;
         buf->base = NULL;
@@ -920,7 +936,7 @@ static void on_channel_data(uv_stream_t *s, ssize_t len, const uv_buf_t *buf) {
     }
 
     if (len < 0) {
-        free(buf->base);
+        ziti_free(buf->base);
         CH_LOG(INFO, "channel disconnected [%zd/%s]", len, uv_strerror(len));
         // propagate close
         on_channel_close(ch, ZITI_CONNABORT, len);
@@ -930,7 +946,7 @@ static void on_channel_data(uv_stream_t *s, ssize_t len, const uv_buf_t *buf) {
     if (len == 0) {
         // sometimes SSL message has no payload
         CH_LOG(TRACE, "read no data");
-        free(buf->base);
+        ziti_free(buf->base);
         return;
     }
 
@@ -978,7 +994,7 @@ static void on_tls_connect(uv_connect_t *req, int status) {
         on_channel_close(ch, ZITI_CONNABORT, status);
     }
     done:
-    free(req);
+    ziti_free(req);
 }
 
 
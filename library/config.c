@@ -24,8 +24,8 @@ const char* APP_VERSION = NULL;
 void ziti_set_app_info(const char *app_id, const char *app_version) {
     FREE(APP_ID);
     FREE(APP_VERSION);
-    APP_ID = strdup(app_id);
-    APP_VERSION = strdup(app_version);
+    APP_ID = ziti_strdup(app_id);
+    APP_VERSION = ziti_strdup(app_version);
 }
 
 static int load_config_file(const char *filename, ziti_config *cfg) {
@@ -39,11 +39,11 @@ static int load_config_file(const char *filename, ziti_config *cfg) {
     }
 
     if (parse_ziti_config(cfg, config, config_len) < 0) {
-        free(config);
+        ziti_free(config);
         return ZITI_INVALID_CONFIG;
     }
-    cfg->cfg_source = strdup(filename);
-    free(config);
+    cfg->cfg_source = ziti_strdup(filename);
+    ziti_free(config);
     return ZITI_OK;
 }
 
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_bridge
+
 #include "zt_internal.h"
 #include "utils.h"
 
@@ -113,20 +115,20 @@ static void on_sock_close(uv_handle_t *h) {
         if (fdbr->close_cb) {
             fdbr->close_cb(fdbr->ctx);
         }
-        free(fdbr);
+        ziti_free(fdbr);
     }
-    uv_close(h, (uv_close_cb) free);
+    uv_close(h, (uv_close_cb) ziti_free);
 }
 
 static void on_pipes_close(uv_handle_t *h) {
     struct ziti_bridge_s *br = h->data;
-    uv_close((uv_handle_t *) br->input, (uv_close_cb) free);
-    uv_close((uv_handle_t *) br->output, (uv_close_cb) free);
+    uv_close((uv_handle_t *) br->input, (uv_close_cb) ziti_free);
+    uv_close((uv_handle_t *) br->output, (uv_close_cb) ziti_free);
     if (br->fdbr) {
         if (br->fdbr->close_cb) {
             br->fdbr->close_cb(br->fdbr->ctx);
         }
-        free(br->fdbr);
+        ziti_free(br->fdbr);
     }
 }
 
@@ -148,11 +150,11 @@ extern int ziti_conn_bridge_fds(ziti_connection conn, uv_os_fd_t input, uv_os_fd
         socklen_t len = sizeof(type);
         if (getsockopt(input_sock, SOL_SOCKET, SO_TYPE, (void *) &type, &len) == 0) {
             if (type == SOCK_STREAM) {
-                sock = calloc(1, sizeof(uv_tcp_t));
+                sock = ziti_calloc(1, sizeof(uv_tcp_t));
                 uv_tcp_init(l, (uv_tcp_t *) sock);
                 uv_tcp_open((uv_tcp_t *) sock, input_sock);
             } else if (type == SOCK_DGRAM) {
-                sock = calloc(1, sizeof(uv_udp_t));
+                sock = ziti_calloc(1, sizeof(uv_udp_t));
                 uv_udp_init(l, (uv_udp_t *) sock);
                 uv_udp_open((uv_udp_t *) sock, input_sock);
             }
@@ -169,8 +171,8 @@ extern int ziti_conn_bridge_fds(ziti_connection conn, uv_os_fd_t input, uv_os_fd
 
     NEWP(br, struct ziti_bridge_s);
     br->conn = conn;
-    br->input = calloc(1, sizeof(uv_pipe_t));
-    br->output = calloc(1, sizeof(uv_pipe_t));
+    br->input = ziti_calloc(1, sizeof(uv_pipe_t));
+    br->output = ziti_calloc(1, sizeof(uv_pipe_t));
     br->input_pool = pool_new(BRIDGE_MSG_SIZE, BRIDGE_POOL_SIZE, NULL);
 
     uv_pipe_init(l, (uv_pipe_t *) br->input, 0);
@@ -228,7 +230,7 @@ int ziti_conn_bridge_idle_timeout(ziti_connection conn, unsigned long millis) {
 static void on_ziti_close(ziti_connection conn) {
     struct ziti_bridge_s *br = ziti_conn_data(conn);
     pool_destroy(br->input_pool);
-    free(br);
+    ziti_free(br);
 }
 
 static void close_bridge(struct ziti_bridge_s *br) {
@@ -254,7 +256,7 @@ static void on_shutdown(uv_shutdown_t *sr, int status) {
         BR_LOG(WARN, "shutdown failed: %d(%s)", status, uv_strerror(status));
         close_bridge(sr->handle->data);
     }
-    free(sr);
+    ziti_free(sr);
 }
 
 ssize_t on_ziti_data(ziti_connection conn, const uint8_t *data, ssize_t len) {
@@ -298,7 +300,7 @@ ssize_t on_ziti_data(ziti_connection conn, const uint8_t *data, ssize_t len) {
             NEWP(sr, uv_shutdown_t);
             int rc = uv_shutdown(sr, (uv_stream_t *) br->output, on_shutdown);
             if (rc != 0) {
-                free(sr);
+                ziti_free(sr);
                 BR_LOG(WARN, "shutdown failed: %d/%s", rc, uv_strerror(rc));
                 close_bridge(br);
             }
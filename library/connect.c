@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_connection
+
 #include <stdlib.h>
 #include <posture.h>
 #include <assert.h>
@@ -20,6 +22,7 @@
 #include "endian_internal.h"
 #include "win32_compat.h"
 #include "connect.h"
+#include "ziti_trace.h"
 
 static const char *INVALID_SESSION = "Invalid Session";
 static const int MAX_CONNECT_RETRY = 3;
@@ -99,7 +102,7 @@ static int ziti_disconnect(ziti_connection conn);
 static void restart_connect(struct ziti_conn *conn);
 
 static void free_handle(uv_handle_t *h) {
-    free(h);
+    ziti_free(h);
 }
 
 const char *ziti_conn_state(ziti_connection conn) {
@@ -139,11 +142,11 @@ static void clone_ziti_dial_opts(ziti_dial_opts *dest, const ziti_dial_opts *dia
     dest->stream = dial_opts->stream;
     dest->connect_timeout_seconds = dial_opts->connect_timeout_seconds;
     if (dial_opts->identity != NULL && dial_opts->identity[0] != '\0') {
-        dest->identity = strdup(dial_opts->identity);
+        dest->identity = ziti_strdup(dial_opts->identity);
     }
 
     if (dial_opts->app_data != NULL && dial_opts->app_data_sz > 0) {
-        dest->app_data = malloc(dial_opts->app_data_sz);
+        dest->app_data = ziti_malloc(dial_opts->app_data_sz);
         dest->app_data_sz = dial_opts->app_data_sz;
         memcpy(dest->app_data, dial_opts->app_data, dial_opts->app_data_sz);
     }
@@ -159,7 +162,7 @@ static void free_conn_req(struct ziti_conn_req *r) {
 
     free_ziti_dial_opts(&r->dial_opts);
     FREE(r->service_id);
-    free(r);
+    ziti_free(r);
 }
 
 static int close_conn_internal(struct ziti_conn *conn) {
@@ -173,7 +176,7 @@ static int close_conn_internal(struct ziti_conn *conn) {
             if (req->cb) {
                 req->cb(conn, ZITI_INVALID_STATE, req->ctx);
             }
-            free(req);
+            ziti_free(req);
         }
 
         if (!TAILQ_EMPTY(&conn->pending_wreqs)) {
@@ -234,7 +237,7 @@ static int close_conn_internal(struct ziti_conn *conn) {
 void on_write_completed(struct ziti_conn *conn, struct ziti_write_req_s *req, int status) {
     if (req->conn == NULL) {
         ZITI_LOG(DEBUG, "write completed for timed out or closed connection");
-        free(req);
+        ziti_free(req);
         return;
     }
     CONN_LOG(TRACE, "status %d", status);
@@ -255,8 +258,8 @@ void on_write_completed(struct ziti_conn *conn, struct ziti_write_req_s *req, in
         r = model_list_it_element(it);
         it = model_list_it_next(it);
     } while(r);
-    model_list_clear(&req->chain, free);
-    free(req);
+    model_list_clear(&req->chain, ziti_free);
+    ziti_free(req);
 }
 
 #define mk_hdr(idx, hid, l, v) headers[(idx)++] = (hdr_t){ .header_id = (hid), .length = (l), .value = (uint8_t*)(v) }
@@ -316,9 +319,25 @@ static int send_message(struct ziti_conn *conn, message *m, struct ziti_write_re
     return ziti_channel_send_message(ch, m, wr);
 }
 
+static void dial_metrics(struct ziti_conn *conn, int code) {
+    metrics_registry *metrics = conn->ziti_ctx->metrics;
+    uint64_t latency = uv_now(conn->ziti_ctx->loop) - conn->start;
+    ZITI_TRACE(dial_done, conn->conn_id, conn->service, code, latency);
+    if (code == ZITI_OK) {
+        metric_record(metrics_get(metrics, ziti_metric_histogram, "dial_latency_ms",
+                                  "service", conn->service, NULL, NULL), latency);
+    } else {
+        metric_add(metrics_get(metrics, ziti_metric_counter, "dial_failures",
+                               "service", conn->service, "error", ziti_errorstr(code)), 1);
+    }
+}
+
 static void complete_conn_req(struct ziti_conn *conn, int code) {
     struct ziti_conn_req *cr = conn->conn_req;
     if (cr && cr->cb) {
+        if (cr->session_type == ziti_session_types.Dial) {
+            dial_metrics(conn, code);
+        }
         if (code != ZITI_OK) {
             CONN_LOG(DEBUG, "%s failed: %s", ziti_conn_state(conn), ziti_errorstr(code));
             conn_set_state(conn, code == ZITI_TIMEOUT ? Timedout : Disconnected);
@@ -334,7 +353,11 @@ static void complete_conn_req(struct ziti_conn *conn, int code) {
             cr->waiter = NULL;
         }
 
-        cr->cb(conn, code);
+        ziti_context ztx = conn->ziti_ctx;
+        ziti_conn_cb cb = cr->cb;
+        uint64_t start = ztx_cb_start(ztx);
+        cb(conn, code);
+        ztx_cb_done(ztx, ztx_conn_cb, (void *) cb, start);
         cr->cb = NULL;
 
         if (code != ZITI_OK) {
@@ -345,7 +368,7 @@ static void complete_conn_req(struct ziti_conn *conn, int code) {
                 if (req->cb) {
                     req->cb(conn, code, req->ctx);
                 }
-                free(req);
+                ziti_free(req);
             }
         }
 
@@ -436,7 +459,7 @@ static void connect_get_service_cb(ziti_context ztx, const ziti_service *s, int
             return;
         }
 
-        req->service_id = strdup(s->id);
+        req->service_id = ziti_strdup(s->id);
         conn->encrypted = s->encryption;
         process_connect(conn, NULL);
     } else if (status == ZITI_SERVICE_UNAVAILABLE) {
@@ -459,6 +482,75 @@ static void refresh_session_cb(ziti_session *s, const ziti_error *err, void *ctx
     }
 }
 
+static void prefetch_session(ziti_context ztx, const ziti_service *service) {
+    if ((service->perm_flags & ZITI_CAN_DIAL) == 0) {
+        return;
+    }
+
+    // concurrent requests for the same session are coalesced by the controller client
+    ziti_session *session = model_map_get(&ztx->sessions, service->id);
+    if (session == NULL) {
+        ZTX_LOG(VERBOSE, "prefetching 'Dial' session for service[%s]", service->name);
+        ziti_ctrl_create_session(ztx_get_controller(ztx), service->id, ziti_session_types.Dial,
+                                 refresh_session_cb, ztx);
+    } else if (session->refresh) {
+        ZTX_LOG(VERBOSE, "refreshing prefetched session[%s] for service[%s]", session->id, service->name);
+        session->refresh = false;
+        ziti_ctrl_get_session(ztx_get_controller(ztx), session->id, refresh_session_cb, ztx);
+    }
+}
+
+void ztx_prefetch_sessions(ziti_context ztx) {
+    if (ztx->opts.session_prefetch == 0 || ztx->auth_state != ZitiAuthStateFullyAuthenticated) {
+        return;
+    }
+
+    const char *name;
+    ziti_service *service;
+    if (ztx->opts.session_prefetch < 0) {
+        MODEL_MAP_FOREACH(name, service, &ztx->services) {
+            prefetch_session(ztx, service);
+        }
+    } else {
+        MODEL_LIST_FOREACH(name, ztx->dial_mru) {
+            service = model_map_get(&ztx->services, name);
+            if (service) {
+                prefetch_session(ztx, service);
+            }
+        }
+    }
+}
+
+void ztx_record_dial(ziti_context ztx, const char *service) {
+    if (ztx->opts.session_prefetch <= 0) {
+        return;
+    }
+
+    const char *head = model_list_head(&ztx->dial_mru);
+    if (head && strcmp(head, service) == 0) {
+        return;
+    }
+
+    MODEL_LIST_FOR(it, ztx->dial_mru) {
+        char *name = (char *) model_list_it_element(it);
+        if (strcmp(name, service) == 0) {
+            model_list_it_remove(it);
+            ziti_free(name);
+            break;
+        }
+    }
+    model_list_push(&ztx->dial_mru, ziti_strdup(service));
+
+    // trim to the configured size
+    int count = 0;
+    MODEL_LIST_FOR(it, ztx->dial_mru) {
+        if (++count > ztx->opts.session_prefetch) {
+            ziti_free((void *) model_list_it_element(it));
+            model_list_it_remove(it);
+        }
+    }
+}
+
 static void connect_get_net_session_cb(ziti_session *s, const ziti_error *err, void *ctx) {
     struct ziti_conn *conn = ctx;
     struct ziti_conn_req *req = conn->conn_req;
@@ -481,7 +573,7 @@ static void connect_get_net_session_cb(ziti_session *s, const ziti_error *err, v
         if (existing) {
             CONN_LOG(DEBUG, "discarding existing session[%s] for service[%s]", existing->id, conn->service);
             free_ziti_session(existing);
-            free(existing);
+            ziti_free(existing);
         } else {
             CONN_LOG(DEBUG, "got session[%s] for service[%s]", s->id, conn->service);
             model_map_set(&ztx->sessions, s->service_id, s);
@@ -500,6 +592,13 @@ void process_connect(struct ziti_conn *conn, ziti_session *session) {
     assert(req->session_type == ziti_session_types.Dial);
 
     // verify ziti context is still authorized
+    if (ztx->auth_state != ZitiAuthStateFullyAuthenticated && ztx->warm_start) {
+        // started from cache: proceed once authentication completes
+        CONN_LOG(DEBUG, "waiting for authentication to connect to service[%s]", conn->service);
+        model_map_setl(&ztx->waiting_connections, (long)conn->conn_id, (void*)(uintptr_t)conn->conn_id);
+        return;
+    }
+
     if (ztx->auth_state != ZitiAuthStateFullyAuthenticated) {
         CONN_LOG(ERROR, "ziti context is not authenticated, cannot connect to service[%s]", conn->service);
         complete_conn_req(conn, ZITI_INVALID_STATE);
@@ -519,6 +618,7 @@ void process_connect(struct ziti_conn *conn, ziti_session *session) {
     }
 
     ziti_send_posture_data(ztx);
+    ztx_record_dial(ztx, conn->service);
     if (session == NULL) {
         session = model_map_get(&ztx->sessions, req->service_id);
     }
@@ -548,6 +648,7 @@ void process_connect(struct ziti_conn *conn, ziti_session *session) {
     }
 
     CONN_LOG(DEBUG, "starting Dial connection for service[%s] with session[%s]", conn->service, session->id);
+    ZITI_TRACE(dial_start, conn->conn_id, conn->service);
     if (!ziti_connect(ztx, session, conn)) {
         CONN_LOG(DEBUG, "no active edge routers, pending ER connection");
         // TODO deal with pending connect
@@ -582,7 +683,7 @@ static int do_ziti_dial(ziti_connection conn, const char *service, ziti_dial_opt
                       sodium_base64_VARIANT_URLSAFE_NO_PADDING);
 
     NEWP(req, struct ziti_conn_req);
-    conn->service = strdup(service);
+    conn->service = ziti_strdup(service);
     conn->conn_req = req;
 
     req->session_type = ziti_session_types.Dial;
@@ -601,7 +702,7 @@ static int do_ziti_dial(ziti_connection conn, const char *service, ziti_dial_opt
     conn->data_cb = data_cb;
     conn_set_state(conn, Connecting);
 
-    conn->flusher = calloc(1, sizeof(uv_idle_t));
+    conn->flusher = ziti_calloc(1, sizeof(uv_idle_t));
     uv_idle_init(conn->ziti_ctx->loop, conn->flusher);
     conn->flusher->data = conn;
 
@@ -792,7 +893,7 @@ static int send_crypto_header(ziti_connection conn) {
 static void on_flush(uv_idle_t *fl) {
     ziti_connection conn = fl->data;
     if (conn == NULL) {
-        uv_close((uv_handle_t *) fl, (uv_close_cb) free);
+        uv_close((uv_handle_t *) fl, (uv_close_cb) ziti_free);
         return;
     }
 
@@ -873,7 +974,7 @@ static bool flush_to_service(ziti_connection conn) {
             if (req->cb) {
                 req->cb(conn, ZITI_INVALID_STATE, req->ctx);
             }
-            free(req);
+            ziti_free(req);
         }
     }
     CONN_LOG(TRACE, "flushed %d messages", count);
@@ -899,7 +1000,10 @@ static bool flush_to_client(ziti_connection conn) {
     while (conn->data_cb && buffer_available(conn->inbound) > 0 && (flushes--) > 0) {
         uint8_t *chunk;
         ssize_t chunk_len = buffer_get_next(conn->inbound, 16 * 1024, &chunk);
-        ssize_t consumed = conn->data_cb(conn, chunk, chunk_len);
+        ziti_data_cb data_cb = conn->data_cb;
+        uint64_t start = ztx_cb_start(conn->ziti_ctx);
+        ssize_t consumed = data_cb(conn, chunk, chunk_len);
+        ztx_cb_done(conn->ziti_ctx, ztx_data_cb, (void *) data_cb, start);
         CONN_LOG(TRACE, "client consumed %zd out of %zd bytes", consumed, chunk_len);
 
         if (consumed < 0) {
@@ -909,6 +1013,7 @@ static bool flush_to_client(ziti_connection conn) {
         } else if (consumed < chunk_len) {
             buffer_push_back(conn->inbound, (chunk_len - consumed));
             CONN_LOG(VERBOSE, "client stalled: %zd bytes buffered", buffer_available(conn->inbound));
+            ZITI_TRACE(client_stall, conn->conn_id, conn->service, buffer_available(conn->inbound));
             break;
         }
     }
@@ -955,7 +1060,7 @@ void conn_inbound_data_msg(ziti_connection conn, message *msg) {
         } else {
             unsigned char tag;
             if (msg->header.body_len > 0) {
-                plain_text = malloc(msg->header.body_len - crypto_secretstream_xchacha20poly1305_ABYTES);
+                plain_text = ziti_malloc(msg->header.body_len - crypto_secretstream_xchacha20poly1305_ABYTES);
                 assert(plain_text != NULL);
                 CONN_LOG(VERBOSE, "decrypting %d bytes", msg->header.body_len);
                 int crypto_rc = crypto_secretstream_xchacha20poly1305_pull(&conn->crypt_i,
@@ -991,7 +1096,7 @@ void conn_inbound_data_msg(ziti_connection conn, message *msg) {
             return;
         }
     } else if (msg->header.body_len > 0) {
-        plain_text = malloc(msg->header.body_len);
+        plain_text = ziti_malloc(msg->header.body_len);
         plain_len = msg->header.body_len;
         memcpy(plain_text, msg->body, msg->header.body_len);
     }
@@ -1011,11 +1116,16 @@ void conn_inbound_data_msg(ziti_connection conn, message *msg) {
                 p += partlen;
                 CONN_LOG(TRACE, "chunk[%d]", partlen);
             } while (p < end);
-            free(plain_text);
+            ziti_free(plain_text);
         } else {
             buffer_append(conn->inbound, plain_text, plain_len);
             metrics_rate_update(&conn->ziti_ctx->down_rate, (int64_t) plain_len);
             conn->received += plain_len;
+            if (conn->bytes_in == NULL && conn->service) {
+                conn->bytes_in = metrics_get(conn->ziti_ctx->metrics, ziti_metric_counter, "bytes_in",
+                                             "service", conn->service, NULL, NULL);
+            }
+            metric_add(conn->bytes_in, (int64_t) plain_len);
         }
     }
 
@@ -1087,6 +1197,7 @@ void connect_reply_cb(void *ctx, message *msg, int err) {
                 complete_conn_req(conn, rc);
             } else if (conn->state == Accepting) {
                 CONN_LOG(TRACE, "accepted");
+                ZITI_TRACE(accept_done, conn->conn_id, uv_now(conn->ziti_ctx->loop) - conn->start);
                 if (conn->encrypted) {
                     send_crypto_header(conn);
                 }
@@ -1235,7 +1346,7 @@ int ziti_accept(ziti_connection conn, ziti_conn_cb cb, ziti_data_cb data_cb) {
     conn->data_cb = data_cb;
 
     TAILQ_INIT(&conn->in_q);
-    conn->flusher = calloc(1, sizeof(uv_idle_t));
+    conn->flusher = ziti_calloc(1, sizeof(uv_idle_t));
     uv_idle_init(conn->ziti_ctx->loop, conn->flusher);
     conn->flusher->data = conn;
     uv_unref((uv_handle_t *) &conn->flusher);
@@ -1268,7 +1379,7 @@ int ziti_accept(ziti_connection conn, ziti_conn_cb cb, ziti_data_cb data_cb) {
             },
     };
 
-    struct ziti_write_req_s *ar = calloc(1, sizeof(*ar));
+    struct ziti_write_req_s *ar = ziti_calloc(1, sizeof(*ar));
     ar->conn = conn;
     ar->cb = accept_cb;
     ar->ctx = cb;
@@ -1299,6 +1410,11 @@ int ziti_write(ziti_connection conn, const uint8_t *data, size_t length, ziti_wr
     req->ctx = write_ctx;
     CONN_LOG(TRACE, "write %zd bytes", length);
     metrics_rate_update(&conn->ziti_ctx->up_rate, (long)length);
+    if (conn->bytes_out == NULL && conn->service) {
+        conn->bytes_out = metrics_get(conn->ziti_ctx->metrics, ziti_metric_counter, "bytes_out",
+                                      "service", conn->service, NULL, NULL);
+    }
+    metric_add(conn->bytes_out, (int64_t) length);
 
     TAILQ_INSERT_TAIL(&conn->wreqs, req, _next);
     flush_connection(conn);
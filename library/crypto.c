@@ -20,11 +20,11 @@ int init_key_pair(struct key_pair *kp) {
 }
 
 int init_crypto(struct key_exchange *key_ex, struct key_pair *kp, const uint8_t *peer_key, bool server) {
-    free(key_ex->rx);
-    free(key_ex->tx);
+    ziti_free(key_ex->rx);
+    ziti_free(key_ex->tx);
 
-    key_ex->rx = calloc(1, crypto_secretstream_xchacha20poly1305_keybytes());
-    key_ex->tx = calloc(1, crypto_secretstream_xchacha20poly1305_keybytes());
+    key_ex->rx = ziti_calloc(1, crypto_secretstream_xchacha20poly1305_keybytes());
+    key_ex->tx = ziti_calloc(1, crypto_secretstream_xchacha20poly1305_keybytes());
     if (server) {
         return crypto_kx_server_session_keys(key_ex->rx, key_ex->tx, kp->pk, kp->sk, peer_key);
     } else {
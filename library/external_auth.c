@@ -14,6 +14,8 @@
 // 	limitations under the License.
 //
 
+#define ZITI_ALLOC_TAG ziti_alloc_ctrl
+
 #include <ziti/ziti_events.h>
 #include "zt_internal.h"
 #include "oidc.h"
@@ -64,7 +66,7 @@ int ztx_init_external_auth(ziti_context ztx, const ziti_jwt_signer *oidc_cfg) {
         NEWP(oidc, oidc_client_t);
         int rc = oidc_client_init(ztx->loop, oidc, oidc_cfg, NULL);
         if (rc != ZITI_OK) {
-            free(oidc);
+            ziti_free(oidc);
             ZTX_LOG(ERROR, "failed to initialize OIDC client: %s", ziti_errorstr(rc));
             return rc;
         }
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_ctrl
+
 #include "auth_method.h"
 #include "oidc.h"
 #include "utils.h"
@@ -45,7 +47,7 @@ struct ha_auth_s {
 };
 
 ziti_auth_method_t *new_ha_auth(uv_loop_t *l, const char* url, tls_context *tls) {
-    struct ha_auth_s *auth = calloc(1, sizeof(*auth));
+    struct ha_auth_s *auth = ziti_calloc(1, sizeof(*auth));
 
     auth->api = (ziti_auth_method_t){
         .kind = HA,
@@ -78,7 +80,7 @@ static char *internal_oidc_path(const char *url) {
 
     size_t baselen = u.path ? u.path - url : strlen(url);
     size_t maxlen = baselen + 6;
-    char *ep = malloc(maxlen);
+    char *ep = ziti_malloc(maxlen);
     snprintf(ep, maxlen, "%.*s/oidc", (int)baselen, url);
     return ep;
 }
@@ -87,7 +89,7 @@ static int ha_set_endpoint(ziti_auth_method_t *self, const char *url) {
     struct ha_auth_s *auth = HA_AUTH(self);
     char *ep = internal_oidc_path(url);
     if (auth->config.provider_url && strcmp(ep, auth->config.provider_url) == 0) {
-        free(ep);
+        ziti_free(ep);
         return -1;
     }
 
@@ -101,9 +103,9 @@ static int ha_set_endpoint(ziti_auth_method_t *self, const char *url) {
 
 static void close_cb(oidc_client_t *oidc) {
     struct ha_auth_s *auth = HA_AUTH_FROM_OIDC(oidc);
-    free((char*)auth->config.provider_url);
+    ziti_free((char*)auth->config.provider_url);
     model_list_clear(&auth->config.scopes, NULL);
-    free(auth);
+    ziti_free(auth);
 }
 
 static void ha_auth_free(ziti_auth_method_t *self) {
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 
+#define ZITI_ALLOC_TAG ziti_alloc_model
+
 #include <internal_model.h>
 #include <ziti/ziti_model.h>
 #include <ziti/errors.h>
@@ -22,6 +24,7 @@
 #include <string.h>
 #include <assert.h>
 #include "ziti/ziti_buffer.h"
+#include "alloc.h"
 #include "ziti/ziti.h"
 
 #if _WIN32
@@ -170,6 +173,8 @@ IMPL_MODEL(ziti_controller_detail, ZITI_CONTROLLER_DETAIL)
 
 IMPL_MODEL(ziti_pr_base, ZITI_PR_BASE);
 
+IMPL_MODEL(ziti_bootstrap_cache, ZITI_BOOTSTRAP_CACHE_MODEL)
+
 bool ziti_service_has_permission(const ziti_service *service, ziti_session_type sessionType) {
     if (sessionType == ziti_session_types.Dial) {
         return (service->perm_flags & ZITI_CAN_DIAL) != 0;
@@ -490,23 +495,24 @@ static type_meta ziti_address_META = {
         .jsonifier = (_to_json_f) ziti_address_write_json,
         .from_json = (from_json_func) ziti_address_from_j,
         .to_json = (to_json_func) ziti_address_to_j,
+        .arena_aware = true,
 };
 
 int ziti_intercept_from_client_cfg(ziti_intercept_cfg_v1 *intercept, const ziti_client_cfg_v1 *client_cfg) {
     memset(intercept, 0, sizeof(*intercept));
 
-    ziti_protocol *proto = calloc(1, sizeof(ziti_protocol));
+    ziti_protocol *proto = ziti_calloc(1, sizeof(ziti_protocol));
     *proto = ziti_protocols.tcp;
     model_list_append(&intercept->protocols, proto);
-    proto = calloc(1, sizeof(ziti_protocol));
+    proto = ziti_calloc(1, sizeof(ziti_protocol));
     *proto = ziti_protocols.udp;
     model_list_append(&intercept->protocols, proto);
 
-    ziti_address *addr_copy = calloc(1, sizeof(ziti_address));
+    ziti_address *addr_copy = ziti_calloc(1, sizeof(ziti_address));
     memcpy(addr_copy, &client_cfg->hostname, sizeof(ziti_address));
     model_list_append(&intercept->addresses, addr_copy);
 
-    ziti_port_range *range_copy = calloc(1, sizeof(ziti_port_range));
+    ziti_port_range *range_copy = ziti_calloc(1, sizeof(ziti_port_range));
     range_copy->low = client_cfg->port;
     range_copy->high = client_cfg->port;
     model_list_append(&intercept->port_ranges, range_copy);
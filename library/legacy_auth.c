@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_ctrl
+
 #include "auth_method.h"
 #include "zt_internal.h"
 #include <assert.h>
@@ -66,7 +68,7 @@ static void login_cb(ziti_api_session *session, const ziti_error *err, void *ctx
     }
 
 ziti_auth_method_t *new_legacy_auth(ziti_controller *ctrl) {
-    struct legacy_auth_s *auth = calloc(1, sizeof(*auth));
+    struct legacy_auth_s *auth = ziti_calloc(1, sizeof(*auth));
     auth->api = LEGACY_AUTH_INIT();
     auth->ctrl = ctrl;
     uv_timer_init(ctrl->loop, &auth->timer);
@@ -76,8 +78,8 @@ ziti_auth_method_t *new_legacy_auth(ziti_controller *ctrl) {
 
 static int legacy_auth_jwt_token(ziti_auth_method_t *self, const char *token) {
     struct legacy_auth_s *auth = container_of(self, struct legacy_auth_s, api);
-    free(auth->jwt);
-    auth->jwt = strdup(token);
+    ziti_free(auth->jwt);
+    auth->jwt = ziti_strdup(token);
     if (auth->session) {
         ziti_ctrl_mfa_jwt(auth->ctrl, auth->jwt, login_cb, auth);
     }
@@ -114,14 +116,14 @@ int legacy_auth_stop(ziti_auth_method_t *self) {
 
 static void close_cb(uv_timer_t *t) {
     struct legacy_auth_s *auth = container_of(t, struct legacy_auth_s, timer);
-    free(auth);
+    ziti_free(auth);
 }
 
 void legacy_auth_free(ziti_auth_method_t *self) {
     struct legacy_auth_s *auth = container_of(self, struct legacy_auth_s, api);
     model_list_clear(&auth->config_types, NULL);
     free_ziti_api_session_ptr(auth->session);
-    free(auth->jwt);
+    ziti_free(auth->jwt);
     uv_close((uv_handle_t *)&auth->timer, (uv_close_cb)close_cb);
 }
 
@@ -0,0 +1,205 @@
+//
+// 	Copyright NetFoundry Inc.
+//
+// 	Licensed under the Apache License, Version 2.0 (the "License");
+// 	you may not use this file except in compliance with the License.
+// 	You may obtain a copy of the License at
+//
+// 	https://www.apache.org/licenses/LICENSE-2.0
+//
+// 	Unless required by applicable law or agreed to in writing, software
+// 	distributed under the License is distributed on an "AS IS" BASIS,
+// 	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// 	See the License for the specific language governing permissions and
+// 	limitations under the License.
+//
+
+// dladdr()
+#define _GNU_SOURCE
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <dlfcn.h>
+#endif
+
+#include "zt_internal.h"
+#include "utils.h"
+#include "metrics.h"
+
+#define WATCHDOG_INTERVAL 100
+#define NS_PER_MS 1000000
+
+static const char *const cb_names[ztx_cb_kinds] = {
+        [ztx_data_cb] = "data_cb",
+        [ztx_conn_cb] = "conn_cb",
+        [ztx_event_cb] = "event_cb",
+};
+
+struct loop_monitor_s {
+    ziti_context ztx;
+    uint64_t threshold; // ms
+
+    // watchdog: how late timers run
+    uv_timer_t watchdog;
+    uint64_t watchdog_due;
+    metric_t *lag;
+
+    // iteration time, between consecutive check phases, minus time blocked in poll
+    uv_check_t check;
+    uint64_t check_ts;
+    uint64_t check_idle;
+    metric_t *busy;
+
+    metric_t *callbacks[ztx_cb_kinds];
+    // stall in current iteration was already reported against a callback
+    bool attributed;
+    int open_handles;
+};
+
+static const char *cb_symbol(void *cb, char *buf, size_t len) {
+#if !defined(_WIN32)
+    Dl_info info;
+    if (dladdr(cb, &info) != 0) {
+        if (info.dli_sname) {
+            return info.dli_sname;
+        }
+        if (info.dli_fname) {
+            const char *fname = strrchr(info.dli_fname, '/');
+            snprintf(buf, len, "%s+0x%" PRIxPTR, fname ? fname + 1 : info.dli_fname,
+                     (uintptr_t) cb - (uintptr_t) info.dli_fbase);
+            return buf;
+        }
+    }
+#endif
+    snprintf(buf, len, "%p", cb);
+    return buf;
+}
+
+static void report_stall(ziti_context ztx, const char *source, const char *callback, uint64_t duration) {
+    if (callback) {
+        ZTX_LOG(WARN, "%s[%s] blocked event loop for %" PRIu64 "ms", source, callback, duration);
+    } else {
+        ZTX_LOG(WARN, "event loop blocked for %" PRIu64 "ms", duration);
+    }
+
+    // not going through ziti_send_event(): it would time this callback as well
+    if ((ztx->opts.events & ZitiLoopStallEvent) && ztx->opts.event_cb) {
+        ziti_event_t ev = {
+                .type = ZitiLoopStallEvent,
+                .stall = {
+                        .source = source,
+                        .callback = callback,
+                        .duration_ms = duration,
+                },
+        };
+        ztx->opts.event_cb(ztx, &ev);
+    }
+}
+
+void ztx_cb_done(ziti_context ztx, enum ztx_cb_kind kind, void *cb, uint64_t start) {
+    struct loop_monitor_s *mon = ztx->loop_monitor;
+    if (start == 0 || mon == NULL) {
+        return;
+    }
+
+    uint64_t elapsed = (uv_hrtime() - start) / NS_PER_MS;
+    metric_record(mon->callbacks[kind], elapsed);
+
+    if (elapsed >= mon->threshold) {
+        char buf[128];
+        mon->attributed = true;
+        report_stall(ztx, cb_names[kind], cb_symbol(cb, buf, sizeof(buf)), elapsed);
+    }
+}
+
+static void watchdog_cb(uv_timer_t *t) {
+    struct loop_monitor_s *mon = t->data;
+    uint64_t now = uv_now(t->loop);
+
+    metric_record(mon->lag, now > mon->watchdog_due ? now - mon->watchdog_due : 0);
+    mon->watchdog_due = now + WATCHDOG_INTERVAL;
+}
+
+static void check_cb(uv_check_t *c) {
+    struct loop_monitor_s *mon = c->data;
+    uint64_t now = uv_hrtime();
+    uint64_t idle = uv_metrics_idle_time(c->loop);
+
+    if (mon->check_ts != 0) {
+        uint64_t iteration = now - mon->check_ts;
+        uint64_t polled = idle - mon->check_idle;
+        uint64_t busy = (iteration > polled ? iteration - polled : 0) / NS_PER_MS;
+        metric_record(mon->busy, busy);
+
+        if (busy >= mon->threshold && !mon->attributed) {
+            report_stall(mon->ztx, "loop", NULL, busy);
+        }
+    }
+
+    mon->attributed = false;
+    mon->check_ts = now;
+    mon->check_idle = idle;
+}
+
+void loop_monitor_start(ziti_context ztx) {
+    if (ztx->opts.loop_stall_threshold_ms == 0 || ztx->loop_monitor != NULL) {
+        return;
+    }
+
+    uv_loop_t *loop = ztx->loop;
+    NEWP(mon, struct loop_monitor_s);
+    mon->ztx = ztx;
+    mon->threshold = ztx->opts.loop_stall_threshold_ms;
+
+    mon->lag = metrics_get(ztx->metrics, ziti_metric_histogram, "loop_lag_ms", NULL, NULL, NULL, NULL);
+    mon->busy = metrics_get(ztx->metrics, ziti_metric_histogram, "loop_busy_ms", NULL, NULL, NULL, NULL);
+    for (int i = 0; i < ztx_cb_kinds; i++) {
+        mon->callbacks[i] = metrics_get(ztx->metrics, ziti_metric_histogram, "callback_ms",
+                                        "callback", cb_names[i], NULL, NULL);
+    }
+
+    uv_timer_init(loop, &mon->watchdog);
+    mon->watchdog.data = mon;
+    uv_unref((uv_handle_t *) &mon->watchdog);
+    mon->watchdog_due = uv_now(loop) + WATCHDOG_INTERVAL;
+    uv_timer_start(&mon->watchdog, watchdog_cb, WATCHDOG_INTERVAL, WATCHDOG_INTERVAL);
+    mon->open_handles++;
+
+    // idle time accounting is needed to exclude poll wait from iteration time
+    int rc = uv_loop_configure(loop, UV_METRICS_IDLE_TIME);
+    if (rc == 0) {
+        uv_check_init(loop, &mon->check);
+        mon->check.data = mon;
+        uv_unref((uv_handle_t *) &mon->check);
+        uv_check_start(&mon->check, check_cb);
+        mon->open_handles++;
+    } else {
+        ZTX_LOG(WARN, "loop idle time is not available[%s], iteration time will not be tracked", uv_strerror(rc));
+    }
+
+    ztx->loop_monitor = mon;
+    ZTX_LOG(INFO, "monitoring event loop stalls over %" PRIu64 "ms", mon->threshold);
+}
+
+static void on_monitor_close(uv_handle_t *h) {
+    struct loop_monitor_s *mon = h->data;
+    if (--mon->open_handles == 0) {
+        ziti_free(mon);
+    }
+}
+
+void loop_monitor_stop(ziti_context ztx) {
+    struct loop_monitor_s *mon = ztx->loop_monitor;
+    if (mon == NULL) {
+        return;
+    }
+
+    ztx->loop_monitor = NULL;
+    uv_close((uv_handle_t *) &mon->watchdog, on_monitor_close);
+    if (uv_is_active((uv_handle_t *) &mon->check)) {
+        uv_close((uv_handle_t *) &mon->check, on_monitor_close);
+    }
+}
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_channel
+
 #include "message.h"
 #include <stdlib.h>
 #include <string.h>
@@ -65,7 +67,7 @@ void message_init(message* m) {
 void message_free(message* m) {
     if (m != NULL) {
         if (m->msgbufp != m->msgbuf) {
-            free(m->msgbufp);
+            ziti_free(m->msgbufp);
         }
         FREE(m->hdrs);
     }
@@ -110,7 +112,7 @@ int parse_hdrs(const uint8_t *buf, uint32_t len, hdr_t **hp) {
         return ZITI_INVALID_STATE;
     }
 
-    hdr_t *headers = calloc(count, sizeof(hdr_t));
+    hdr_t *headers = ziti_calloc(count, sizeof(hdr_t));
     if (headers == NULL) {
         ZITI_LOG(ERROR, "failed to allocates message headers");
         return ZITI_ALLOC_FAILED;
@@ -207,7 +209,7 @@ int message_new_from_header(pool_t *pool, uint8_t buf[HEADER_SIZE], message **ms
 
     size_t msgsize = sizeof(message) + msgbuflen;
     if (msgsize > pool_obj_size(m)) {
-        m->msgbufp = malloc(msgbuflen);
+        m->msgbufp = ziti_malloc(msgbuflen);
         if (m->msgbufp == NULL) {
             pool_return_obj(m);
             return ZITI_ALLOC_FAILED;
@@ -248,7 +250,7 @@ message *message_new(pool_t *pool, uint32_t content, const hdr_t *hdrs, int nhdr
     m->msgbuflen = msgbuflen;
 
     if (msgsize > pool_obj_size(m)) {
-        m->msgbufp = malloc(msgbuflen);
+        m->msgbufp = ziti_malloc(msgbuflen);
     }
     else {
         m->msgbufp = m->msgbuf;
@@ -258,7 +260,7 @@ message *message_new(pool_t *pool, uint32_t content, const hdr_t *hdrs, int nhdr
     header_to_buffer(&m->header, m->msgbufp);
 
     // write/populate headers
-    m->hdrs = calloc(nhdrs, sizeof(hdr_t));
+    m->hdrs = ziti_calloc(nhdrs, sizeof(hdr_t));
     m->nhdrs = nhdrs;
     m->headers = m->msgbufp + HEADER_SIZE;
     m->body = m->headers + m->header.headers_len;
@@ -18,9 +18,16 @@ limitations under the License.
 
 #define _USE_MATH_DEFINES
 
+#include <inttypes.h>
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <ziti/model_collections.h>
+
+#include "alloc.h"
+
 #if defined(__unix__) || defined(__APPLE__)
 # if __STDC_NO_ATOMICS__
 #   include <atomic.h>
@@ -51,6 +58,9 @@ static double intervalNanos = NANOS(5);
 static void tick_ewma(rate_t *ewma);
 static void tick_cma(rate_t *cma);
 static void tick_instant(rate_t *inst);
+static void idle_ewma(rate_t *ewma, uint64_t ticks);
+static void idle_cma(rate_t *cma, uint64_t ticks);
+static void idle_instant(rate_t *inst, uint64_t ticks);
 
 extern void metrics_init(long interval_secs, time_fn f, void *time_ctx) {
 
@@ -68,6 +78,7 @@ extern void metrics_rate_close(rate_t* r) {
     if (r->active) {
         r->active = false;
         r->tick_fn = NULL;
+        r->idle_fn = NULL;
         atomic_exchange(&r->delta, 0);
         r->rate = 0;
     }
@@ -78,6 +89,7 @@ extern int metrics_rate_init(rate_t *r, rate_type type) {
         metrics_rate_close(r);
     }
     memset(r, 0, sizeof(rate_t));
+    r->idle_fn = idle_ewma;
     switch (type) {
         case EWMA_5s:
             r->tick_fn = tick_ewma;
@@ -105,10 +117,12 @@ extern int metrics_rate_init(rate_t *r, rate_type type) {
 
         case CMA_1m:
             r->tick_fn = tick_cma;
+            r->idle_fn = idle_cma;
             break;
             
         case INSTANT:
             r->tick_fn = tick_instant;
+            r->idle_fn = idle_instant;
             r->param = 1;
             break;
         default:
@@ -122,33 +136,41 @@ extern int metrics_rate_init(rate_t *r, rate_type type) {
     return 0;
 }
 
-static void rate_catchup(rate_t *r) {
-    if (clock_fn) {
-        uint64_t now = clock_fn(clock_ctx);
-        while (now > r->last_tick + (uint64_t) MILLIS(interval)) {
-            r->tick_fn(r);
-            r->last_tick = r->last_tick + (uint64_t) MILLIS(interval);
-        }
+uint64_t metrics_tick_interval(void) {
+    return (uint64_t) MILLIS(interval);
+}
+
+void metrics_rate_tick(rate_t *r, uint64_t now) {
+    if (r == NULL || !r->active) return;
+
+    uint64_t step = metrics_tick_interval();
+    if (now < r->last_tick + step) return;
+
+    uint64_t ticks = (now - r->last_tick) / step;
+    r->last_tick += ticks * step;
+
+    // accumulated delta is accounted to the first interval, the rest of the gap was idle
+    r->tick_fn(r);
+    if (ticks > 1) {
+        r->idle_fn(r, ticks - 1);
     }
 }
 
 extern void metrics_rate_update(rate_t *r, long delta) {
     if (r == NULL || !r->active) return;
 
-    rate_catchup(r);
-    atomic_fetch_add(&r->delta, delta);
+    atomic_fetch_add_explicit(&r->delta, delta, memory_order_relaxed);
 }
 
 extern int metrics_rate_get(rate_t *r, double *rate) {
     if (r == NULL || !r->active) return -1;
-    rate_catchup(r);
-    *rate = (*(double*)&r->rate) * (SECOND);
+    int64_t bits = atomic_load_explicit(&r->rate, memory_order_relaxed);
+    *rate = (*(double*)&bits) * (SECOND);
     return 0;
 }
 
 static double instant_rate(rate_t *r) {
-    int64_t c = r->delta;
-    atomic_fetch_add(&r->delta, -c);
+    int64_t c = atomic_exchange(&r->delta, 0);
     return ((double) c) / (intervalNanos);
 }
 
@@ -176,6 +198,378 @@ static void tick_ewma(rate_t *ewma) {
 
 static void tick_instant(rate_t *inst) {
     double r = instant_rate(inst);
-    atomic_exchange(&inst->delta, 0); //reset the delta
     atomic_exchange(&inst->rate, *(int64_t*)(&r));
 }
+
+// closed-form equivalents of running tick function [ticks] times with no updates
+
+static void idle_ewma(rate_t *ewma, uint64_t ticks) {
+    double currRate = *(double*)&ewma->rate;
+    currRate *= pow(1.0 - *(double*)(&ewma->param), (double) ticks);
+    atomic_exchange(&ewma->rate, *(int64_t *) (&currRate));
+}
+
+static void idle_cma(rate_t *cma, uint64_t ticks) {
+    double current_rate = *(double*)&cma->rate;
+    current_rate = current_rate * (double) cma->param / ((double) cma->param + (double) ticks);
+
+    atomic_exchange(&cma->rate, *(int64_t *) (&current_rate));
+    atomic_exchange(&cma->param, cma->param + (int64_t) ticks);
+}
+
+static void idle_instant(rate_t *inst, uint64_t ticks) {
+    atomic_exchange(&inst->rate, 0);
+}
+
+// log-linear histogram (HDR-style): 8 linear sub-buckets per power of two,
+// values are recorded with 1/8 relative precision
+#define HIST_SUB_BITS 3
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB)
+
+struct histogram_s {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[HIST_BUCKETS];
+};
+
+struct metric_s {
+    char *name;
+    ziti_metric_type type;
+    char *labels[ZITI_METRIC_MAX_LABELS][2];
+    int64_t value;
+    struct histogram_s *hist;
+};
+
+struct metrics_registry_s {
+    model_map metrics;
+};
+
+static int msb64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(v);
+#else
+    int n = 0;
+    while (v >>= 1) n++;
+    return n;
+#endif
+}
+
+static int hist_index(uint64_t v) {
+    if (v < HIST_SUB) {
+        return (int) v;
+    }
+    int shift = msb64(v) - HIST_SUB_BITS;
+    return (shift + 1) * HIST_SUB + (int) ((v >> shift) & (HIST_SUB - 1));
+}
+
+static uint64_t hist_upper_bound(int idx) {
+    if (idx < HIST_SUB) {
+        return (uint64_t) idx;
+    }
+    int shift = idx / HIST_SUB - 1;
+    uint64_t low = (uint64_t) (HIST_SUB + idx % HIST_SUB) << shift;
+    return low + ((uint64_t) 1 << shift) - 1;
+}
+
+static uint64_t hist_quantile(const struct histogram_s *h, double q) {
+    if (h->count == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t) ceil(q * (double) h->count);
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint64_t bound = hist_upper_bound(i);
+            return bound > h->max ? h->max : bound;
+        }
+    }
+    return h->max;
+}
+
+metrics_registry *metrics_registry_new(void) {
+    return ziti_calloc(1, sizeof(metrics_registry));
+}
+
+static void metric_free(metric_t *m) {
+    ziti_free(m->name);
+    for (int i = 0; i < ZITI_METRIC_MAX_LABELS; i++) {
+        ziti_free(m->labels[i][0]);
+        ziti_free(m->labels[i][1]);
+    }
+    ziti_free(m->hist);
+    ziti_free(m);
+}
+
+void metrics_registry_free(metrics_registry *reg) {
+    if (reg == NULL) return;
+    model_map_clear(&reg->metrics, (void (*)(void *)) metric_free);
+    ziti_free(reg);
+}
+
+metric_t *metrics_get(metrics_registry *reg, ziti_metric_type type, const char *name,
+                      const char *label, const char *value,
+                      const char *label2, const char *value2) {
+    if (reg == NULL) return NULL;
+
+    char key[512];
+    snprintf(key, sizeof(key), "%s{%s=%s,%s=%s}", name,
+             label ? label : "", value ? value : "", label2 ? label2 : "", value2 ? value2 : "");
+
+    metric_t *m = model_map_get(&reg->metrics, key);
+    if (m == NULL) {
+        m = ziti_calloc(1, sizeof(*m));
+        m->name = ziti_strdup(name);
+        m->type = type;
+        const char *l[ZITI_METRIC_MAX_LABELS][2] = {{label, value}, {label2, value2}};
+        for (int i = 0; i < ZITI_METRIC_MAX_LABELS; i++) {
+            if (l[i][0]) {
+                m->labels[i][0] = ziti_strdup(l[i][0]);
+                m->labels[i][1] = ziti_strdup(l[i][1] ? l[i][1] : "");
+            }
+        }
+        if (type == ziti_metric_histogram) {
+            m->hist = ziti_calloc(1, sizeof(struct histogram_s));
+        }
+        model_map_set(&reg->metrics, key, m);
+    }
+    return m;
+}
+
+void metric_add(metric_t *m, int64_t delta) {
+    if (m == NULL) return;
+    m->value += delta;
+}
+
+void metric_set(metric_t *m, int64_t value) {
+    if (m == NULL) return;
+    m->value = value;
+}
+
+void metric_record(metric_t *m, uint64_t value) {
+    if (m == NULL || m->hist == NULL) return;
+
+    struct histogram_s *h = m->hist;
+    if (h->count == 0 || value < h->min) h->min = value;
+    if (value > h->max) h->max = value;
+    h->count++;
+    h->sum += value;
+    h->buckets[hist_index(value)]++;
+}
+
+static int metric_cmp(const void *a, const void *b) {
+    const ziti_metric *l = a;
+    const ziti_metric *r = b;
+    int rc = strcmp(l->name, r->name);
+    for (int i = 0; rc == 0 && i < ZITI_METRIC_MAX_LABELS; i++) {
+        rc = strcmp(l->labels[i].value ? l->labels[i].value : "", r->labels[i].value ? r->labels[i].value : "");
+    }
+    return rc;
+}
+
+int metrics_snapshot(metrics_registry *reg, ziti_metrics_snapshot *snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    if (reg == NULL) return -1;
+
+    snapshot->metrics = ziti_calloc(model_map_size(&reg->metrics) + 1, sizeof(ziti_metric));
+
+    const char *key;
+    metric_t *m;
+    MODEL_MAP_FOREACH(key, m, &reg->metrics) {
+        ziti_metric *out = &snapshot->metrics[snapshot->count++];
+        out->name = ziti_strdup(m->name);
+        out->type = m->type;
+        for (int i = 0; i < ZITI_METRIC_MAX_LABELS; i++) {
+            if (m->labels[i][0]) {
+                out->labels[i].name = ziti_strdup(m->labels[i][0]);
+                out->labels[i].value = ziti_strdup(m->labels[i][1]);
+            }
+        }
+
+        struct histogram_s *h = m->hist;
+        if (h == NULL) {
+            out->value = m->value;
+            continue;
+        }
+
+        out->value = (int64_t) h->count;
+        out->sum = h->sum;
+        out->min = h->min;
+        out->max = h->max;
+        out->p50 = hist_quantile(h, 0.5);
+        out->p90 = hist_quantile(h, 0.9);
+        out->p99 = hist_quantile(h, 0.99);
+        out->p999 = hist_quantile(h, 0.999);
+
+        for (int i = 0; i < HIST_BUCKETS; i++) {
+            if (h->buckets[i] > 0) out->bucket_count++;
+        }
+        out->buckets = ziti_calloc(out->bucket_count + 1, sizeof(ziti_metric_bucket));
+        size_t b = 0;
+        for (int i = 0; i < HIST_BUCKETS; i++) {
+            if (h->buckets[i] > 0) {
+                out->buckets[b].upper_bound = hist_upper_bound(i);
+                out->buckets[b].count = h->buckets[i];
+                b++;
+            }
+        }
+    }
+
+    qsort(snapshot->metrics, snapshot->count, sizeof(ziti_metric), metric_cmp);
+    return 0;
+}
+
+void ziti_metrics_snapshot_free(ziti_metrics_snapshot *snapshot) {
+    if (snapshot == NULL) return;
+
+    for (size_t i = 0; i < snapshot->count; i++) {
+        ziti_metric *m = &snapshot->metrics[i];
+        ziti_free((char *) m->name);
+        for (int l = 0; l < ZITI_METRIC_MAX_LABELS; l++) {
+            ziti_free((char *) m->labels[l].name);
+            ziti_free((char *) m->labels[l].value);
+        }
+        ziti_free(m->buckets);
+    }
+    ziti_free(snapshot->metrics);
+    snapshot->metrics = NULL;
+    snapshot->count = 0;
+}
+
+#define METRIC_PREFIX "ziti_"
+
+static const char *const metric_types[] = {
+        [ziti_metric_counter] = "counter",
+        [ziti_metric_gauge] = "gauge",
+        [ziti_metric_histogram] = "histogram",
+};
+
+// label values must escape backslash, double-quote and line feed
+static const char *escape_label(const char *v, char *buf, size_t len) {
+    size_t i = 0;
+    for (; *v && i + 2 < len; v++) {
+        if (*v == '\\' || *v == '"') {
+            buf[i++] = '\\';
+            buf[i++] = *v;
+        } else if (*v == '\n') {
+            buf[i++] = '\\';
+            buf[i++] = 'n';
+        } else {
+            buf[i++] = *v;
+        }
+    }
+    buf[i] = '\0';
+    return buf;
+}
+
+// sample line is assembled on the stack and handed to the printer in one call
+static void print_sample(metrics_printer p, void *ctx, const char *name, const char *suffix,
+                         char *labels[][2], const char *le, const char *value) {
+    char line[1024];
+    char esc[256];
+    size_t len = 0;
+    const char *sep = "{";
+
+#define APPEND(...) do { \
+    int n = snprintf(line + len, sizeof(line) - len, __VA_ARGS__); \
+    if (n > 0) len = (size_t) n < sizeof(line) - len ? len + n : sizeof(line) - 1; \
+} while(0)
+
+    APPEND(METRIC_PREFIX "%s%s", name, suffix);
+    for (int i = 0; labels && i < ZITI_METRIC_MAX_LABELS; i++) {
+        if (labels[i][0] == NULL) continue;
+        APPEND("%s%s=\"%s\"", sep, labels[i][0], escape_label(labels[i][1], esc, sizeof(esc)));
+        sep = ",";
+    }
+    if (le) {
+        APPEND("%sle=\"%s\"", sep, le);
+        sep = ",";
+    }
+    APPEND("%s %s\n", *sep == ',' ? "}" : "", value);
+#undef APPEND
+
+    p(ctx, "%s", line);
+}
+
+static const char *counter_suffix(ziti_metrics_format fmt, ziti_metric_type type) {
+    return fmt == ziti_metrics_openmetrics && type == ziti_metric_counter ? "_total" : "";
+}
+
+void metrics_write_type(metrics_printer p, void *ctx, const char *name, ziti_metric_type type) {
+    p(ctx, "# TYPE " METRIC_PREFIX "%s %s\n", name, metric_types[type]);
+}
+
+void metrics_write_sample(metrics_printer p, void *ctx, ziti_metrics_format fmt,
+                          const char *name, ziti_metric_type type,
+                          const char *label, const char *value, double v) {
+    char *labels[ZITI_METRIC_MAX_LABELS][2] = {{(char *) label, (char *) value}};
+    char num[32];
+    snprintf(num, sizeof(num), "%.15g", v);
+    print_sample(p, ctx, name, counter_suffix(fmt, type), labels, NULL, num);
+}
+
+static int metric_ptr_cmp(const void *a, const void *b) {
+    const metric_t *l = *(const metric_t *const *) a;
+    const metric_t *r = *(const metric_t *const *) b;
+    int rc = strcmp(l->name, r->name);
+    for (int i = 0; rc == 0 && i < ZITI_METRIC_MAX_LABELS; i++) {
+        rc = strcmp(l->labels[i][1] ? l->labels[i][1] : "", r->labels[i][1] ? r->labels[i][1] : "");
+    }
+    return rc;
+}
+
+int metrics_write(metrics_registry *reg, ziti_metrics_format fmt, metrics_printer p, void *ctx) {
+    if (reg == NULL || p == NULL) return -1;
+
+    size_t count = model_map_size(&reg->metrics);
+    if (count == 0) return 0;
+
+    // samples of the same metric family must be written together
+    metric_t **sorted = ziti_calloc(count, sizeof(metric_t *));
+    size_t idx = 0;
+    const char *key;
+    metric_t *m;
+    MODEL_MAP_FOREACH(key, m, &reg->metrics) {
+        sorted[idx++] = m;
+    }
+    qsort(sorted, count, sizeof(metric_t *), metric_ptr_cmp);
+
+    const char *family = NULL;
+    char num[32];
+    char le[32];
+    for (idx = 0; idx < count; idx++) {
+        m = sorted[idx];
+        if (family == NULL || strcmp(family, m->name) != 0) {
+            metrics_write_type(p, ctx, m->name, m->type);
+            family = m->name;
+        }
+
+        struct histogram_s *h = m->hist;
+        if (h == NULL) {
+            snprintf(num, sizeof(num), "%" PRId64, m->value);
+            print_sample(p, ctx, m->name, counter_suffix(fmt, m->type), m->labels, NULL, num);
+            continue;
+        }
+
+        // only non-empty buckets are written, counts are cumulative
+        uint64_t cumulative = 0;
+        for (int i = 0; i < HIST_BUCKETS; i++) {
+            if (h->buckets[i] == 0) continue;
+            cumulative += h->buckets[i];
+            snprintf(le, sizeof(le), "%" PRIu64, hist_upper_bound(i));
+            snprintf(num, sizeof(num), "%" PRIu64, cumulative);
+            print_sample(p, ctx, m->name, "_bucket", m->labels, le, num);
+        }
+        snprintf(num, sizeof(num), "%" PRIu64, h->count);
+        print_sample(p, ctx, m->name, "_bucket", m->labels, "+Inf", num);
+        print_sample(p, ctx, m->name, "_count", m->labels, NULL, num);
+        snprintf(num, sizeof(num), "%" PRIu64, h->sum);
+        print_sample(p, ctx, m->name, "_sum", m->labels, NULL, num);
+    }
+
+    ziti_free(sorted);
+    return 0;
+}
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_model
+
 #include <ziti/model_collections.h>
 
 #include <stddef.h>
@@ -42,8 +44,95 @@ struct model_impl_s {
     entries_t *table;
     int buckets;
     size_t size;
+    model_arena *arena;
+};
+
+#define ARENA_ALIGN (2 * sizeof(void *))
+#define ARENA_DEFAULT_BLOCK (16 * 1024)
+
+struct arena_block_s {
+    struct arena_block_s *next;
+    size_t size;
+    size_t used;
+    char data[];
+};
+
+struct model_arena_s {
+    struct arena_block_s *blocks;
+    size_t block_size;
+    size_t used;
 };
 
+model_arena *model_arena_new(size_t block_size) {
+    model_arena *a = ziti_calloc(1, sizeof(model_arena));
+    a->block_size = block_size > 0 ? block_size : ARENA_DEFAULT_BLOCK;
+    return a;
+}
+
+void *model_arena_alloc(model_arena *a, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+    struct arena_block_s *b = a->blocks;
+    if (b == NULL || b->size - b->used < size) {
+        // oversized allocations get their own block, current block stays at the head
+        size_t bsize = size > a->block_size / 4 ? size : a->block_size;
+        struct arena_block_s *nb = ziti_calloc(1, sizeof(struct arena_block_s) + bsize);
+        if (nb == NULL) {
+            return NULL;
+        }
+        nb->size = bsize;
+        if (b != NULL && bsize != a->block_size) {
+            nb->next = b->next;
+            b->next = nb;
+        } else {
+            nb->next = b;
+            a->blocks = nb;
+        }
+        b = nb;
+    }
+
+    void *p = b->data + b->used;
+    b->used += size;
+    a->used += size;
+    return p;
+}
+
+char *model_arena_strdup(model_arena *a, const char *str) {
+    if (str == NULL) { return NULL; }
+
+    size_t len = strlen(str);
+    char *s = model_arena_alloc(a, len + 1);
+    if (s) {
+        memcpy(s, str, len);
+    }
+    return s;
+}
+
+size_t model_arena_used(const model_arena *a) {
+    return a ? a->used : 0;
+}
+
+void model_arena_free(model_arena *a) {
+    if (a == NULL) { return; }
+
+    while (a->blocks) {
+        struct arena_block_s *b = a->blocks;
+        a->blocks = b->next;
+        ziti_free(b);
+    }
+    ziti_free(a);
+}
+
+static inline void *coll_alloc(model_arena *a, size_t size) {
+    return a ? model_arena_alloc(a, size) : ziti_calloc(1, size);
+}
+
+static inline void coll_free(model_arena *a, void *p) {
+    if (a == NULL) {
+        ziti_free(p);
+    }
+}
+
 static uint32_t key_hash0(const uint8_t *key, size_t key_len) {
     uint32_t h = 0;
     for (size_t idx = 0; idx < key_len; idx++) {
@@ -60,7 +149,9 @@ static void map_resize_table(model_map *m) {
     if (m->impl == NULL) { return; }
 
     int new_buckets = m->impl->buckets * 2;
-    void *new_table = realloc(m->impl->table, new_buckets * sizeof(entries_t));
+    void *new_table = m->impl->arena ?
+                      model_arena_alloc(m->impl->arena, new_buckets * sizeof(entries_t)) :
+                      ziti_realloc(m->impl->table, new_buckets * sizeof(entries_t));
 
     m->impl->buckets *= 2;
     m->impl->table = new_table;
@@ -97,6 +188,21 @@ size_t model_map_size(const model_map *m) {
     return m->impl ? m->impl->size : 0;
 }
 
+static void map_init(model_map *m, model_arena *arena) {
+    m->impl = coll_alloc(arena, sizeof(struct model_impl_s));
+    m->impl->arena = arena;
+    m->impl->buckets = DEFAULT_MAP_BUCKETS;
+    m->impl->table = coll_alloc(arena, m->impl->buckets * sizeof(entries_t));
+}
+
+int model_map_init_arena(model_map *m, model_arena *arena) {
+    if (m->impl != NULL) {
+        return -1;
+    }
+    map_init(m, arena);
+    return 0;
+}
+
 void *model_map_setl(model_map *m, long key, const void *val) {
     return model_map_set_key(m, &key, sizeof(key), val);
 }
@@ -109,9 +215,7 @@ void *model_map_set_key(model_map *m, const void *key, size_t key_len, const voi
     uint32_t kh = 0;
     struct model_map_entry *el = NULL;
     if (m->impl == NULL) {
-        m->impl = calloc(1, sizeof(struct model_impl_s));
-        m->impl->buckets = DEFAULT_MAP_BUCKETS;
-        m->impl->table = calloc(m->impl->buckets, sizeof(entries_t));
+        map_init(m, NULL);
         kh = key_hash0(key, key_len);
     } else {
         el = find_map_entry(m, key, key_len, &kh);
@@ -123,11 +227,12 @@ void *model_map_set_key(model_map *m, const void *key, size_t key_len, const voi
         return (void*)old_val;
     }
 
-    el = calloc(1, sizeof(*el));
+    model_arena *arena = m->impl->arena;
+    el = coll_alloc(arena, sizeof(*el));
     el->value = val;
     el->key_len = key_len;
     if (key_len > sizeof(el->key)) {
-        el->key = calloc(1, key_len + 1);
+        el->key = coll_alloc(arena, key_len + 1);
         memcpy(el->key, key, key_len);
     } else {
         memcpy(&el->key, key, key_len);
@@ -185,13 +290,13 @@ void *model_map_remove_key(model_map *m, const void *key, size_t key_len) {
         LIST_REMOVE(el, _next);
         LIST_REMOVE(el, _tnext);
         if (el->key_len > sizeof(el->key)) {
-            free(el->key);
+            coll_free(m->impl->arena, el->key);
         }
-        free(el);
+        coll_free(m->impl->arena, el);
         m->impl->size--;
     }
 
-    if (m->impl->size == 0) {
+    if (m->impl->size == 0 && m->impl->arena == NULL) {
         FREE(m->impl->table);
         FREE(m->impl);
     }
@@ -201,19 +306,21 @@ void *model_map_remove_key(model_map *m, const void *key, size_t key_len) {
 void model_map_clear(model_map *map, void (*val_free_func)(void *)) {
     if (map->impl == NULL) { return; }
 
+    model_arena *arena = map->impl->arena;
     struct model_map_entry *el;
     while ((el = LIST_FIRST(&map->impl->entries)) != NULL) {
         LIST_REMOVE(el, _next);
         if (el->key_len > sizeof(el->key)) {
-            FREE(el->key);
+            coll_free(arena, el->key);
         }
         if (val_free_func) {
             val_free_func((void*)el->value);
         }
-        FREE(el);
+        coll_free(arena, el);
     }
-    FREE(map->impl->table);
-    FREE(map->impl);
+    coll_free(arena, map->impl->table);
+    coll_free(arena, map->impl);
+    map->impl = NULL;
 }
 
 model_map_iter model_map_iterator(const model_map *m) {
@@ -256,18 +363,24 @@ model_map_iter model_map_it_remove(model_map_iter it) {
         model_map *m = e->_map;
         LIST_REMOVE(e, _next);
         LIST_REMOVE(e, _tnext);
-        if (e->key_len > sizeof(e->key)) {
-            free(e->key);
-        }
-        free(e);
 
         if (m->impl == NULL) {
+            if (e->key_len > sizeof(e->key)) {
+                ziti_free(e->key);
+            }
+            ziti_free(e);
             return NULL;
         }
 
+        model_arena *arena = m->impl->arena;
+        if (e->key_len > sizeof(e->key)) {
+            coll_free(arena, e->key);
+        }
+        coll_free(arena, e);
+
         m->impl->size--;
         // last element removed
-        if (m->impl->size == 0) {
+        if (m->impl->size == 0 && arena == NULL) {
             FREE(m->impl->table);
             FREE(m->impl);
         }
@@ -285,12 +398,27 @@ struct model_list_impl_s {
     size_t size;
     LIST_HEAD(, model_list_el) elements;
     struct model_list_el end;
+    model_arena *arena;
 };
 
 size_t model_list_size(const model_list *l) {
     return l->impl ? l->impl->size : 0;
 }
 
+static void list_init(model_list *l, model_arena *arena) {
+    l->impl = coll_alloc(arena, sizeof(*l->impl));
+    l->impl->arena = arena;
+    LIST_INSERT_HEAD(&l->impl->elements, &l->impl->end, _next);
+}
+
+int model_list_init_arena(model_list *l, model_arena *arena) {
+    if (l->impl != NULL) {
+        return -1;
+    }
+    list_init(l, arena);
+    return 0;
+}
+
 void *model_list_pop(model_list *l) {
     model_list_iter it = model_list_iterator(l);
     const void *el = model_list_it_element(it);
@@ -301,11 +429,10 @@ void *model_list_pop(model_list *l) {
 
 void model_list_push(model_list *l, const void *el) {
     if (l->impl == NULL) {
-        l->impl = calloc(1, sizeof(*l->impl));
-        LIST_INSERT_HEAD(&l->impl->elements, &l->impl->end, _next);
+        list_init(l, NULL);
     }
     l->impl->size++;
-    struct model_list_el *entry = calloc(1, sizeof(struct model_list_el));
+    struct model_list_el *entry = coll_alloc(l->impl->arena, sizeof(struct model_list_el));
     entry->el = el;
     entry->l = l;
     LIST_INSERT_HEAD(&l->impl->elements, entry, _next);
@@ -313,12 +440,11 @@ void model_list_push(model_list *l, const void *el) {
 
 void model_list_append(model_list *l, const void *el) {
     if (l->impl == NULL) {
-        l->impl = calloc(1, sizeof(*l->impl));
-        LIST_INSERT_HEAD(&l->impl->elements, &l->impl->end, _next);
+        list_init(l, NULL);
     }
 
     l->impl->size++;
-    struct model_list_el *entry = calloc(1, sizeof(struct model_list_el));
+    struct model_list_el *entry = coll_alloc(l->impl->arena, sizeof(struct model_list_el));
     entry->el = el;
     entry->l = l;
     LIST_INSERT_BEFORE(&l->impl->end, entry, _next);
@@ -368,12 +494,13 @@ model_list_iter model_list_it_remove(model_list_iter it) {
     model_list *list = entry->l;
 
     model_list_iter next = model_list_it_next(it);
+    model_arena *arena = list->impl->arena;
     list->impl->size--;
     LIST_REMOVE(entry, _next);
-    free(entry);
+    coll_free(arena, entry);
 
-    if (list->impl->size == 0) {
-        free(list->impl);
+    if (list->impl->size == 0 && arena == NULL) {
+        ziti_free(list->impl);
         list->impl = NULL;
     }
     return next;
@@ -12,9 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_model
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
 #include <json-c/json.h>
 
 #include <ziti/model_support.h>
@@ -32,101 +35,157 @@
 
 #endif
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JSON_SCAN_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JSON_SCAN_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define JSON_SCAN_NEON 1
+#endif
+
+#if _MSC_VER
+#include <intrin.h>
+static inline unsigned ctz32(unsigned v) { unsigned long i; _BitScanForward(&i, v); return (unsigned) i; }
+#else
+#define ctz32(v) ((unsigned) __builtin_ctz(v))
+#endif
+
+// set for the duration of model_parse_arena()/model_from_json_arena()
+static THREAD_LOCAL model_arena *parse_arena;
+
+static inline void *m_calloc(size_t count, size_t size) {
+    return parse_arena ? model_arena_alloc(parse_arena, count * size) : ziti_calloc(count, size);
+}
+
+static inline char *m_strdup(const char *s) {
+    return parse_arena ? model_arena_strdup(parse_arena, s) : ziti_strdup(s);
+}
+
+// custom parsers allocating on their own would leave heap memory behind when the arena is released
+static int meta_from_json(void *obj, json_object *j, const type_meta *meta) {
+    if (meta->from_json == NULL) {
+        return model_from_json(obj, j, meta);
+    }
+    if (parse_arena && !meta->arena_aware) {
+        ZITI_LOG(ERROR, "type[%s] cannot be parsed in arena mode", meta->name);
+        return -1;
+    }
+    return meta->from_json(obj, j, meta);
+}
+
+// strings (plain or interned) are stored by value in array, list and map slots
+static inline bool is_string_meta(const type_meta *m) {
+    return m == get_model_string_meta() || m == get_model_istring_meta();
+}
+
 #define null_checks(lh, rh) \
     if ((lh) == (rh)) { return 0; } \
     if ((lh) == NULL) { return -1; } \
     if ((rh) == NULL) { return 1; }
 
 // NOLINTNEXTLINE(misc-no-recursion)
-int model_cmp(const void *lh, const void *rh, const type_meta *meta) {
-    null_checks(lh, rh)
-
-    if (meta->comparer) {
-        return meta->comparer(lh, rh);
-    }
+int model_none_field_cmp(const void *lf, const void *rf, const type_meta *ftm) {
+    return ftm->comparer ? ftm->comparer(lf, rf) : model_cmp(lf, rf, ftm);
+}
 
-    int rc = 0;
-    for (int i = 0; rc == 0 && i < meta->field_count; i++) {
-        field_meta *fm = meta->fields + i;
-        const type_meta *ftm = fm->meta();
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_ptr_field_cmp(const void *lf, const void *rf, const type_meta *ftm) {
+    const void *lf_ptr = *(void * const *) lf;
+    const void *rf_ptr = *(void * const *) rf;
+    return ftm->comparer ? ftm->comparer(lf_ptr, rf_ptr) : model_cmp(lf_ptr, rf_ptr, ftm);
+}
 
-        void **lf_addr = (void **) ((char *) lh + fm->offset);
-        void **rf_addr = (void **) ((char *) rh + fm->offset);
-        const void *lf_ptr, *rf_ptr;
+int model_map_field_cmp(const void *lf, const void *rf, const type_meta *ftm) {
+    return model_map_compare(lf, rf, ftm);
+}
 
-        if (fm->mod == none_mod) {
-            lf_ptr = lf_addr;
-            rf_ptr = rf_addr;
-            rc = ftm->comparer ? ftm->comparer(lf_ptr, rf_ptr) : model_cmp(lf_ptr, rf_ptr, ftm);
-        }
-        else if (fm->mod == ptr_mod) {
-            lf_ptr = (void *) (*lf_addr);
-            rf_ptr = (void *) (*rf_addr);
-            rc = ftm->comparer ? ftm->comparer(lf_ptr, rf_ptr) : model_cmp(lf_ptr, rf_ptr, ftm);
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_list_field_cmp(const void *lf, const void *rf, const type_meta *ftm) {
+    int rc = 0;
+    const void *lf_ptr, *rf_ptr;
+    model_list_iter lit = model_list_iterator((model_list *) lf);
+    model_list_iter rit = model_list_iterator((model_list *) rf);
+
+    if (lit == NULL && rit != NULL) { return 1; }
+
+    while (rc == 0) {
+        lf_ptr = model_list_it_element(lit);
+        lit = model_list_it_next(lit);
+        rf_ptr = model_list_it_element(rit);
+        rit = model_list_it_next(rit);
+        if (rf_ptr == NULL && lf_ptr == NULL) { break; }
+
+        if (ftm->comparer) {
+            if (is_string_meta(ftm) ||
+                ftm == get_json_meta() ||
+                ftm == get_model_number_meta() ||
+                ftm == get_model_bool_meta()) {
+                rc = ftm->comparer(&lf_ptr, &rf_ptr);
+            } else {
+                rc = ftm->comparer(lf_ptr, rf_ptr);
+            }
+        } else {
+            rc = model_cmp(lf_ptr, rf_ptr, ftm);
         }
-        else if (fm->mod == map_mod) {
-            lf_ptr = lf_addr;
-            rf_ptr = rf_addr;
+    }
+    return rc;
+}
 
-            rc = model_map_compare(lf_ptr, rf_ptr, ftm);
-        } else if (fm->mod == list_mod) {
-            model_list *ll = (model_list *) (lf_addr);
-            model_list *rl = (model_list *) (rf_addr);
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_array_field_cmp(const void *lf, const void *rf, const type_meta *ftm) {
+    void **larr = *(void ** const *) lf;
+    void **rarr = *(void ** const *) rf;
 
-            model_list_iter lit = model_list_iterator(ll);
-            model_list_iter rit = model_list_iterator(rl);
+    null_checks(larr, rarr)
 
-            if (lit == NULL && rit != NULL) { rc = 1; }
-            else {
-                while (rc == 0) {
-                    lf_ptr = model_list_it_element(lit);
-                    lit = model_list_it_next(lit);
-                    rf_ptr = model_list_it_element(rit);
-                    rit = model_list_it_next(rit);
-                    if (rf_ptr == NULL && lf_ptr == NULL) { break; }
-
-                    if (ftm->comparer) {
-                        if (fm->meta() == get_model_string_meta() ||
-                            fm->meta() == get_json_meta() ||
-                            fm->meta() == get_model_number_meta() ||
-                            fm->meta() == get_model_bool_meta()) {
-                            rc = ftm->comparer(&lf_ptr, &rf_ptr);
-                        } else {
-                            rc = ftm->comparer(lf_ptr, rf_ptr);
-                        }
-                    } else {
-                        rc = model_cmp(lf_ptr, rf_ptr, ftm);
-                    }
-                }
+    int rc = 0;
+    for (int idx = 0; rc == 0; idx++) {
+        const void *lf_ptr = larr[idx];
+        const void *rf_ptr = rarr[idx];
+        if (rf_ptr == NULL && lf_ptr == NULL) { break; }
+
+        if (ftm->comparer) {
+            if (is_string_meta(ftm)) {
+                rc = ftm->comparer(&lf_ptr, &rf_ptr);
             }
-
-        } else if (fm->mod == array_mod) {
-            void **larr = (void **) (*lf_addr);
-            void **rarr = (void **) (*rf_addr);
-
-            if (larr == rarr) {}
-            else if (larr == NULL) { rc = -1; }
-            else if (rarr == NULL) { rc = 1; }
             else {
-                for (int idx = 0; rc == 0; idx++) {
-                    lf_ptr = larr[idx];
-                    rf_ptr = rarr[idx];
-                    if (rf_ptr == NULL && lf_ptr == NULL) { break; }
-
-                    if (ftm->comparer) {
-                        if (fm->meta() == get_model_string_meta()) {
-                            rc = ftm->comparer(&lf_ptr, &rf_ptr);
-                        }
-                        else {
-                            rc = ftm->comparer(lf_ptr, rf_ptr);
-                        }
-                    } else {
-                        rc = model_cmp(lf_ptr, rf_ptr, ftm);
-                    }
-                }
+                rc = ftm->comparer(lf_ptr, rf_ptr);
             }
+        } else {
+            rc = model_cmp(lf_ptr, rf_ptr, ftm);
         }
     }
+    return rc;
+}
+
+typedef int (*field_cmp_f)(const void *lf, const void *rf, const type_meta *ftm);
+static const field_cmp_f field_comparers[] = {
+        [none_mod] = model_none_field_cmp,
+        [ptr_mod] = model_ptr_field_cmp,
+        [array_mod] = model_array_field_cmp,
+        [map_mod] = model_map_field_cmp,
+        [list_mod] = model_list_field_cmp,
+};
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_cmp(const void *lh, const void *rh, const type_meta *meta) {
+    null_checks(lh, rh)
+
+    if (meta->comparer) {
+        return meta->comparer(lh, rh);
+    }
+
+    int rc = 0;
+    for (int i = 0; rc == 0 && i < meta->field_count; i++) {
+        field_meta *fm = meta->fields + i;
+        const void *lf_addr = (const char *) lh + fm->offset;
+        const void *rf_addr = (const char *) rh + fm->offset;
+
+        rc = field_comparers[fm->mod](lf_addr, rf_addr, fm->meta());
+    }
 
     return rc;
 }
@@ -145,7 +204,7 @@ int model_parse_list(model_list *list, const char *json, size_t len, const type_
     size_t end = json_tokener_get_parse_end(tok);
 
     int result = model_list_from_json(list, j, meta);
-    if (result < 0) {
+    if (result < 0 && parse_arena == NULL) {
         model_list_iter it = model_list_iterator(list);
         while (it != NULL) {
             void *el = (void *)model_list_it_element(it);
@@ -178,11 +237,14 @@ int model_parse_array(void ***arrp, const char *json, size_t len, const type_met
     res = (int)json_tokener_get_parse_end(tok);
     if (model_array_from_json(&arr, j, meta) != 0) {
         res = -1;
-        for (int i = 0; arr != NULL && arr[i] != NULL; i++) {
+        for (int i = 0; parse_arena == NULL && arr != NULL && arr[i] != NULL; i++) {
             model_free(arr[i], meta);
-            free(arr[i]);
+            ziti_free(arr[i]);
+        }
+        if (parse_arena == NULL) {
+            ziti_free(arr);
         }
-        FREE(arr);
+        arr = NULL;
     }
     *arrp = arr;
     json_tokener_free(tok);
@@ -205,7 +267,9 @@ int model_parse(void *obj, const char *json, size_t len, const type_meta *meta)
     } else {
         res = (int)json_tokener_get_parse_end(tok);
         if (model_from_json(obj, j, meta) == -1) {
-            model_free(obj, meta);
+            if (parse_arena == NULL) {
+                model_free(obj, meta);
+            }
             res = -1;
         }
     }
@@ -216,6 +280,44 @@ int model_parse(void *obj, const char *json, size_t len, const type_meta *meta)
     return res == 0 ? (int)end : res;
 }
 
+model_arena *model_arena_use(model_arena *arena) {
+    model_arena *prev = parse_arena;
+    parse_arena = arena;
+    return prev;
+}
+
+int model_parse_arena(void *obj, const char *json, size_t len, const type_meta *meta, model_arena *arena) {
+    model_arena *prev = parse_arena;
+    parse_arena = arena;
+    int rc = model_parse(obj, json, len, meta);
+    parse_arena = prev;
+    return rc;
+}
+
+int model_parse_array_arena(void ***arrp, const char *json, size_t len, const type_meta *meta, model_arena *arena) {
+    model_arena *prev = parse_arena;
+    parse_arena = arena;
+    int rc = model_parse_array(arrp, json, len, meta);
+    parse_arena = prev;
+    return rc;
+}
+
+int model_from_json_arena(void *obj, struct json_object *json, const type_meta *meta, model_arena *arena) {
+    model_arena *prev = parse_arena;
+    parse_arena = arena;
+    int rc = model_from_json(obj, json, meta);
+    parse_arena = prev;
+    return rc;
+}
+
+int model_array_from_json_arena(void ***arr, struct json_object *json, const type_meta *meta, model_arena *arena) {
+    model_arena *prev = parse_arena;
+    parse_arena = arena;
+    int rc = model_array_from_json(arr, json, meta);
+    parse_arena = prev;
+    return rc;
+}
+
 static int write_model_to_buf(const void *obj, const type_meta *meta, string_buf_t *buf, int indent, int flags);
 
 char *model_to_json(const void *obj, const type_meta *meta, int flags, size_t *len) {
@@ -293,133 +395,279 @@ int model_list_fmt_to_json(string_buf_t *buf, model_list *l, const type_meta *me
     return 0;
 }
 
-int write_model_to_buf(const void *obj, const type_meta *meta, string_buf_t *buf, int indent, int flags) {
-
+// NOLINTNEXTLINE(misc-no-recursion)
+static int write_value(const void *v, const type_meta *meta, string_buf_t *buf, int indent, int flags) {
     if (meta->jsonifier) {
-        return meta->jsonifier(obj, buf, indent, flags);
+        return meta->jsonifier(v, buf, indent, flags);
     }
+    return write_model_to_buf(v, meta, buf, indent, flags);
+}
 
-    BUF_APPEND_S(buf, "{");
-    bool comma = false;
-    for (int i = 0; i < meta->field_count; i++) {
-        field_meta *fm = meta->fields + i;
+static int write_field_name(const char *path, string_buf_t *buf, int indent, int flags, bool *comma) {
+    if (*comma) {
+        BUF_APPEND_S(buf, ",");
+    }
+    PRETTY_NL(buf);
 
-        if (fm->path == NULL || fm->path[0] == 0) {
-            continue;
-        }
-        const type_meta *ftm = fm->meta();
+    PRETTY_INDENT(buf, indent);
 
-        void **f_addr = (void **) ((char *) obj + fm->offset);
-        void *f_ptr = fm->mod == none_mod ? f_addr : (void *) (*f_addr);
+    BUF_APPEND_B(buf, '\"');
+    BUF_APPEND_S(buf, path);
+    BUF_APPEND_S(buf, "\":");
+    *comma = true;
+    return 0;
+}
 
-        if (ftm == get_model_string_meta() || ftm == get_json_meta()) {
-            f_ptr = (void *) (*f_addr);
-        }
+int model_obj_json_begin(void *buf) {
+    return string_buf_append_byte(buf, '{');
+}
 
-        if (f_ptr == NULL) {
-            continue;
-        }
+int model_obj_json_end(void *bufp, int indent, int flags) {
+    string_buf_t *buf = bufp;
+    PRETTY_NL(buf);
+    PRETTY_INDENT(buf, indent - 1);
+    BUF_APPEND_B(buf, '}');
+    return 0;
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_none_field_to_json(const char *path, const void *f_addr, const type_meta *ftm,
+                             void *buf, int indent, int flags, bool *comma) {
+    const void *f_ptr = f_addr;
+    if (is_string_meta(ftm) || ftm == get_json_meta()) {
+        f_ptr = *(void * const *) f_addr;
+        if (f_ptr == NULL) { return 0; }
+    }
+
+    CHECK_APPEND(write_field_name(path, buf, indent, flags, comma));
+    return write_value(f_ptr, ftm, buf, indent + 1, flags);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_ptr_field_to_json(const char *path, const void *f_addr, const type_meta *ftm,
+                            void *buf, int indent, int flags, bool *comma) {
+    const void *f_ptr = *(void * const *) f_addr;
+    if (f_ptr == NULL) { return 0; }
 
-        if (comma) {
-            BUF_APPEND_S(buf, ",");
+    CHECK_APPEND(write_field_name(path, buf, indent, flags, comma));
+    return write_value(f_ptr, ftm, buf, indent + 1, flags);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_map_field_to_json(const char *path, const void *f_addr, const type_meta *ftm,
+                            void *buf, int indent, int flags, bool *comma) {
+    if (*(void * const *) f_addr == NULL) { return 0; }
+
+    CHECK_APPEND(write_field_name(path, buf, indent, flags, comma));
+
+    indent++;
+    model_map *map = (model_map *) f_addr;
+    const char *k;
+    void *v;
+    BUF_APPEND_B(buf, '{');
+    bool need_comma = false;
+    MODEL_MAP_FOREACH(k, v, map) {
+        if (need_comma) {
+            BUF_APPEND_B(buf, ',');
         }
         PRETTY_NL(buf);
-
         PRETTY_INDENT(buf, indent);
 
         BUF_APPEND_B(buf, '\"');
-        BUF_APPEND_S(buf, fm->path);
+        BUF_APPEND_S(buf, k);
         BUF_APPEND_S(buf, "\":");
+        CHECK_APPEND(write_value(v, ftm, buf, indent + 1, flags));
+        need_comma = true;
+    }
+    BUF_APPEND_B(buf, '}');
+    return 0;
+}
 
-        if (fm->mod == none_mod || fm->mod == ptr_mod) {
-            if (ftm->jsonifier) {
-                CHECK_APPEND(ftm->jsonifier(f_ptr, buf, indent + 1, flags));
-            }
-            else {
-                CHECK_APPEND(write_model_to_buf(f_ptr, ftm, buf, indent + 1, flags));
-            }
-        }
-        else if (fm->mod == map_mod) {
-            indent++;
-            model_map *map = (model_map *) f_addr;
-            const char *k;
-            void *v;
-            BUF_APPEND_B(buf, '{');
-            bool need_comma = false;
-            MODEL_MAP_FOREACH(k, v, map) {
-                if (need_comma) {
-                    BUF_APPEND_B(buf, ',');
-                }
-                PRETTY_NL(buf);
-                PRETTY_INDENT(buf, indent);
-
-                BUF_APPEND_B(buf, '\"');
-                BUF_APPEND_S(buf, k);
-                BUF_APPEND_S(buf, "\":");
-                if (ftm->jsonifier) {
-                    CHECK_APPEND(ftm->jsonifier(v, buf, indent + 1, flags));
-                } else {
-                    CHECK_APPEND(write_model_to_buf(v, ftm, buf, indent + 1, flags));
-                }
-                need_comma = true;
-            }
-            BUF_APPEND_B(buf, '}');
-            indent--;
-        } else if (fm->mod == list_mod) {
-            model_list *list = (model_list *) (f_addr);
-            CHECK_APPEND(model_list_fmt_to_json(buf, list, ftm, flags, indent));
-        } else if (fm->mod == array_mod) {
-            void **arr = (void **) (*f_addr);
-
-            BUF_APPEND_B(buf, '[');
-            PRETTY_NL(buf);
-            for (int idx = 0; true; idx++) {
-                f_ptr = arr[idx];
-                if (f_ptr == NULL) { break; }
-                if (idx > 0) {
-                    BUF_APPEND_B(buf, ',');
-                    PRETTY_NL(buf);
-                }
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_list_field_to_json(const char *path, const void *f_addr, const type_meta *ftm,
+                             void *buf, int indent, int flags, bool *comma) {
+    if (*(void * const *) f_addr == NULL) { return 0; }
 
-                PRETTY_INDENT(buf, indent + 1);
-                if (ftm->jsonifier) {
-                    CHECK_APPEND(ftm->jsonifier(f_ptr, buf, indent + 1, flags));
-                }
-                else {
-                    CHECK_APPEND(write_model_to_buf(f_ptr, ftm, buf, indent + 1, flags));
-                }
-            }
+    CHECK_APPEND(write_field_name(path, buf, indent, flags, comma));
+    return model_list_fmt_to_json(buf, (model_list *) f_addr, ftm, flags, indent);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_array_field_to_json(const char *path, const void *f_addr, const type_meta *ftm,
+                              void *buf, int indent, int flags, bool *comma) {
+    void **arr = *(void ** const *) f_addr;
+    if (arr == NULL) { return 0; }
+
+    CHECK_APPEND(write_field_name(path, buf, indent, flags, comma));
+
+    BUF_APPEND_B(buf, '[');
+    PRETTY_NL(buf);
+    for (int idx = 0; arr[idx] != NULL; idx++) {
+        if (idx > 0) {
+            BUF_APPEND_B(buf, ',');
             PRETTY_NL(buf);
-            PRETTY_INDENT(buf, indent);
-            BUF_APPEND_B(buf, ']');
-        } else {
-            ZITI_LOG(ERROR, "unsupported mod[%d] for field[%s]", fm->mod, fm->name);
-            return -1;
         }
-        comma = true;
+
+        PRETTY_INDENT(buf, indent + 1);
+        CHECK_APPEND(write_value(arr[idx], ftm, buf, indent + 1, flags));
     }
     PRETTY_NL(buf);
-    PRETTY_INDENT(buf, indent - 1);
-    BUF_APPEND_B(buf, '}');
+    PRETTY_INDENT(buf, indent);
+    BUF_APPEND_B(buf, ']');
     return 0;
 }
 
+typedef int (*field_to_json_f)(const char *path, const void *f_addr, const type_meta *ftm,
+                               void *buf, int indent, int flags, bool *comma);
+static const field_to_json_f field_writers[] = {
+        [none_mod] = model_none_field_to_json,
+        [ptr_mod] = model_ptr_field_to_json,
+        [array_mod] = model_array_field_to_json,
+        [map_mod] = model_map_field_to_json,
+        [list_mod] = model_list_field_to_json,
+};
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int write_model_to_buf(const void *obj, const type_meta *meta, string_buf_t *buf, int indent, int flags) {
+
+    if (meta->jsonifier) {
+        return meta->jsonifier(obj, buf, indent, flags);
+    }
+
+    CHECK_APPEND(model_obj_json_begin(buf));
+    bool comma = false;
+    for (int i = 0; i < meta->field_count; i++) {
+        field_meta *fm = meta->fields + i;
+
+        if (fm->path == NULL || fm->path[0] == 0) {
+            continue;
+        }
+
+        if ((unsigned) fm->mod >= sizeof(field_writers) / sizeof(field_writers[0])) {
+            ZITI_LOG(ERROR, "unsupported mod[%d] for field[%s]", fm->mod, fm->name);
+            return -1;
+        }
+
+        const void *f_addr = (const char *) obj + fm->offset;
+        CHECK_APPEND(field_writers[fm->mod](fm->path, f_addr, fm->meta(), buf, indent, flags, &comma));
+    }
+    return model_obj_json_end(buf, indent, flags);
+}
+
 void model_free_array(void ***ap, const type_meta *meta) {
     if (ap == NULL || *ap == NULL) { return; }
 
     void **el = *ap;
     while (*el != NULL) {
         model_free(*el, meta);
-        free(*el);
+        ziti_free(*el);
         el++;
     }
     FREE(*ap);
 }
 
 void* model_alloc(const type_meta *meta) {
-    return calloc(1, meta->size);
+    return ziti_calloc(1, meta->size);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void model_none_field_free(void *f_addr, const type_meta *ftm) {
+    model_free(f_addr, ftm);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void model_ptr_field_free(void *f_addr, const type_meta *ftm) {
+    void *f_ptr = *(void **) f_addr;
+    *(void **) f_addr = NULL;
+    if (f_ptr != NULL) {
+        model_free(f_ptr, ftm);
+        ziti_free(f_ptr);
+    }
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void model_array_field_free(void *f_addr, const type_meta *ftm) {
+    void **arr = *(void ***) f_addr;
+    *(void ***) f_addr = NULL;
+    if (arr == NULL) { return; }
+
+    for (int idx = 0; arr[idx] != NULL; idx++) {
+        if (is_string_meta(ftm)) {
+            model_free(arr + idx, ftm);
+        }
+        else {
+            model_free(arr[idx], ftm);
+            ziti_free(arr[idx]);
+        }
+    }
+    ziti_free(arr);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void model_list_field_free(void *f_addr, const type_meta *ftm) {
+    model_list *list = (model_list *) f_addr;
+    model_list_iter it = model_list_iterator(list);
+    bool str_type = (is_string_meta(ftm) || ftm == get_json_meta());
+    // numbers and bools are stored in the list slots directly
+    bool val_type = (ftm == get_model_number_meta() || ftm == get_model_bool_meta());
+    while (it != NULL) {
+        void *el = (void*)model_list_it_element(it);
+        it = model_list_it_remove(it);
+        if (str_type) {
+            ftm->destroyer(&el);
+        }
+        else if (!val_type) {
+            if (ftm->destroyer) {
+                ftm->destroyer(el);
+            } else {
+                model_free(el, ftm);
+            }
+            ziti_free(el);
+        }
+    }
+    model_list_clear(list, NULL);
 }
 
+// NOLINTNEXTLINE(misc-no-recursion)
+void model_map_field_free(void *f_addr, const type_meta *ftm) {
+    model_map *map = (model_map *) f_addr;
+    _free_f ff = NULL;
+    model_map_iter it = model_map_iterator(map);
+    while (it != NULL) {
+        void *v = model_map_it_value(it);
+        if (is_string_meta(ftm) || ftm == get_json_meta()) {
+            ftm->destroyer(&v);
+        }
+        else if (ftm->destroyer) {
+            ftm->destroyer(v);
+        }
+        else {
+            model_free(v, ftm);
+        }
+        ziti_free(v);
+
+        it = model_map_it_remove(it);
+    }
+
+    if (ftm == get_model_string_meta()) {
+        ff = ziti_free;
+    }
+    else {
+        ff = ftm->destroyer;
+    }
+    model_map_clear(map, ff);
+}
+
+typedef void (*field_free_f)(void *f_addr, const type_meta *ftm);
+static const field_free_f field_destroyers[] = {
+        [none_mod] = model_none_field_free,
+        [ptr_mod] = model_ptr_field_free,
+        [array_mod] = model_array_field_free,
+        [map_mod] = model_map_field_free,
+        [list_mod] = model_list_field_free,
+};
+
+// NOLINTNEXTLINE(misc-no-recursion)
 void model_free(void *obj, const type_meta *meta) {
     if (obj == NULL) { return; }
 
@@ -430,85 +678,7 @@ void model_free(void *obj, const type_meta *meta) {
 
     for (int i = 0; i < meta->field_count; i++) {
         field_meta *fm = &meta->fields[i];
-        void **f_addr = (void **) ((char *) obj + fm->offset);
-        void *f_ptr = NULL;
-        const type_meta *field_meta = fm->meta();
-        if (fm->mod == none_mod) {
-            f_ptr = f_addr;
-            model_free(f_ptr, field_meta);
-        }
-        else if (fm->mod == ptr_mod) {
-            f_ptr = (void *) (*f_addr);
-            *f_addr = NULL;
-            if (f_ptr != NULL) {
-                model_free(f_ptr, field_meta);
-                free(f_ptr);
-            }
-        }
-        else if (fm->mod == array_mod) {
-            void **arr = (void **) (*f_addr);
-            *f_addr = NULL;
-            if (arr != NULL) {
-                for (int idx = 0; arr[idx] != NULL; idx++) {
-                    f_ptr = arr + idx;
-                    if (field_meta == get_model_string_meta()) {
-                        model_free(f_ptr, field_meta);
-                    }
-                    else {
-                        void *mem_ptr = (void *) (*(void **) f_ptr);
-                        model_free(mem_ptr, field_meta);
-                        free(mem_ptr);
-                    }
-                }
-                free(arr);
-            }
-        } else if (fm->mod == list_mod) {
-            model_list *list = (model_list *) f_addr;
-            model_list_iter it = model_list_iterator(list);
-            bool str_type = (field_meta == get_model_string_meta() || field_meta == get_json_meta());
-            while (it != NULL) {
-                void *el = (void*)model_list_it_element(it);
-                it = model_list_it_remove(it);
-                if (str_type) {
-                    field_meta->destroyer(&el);
-                }
-                else if (field_meta->destroyer) {
-                    field_meta->destroyer(el);
-                }
-                else {
-                    model_free(el, field_meta);
-                    free(el);
-                }
-            }
-            model_list_clear(list, NULL);
-        } else if (fm->mod == map_mod) {
-            model_map *map = (model_map *) f_addr;
-            _free_f ff = NULL;
-            model_map_iter it = model_map_iterator(map);
-            while (it != NULL) {
-                void *v = model_map_it_value(it);
-                if (field_meta == get_model_string_meta() || field_meta == get_json_meta()) {
-                    field_meta->destroyer(&v);
-                }
-                else if (field_meta->destroyer) {
-                    field_meta->destroyer(v);
-                }
-                else {
-                    model_free(v, field_meta);
-                }
-                free(v);
-
-                it = model_map_it_remove(it);
-            }
-
-            if (field_meta == get_model_string_meta()) {
-                ff = free;
-            }
-            else {
-                ff = field_meta->destroyer;
-            }
-            model_map_clear(map, ff);
-        }
+        field_destroyers[fm->mod]((char *) obj + fm->offset, fm->meta());
     }
 }
 
@@ -519,33 +689,28 @@ int model_array_from_json(void ***arr, json_object *json, const type_meta *el_me
         return -1;
     }
     size_t children = json_object_array_length(json);
-    void **elems = calloc(children + 1, sizeof(void *));
+    void **elems = m_calloc(children + 1, sizeof(void *));
     int idx;
     int rc = 0;
     for (idx = 0; idx < children; idx++) {
         json_object *ch = json_object_array_get_idx(json, idx);
         void *el;
-        if (el_meta != get_model_string_meta()) {
-            el = calloc(1, el_meta->size);
+        if (!is_string_meta(el_meta)) {
+            el = m_calloc(1, el_meta->size);
             elems[idx] = el;
         } else {
             el = &elems[idx];
         }
-        if (el_meta->from_json != NULL) {
-            rc = el_meta->from_json(el, ch, el_meta);
-        } else {
-            rc = model_from_json(el, ch, el_meta);
-        }
+        rc = meta_from_json(el, ch, el_meta);
         if (rc < 0) {
             break;
         }
     }
     if (rc != 0) {
-        for (int i = 0; elems[i] != NULL; i++) {
-            model_free(elems[i], el_meta);
-            free(elems[i]);
+        if (parse_arena == NULL) {
+            model_array_field_free(&elems, el_meta);
         }
-        FREE(elems);
+        elems = NULL;
     }
     *arr = elems;
     return rc;
@@ -559,19 +724,25 @@ int model_list_from_json (model_list *list, json_object *json, const type_meta *
     size_t children = json_object_array_length(json);
     int idx;
     int rc = 0;
+    if (parse_arena) {
+        model_list_init_arena(list, parse_arena);
+    }
     for (idx = 0; idx < children; idx++) {
         json_object *ch = json_object_array_get_idx(json, idx);
         void *value = NULL;
-        if (el_meta == get_model_string_meta() ||
+        if (is_string_meta(el_meta) ||
             el_meta == get_json_meta() ||
             el_meta == get_model_number_meta() ||
             el_meta == get_model_bool_meta()) {
-            rc = el_meta->from_json(&value, ch, el_meta);
+            rc = meta_from_json(&value, ch, el_meta);
         } else {
-            value = calloc(1, el_meta->size);
-            rc = el_meta->from_json ?
-                 el_meta->from_json(value, ch, el_meta) :
-                 model_from_json(value, ch, el_meta);
+            value = m_calloc(1, el_meta->size);
+            rc = meta_from_json(value, ch, el_meta);
+            if (rc < 0 && parse_arena == NULL) {
+                // partially parsed element is not in the list yet
+                model_free(value, el_meta);
+                ziti_free(value);
+            }
         }
         if (rc < 0) {
             break;
@@ -579,41 +750,36 @@ int model_list_from_json (model_list *list, json_object *json, const type_meta *
         model_list_append(list, value);
     }
 
-    if (rc != 0) {
-        model_list_iter it = model_list_iterator(list);
-        while (it) {
-            void* val = (void*)model_list_it_element(it);
-            model_free(val, el_meta);
-            free(val);
-            it = model_list_it_remove(it);
-        }
+    if (rc != 0 && parse_arena == NULL) {
+        model_list_field_free(list, el_meta);
     }
     return rc;
 }
 
-static int parse_map_from_json(void *mapp, json_object *json, type_meta *el_meta) {
+static int parse_map_from_json(void *mapp, json_object *json, const type_meta *el_meta) {
     if (json_object_get_type(json) != json_type_object) {
         ZITI_LOG(ERROR, "unexpected token: object as expected, received %d", json_object_get_type(json));
         return -1;
     }
     model_map *map = mapp;
+    if (parse_arena) {
+        model_map_init_arena(map, parse_arena);
+    }
     json_object_object_foreach(json, key, child) {
         void *value = NULL;
         int rc;
-        if (el_meta == get_model_string_meta()) {
-            rc = get_model_string_meta()->from_json(&value, child, el_meta);
-        }
-        else if (el_meta == get_json_meta()) {
-            rc = get_json_meta()->from_json(&value, child, el_meta);
+        if (is_string_meta(el_meta) || el_meta == get_json_meta()) {
+            rc = meta_from_json(&value, child, el_meta);
         }
         else {
-            value = calloc(1, el_meta->size);
-            rc = el_meta->from_json ?
-                 el_meta->from_json(value, child, el_meta) :
-                 model_from_json(value, child, el_meta);
+            value = m_calloc(1, el_meta->size);
+            rc = meta_from_json(value, child, el_meta);
+            if (rc < 0 && parse_arena == NULL) {
+                model_free(value, el_meta);
+                FREE(value);
+            }
         }
         if (rc < 0) {
-            FREE(value);
             return rc;
         }
         model_map_set(map, key, value);
@@ -621,11 +787,62 @@ static int parse_map_from_json(void *mapp, json_object *json, type_meta *el_meta
     return 0;
 }
 
+static inline bool json_value_missing(const json_object *j) {
+    return j == NULL || json_object_get_type(j) == json_type_null;
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_none_field_from_json(void *field, json_object *child, const type_meta *ftm) {
+    if (json_value_missing(child)) { return 0; }
+
+    return meta_from_json(field, child, ftm);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_ptr_field_from_json(void *field, json_object *child, const type_meta *ftm) {
+    if (json_value_missing(child)) { return 0; }
+
+    void *ch_obj = m_calloc(1, ftm->size);
+    *(void **) field = ch_obj;
+    return meta_from_json(ch_obj, child, ftm);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_array_field_from_json(void *field, json_object *child, const type_meta *ftm) {
+    if (json_value_missing(child)) { return 0; }
+
+    return model_array_from_json(field, child, ftm);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_map_field_from_json(void *field, json_object *child, const type_meta *ftm) {
+    if (json_value_missing(child)) { return 0; }
+
+    return parse_map_from_json(field, child, ftm);
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+int model_list_field_from_json(void *field, json_object *child, const type_meta *ftm) {
+    if (json_value_missing(child)) { return 0; }
+
+    return model_list_from_json(field, child, ftm);
+}
+
+typedef int (*field_from_json_f)(void *field, json_object *child, const type_meta *ftm);
+static const field_from_json_f field_parsers[] = {
+        [none_mod] = model_none_field_from_json,
+        [ptr_mod] = model_ptr_field_from_json,
+        [array_mod] = model_array_field_from_json,
+        [map_mod] = model_map_field_from_json,
+        [list_mod] = model_list_field_from_json,
+};
+
+// NOLINTNEXTLINE(misc-no-recursion)
 int model_from_json(void *obj, json_object *json, const type_meta *meta) {
     int rc = 0;
     memset(obj, 0, meta->size);
     if (meta->from_json) {
-        rc = meta->from_json(obj, json, meta);
+        rc = meta_from_json(obj, json, meta);
         goto done;
     }
 
@@ -641,42 +858,15 @@ int model_from_json(void *obj, json_object *json, const type_meta *meta) {
             continue;
 
         json_object *child = json_object_object_get(json, fm->path);
-        if (child == NULL || json_object_get_type(child) == json_type_null)
-            continue;
-
         void *field = (char *) obj + fm->offset;
-        void *ch_obj = field;
-        const type_meta *ch_meta = fm->meta();
-        from_json_func parser = ch_meta->from_json;
-        if (parser == NULL) {
-            parser = model_from_json;
-        }
-        
-        switch (fm->mod) {
-            case none_mod:
-                break;
-            case ptr_mod:
-                ch_obj = calloc(1, ch_meta->size);
-                *(char**)field = ch_obj;
-                break;
-            case array_mod:
-                parser = (from_json_func) model_array_from_json;
-                break;
-            case map_mod:
-                parser = (from_json_func) parse_map_from_json;
-                break;
-            case list_mod:
-                parser = (from_json_func) model_list_from_json;
-                break;
-        }
-        rc = parser(ch_obj, child, ch_meta);
+        rc = field_parsers[fm->mod](field, child, fm->meta());
         if (rc != 0) {
             break;
         }
     }
 
     done:
-    if (rc != 0) {
+    if (rc != 0 && parse_arena == NULL) {
         model_free(obj, meta);
     }
     return rc;
@@ -713,7 +903,7 @@ static json_object* bool_to_json(const bool *val) {
 }
 
 static int json_from_json(model_string *val, json_object *j, type_meta * UNUSED(meta)) {
-    *val = strdup(json_object_to_json_string(j));
+    *val = m_strdup(json_object_to_json_string(j));
     return 0;
 }
 
@@ -723,7 +913,98 @@ static json_object* json_to_json(model_string val) {
 
 static int string_from_json (model_string *str, json_object *j, const type_meta * UNUSED(meta)) {
     if (json_object_get_type(j) == json_type_string) {
-        *str = strdup(json_object_get_string(j));
+        *str = m_strdup(json_object_get_string(j));
+        return 0;
+    }
+    return -1;
+}
+
+struct istring_s {
+    model_string_pool *pool;
+    atomic_size_t refs;
+    char str[];
+};
+
+struct model_string_pool_s {
+    model_map strings; // string -> struct istring_s
+};
+
+#define istring_entry(s) ((struct istring_s *) ((s) - offsetof(struct istring_s, str)))
+
+// set with model_string_pool_use(), interns model_istring values during parsing
+static THREAD_LOCAL model_string_pool *parse_pool;
+
+model_string_pool *model_string_pool_new(void) {
+    model_string_pool *pool = ziti_calloc(1, sizeof(*pool));
+    return pool;
+}
+
+void model_string_pool_free(model_string_pool *pool) {
+    if (pool == NULL) { return; }
+
+    // strings still referenced by model objects outlive the pool
+    model_map_iter it = model_map_iterator(&pool->strings);
+    while (it != NULL) {
+        struct istring_s *e = model_map_it_value(it);
+        e->pool = NULL;
+        it = model_map_it_remove(it);
+    }
+    ziti_free(pool);
+}
+
+size_t model_string_pool_size(const model_string_pool *pool) {
+    return pool ? model_map_size(&pool->strings) : 0;
+}
+
+model_string_pool *model_string_pool_use(model_string_pool *pool) {
+    model_string_pool *prev = parse_pool;
+    parse_pool = pool;
+    return prev;
+}
+
+model_istring model_intern(model_string_pool *pool, const char *str) {
+    if (str == NULL) { return NULL; }
+
+    struct istring_s *e = pool ? model_map_get(&pool->strings, str) : NULL;
+    if (e != NULL) {
+        atomic_fetch_add_explicit(&e->refs, 1, memory_order_relaxed);
+        return e->str;
+    }
+
+    size_t len = strlen(str);
+    e = ziti_malloc(sizeof(*e) + len + 1);
+    e->pool = pool;
+    atomic_init(&e->refs, 1);
+    memcpy(e->str, str, len + 1);
+    if (pool) {
+        model_map_set(&pool->strings, e->str, e);
+    }
+    return e->str;
+}
+
+model_istring model_istring_ref(model_istring s) {
+    if (s != NULL) {
+        atomic_fetch_add_explicit(&istring_entry(s)->refs, 1, memory_order_relaxed);
+    }
+    return s;
+}
+
+void model_istring_release(model_istring s) {
+    if (s == NULL) { return; }
+
+    struct istring_s *e = istring_entry(s);
+    if (atomic_fetch_sub_explicit(&e->refs, 1, memory_order_acq_rel) > 1) { return; }
+
+    if (e->pool) {
+        model_map_remove(&e->pool->strings, e->str);
+    }
+    ziti_free(e);
+}
+
+static int istring_from_json(model_istring *str, json_object *j, const type_meta * UNUSED(meta)) {
+    if (json_object_get_type(j) == json_type_string) {
+        const char *s = json_object_get_string(j);
+        *str = parse_arena ? model_arena_strdup(parse_arena, s) : model_intern(parse_pool, s);
         return 0;
     }
     return -1;
@@ -837,14 +1118,100 @@ static int m_bool_to_json(const bool *v, string_buf_t *buf, int UNUSED(indent),
     return string_buf_append(buf, *v ? "true" : "false");
 }
 
+static const char digit_pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+// formats `v` into the tail of `out[21]`, returns pointer to the first char
+static char *fmt_int64(char out[21], int64_t v) {
+    char *p = out + 21;
+    uint64_t u = v < 0 ? 0 - (uint64_t) v : (uint64_t) v;
+    while (u >= 100) {
+        unsigned idx = (unsigned) (u % 100) * 2;
+        u /= 100;
+        *--p = digit_pairs[idx + 1];
+        *--p = digit_pairs[idx];
+    }
+    if (u < 10) {
+        *--p = (char) ('0' + u);
+    } else {
+        unsigned idx = (unsigned) u * 2;
+        *--p = digit_pairs[idx + 1];
+        *--p = digit_pairs[idx];
+    }
+    if (v < 0) {
+        *--p = '-';
+    }
+    return p;
+}
+
 static int m_int_to_json(const model_number *v, string_buf_t *buf, int UNUSED(indent), int UNUSED(flags)) {
+    char b[21];
+    char *num = fmt_int64(b, *v);
+    return string_buf_appendn(buf, num, b + sizeof(b) - num);
+}
 
-    char b[16];
-    int rc = snprintf(b, sizeof(b), "%" PRId64, *v);
-    if (rc > 0) {
-        return string_buf_append(buf, b);
+/**
+ * returns length of the leading run of `s` that does not need escaping in a JSON string
+ * (control characters, '"' and '\\')
+ */
+static size_t json_clean_run(const unsigned char *s, size_t len) {
+    size_t i = 0;
+#if JSON_SCAN_AVX2
+    const __m256i ctl = _mm256_set1_epi8(0x1f);
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i bslash = _mm256_set1_epi8('\\');
+    for (; i + 32 <= len; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i *) (s + i));
+        __m256i m = _mm256_or_si256(
+                _mm256_cmpeq_epi8(_mm256_max_epu8(c, ctl), ctl),
+                _mm256_or_si256(_mm256_cmpeq_epi8(c, quote), _mm256_cmpeq_epi8(c, bslash)));
+        unsigned mask = (unsigned) _mm256_movemask_epi8(m);
+        if (mask != 0) {
+            return i + ctz32(mask);
+        }
     }
-    return rc;
+#elif JSON_SCAN_SSE2
+    const __m128i ctl = _mm_set1_epi8(0x1f);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i bslash = _mm_set1_epi8('\\');
+    for (; i + 16 <= len; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *) (s + i));
+        __m128i m = _mm_or_si128(
+                _mm_cmpeq_epi8(_mm_max_epu8(c, ctl), ctl),
+                _mm_or_si128(_mm_cmpeq_epi8(c, quote), _mm_cmpeq_epi8(c, bslash)));
+        unsigned mask = (unsigned) _mm_movemask_epi8(m);
+        if (mask != 0) {
+            return i + ctz32(mask);
+        }
+    }
+#elif JSON_SCAN_NEON
+    const uint8x16_t space = vdupq_n_u8(' ');
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t bslash = vdupq_n_u8('\\');
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t c = vld1q_u8(s + i);
+        uint8x16_t m = vorrq_u8(vcltq_u8(c, space),
+                                vorrq_u8(vceqq_u8(c, quote), vceqq_u8(c, bslash)));
+        if (vmaxvq_u8(m) != 0) {
+            break; // locate it with the scalar loop
+        }
+    }
+#endif
+    for (; i < len; i++) {
+        if (s[i] < ' ' || s[i] == '"' || s[i] == '\\') {
+            break;
+        }
+    }
+    return i;
 }
 
 static int m_string_to_json(const char *str, string_buf_t *buf, int UNUSED(indent), int UNUSED(flags)) {
@@ -852,8 +1219,19 @@ static int m_string_to_json(const char *str, string_buf_t *buf, int UNUSED(inden
 
     BUF_APPEND_B(buf, '\"');
     const unsigned char *s = (const unsigned char *) str;
+    const unsigned char *end = s + strlen(str);
+
+    while (s < end) {
+        // bulk copy characters that don't need escaping
+        size_t run = json_clean_run(s, end - s);
+        if (run > 0) {
+            CHECK_APPEND(string_buf_appendn(buf, (const char *) s, run));
+            s += run;
+            if (s == end) {
+                break;
+            }
+        }
 
-    while (*s != '\0') {
         switch (*s) {
             case '\n':
                 BUF_APPEND_S(buf, "\\n");
@@ -874,14 +1252,10 @@ static int m_string_to_json(const char *str, string_buf_t *buf, int UNUSED(inden
                 BUF_APPEND_S(buf, "\\\"");
                 break;
             default:
-                if (*s < ' ') {
-                    BUF_APPEND_B(buf, '\\');
-                    BUF_APPEND_S(buf, "u00");
-                    BUF_APPEND_B(buf, hex[*s >> 4]);
-                    BUF_APPEND_B(buf, hex[*s & 0xF]);
-                } else {
-                    BUF_APPEND_B(buf, *s);
-                }
+                BUF_APPEND_B(buf, '\\');
+                BUF_APPEND_S(buf, "u00");
+                BUF_APPEND_B(buf, hex[*s >> 4]);
+                BUF_APPEND_B(buf, hex[*s & 0xF]);
         }
         s++;
     }
@@ -947,11 +1321,16 @@ static void m_free_noop(void *UNUSED(v)) {}
 
 static void m_free_string(char **s) {
     if (*s != NULL) {
-        free(*s);
+        ziti_free(*s);
         *s = NULL;
     }
 }
 
+static void m_free_istring(char **s) {
+    model_istring_release(*s);
+    *s = NULL;
+}
+
 static void m_free_tag(tag *t) {
     if (t != NULL) {
         if (t->type == tag_string) {
@@ -1010,7 +1389,7 @@ int model_map_compare(const model_map *lh, const model_map *rh, const type_meta
                 rc = 1;
             }
             else {
-                if (m == get_model_string_meta() || m == get_json_meta()) {
+                if (is_string_meta(m) || m == get_json_meta()) {
                     rc = m->comparer(&lhv, &rhv);
                 }
                 else {
@@ -1033,6 +1412,7 @@ static type_meta bool_META = {
         .destroyer = m_free_noop,
         .from_json = (from_json_func) bool_from_json,
         .to_json = (to_json_func) bool_to_json,
+        .arena_aware = true,
 };
 
 static type_meta int_META = {
@@ -1043,6 +1423,7 @@ static type_meta int_META = {
         .destroyer = m_free_noop,
         .from_json = (from_json_func) int_from_json,
         .to_json = (to_json_func) int_to_json,
+        .arena_aware = true,
 };
 
 static type_meta string_META = {
@@ -1053,6 +1434,18 @@ static type_meta string_META = {
         .destroyer = (_free_f) m_free_string,
         .from_json = (from_json_func) string_from_json,
         .to_json = (to_json_func) string_to_json,
+        .arena_aware = true,
+};
+
+static type_meta istring_META = {
+        .name = "istring",
+        .size = sizeof(char *),
+        .comparer = (_cmp_f) m_cmp_string, // equal interned strings are matched by pointer
+        .jsonifier = (_to_json_f) m_string_to_json,
+        .destroyer = (_free_f) m_free_istring,
+        .from_json = (from_json_func) istring_from_json,
+        .to_json = (to_json_func) string_to_json,
+        .arena_aware = true,
 };
 
 static type_meta timestamp_META = {
@@ -1063,6 +1456,7 @@ static type_meta timestamp_META = {
         .destroyer = (_free_f) m_free_noop,
         .from_json = (from_json_func) timeval_from_json,
         .to_json = (to_json_func) timeval_to_json,
+        .arena_aware = true,
 };
 
 static type_meta json_META = {
@@ -1073,6 +1467,7 @@ static type_meta json_META = {
         .destroyer = (_free_f) m_free_string,
         .from_json = (from_json_func) json_from_json,
         .to_json = (to_json_func) json_to_json,
+        .arena_aware = true,
 };
 
 static type_meta tag_META = {
@@ -1083,6 +1478,7 @@ static type_meta tag_META = {
         .destroyer = (_free_f) m_free_tag,
         .from_json = (from_json_func)tag_from_json,
         .to_json = (to_json_func)tag_to_json,
+        .arena_aware = true,
 };
 
 const type_meta *get_model_bool_meta() { return &bool_META; }
@@ -1091,12 +1487,63 @@ const type_meta *get_model_number_meta() { return &int_META; }
 
 const type_meta *get_model_string_meta() { return &string_META; }
 
+const type_meta *get_model_istring_meta() { return &istring_META; }
+
 const type_meta *get_timestamp_meta() { return &timestamp_META; }
 
 const type_meta *get_json_meta() { return &json_META; }
 
 const type_meta *get_tag_meta() { return &tag_META; }
 
+/*
+ * plain (none_mod) primitive fields: called directly by the functions generated in IMPL_MODEL(),
+ * same behavior as model_none_field_*() with the primitive's meta
+ */
+int model_number_field_cmp(const model_number *lf, const model_number *rf) {
+    return m_cmp_int(lf, rf);
+}
+
+int model_bool_field_cmp(const model_bool *lf, const model_bool *rf) {
+    return m_cmp_bool(lf, rf);
+}
+
+int model_string_field_cmp(const model_string *lf, const model_string *rf) {
+    return m_cmp_string(lf, rf);
+}
+
+int model_number_field_from_json(model_number *f, struct json_object *j) {
+    return json_value_missing(j) ? 0 : int_from_json(f, j, NULL);
+}
+
+int model_bool_field_from_json(model_bool *f, struct json_object *j) {
+    return json_value_missing(j) ? 0 : bool_from_json(f, j, NULL);
+}
+
+int model_string_field_from_json(model_string *f, struct json_object *j) {
+    return json_value_missing(j) ? 0 : string_from_json(f, j, NULL);
+}
+
+int model_number_field_to_json(const char *path, const model_number *f, void *buf, int indent, int flags, bool *comma) {
+    CHECK_APPEND(write_field_name(path, buf, indent, flags, comma));
+    return m_int_to_json(f, buf, indent + 1, flags);
+}
+
+int model_bool_field_to_json(const char *path, const model_bool *f, void *buf, int indent, int flags, bool *comma) {
+    CHECK_APPEND(write_field_name(path, buf, indent, flags, comma));
+    return m_bool_to_json(f, buf, indent + 1, flags);
+}
+
+int model_string_field_to_json(const char *path, const model_string *f, void *buf, int indent, int flags, bool *comma) {
+    if (*f == NULL) { return 0; }
+
+    CHECK_APPEND(write_field_name(path, buf, indent, flags, comma));
+    return m_string_to_json(*f, buf, indent + 1, flags);
+}
+
+void model_string_field_free(model_string *f) {
+    m_free_string((char **) f);
+}
+
 static int cmp_duration (const duration *lh, const duration *rh) {
     null_checks(lh, rh)
     duration diff = *lh - *rh;
@@ -1154,6 +1601,7 @@ const type_meta *get_duration_meta() {
             .destroyer = m_free_noop,
             .from_json = (from_json_func) duration_from_json,
             .to_json = (to_json_func) duration_to_json,
+            .arena_aware = true,
     };
     return &_meta;
 }
@@ -0,0 +1,232 @@
+//
+// 	Copyright NetFoundry Inc.
+//
+// 	Licensed under the Apache License, Version 2.0 (the "License");
+// 	you may not use this file except in compliance with the License.
+// 	You may obtain a copy of the License at
+//
+// 	https://www.apache.org/licenses/LICENSE-2.0
+//
+// 	Unless required by applicable law or agreed to in writing, software
+// 	distributed under the License is distributed on an "AS IS" BASIS,
+// 	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// 	See the License for the specific language governing permissions and
+// 	limitations under the License.
+//
+
+#include "mpsc_queue.h"
+#include "alloc.h"
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define CACHE_LINE 64
+
+// intrusive node, element data follows the header
+struct mpsc_node_s {
+    _Atomic(struct mpsc_node_s *) next;
+    bool pooled;
+};
+
+#define NODE_HDR ((sizeof(struct mpsc_node_s) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1))
+#define node_data(n) ((char *) (n) + NODE_HDR)
+#define data_node(d) ((struct mpsc_node_s *) ((char *) (d) - NODE_HDR))
+
+// freelist is a bounded ring(D. Vyukov's MPMC):
+// producers take nodes from it, consumer returns them
+struct free_cell_s {
+    atomic_size_t seq;
+    struct mpsc_node_s *node;
+};
+
+// padding keeps producer and consumer fields on separate cache lines
+struct mpsc_queue_s {
+    // producer end: D. Vyukov's intrusive MPSC queue
+    _Atomic(struct mpsc_node_s *) head;
+    atomic_bool signaled;
+    // nodes linked into the queue, bounds each drain to what was there when it started
+    atomic_size_t pushed;
+    char _pad1[CACHE_LINE];
+
+    atomic_size_t free_deq;
+    char _pad2[CACHE_LINE];
+
+    // consumer end
+    struct mpsc_node_s *tail;
+    struct mpsc_node_s stub;
+    size_t popped;
+    size_t free_enq;
+
+    size_t node_size;
+    size_t mask;
+    struct free_cell_s *free_ring;
+    char *nodes;
+};
+
+static void free_put(mpsc_queue_t *q, struct mpsc_node_s *n) {
+    // ring has room for every pooled node, but a producer that claimed this cell a lap ago
+    // may not have taken the node out yet: wait until it releases the cell
+    struct free_cell_s *cell = &q->free_ring[q->free_enq & q->mask];
+    while (atomic_load_explicit(&cell->seq, memory_order_acquire) != q->free_enq) {
+    }
+    cell->node = n;
+    atomic_store_explicit(&cell->seq, q->free_enq + 1, memory_order_release);
+    q->free_enq++;
+}
+
+static struct mpsc_node_s *free_get(mpsc_queue_t *q) {
+    size_t pos = atomic_load_explicit(&q->free_deq, memory_order_relaxed);
+    for (;;) {
+        struct free_cell_s *cell = &q->free_ring[pos & q->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->free_deq, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                struct mpsc_node_s *n = cell->node;
+                atomic_store_explicit(&cell->seq, pos + q->mask + 1, memory_order_release);
+                return n;
+            }
+        } else if (diff < 0) {
+            return NULL; // exhausted
+        } else {
+            pos = atomic_load_explicit(&q->free_deq, memory_order_relaxed);
+        }
+    }
+}
+
+mpsc_queue_t *mpsc_queue_new(size_t elem_size, size_t capacity) {
+    size_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+
+    mpsc_queue_t *q = ziti_calloc(1, sizeof(mpsc_queue_t));
+    if (q == NULL) return NULL;
+
+    q->node_size = NODE_HDR + ((elem_size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1));
+    q->mask = cap - 1;
+    q->free_ring = ziti_calloc(cap, sizeof(struct free_cell_s));
+    q->nodes = ziti_calloc(cap, q->node_size);
+
+    atomic_init(&q->stub.next, NULL);
+    q->stub.pooled = false;
+    atomic_init(&q->head, &q->stub);
+    q->tail = &q->stub;
+    atomic_init(&q->signaled, false);
+    atomic_init(&q->pushed, 0);
+    q->popped = 0;
+    atomic_init(&q->free_deq, 0);
+    q->free_enq = 0;
+
+    for (size_t i = 0; i < cap; i++) {
+        atomic_init(&q->free_ring[i].seq, i);
+    }
+    for (size_t i = 0; i < cap; i++) {
+        struct mpsc_node_s *n = (struct mpsc_node_s *) (q->nodes + i * q->node_size);
+        n->pooled = true;
+        free_put(q, n);
+    }
+    return q;
+}
+
+void *mpsc_queue_alloc(mpsc_queue_t *q) {
+    struct mpsc_node_s *n = free_get(q);
+    if (n == NULL) {
+        n = ziti_malloc(q->node_size);
+        if (n == NULL) return NULL;
+        n->pooled = false;
+    }
+    atomic_store_explicit(&n->next, NULL, memory_order_relaxed);
+    return node_data(n);
+}
+
+void *mpsc_queue_try_alloc(mpsc_queue_t *q) {
+    struct mpsc_node_s *n = free_get(q);
+    if (n == NULL) return NULL;
+
+    atomic_store_explicit(&n->next, NULL, memory_order_relaxed);
+    return node_data(n);
+}
+
+static void release_node(mpsc_queue_t *q, struct mpsc_node_s *n) {
+    if (n->pooled) {
+        free_put(q, n);
+    } else {
+        ziti_free(n);
+    }
+}
+
+static void push_node(mpsc_queue_t *q, struct mpsc_node_s *n) {
+    atomic_store_explicit(&n->next, NULL, memory_order_relaxed);
+    struct mpsc_node_s *prev = atomic_exchange_explicit(&q->head, n, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, n, memory_order_release);
+}
+
+bool mpsc_queue_push(mpsc_queue_t *q, void *elem) {
+    push_node(q, data_node(elem));
+    atomic_fetch_add_explicit(&q->pushed, 1, memory_order_relaxed);
+    // only the first producer after consumer re-armed needs to send wakeup
+    return !atomic_exchange_explicit(&q->signaled, true, memory_order_acq_rel);
+}
+
+static struct mpsc_node_s *pop_node(mpsc_queue_t *q) {
+    struct mpsc_node_s *tail = q->tail;
+    struct mpsc_node_s *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+    if (tail == &q->stub) {
+        if (next == NULL) return NULL;
+        q->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&next->next, memory_order_acquire);
+    }
+
+    if (next) {
+        q->tail = next;
+        return tail;
+    }
+
+    // producer is between swapping head and linking the node,
+    // it will signal after it is done
+    if (tail != atomic_load_explicit(&q->head, memory_order_acquire)) {
+        return NULL;
+    }
+
+    push_node(q, &q->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next) {
+        q->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+size_t mpsc_queue_drain(mpsc_queue_t *q, mpsc_handler_f handler, void *ctx) {
+    // RMW pairs with producers' exchange: everything pushed before their signal is visible below
+    atomic_exchange_explicit(&q->signaled, false, memory_order_acq_rel);
+
+    // elements pushed from here on come with their own wakeup:
+    // leave them for the next drain, so that handlers re-queueing work do not loop forever
+    size_t limit = atomic_load_explicit(&q->pushed, memory_order_relaxed) - q->popped;
+
+    size_t count = 0;
+    struct mpsc_node_s *n;
+    while (count < limit && (n = pop_node(q)) != NULL) {
+        if (handler) {
+            handler(node_data(n), ctx);
+        }
+        release_node(q, n);
+        count++;
+    }
+    q->popped += count;
+    return count;
+}
+
+void mpsc_queue_free(mpsc_queue_t *q) {
+    if (q == NULL) return;
+
+    mpsc_queue_drain(q, NULL, NULL);
+    ziti_free(q->free_ring);
+    ziti_free(q->nodes);
+    ziti_free(q);
+}
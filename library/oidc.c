@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_ctrl
+
 #include <oidc.h>
 #include <assert.h>
 #include <json-c/json.h>
@@ -123,7 +125,7 @@ static const char HTTP_SUCCESS_BODY[] =
 
 
 static oidc_req *new_oidc_req(oidc_client_t *clt, oidc_cb cb, void *ctx) {
-    oidc_req *res = calloc(1, sizeof(*res));
+    oidc_req *res = ziti_calloc(1, sizeof(*res));
     res->client = clt;
     res->cb = cb;
 
@@ -135,7 +137,7 @@ static oidc_req *new_oidc_req(oidc_client_t *clt, oidc_cb cb, void *ctx) {
 static void complete_oidc_req(oidc_req *req, int err, json_object *obj) {
     req->cb(req, err, obj);
     json_tokener_free(req->parser);
-    free(req);
+    ziti_free(req);
 }
 
 static void json_parse_cb(tlsuv_http_req_t *r, char *data, ssize_t len) {
@@ -229,7 +231,7 @@ int oidc_client_init(uv_loop_t *loop, oidc_client_t *clt,
     }
     tlsuv_http_set_ssl(&clt->http, tls);
 
-    clt->timer = calloc(1, sizeof(*clt->timer));
+    clt->timer = ziti_calloc(1, sizeof(*clt->timer));
     uv_timer_init(loop, clt->timer);
     clt->timer->data = clt;
     uv_unref((uv_handle_t *) clt->timer);
@@ -244,13 +246,13 @@ int oidc_client_set_cfg(oidc_client_t *clt, const ziti_jwt_signer *cfg) {
         return ZITI_INVALID_CONFIG;
     }
 
-    clt->signer_cfg.client_id = cfg->client_id ? strdup(cfg->client_id) : NULL;
-    clt->signer_cfg.provider_url = strdup(cfg->provider_url);
-    clt->signer_cfg.audience = cfg->audience ? strdup(cfg->audience) : NULL;
+    clt->signer_cfg.client_id = cfg->client_id ? ziti_strdup(cfg->client_id) : NULL;
+    clt->signer_cfg.provider_url = ziti_strdup(cfg->provider_url);
+    clt->signer_cfg.audience = cfg->audience ? ziti_strdup(cfg->audience) : NULL;
     clt->signer_cfg.target_token = cfg->target_token;
     const char *scope;
     MODEL_LIST_FOREACH(scope, cfg->scopes) {
-        model_list_append(&clt->signer_cfg.scopes, strdup(scope));
+        model_list_append(&clt->signer_cfg.scopes, ziti_strdup(scope));
     }
     return tlsuv_http_set_url(&clt->http, clt->signer_cfg.provider_url);
 }
@@ -312,7 +314,7 @@ int oidc_client_configure(oidc_client_t *clt, oidc_config_cb cb) {
 }
 
 static auth_req *new_auth_req(oidc_client_t *clt) {
-    auth_req *req = calloc(1, sizeof(*req));
+    auth_req *req = ziti_calloc(1, sizeof(*req));
     req->clt = clt;
 
     uint8_t code[code_len];
@@ -340,7 +342,7 @@ static void free_auth_req(auth_req *req) {
         req->json_parser = NULL;
     }
     FREE(req->id);
-    free(req);
+    ziti_free(req);
 }
 
 static void failed_auth_req(auth_req *req, const char *error) {
@@ -355,7 +357,7 @@ static void failed_auth_req(auth_req *req, const char *error) {
     if (req->elr) {
         req->elr->err = ECANCELED;
         if (uv_cancel((uv_req_t *) &req->elr->wr) == 0) {
-            free(req->elr);
+            ziti_free(req->elr);
         }
     }
 
@@ -464,7 +466,7 @@ static void login_cb(tlsuv_http_resp_t *http_resp, void *ctx) {
 }
 
 static void free_body_cb(tlsuv_http_req_t * UNUSED(req), char *body, ssize_t UNUSED(len)) {
-    free(body);
+    ziti_free(body);
 }
 
 static void auth_cb(tlsuv_http_resp_t *http_resp, void *ctx) {
@@ -475,7 +477,7 @@ static void auth_cb(tlsuv_http_resp_t *http_resp, void *ctx) {
         tlsuv_parse_url(&uri, redirect);
         char *p = strstr(uri.query, "authRequestID=");
         p += strlen("authRequestID=");
-        req->id = strdup(p);
+        req->id = ziti_strdup(p);
         char path[256] = {};
         if (req->clt->jwt_token_auth) {
             snprintf(path, sizeof(path),"/oidc/login/ext-jwt?id=%s", req->id);
@@ -647,7 +649,7 @@ static void ext_accept(uv_work_t *wr) {
     }
 
     size_t param_len = ce - cs;
-    char* decoded_code = calloc(param_len + 1, sizeof(char));
+    char* decoded_code = ziti_calloc(param_len + 1, sizeof(char));
     url_decode(cs, param_len, decoded_code);
     elr->code = decoded_code;
 
@@ -680,7 +682,7 @@ static void ext_accept(uv_work_t *wr) {
         rp += wc;
     }
 
-    free(resp);
+    ziti_free(resp);
     string_buf_free(&resp_buf);
 
 #if _WIN32
@@ -712,8 +714,8 @@ static void ext_done(uv_work_t *wr, int status) {
 
     }
 
-    free(elr->code);
-    free(elr);
+    ziti_free(elr->code);
+    ziti_free(elr);
 }
 
 static void start_ext_auth(auth_req *req, const char *ep, int qc, tlsuv_http_pair q[]) {
@@ -740,12 +742,12 @@ static void start_ext_auth(auth_req *req, const char *ep, int qc, tlsuv_http_pai
     }
     set_blocking(sock);
 
-    struct ext_link_req *elr = calloc(1, sizeof(*elr));
+    struct ext_link_req *elr = ziti_calloc(1, sizeof(*elr));
     elr->sock = sock;
     elr->req = req;
     int rc = uv_queue_work(loop, &elr->wr, ext_accept, ext_done);
     if (rc != 0) {
-        free(elr);
+        ziti_free(elr);
         close_socket(sock);
         failed_auth_req(req, uv_strerror(rc));
         return;
@@ -764,7 +766,7 @@ static void start_ext_auth(auth_req *req, const char *ep, int qc, tlsuv_http_pai
     req->elr = elr;
     req->clt->link_cb(req->clt, url, req->clt->link_ctx);
 
-    free(url);
+    ziti_free(url);
     delete_string_buf(buf);
 }
 
@@ -819,7 +821,7 @@ int oidc_client_start(oidc_client_t *clt, oidc_token_cb cb) {
         }
     }
 
-    free(scope);
+    ziti_free(scope);
     delete_string_buf(scopes_buf);
     return rc;
 }
@@ -898,7 +900,7 @@ int oidc_client_close(oidc_client_t *clt, oidc_close_cb cb) {
     clt->token_cb = NULL;
     clt->close_cb = cb;
     tlsuv_http_close(&clt->http, http_close_cb);
-    uv_close((uv_handle_t *) clt->timer, (uv_close_cb) free);
+    uv_close((uv_handle_t *) clt->timer, (uv_close_cb) ziti_free);
     clt->timer = NULL;
     free_ziti_jwt_signer(&clt->signer_cfg);
 
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_channel
+
 #include "pool.h"
 #include "utils.h"
 
@@ -43,7 +45,7 @@ struct pool_s {
 };
 
 pool_t *pool_new(size_t objsize, size_t count, void (*clear_func)(void *)) {
-    pool_t *p = calloc(1, sizeof(pool_t));
+    pool_t *p = ziti_calloc(1, sizeof(pool_t));
     p->memsize = objsize;
     p->capacity = count;
     p->clear_func = clear_func;
@@ -56,11 +58,11 @@ void pool_destroy(pool_t *pool) {
     while (!LIST_EMPTY(&pool->pool)) {
         struct pool_obj_s *m = LIST_FIRST(&pool->pool);
         LIST_REMOVE(m, _next);
-        free(m);
+        ziti_free(m);
     }
 
     if (pool->out == 0) {
-        free(pool);
+        ziti_free(pool);
     }
 }
 
@@ -77,7 +79,7 @@ bool pool_has_available(pool_t *pool) {
 }
 
 void *alloc_unpooled_obj(size_t size, void (*clear_func)(void *)) {
-    struct pool_obj_s *obj = calloc(1, sizeof(struct pool_obj_s) + size);
+    struct pool_obj_s *obj = ziti_calloc(1, sizeof(struct pool_obj_s) + size);
     if (obj) {
         obj->size = size;
         obj->pool = NULL;
@@ -99,7 +101,7 @@ void *pool_alloc_obj(pool_t *pool) {
         LIST_REMOVE(member, _next);
     }
     else if (pool->capacity > pool->out) {
-        member = calloc(1, sizeof(struct pool_obj_s) + pool->memsize);
+        member = ziti_calloc(1, sizeof(struct pool_obj_s) + pool->memsize);
         member->size = pool->memsize;
         member->pool = pool;
         member->clear_func = pool->clear_func;
@@ -117,6 +119,14 @@ size_t pool_mem_size(pool_t *pool) {
     return pool ? pool->memsize : 0;
 }
 
+size_t pool_in_use(pool_t *pool) {
+    return pool ? pool->out : 0;
+}
+
+size_t pool_capacity(pool_t *pool) {
+    return pool ? pool->capacity : 0;
+}
+
 size_t pool_obj_size(void *o) {
     if (o == NULL) { return 0; }
 
@@ -133,7 +143,7 @@ void pool_return_obj(void *o) {
     }
     pool_t *pool = m->pool;
     if (pool == NULL) {
-        free(m);
+        ziti_free(m);
         return;
     }
 
@@ -141,9 +151,9 @@ void pool_return_obj(void *o) {
     pool->out--;
 
     if (pool->is_closed) {
-        free(m);
+        ziti_free(m);
         if (pool->out == 0) {
-            free(pool);
+            ziti_free(pool);
         }
     } else {
         bool was_empty = LIST_EMPTY(&pool->pool);
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_posture
+
 #include "edge_protocol.h"
 #include "posture.h"
 #include <utils.h>
@@ -50,7 +52,7 @@ const bool IS_NOT_ERRORED = false;
 #define PC_OS_TYPE ziti_posture_query_types.name(ziti_posture_query_types.PC_OS)
 #define PC_MAC_TYPE ziti_posture_query_types.name(ziti_posture_query_types.PC_MAC)
 
-#define s_strdup(s) ((s) ? strdup(s) : NULL)
+#define s_strdup(s) ((s) ? ziti_strdup(s) : NULL)
 
 struct query_info {
     ziti_service *service;
@@ -174,8 +176,8 @@ static void ziti_pr_ticker_cb(void *data) {
 static pr_info *get_resp_info(ziti_context ztx, const char *id) {
     pr_info *resp = model_map_get(&ztx->posture_checks->responses, id);
     if (resp == NULL) {
-        resp = calloc(1, sizeof(pr_info));
-        resp->id = strdup(id);
+        resp = ziti_calloc(1, sizeof(pr_info));
+        resp->id = ziti_strdup(id);
         model_map_set(&ztx->posture_checks->responses, id, resp);
     }
     return resp;
@@ -215,8 +217,8 @@ void ziti_send_posture_data(ziti_context ztx) {
         checks->must_send = true;
         FREE(checks->previous_api_session_id);
         FREE(checks->controller_instance_id);
-        checks->previous_api_session_id = strdup(ztx->session_token);
-        checks->controller_instance_id = strdup(ctrl->instance_id);
+        checks->previous_api_session_id = ziti_strdup(ztx->session_token);
+        checks->controller_instance_id = ziti_strdup(ctrl->instance_id);
     } else {
         ZTX_LOG(DEBUG, "posture checks must_send set to FALSE, new_session_id[%s], must_send_every_time[%s], new_controller_instance[%s]",
                 new_session_id ? "TRUE" : "FALSE",
@@ -407,7 +409,7 @@ void ziti_send_posture_data(ziti_context ztx) {
         }
     }
 
-    model_map_clear(&processes, free);
+    model_map_clear(&processes, ziti_free);
 
     ziti_pr_send(ztx);
 }
@@ -620,14 +622,14 @@ static void send_posture_legacy(ziti_context ztx, model_list *send_prs) {
     string_buf_t buf;
     string_buf_init(&buf);
     model_list_fmt_to_json(&buf, &json_list, get_json_meta(), 0, 0);
-    model_list_clear(&json_list, free);
+    model_list_clear(&json_list, ziti_free);
 
     size_t body_len;
     char *body = string_buf_to_string(&buf, &body_len);
     ZTX_LOG(TRACE, "bulk posture response: %s", body);
 
     ziti_pr_post_bulk(ztx_get_controller(ztx), body, body_len, ziti_pr_post_bulk_cb, ztx);
-    free(body);
+    ziti_free(body);
     string_buf_free(&buf);
 }
 
@@ -643,9 +645,9 @@ static void send_posture_ha(ziti_context ztx, model_list *send_prs) {
             case ziti_posture_query_type_PC_Domain: {
                 ziti_pr_domain_req *req = (ziti_pr_domain_req *) info->obj;
 
-                pr_resp = calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse));
+                pr_resp = ziti_calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse));
                 ziti__edge_client__pb__posture_response__init(pr_resp);
-                Ziti__EdgeClient__Pb__PostureResponse__Domain * d = calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse__Domain));
+                Ziti__EdgeClient__Pb__PostureResponse__Domain * d = ziti_calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse__Domain));
                 ziti__edge_client__pb__posture_response__domain__init(d);
                 d->name = s_strdup(req->domain);
                 pr_resp->type_case = ZITI__EDGE_CLIENT__PB__POSTURE_RESPONSE__TYPE_DOMAIN;
@@ -656,13 +658,13 @@ static void send_posture_ha(ziti_context ztx, model_list *send_prs) {
             case ziti_posture_query_type_PC_OS: {
                 ziti_pr_os_req *req = (ziti_pr_os_req *) info->obj;
                 Ziti__EdgeClient__Pb__PostureResponse__OperatingSystem *os =
-                        calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse__OperatingSystem));
+                        ziti_calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse__OperatingSystem));
                 ziti__edge_client__pb__posture_response__operating_system__init(os);
                 os->type = s_strdup(req->type);
                 os->version = s_strdup(req->version);
                 os->build = s_strdup(req->build);
 
-                pr_resp = calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse));
+                pr_resp = ziti_calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse));
                 ziti__edge_client__pb__posture_response__init(pr_resp);
                 pr_resp->type_case = ZITI__EDGE_CLIENT__PB__POSTURE_RESPONSE__TYPE_OS;
                 pr_resp->os = os;
@@ -672,7 +674,7 @@ static void send_posture_ha(ziti_context ztx, model_list *send_prs) {
             case ziti_posture_query_type_PC_Process: {
                 ziti_pr_process_req *req = (ziti_pr_process_req *) info->obj;
                 Ziti__EdgeClient__Pb__PostureResponse__Process *proc =
-                        calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse__Process));
+                        ziti_calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse__Process));
                 ziti__edge_client__pb__posture_response__process__init(proc);
                 proc->path = s_strdup(req->path);
                 proc->hash = s_strdup(req->hash);
@@ -685,17 +687,17 @@ static void send_posture_ha(ziti_context ztx, model_list *send_prs) {
             case ziti_posture_query_type_PC_MAC: {
                 ziti_pr_mac_req *req = (ziti_pr_mac_req *) info->obj;
                 Ziti__EdgeClient__Pb__PostureResponse__Macs *mac =
-                        calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse__Macs));
+                        ziti_calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse__Macs));
                 ziti__edge_client__pb__posture_response__macs__init(mac);
                 mac->n_addresses = model_list_size(&req->mac_addresses);
-                mac->addresses = calloc(mac->n_addresses, sizeof(mac->addresses[0]));
+                mac->addresses = ziti_calloc(mac->n_addresses, sizeof(mac->addresses[0]));
                 int i = 0;
                 const char* addr;
                 MODEL_LIST_FOREACH(addr, req->mac_addresses) {
                     mac->addresses[i++] = s_strdup(addr);
                 }
 
-                pr_resp = calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse));
+                pr_resp = ziti_calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse));
                 ziti__edge_client__pb__posture_response__init(pr_resp);
                 pr_resp->type_case = ZITI__EDGE_CLIENT__PB__POSTURE_RESPONSE__TYPE_MACS;
                 pr_resp->macs = mac;
@@ -710,13 +712,13 @@ static void send_posture_ha(ziti_context ztx, model_list *send_prs) {
                 uv_gettimeofday(&now);
 
                 if (req->unlocked) {
-                    Ziti__EdgeClient__Pb__PostureResponse__Unlocked *unlocked = calloc(1, sizeof(*unlocked));
+                    Ziti__EdgeClient__Pb__PostureResponse__Unlocked *unlocked = ziti_calloc(1, sizeof(*unlocked));
                     ziti__edge_client__pb__posture_response__unlocked__init(unlocked);
-                    unlocked->time = calloc(1, sizeof(*unlocked->time));
+                    unlocked->time = ziti_calloc(1, sizeof(*unlocked->time));
                     google__protobuf__timestamp__init(unlocked->time);
                     unlocked->time->seconds = now.tv_sec;
 
-                    pr_resp = calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse));
+                    pr_resp = ziti_calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse));
                     ziti__edge_client__pb__posture_response__init(pr_resp);
                     pr_resp->type_case = ZITI__EDGE_CLIENT__PB__POSTURE_RESPONSE__TYPE_UNLOCKED;
                     pr_resp->unlocked = unlocked;
@@ -724,13 +726,13 @@ static void send_posture_ha(ziti_context ztx, model_list *send_prs) {
                 }
 
                 if (req->woken) {
-                    Ziti__EdgeClient__Pb__PostureResponse__Woken *woken = calloc(1, sizeof(*woken));
+                    Ziti__EdgeClient__Pb__PostureResponse__Woken *woken = ziti_calloc(1, sizeof(*woken));
                     ziti__edge_client__pb__posture_response__woken__init(woken);
-                    woken->time = calloc(1, sizeof(*woken->time));
+                    woken->time = ziti_calloc(1, sizeof(*woken->time));
                     google__protobuf__timestamp__init(woken->time);
                     woken->time->seconds = now.tv_sec;
 
-                    pr_resp = calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse));
+                    pr_resp = ziti_calloc(1, sizeof(Ziti__EdgeClient__Pb__PostureResponse));
                     ziti__edge_client__pb__posture_response__init(pr_resp);
                     pr_resp->type_case = ZITI__EDGE_CLIENT__PB__POSTURE_RESPONSE__TYPE_WOKEN;
                     pr_resp->woken = woken;
@@ -743,12 +745,12 @@ static void send_posture_ha(ziti_context ztx, model_list *send_prs) {
     }
 
     if (model_list_size(&process_list) > 0) {
-        pr_resp = calloc(1, sizeof(*pr_resp));
+        pr_resp = ziti_calloc(1, sizeof(*pr_resp));
         ziti__edge_client__pb__posture_response__init(pr_resp);
-        Ziti__EdgeClient__Pb__PostureResponse__ProcessList *pl = calloc(1, sizeof(*pl));
+        Ziti__EdgeClient__Pb__PostureResponse__ProcessList *pl = ziti_calloc(1, sizeof(*pl));
         ziti__edge_client__pb__posture_response__process_list__init(pl);
         pl->n_processes = model_list_size(&process_list);
-        pl->processes = calloc(pl->n_processes, sizeof(pl->processes[0]));
+        pl->processes = ziti_calloc(pl->n_processes, sizeof(pl->processes[0]));
         int i = 0;
         Ziti__EdgeClient__Pb__PostureResponse__Process *proc;
         MODEL_LIST_FOREACH(proc, process_list) {
@@ -761,11 +763,11 @@ static void send_posture_ha(ziti_context ztx, model_list *send_prs) {
     }
 
     if (model_list_size(&pb_list) > 0) {
-        Ziti__EdgeClient__Pb__PostureResponses *resp = calloc(1, sizeof(*resp));
+        Ziti__EdgeClient__Pb__PostureResponses *resp = ziti_calloc(1, sizeof(*resp));
         ziti__edge_client__pb__posture_responses__init(resp);
 
         resp->n_responses = model_list_size(&pb_list);
-        resp->responses = calloc(resp->n_responses, sizeof(resp->responses[0]));
+        resp->responses = ziti_calloc(resp->n_responses, sizeof(resp->responses[0]));
 
         int idx = 0;
         MODEL_LIST_FOREACH(pr_resp, pb_list) {
@@ -792,11 +794,11 @@ static void send_posture_ha(ziti_context ztx, model_list *send_prs) {
 static void ziti_pr_handle_mac(ziti_context ztx, const char *id, char **mac_addresses, int num_mac) {
     ziti_pr_mac_req *mac_req = alloc_ziti_pr_mac_req();
     *mac_req = (ziti_pr_mac_req){
-            .id = strdup(id),
+            .id = ziti_strdup(id),
             .typeId = ziti_posture_query_type_PC_MAC,
     };
     for (int idx = 0; idx < num_mac; idx++) {
-        model_list_append(&mac_req->mac_addresses, strdup(mac_addresses[idx]));
+        model_list_append(&mac_req->mac_addresses, ziti_strdup(mac_addresses[idx]));
     }
 
     ziti_collect_pr(ztx, mac_req);
@@ -805,8 +807,8 @@ static void ziti_pr_handle_mac(ziti_context ztx, const char *id, char **mac_addr
 static void ziti_pr_handle_domain(ziti_context ztx, const char *id, const char *domain) {
     ziti_pr_domain_req *req = alloc_ziti_pr_domain_req();
     *req = (ziti_pr_domain_req){
-            .id = strdup(id),
-            .domain = strdup(domain),
+            .id = ziti_strdup(id),
+            .domain = ziti_strdup(domain),
             .typeId = ziti_posture_query_type_PC_Domain,
     };
 
@@ -816,11 +818,11 @@ static void ziti_pr_handle_domain(ziti_context ztx, const char *id, const char *
 static void ziti_pr_handle_os(ziti_context ztx, const char *id, const char *os_type, const char *os_version, const char *os_build) {
     ziti_pr_os_req *os_req = alloc_ziti_pr_os_req();
     *os_req = (ziti_pr_os_req){
-            .id = strdup(id),
+            .id = ziti_strdup(id),
             .typeId = ziti_posture_query_type_PC_OS,
-            .type = strdup(os_type),
-            .version = strdup(os_version),
-            .build = strdup(os_build)
+            .type = ziti_strdup(os_type),
+            .version = ziti_strdup(os_version),
+            .build = ziti_strdup(os_build)
     };
     
     ziti_collect_pr(ztx, os_req);
@@ -833,14 +835,14 @@ static void ziti_pr_handle_process(ziti_context ztx, const char *id, const char
 
     ziti_pr_process_req *process_req = alloc_ziti_pr_process_req();
     *process_req = (ziti_pr_process_req){
-            .id = strdup(id),
+            .id = ziti_strdup(id),
             .typeId = ziti_posture_query_type_PC_Process,
-            .path = strdup(path),
+            .path = ziti_strdup(path),
             .is_running = is_running,
-            .hash = sha_512_hash ? strdup(sha_512_hash) : NULL,
+            .hash = sha_512_hash ? ziti_strdup(sha_512_hash) : NULL,
     };
     for (int idx = 0; idx < num_signers; idx++) {
-        model_list_append(&process_req->signers, strdup(signers[idx]));
+        model_list_append(&process_req->signers, ziti_strdup(signers[idx]));
     }
     
     ziti_collect_pr(ztx, process_req);
@@ -930,7 +932,7 @@ static void default_pq_mac(ziti_context ztx, const char *id, ziti_pr_mac_cb resp
     }
 
     size_t addr_count = model_map_size(&addrs);
-    char **addresses = calloc(addr_count, sizeof(char *));
+    char **addresses = ziti_calloc(addr_count, sizeof(char *));
     const char *ifname;
     char *mac;
     int idx = 0;
@@ -939,8 +941,8 @@ static void default_pq_mac(ziti_context ztx, const char *id, ziti_pr_mac_cb resp
     }
 
     response_cb(ztx, id, addresses, (int) addr_count);
-    free(addresses);
-    model_map_clear(&addrs, free);
+    ziti_free(addresses);
+    model_map_clear(&addrs, ziti_free);
     uv_free_interface_addresses(info, count);
 }
 
@@ -969,16 +971,16 @@ static void process_check_done(uv_work_t *w, int status) {
     } else {
         ZITI_LOG(INFO, "process check path[%s] was cancelled", pcw->path);
     }
-    free(pcw->id);
-    free(pcw->path);
+    ziti_free(pcw->id);
+    ziti_free(pcw->path);
     FREE(pcw->sha512);
     if (pcw->signers) {
         for (int i = 0; i < pcw->num_signers; i++) {
-            free(pcw->signers[i]);
+            ziti_free(pcw->signers[i]);
         }
-        free(pcw->signers);
+        ziti_free(pcw->signers);
     }
-    free(pcw);
+    ziti_free(pcw);
 }
 
 bool ziti_service_has_query_with_timeout(ziti_service *service) {
@@ -1005,8 +1007,8 @@ bool ziti_service_has_query_with_timeout(ziti_service *service) {
 
 static void default_pq_process(ziti_context ztx, const char *id, const char *path, ziti_pr_process_cb cb) {
     NEWP(wr, struct process_work);
-    wr->id = strdup(id);
-    wr->path = strdup(path);
+    wr->id = ziti_strdup(id);
+    wr->path = ziti_strdup(path);
     wr->cb = cb;
     wr->ztx = ztx;
     model_map_set_key(&ztx->posture_checks->active_work, &wr, sizeof(uintptr_t), wr);
@@ -1030,7 +1032,7 @@ static void process_check_work(uv_work_t *w) {
     if (hash_sha512(ztx, w->loop, path, &digest, &digest_len) == 0) {
         hexify(digest, digest_len, 0, &pcw->sha512);
         ZITI_LOG(VERBOSE, "file(%s) hash = %s", path, pcw->sha512);
-        free(digest);
+        ziti_free(digest);
     }
     pcw->signers = get_signers(path, &pcw->num_signers);
 }
@@ -1089,7 +1091,7 @@ goto cleanup;                                   \
     uv_file file = uv_fs_open(loop, &ft, path, UV_FS_O_RDONLY, 0, NULL);
 
     if (file < 0) { return -1; }
-    uv_buf_t buf = uv_buf_init(malloc(64 * 1024), 64 * 1024);
+    uv_buf_t buf = uv_buf_init(ziti_malloc(64 * 1024), 64 * 1024);
     int64_t offset = 0;
     crypto_hash_sha512_state sha512;
     crypto_hash_sha512_init(&sha512);
@@ -1109,7 +1111,7 @@ goto cleanup;                                   \
         offset += read;
         CHECK(crypto_hash_sha512_update(&sha512, (uint8_t *) buf.base, read));
     }
-    digest = malloc(digest_size);
+    digest = ziti_malloc(digest_size);
     CHECK(crypto_hash_sha512_final(&sha512, digest));
 
     *out_buf = digest;
@@ -1186,7 +1188,7 @@ static bool check_running(uv_loop_t *loop, const char *path) {
                 if (strcmp((const char *) ex.ptr, path) == 0) {
                     result = true;
                 }
-                free(ex.ptr);
+                ziti_free(ex.ptr);
             }
         }
     }
@@ -1195,7 +1197,7 @@ static bool check_running(uv_loop_t *loop, const char *path) {
 #elif __APPLE__ && TARGET_OS_IPHONE == 0 && TARGET_OS_SIMULATOR == 0
     int n_pids = proc_listallpids(NULL, 0);
     unsigned long pids_sz = sizeof(pid_t) * (unsigned long)n_pids;
-    pid_t * pids = calloc(1, pids_sz);
+    pid_t * pids = ziti_calloc(1, pids_sz);
     proc_listallpids(pids, (int)pids_sz);
     char proc_path[PROC_PIDPATHINFO_MAXSIZE];
     for (int i=0; i < n_pids; i++) {
@@ -1206,7 +1208,7 @@ static bool check_running(uv_loop_t *loop, const char *path) {
             break;
         }
     }
-    free(pids);
+    ziti_free(pids);
 #else
     uv_utsname_t uname;
     uv_os_uname(&uname);
@@ -1243,7 +1245,7 @@ char **get_signers(const char *path, int *signers_count) {
 
     if (!res) return NULL;
 
-    result = calloc(16, sizeof(char *));
+    result = ziti_calloc(16, sizeof(char *));
     int idx = 0;
     pCertContext = CertEnumCertificatesInStore(hStore, NULL);
     while (pCertContext != NULL) {
@@ -15,6 +15,7 @@
 //
 #include <uv.h>
 #include <internal_model.h>
+#include "alloc.h"
 
 #if _WIN32
 #include <stdint.h>
@@ -109,10 +110,10 @@ const ziti_env_info* get_env_info() {
 }
 
 void ziti_set_device_id(const char *device_id) {
-    free((void*)s_info.device_id);
+    ziti_free((void*)s_info.device_id);
     s_info.device_id = NULL;
 
     if (device_id) {
-        s_info.device_id = strdup(device_id);
+        s_info.device_id = ziti_strdup(device_id);
     }
 }
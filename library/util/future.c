@@ -19,6 +19,7 @@
 #include <uv.h>
 
 #include "future.h"
+#include "alloc.h"
 
 typedef struct future_s {
     uv_mutex_t lock;
@@ -31,7 +32,7 @@ typedef struct future_s {
 
 
 future_t *new_future() {
-    future_t *f = calloc(1, sizeof(future_t));
+    future_t *f = ziti_calloc(1, sizeof(future_t));
     int rc = uv_mutex_init(&f->lock);
     if (rc != 0) {
         fprintf(stderr, "failed to init lock %d/%s\n", rc, uv_strerror(rc));
@@ -58,7 +59,7 @@ void destroy_future(future_t *f) {
     uv_mutex_unlock(&f->lock);
     uv_mutex_destroy(&f->lock);
     uv_cond_destroy(&f->cond);
-    free(f);
+    ziti_free(f);
 }
 
 int await_future_timed(future_t *f, void **result, uint64_t timeout) {
@@ -16,9 +16,12 @@
 #include <tlsuv/tlsuv.h>
 #include <ziti/ziti_model.h>
 #include <ziti/ziti_log.h>
+#include <inttypes.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 
 #include "utils.h"
+#include "mpsc_queue.h"
 #include "tlsuv/http.h"
 #include "ziti/errors.h"
 
@@ -113,6 +116,32 @@ const char* ziti_git_commit() {
 
 static const char *TLSUV_MODULE = "tlsuv";
 
+#define ASYNC_LOG_LINE_LENGTH 1024
+
+struct log_record {
+    uint64_t ts;
+    int level;
+    unsigned int line;
+    // location pointers are static strings (__FILE__, __func__)
+    const char *module;
+    const char *file;
+    const char *func;
+    int len;
+    char msg[ASYNC_LOG_LINE_LENGTH];
+};
+
+static struct {
+    _Atomic(mpsc_queue_t *) queue;
+    uv_thread_t writer;
+    uv_sem_t wakeup;
+    atomic_bool running;
+    atomic_ullong dropped;
+    uint64_t reported;
+} async_log;
+
+// set by async writer thread so that timestamps reflect when the message was logged
+static THREAD_LOCAL uint64_t log_record_ts;
+
 static model_map log_levels;
 static int ziti_log_lvl = ZITI_LOG_DEFAULT_LEVEL;
 static FILE *ziti_debug_out;
@@ -134,6 +163,18 @@ static char log_timestamp[64];
 
 static log_writer logger = NULL;
 
+// starts at 1 so that zero-initialized call sites are resolved on first use
+ziti_log_atomic_uint ziti_log_generation = 1;
+
+static void log_levels_changed(void) {
+    unsigned int gen = ziti_log_atomic_load(&ziti_log_generation) + 1;
+    // generation must fit next to the level in the call site word
+    if ((gen << ZITI_LOG_SITE_LEVEL_BITS) >> ZITI_LOG_SITE_LEVEL_BITS != gen) {
+        gen = 1;
+    }
+    ziti_log_atomic_store(&ziti_log_generation, gen);
+}
+
 static void init_debug(uv_loop_t *loop);
 
 static void init_uv_mbed_log();
@@ -189,6 +230,7 @@ void ziti_log_set_level(int level, const char *marker) {
             ziti_log_lvl = level;
         }
     }
+    log_levels_changed();
 
     if (logger) {
         int l = level == ZITI_LOG_DEFAULT_LEVEL ? ziti_log_lvl : level;
@@ -197,6 +239,16 @@ void ziti_log_set_level(int level, const char *marker) {
     }
 }
 
+int ziti_log_resolve_site(ziti_log_atomic_uint *site, const char *module, const char *file) {
+    unsigned int gen = ziti_log_atomic_load(&ziti_log_generation);
+    int level = ziti_log_level(module, file);
+    if (level < NONE) {
+        level = NONE;
+    }
+    ziti_log_atomic_store(site, (gen << ZITI_LOG_SITE_LEVEL_BITS) | (unsigned int) level);
+    return level;
+}
+
 int ziti_log_level(const char *module, const char *file) {
     int level;
 
@@ -251,6 +303,9 @@ static void init_uv_mbed_log() {
 static void child_init() {
     log_initialized = false;
     log_pid = uv_os_getpid();
+    // writer thread does not exist in the child
+    atomic_store(&async_log.queue, NULL);
+    atomic_store(&async_log.running, false);
 }
 
 static void init_debug(uv_loop_t *loop) {
@@ -291,7 +346,7 @@ static void init_debug(uv_loop_t *loop) {
             ziti_log_lvl = l;
         }
     }
-    model_list_clear(&levels, free);
+    model_list_clear(&levels, ziti_free);
 
     int tlsuv_level = (int) (intptr_t) model_map_get(&log_levels, TLSUV_MODULE);
     if (tlsuv_level > 0) {
@@ -299,8 +354,14 @@ static void init_debug(uv_loop_t *loop) {
     }
 
     ziti_debug_out = stderr;
+    log_levels_changed();
 
     starttime = uv_now(loop);
+
+    const char *async = getenv("ZITI_LOG_ASYNC");
+    if (async) {
+        ziti_log_set_async((size_t) strtoul(async, NULL, 10));
+    }
 }
 
 #if _WIN32 && defined(_MSC_VER)
@@ -325,11 +386,8 @@ static const char *basename(const char *path) {
 
 static THREAD_LOCAL char log_buf[LOG_LINE_LENGTH];
 
-void ziti_logger(int level, const char *module, const char *file, unsigned int line, const char *func, FORMAT_STRING(const char *fmt), ...) {
-    log_writer logfunc = logger;
-    if (logfunc == NULL) { return; }
-
-    char location[128];
+static void format_location(char *location, size_t size, const char *module, const char *file,
+                            unsigned int line, const char *func) {
     char *last_slash = strrchr(file, DIR_SEP);
 
     int modlen = 16;
@@ -355,12 +413,56 @@ void ziti_logger(int level, const char *module, const char *file, unsigned int l
         file = last_slash + 1;
     }
     if (func && func[0]) {
-        snprintf(location, sizeof(location), "%.*s:%s:%u %s()", modlen, module, file, line, func);
+        snprintf(location, size, "%.*s:%s:%u %s()", modlen, module, file, line, func);
     }
     else {
-        snprintf(location, sizeof(location), "%.*s:%s:%u", modlen, module, file, line);
+        snprintf(location, size, "%.*s:%s:%u", modlen, module, file, line);
+    }
+}
+
+static void async_log_submit(mpsc_queue_t *q, int level, const char *module, const char *file, unsigned int line,
+                             const char *func, const char *fmt, va_list argp) {
+    // callers are mostly loop threads, never wait for the writer to catch up
+    struct log_record *r = mpsc_queue_try_alloc(q);
+    if (r == NULL) {
+        atomic_fetch_add_explicit(&async_log.dropped, 1, memory_order_relaxed);
+        return;
     }
 
+    r->ts = ts_loop ? uv_now(ts_loop) : 0;
+    r->level = level;
+    r->line = line;
+    r->module = module;
+    r->file = file;
+    r->func = func;
+    r->len = vsnprintf(r->msg, sizeof(r->msg), fmt, argp);
+    if (r->len < 0) {
+        r->len = 0;
+    } else if (r->len >= (int) sizeof(r->msg)) {
+        r->len = (int) sizeof(r->msg) - 1;
+    }
+
+    if (mpsc_queue_push(q, r)) {
+        uv_sem_post(&async_log.wakeup);
+    }
+}
+
+void ziti_logger(int level, const char *module, const char *file, unsigned int line, const char *func, FORMAT_STRING(const char *fmt), ...) {
+    log_writer logfunc = logger;
+    if (logfunc == NULL) { return; }
+
+    mpsc_queue_t *q = atomic_load_explicit(&async_log.queue, memory_order_acquire);
+    if (q) {
+        va_list argp;
+        va_start(argp, fmt);
+        async_log_submit(q, level, module, file, line, func, fmt, argp);
+        va_end(argp);
+        return;
+    }
+
+    char location[128];
+    format_location(location, sizeof(location), module, file, line, func);
+
     va_list argp;
     va_start(argp, fmt);
     int len = vsnprintf(log_buf, sizeof(log_buf), fmt, argp);
@@ -373,6 +475,101 @@ void ziti_logger(int level, const char *module, const char *file, unsigned int l
     logfunc(level, location, log_buf, len);
 }
 
+static void write_record(void *elem, void *ctx) {
+    struct log_record *r = elem;
+    log_writer logfunc = logger;
+    if (logfunc == NULL) { return; }
+
+    char location[128];
+    format_location(location, sizeof(location), r->module, r->file, r->line, r->func);
+
+    log_record_ts = r->ts;
+    logfunc(r->level, location, r->msg, (size_t) r->len);
+    log_record_ts = 0;
+}
+
+static void async_log_flush(mpsc_queue_t *q) {
+    while (mpsc_queue_drain(q, write_record, NULL) > 0) {}
+
+    uint64_t dropped = atomic_load_explicit(&async_log.dropped, memory_order_relaxed);
+    if (dropped != async_log.reported && logger) {
+        char location[128];
+        char msg[64];
+        format_location(location, sizeof(location), ZITI_LOG_MODULE, __FILENAME__, __LINE__, __func__);
+        int len = snprintf(msg, sizeof(msg), "%" PRIu64 " log messages dropped", dropped - async_log.reported);
+        async_log.reported = dropped;
+        logger(WARN, location, msg, (size_t) len);
+    }
+
+    if (logger == default_log_writer) {
+        fflush(ziti_debug_out);
+    }
+}
+
+static void async_log_writer(void *arg) {
+    mpsc_queue_t *q = arg;
+    while (atomic_load(&async_log.running)) {
+        uv_sem_wait(&async_log.wakeup);
+        async_log_flush(q);
+    }
+}
+
+static void async_log_stop(bool release) {
+    mpsc_queue_t *q = atomic_exchange(&async_log.queue, NULL);
+    if (q == NULL) return;
+
+    atomic_store(&async_log.running, false);
+    uv_sem_post(&async_log.wakeup);
+    uv_thread_join(&async_log.writer);
+
+    // pick up anything that got in after the writer's last batch
+    async_log_flush(q);
+    if (release) {
+        uv_sem_destroy(&async_log.wakeup);
+        mpsc_queue_free(q);
+    }
+}
+
+// loop threads may still be logging into the queue while the process exits,
+// flush it but leave the memory to the OS
+static void async_log_exit(void) {
+    async_log_stop(false);
+}
+
+int ziti_log_set_async(size_t capacity) {
+    static bool exit_registered = false;
+
+    async_log_stop(true);
+    if (capacity == 0) {
+        return ZITI_OK;
+    }
+
+    mpsc_queue_t *q = mpsc_queue_new(sizeof(struct log_record), capacity);
+    if (q == NULL) {
+        return ZITI_ALLOC_FAILED;
+    }
+
+    uv_sem_init(&async_log.wakeup, 0);
+    atomic_store(&async_log.running, true);
+    if (uv_thread_create(&async_log.writer, async_log_writer, q) != 0) {
+        atomic_store(&async_log.running, false);
+        uv_sem_destroy(&async_log.wakeup);
+        mpsc_queue_free(q);
+        return ZITI_INVALID_STATE;
+    }
+    atomic_store_explicit(&async_log.queue, q, memory_order_release);
+
+    if (!exit_registered) {
+        exit_registered = true;
+        atexit(async_log_exit);
+    }
+    return ZITI_OK;
+}
+
+uint64_t ziti_log_dropped(void) {
+    return atomic_load_explicit(&async_log.dropped, memory_order_relaxed);
+}
+
 static void default_log_writer(int level, const char *loc, const char *msg, size_t msglen) {
     const char *elapsed = get_elapsed();
     fprintf(ziti_debug_out, "(%u)[%s] %7s %s %.*s\n", log_pid, elapsed, level_labels[level], loc, (unsigned int) msglen, msg);
@@ -383,8 +580,8 @@ void tlsuv_logger(int level, const char *file, unsigned int line, const char *ms
 }
 
 static const char *get_elapsed_time() {
-    uint64_t now = uv_now(ts_loop);
-    if (now > last_update) {
+    uint64_t now = log_record_ts ? log_record_ts : uv_now(ts_loop);
+    if (now != last_update) {
         last_update = now;
         unsigned long long elapsed = now - starttime;
         snprintf(log_timestamp, sizeof(log_timestamp), "%9llu.%03llu", (elapsed / 1000), (elapsed % 1000));
@@ -394,11 +591,17 @@ static const char *get_elapsed_time() {
 
 static const char *get_utc_time() {
     uint64_t now = uv_now(ts_loop);
-    if (now > last_update) {
+    uint64_t lag = log_record_ts && log_record_ts < now ? now - log_record_ts : 0;
+    now -= lag;
+    if (now != last_update) {
         last_update = now;
 
         uv_timeval64_t ts;
         uv_gettimeofday(&ts);
+        // queued record: shift wall clock back by the time it spent in the queue
+        int64_t usec = ts.tv_sec * 1000000 + ts.tv_usec - (int64_t) lag * 1000;
+        ts.tv_sec = usec / 1000000;
+        ts.tv_usec = (int32_t) (usec % 1000000);
         time_t t = ts.tv_sec;
         struct tm *tm = gmtime(&t);
 
@@ -462,7 +665,7 @@ void ziti_fmt_time(char* time_str, size_t time_str_sz, uv_timeval64_t* tv) {
 void hexify(const uint8_t *bin, size_t bin_len, char sep, char **buf) {
     static char hex[] = "0123456789abcdef";
     size_t out_size = sep ? bin_len * 3 : bin_len * 2 + 1;
-    char *out = malloc(out_size);
+    char *out = ziti_malloc(out_size);
     char *p = out;
     for (int i = 0; i < bin_len; i++) {
         unsigned char b = bin[i];
@@ -484,11 +687,11 @@ size_t str_split(const char *str, const char *delim, model_list *result) {
             char *val;
             if ((sep = strpbrk(s, delim)) != NULL) {
                 size_t tok_len = sep++ - s;
-                val = calloc(1, tok_len + 1);
+                val = ziti_calloc(1, tok_len + 1);
                 strncpy(val, s, tok_len);
             }
             else {
-                val = strdup(s);
+                val = ziti_strdup(s);
             }
             model_list_append(result, val);
             count++;
@@ -536,7 +739,7 @@ static int parse_pkcs11_uri(const char *keyuri, tls_context *tls, void *ctx, par
             }
 
             rc = cb(tls, ctx, lib, slot, pin, id, label);
-            model_list_clear(&opts, free);
+            model_list_clear(&opts, ziti_free);
             return rc;
         }
     }
@@ -655,7 +858,7 @@ int load_file(const char *path, size_t pathlen, char **content, size_t *size) {
     }
 
     if (content_buf == NULL) {
-        content_buf = malloc(content_len + 1);
+        content_buf = ziti_malloc(content_len + 1);
     }
 
     size_t read = 0;
@@ -44,6 +44,7 @@
 #endif
 
 #define ONE_DAY (60 * 60 * 24)
+#define ZTX_WORK_QUEUE_SIZE 64
 
 #define ztx_controller(ztx) \
 ((ztx)->ctrl.url ? (ztx)->ctrl.url : (ztx)->config.controller_url)
@@ -59,7 +60,7 @@ static void ziti_init_async(ziti_context ztx, void *data);
 
 static void ziti_re_auth(ziti_context ztx);
 
-static void ztx_prepare(uv_prepare_t *prep);
+void ztx_prepare(uv_prepare_t *prep);
 static void grim_reaper(ziti_context ztx);
 
 static void ztx_work_async(uv_async_t *ar);
@@ -83,6 +84,10 @@ static void ztx_config_update(ziti_context ztx);
 
 static void api_session_cb(ziti_api_session *, const ziti_error *, void *);
 
+static void process_services(ziti_context ztx, ziti_service_array services, const model_map *listed);
+
+static void ztx_resume_waiting(ziti_context ztx);
+
 static volatile uint32_t ztx_seq;
 
 struct ztx_req_s {
@@ -271,6 +276,12 @@ void ziti_set_impossible_to_authenticate(ziti_context ztx, const ziti_error *err
     ZTX_LOG(DEBUG, "setting api_session_state[%d] to %d", ztx->auth_state, ZitiAuthImpossibleToAuthenticate);
     FREE(ztx->session_token);
     ziti_ctrl_clear_api_session(ztx_get_controller(ztx));
+
+    // optimistic dials cannot proceed, let them fail
+    if (ztx->warm_start) {
+        ztx->warm_start = false;
+        ztx_resume_waiting(ztx);
+    }
     ziti_send_event(ztx, &(ziti_event_t){
         .type = ZitiContextEvent,
         .ctx = (struct ziti_context_event){
@@ -356,10 +367,10 @@ static void ctrl_list_cb(ziti_controller_detail_array ctrls, const ziti_error *e
             if (old_url == NULL) {
                 changed = true;
             } else {
-                free(old_url);
+                ziti_free(old_url);
             }
 
-            model_list_append(&ztx->config.controllers, strdup(edge_api->url));
+            model_list_append(&ztx->config.controllers, ziti_strdup(edge_api->url));
         } else {
             ZTX_LOG(INFO, "controller[%s/%s]: no Edge API", detail->name, detail->id);
             free_ziti_controller_detail_ptr(detail);
@@ -371,9 +382,9 @@ static void ctrl_list_cb(ziti_controller_detail_array ctrls, const ziti_error *e
         ztx_config_update(ztx);
     }
 
-    model_map_clear(&diff, free);
+    model_map_clear(&diff, ziti_free);
     model_map_clear(&old_details, (void (*)(void *)) free_ziti_controller_detail_ptr);
-    free(ctrls);
+    ziti_free(ctrls);
 }
 
 void ziti_set_fully_authenticated(ziti_context ztx, const char *session_token) {
@@ -383,8 +394,8 @@ void ziti_set_fully_authenticated(ziti_context ztx, const char *session_token) {
     ztx->auth_state = ZitiAuthStateFullyAuthenticated;
 
     if (ztx->session_token == NULL || strcmp(ztx->session_token, session_token) != 0) {
-        free(ztx->session_token);
-        ztx->session_token = strdup(session_token);
+        ziti_free(ztx->session_token);
+        ztx->session_token = ziti_strdup(session_token);
     }
     ziti_controller *ctrl = ztx_get_controller(ztx);
     if (ztx->auth_method->kind == HA) {
@@ -401,6 +412,16 @@ void ziti_set_fully_authenticated(ziti_context ztx, const char *session_token) {
     ziti_ctrl_current_api_session(ctrl, api_session_cb, ztx);
     ziti_ctrl_current_identity(ctrl, update_identity_data, ztx);
 
+    if (ztx->warm_start) {
+        // channels restored from cache were waiting for the token
+        const char *er_name;
+        ziti_channel_t *ch;
+        MODEL_MAP_FOREACH(er_name, ch, &ztx->channels) {
+            ziti_channel_force_connect(ch);
+        }
+        ztx_resume_waiting(ztx);
+    }
+
     tlsuv_private_key_t pk;
     if (ztx->id_creds.key == NULL) {
         if (ztx->session_creds.key == NULL) {
@@ -419,11 +440,16 @@ void ziti_set_fully_authenticated(ziti_context ztx, const char *session_token) {
 
         ZTX_LOG(DEBUG, "creating session CSR with CN=%s", common_name);
         size_t csr_len;
-        int rc = ztx->tlsCtx->generate_csr_to_pem(pk, &ztx->sessionCsr, &csr_len,
+        char *csr = NULL;
+        int rc = ztx->tlsCtx->generate_csr_to_pem(pk, &csr, &csr_len,
                                                   "O", "OpenZiti",
                                                   "OU", "ziti-sdk",
                                                   "CN", common_name,
                                                   NULL);
+        if (rc == 0) {
+            ztx->sessionCsr = ziti_strndup(csr, csr_len);
+            free(csr); // allocated by tlsuv
+        }
         if (rc != 0) {
             ZTX_LOG(ERROR, "failed to generate CSR for session cert");
         } else {
@@ -449,10 +475,25 @@ const char* ziti_get_api_session_token(ziti_context ztx) {
     return NULL;
 }
 
+static void rates_tick_cb(void *ctx) {
+    ziti_context ztx = ctx;
+    uint64_t now = uv_now(ztx->loop);
+    metrics_rate_tick(&ztx->up_rate, now);
+    metrics_rate_tick(&ztx->down_rate, now);
+    ztx_set_deadline(ztx, metrics_tick_interval(), &ztx->rates_deadline, rates_tick_cb, ztx);
+}
+
 static void ziti_stop_internal(ziti_context ztx, void *data) {
     if (ztx->enabled) {
         ZTX_LOG(INFO, "disabling Ziti Context");
 
+        // flush pending cache update before state is cleared
+        if (ztx->cache_deadline.expire_cb) {
+            ztx_cache_save(ztx);
+        }
+        ztx->warm_start = false;
+
+        clear_deadline(&ztx->rates_deadline);
         metrics_rate_close(&ztx->up_rate);
         metrics_rate_close(&ztx->down_rate);
 
@@ -474,11 +515,12 @@ static void ziti_stop_internal(ziti_context ztx, void *data) {
         ziti_close_channels(ztx, ZITI_DISABLED);
 
         FREE(ztx->last_update);
+        ziti_ctrl_reset_services_etag(ztx_get_controller(ztx));
         const char *svc_name;
         ziti_service *svc;
         ziti_event_t ev = {0};
         ev.type = ZitiServiceEvent;
-        ev.service.removed = calloc(model_map_size(&ztx->services) + 1, sizeof(ziti_service *));
+        ev.service.removed = ziti_calloc(model_map_size(&ztx->services) + 1, sizeof(ziti_service *));
         int idx = 0;
         model_map_iter it = model_map_iterator(&ztx->services);
         while (it) {
@@ -492,7 +534,7 @@ static void ziti_stop_internal(ziti_context ztx, void *data) {
         }
 
         if (ztx->ext_auth) {
-            oidc_client_close(ztx->ext_auth, (oidc_close_cb) free);
+            oidc_client_close(ztx->ext_auth, (oidc_close_cb) ziti_free);
             ztx->ext_auth = NULL;
         }
 
@@ -507,6 +549,38 @@ static void ziti_stop_internal(ziti_context ztx, void *data) {
     }
 }
 
+static void ztx_merge_controllers(ziti_context ztx, model_list *cached) {
+    const char *url;
+    MODEL_LIST_FOREACH(url, *cached) {
+        bool found = false;
+        const char *u;
+        MODEL_LIST_FOREACH(u, ztx->config.controllers) {
+            if (strcasecmp(u, url) == 0) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            model_list_append(&ztx->config.controllers, ziti_strdup(url));
+        }
+    }
+}
+
+// start from last known state: services are published and router channels created right away,
+// dials are queued until authentication completes and controller data reconciles the state
+static void ztx_warm_start(ziti_context ztx, ziti_bootstrap_cache *cache) {
+    ztx->warm_start = true;
+
+    if (cache->services) {
+        process_services(ztx, cache->services, NULL);
+        cache->services = NULL;
+    }
+
+    for (int i = 0; cache->edge_routers && cache->edge_routers[i] != NULL; i++) {
+        ziti_channel_connect(ztx, cache->edge_routers[i]);
+    }
+}
+
 static void ziti_start_internal(ziti_context ztx, void *init_req) {
     if (!ztx->enabled) {
         ZTX_LOG(INFO, "enabling Ziti Context");
@@ -528,15 +602,28 @@ static void ziti_start_internal(ziti_context ztx, void *init_req) {
         ZTX_LOG(INFO, "using tlsuv[%s/%s]", tlsuv_version(),
                 ztx->tlsCtx->version ? ztx->tlsCtx->version() : "unspecified");
 
+        ziti_bootstrap_cache cache = {0};
+        bool warm = ztx_cache_load(ztx, &cache) == ZITI_OK;
+        if (warm) {
+            ztx_merge_controllers(ztx, &cache.controllers);
+        }
+
         rc = ztx_init_controller(ztx);
         if (rc != ZITI_OK) {
+            free_ziti_bootstrap_cache(&cache);
             ztx->enabled = false;
             return;
         }
 
+        if (warm) {
+            ztx_warm_start(ztx, &cache);
+        }
+        free_ziti_bootstrap_cache(&cache);
+
         ZTX_LOG(DEBUG, "using metrics interval: %d", (int) ztx->opts.metrics_type);
         metrics_rate_init(&ztx->up_rate, ztx->opts.metrics_type);
         metrics_rate_init(&ztx->down_rate, ztx->opts.metrics_type);
+        ztx_set_deadline(ztx, metrics_tick_interval(), &ztx->rates_deadline, rates_tick_cb, ztx);
 
         uv_prepare_start(&ztx->prepper, ztx_prepare);
         ztx->start = uv_now(ztx->loop);
@@ -549,7 +636,7 @@ static void ziti_start_internal(ziti_context ztx, void *init_req) {
 static void on_ctrl_list_change(ziti_context ztx, const model_map *endpoints) {
     if (ztx->opts.event_cb && (ztx->opts.events & ZitiContextEvent)) {
         size_t count = model_map_size(endpoints);
-        struct ctrl_detail_s *details = (count > 0) ? calloc(count, sizeof(struct ctrl_detail_s)) : NULL;
+        struct ctrl_detail_s *details = (count > 0) ? ziti_calloc(count, sizeof(struct ctrl_detail_s)) : NULL;
         size_t idx = 0;
         const char *url;
         ziti_controller_detail *d;
@@ -568,7 +655,7 @@ static void on_ctrl_list_change(ziti_context ztx, const model_map *endpoints) {
             },
         });
 
-        free(details);
+        ziti_free(details);
     }
 }
 
@@ -580,12 +667,12 @@ static void on_ctrl_redirect(const char *new_addr, void *ctx) {
         char *addr = (char*)model_list_it_element(it);
         if (strcasecmp(addr, ztx->config.controller_url) == 0) {
             it = model_list_it_remove(it);
-            free(addr);
+            ziti_free(addr);
         }
     }
     FREE(ztx->config.controller_url);
-    ztx->config.controller_url = strdup(new_addr);
-    model_list_append(&ztx->config.controllers, strdup(new_addr));
+    ztx->config.controller_url = ziti_strdup(new_addr);
+    model_list_append(&ztx->config.controllers, ziti_strdup(new_addr));
     
     ztx_config_update(ztx);
 }
@@ -609,6 +696,9 @@ static int ztx_init_controller(ziti_context ztx) {
     if (ztx->opts.api_page_size != 0) {
         ziti_ctrl_set_page_size(ztx_get_controller(ztx), ztx->opts.api_page_size);
     }
+    if (ztx->opts.api_max_page_size != 0) {
+        ziti_ctrl_set_max_page_size(ztx_get_controller(ztx), ztx->opts.api_max_page_size);
+    }
     return 0;
 }
 
@@ -620,6 +710,7 @@ static void ziti_init_async(ziti_context ztx, void *data) {
     uv_unref((uv_handle_t *) &ztx->prepper);
 
     metrics_init(5, (time_fn)uv_now, loop);
+    loop_monitor_start(ztx);
 
     if (!ztx->opts.disabled) {
         ziti_start_internal(ztx, NULL);
@@ -662,9 +753,9 @@ static void ext_jwt_singers_cb(ziti_jwt_signer_array signers, const ziti_error *
 
         ZTX_LOG(DEBUG, "%zd external auth providers available", model_map_size(&ztx->ext_signers));
         CALL_CB(cb, ztx, ZITI_OK, signers, req->cb_ctx);
-        free(signers);
+        ziti_free(signers);
     }
-    free(req);
+    ziti_free(req);
 }
 
 int ziti_get_ext_jwt_signers(ziti_context ztx, ziti_ext_signers_cb cb, void *ctx) {
@@ -699,7 +790,7 @@ int ziti_use_ext_jwt_signer(ziti_context ztx, const char *name) {
 
     if (ztx->ext_auth) {
         ZTX_LOG(INFO, "clearing up previous OIDC provider");
-        oidc_client_close(ztx->ext_auth, (oidc_close_cb) free);
+        oidc_client_close(ztx->ext_auth, (oidc_close_cb) ziti_free);
         ztx->ext_auth = NULL;
     }
 
@@ -736,6 +827,81 @@ int ziti_get_transfer_rates(ziti_context ztx, double *up, double *down) {
     return metrics_rate_get(&ztx->up_rate, up) || metrics_rate_get(&ztx->down_rate, down);
 }
 
+static void alloc_metrics_update(ziti_context ztx) {
+    for (ziti_alloc_tag tag = 0; tag < ziti_alloc_tags; tag++) {
+        int64_t live;
+        uint64_t count;
+        if (!ziti_alloc_stats(tag, &live, &count)) {
+            return;
+        }
+
+        const char *subsystem = ziti_alloc_tag_name(tag);
+        metric_set(metrics_get(ztx->metrics, ziti_metric_gauge, "alloc_live_bytes",
+                               "subsystem", subsystem, NULL, NULL), live);
+        metric_set(metrics_get(ztx->metrics, ziti_metric_counter, "allocations",
+                               "subsystem", subsystem, NULL, NULL), (int64_t) count);
+    }
+}
+
+int ziti_get_metrics(ziti_context ztx, ziti_metrics_snapshot *snapshot) {
+    if (ztx == NULL || snapshot == NULL) return ZITI_INVALID_STATE;
+
+    alloc_metrics_update(ztx);
+
+    return metrics_snapshot(ztx->metrics, snapshot) == 0 ? ZITI_OK : ZITI_INVALID_STATE;
+}
+
+int ziti_metrics_write(ziti_context ztx, ziti_metrics_format format,
+                       int (*printer)(void *ctx, const char *fmt, ...), void *ctx) {
+    if (ztx == NULL || printer == NULL) return ZITI_INVALID_STATE;
+
+    alloc_metrics_update(ztx);
+    metrics_write(ztx->metrics, format, printer, ctx);
+
+    double up = 0, down = 0;
+    metrics_rate_get(&ztx->up_rate, &up);
+    metrics_rate_get(&ztx->down_rate, &down);
+    metrics_write_type(printer, ctx, "transfer_rate_bytes", ziti_metric_gauge);
+    metrics_write_sample(printer, ctx, format, "transfer_rate_bytes", ziti_metric_gauge, "direction", "up", up);
+    metrics_write_sample(printer, ctx, format, "transfer_rate_bytes", ziti_metric_gauge, "direction", "down", down);
+
+    metrics_write_type(printer, ctx, "connections", ziti_metric_gauge);
+    metrics_write_sample(printer, ctx, format, "connections", ziti_metric_gauge, NULL, NULL,
+                         (double) model_map_size(&ztx->connections));
+
+    if (model_map_size(&ztx->channels) > 0) {
+        const char *er;
+        ziti_channel_t *ch;
+        metrics_write_type(printer, ctx, "channel_latency_ms", ziti_metric_gauge);
+        MODEL_MAP_FOREACH(er, ch, &ztx->channels) {
+            metrics_write_sample(printer, ctx, format, "channel_latency_ms", ziti_metric_gauge,
+                                 "router", er, (double) ch->latency);
+        }
+        metrics_write_type(printer, ctx, "channel_queue_messages", ziti_metric_gauge);
+        MODEL_MAP_FOREACH(er, ch, &ztx->channels) {
+            metrics_write_sample(printer, ctx, format, "channel_queue_messages", ziti_metric_gauge,
+                                 "router", er, (double) ch->out_q);
+        }
+        metrics_write_type(printer, ctx, "channel_queue_bytes", ziti_metric_gauge);
+        MODEL_MAP_FOREACH(er, ch, &ztx->channels) {
+            metrics_write_sample(printer, ctx, format, "channel_queue_bytes", ziti_metric_gauge,
+                                 "router", er, (double) ch->out_q_bytes);
+        }
+    }
+
+    metrics_write_type(printer, ctx, "controller_requests", ziti_metric_counter);
+    metrics_write_sample(printer, ctx, format, "controller_requests", ziti_metric_counter, NULL, NULL,
+                         (double) ztx->ctrl.req_count);
+    metrics_write_type(printer, ctx, "controller_requests_coalesced", ziti_metric_counter);
+    metrics_write_sample(printer, ctx, format, "controller_requests_coalesced", ziti_metric_counter, NULL, NULL,
+                         (double) ztx->ctrl.coalesced_count);
+
+    if (format == ziti_metrics_openmetrics) {
+        printer(ctx, "# EOF\n");
+    }
+    return ZITI_OK;
+}
+
 static void free_ztx(uv_handle_t *h) {
     ziti_context ztx = h->data;
 
@@ -744,7 +910,12 @@ static void free_ztx(uv_handle_t *h) {
     ziti_auth_query_free(ztx->auth_queries);
     ziti_posture_checks_free(ztx->posture_checks);
     model_map_clear(&ztx->services, (_free_f) free_ziti_service_ptr);
+    model_map_clear(&ztx->service_fps, ziti_free);
+    model_map_clear(&ztx->pending_fps, ziti_free);
     model_map_clear(&ztx->sessions, (_free_f) free_ziti_session_ptr);
+    model_list_clear(&ztx->dial_mru, ziti_free);
+    metrics_registry_free(ztx->metrics);
+    ztx->metrics = NULL;
     ziti_set_unauthenticated(ztx, NULL);
     free_ziti_identity_data(ztx->identity_data);
     FREE(ztx->identity_data);
@@ -761,6 +932,7 @@ static void free_ztx(uv_handle_t *h) {
     }
 
     free_ziti_config(&ztx->config);
+    mpsc_queue_free(ztx->w_queue);
 
     ziti_event_t ev = {0};
     ev.type = ZitiContextEvent;
@@ -771,7 +943,7 @@ static void free_ztx(uv_handle_t *h) {
 
 
     ZTX_LOG(INFO, "shutdown is complete\n");
-    free(ztx);
+    ziti_free(ztx);
 }
 
 static void shutdown_and_free(ziti_context ztx) {
@@ -792,6 +964,7 @@ static void shutdown_and_free(ziti_context ztx) {
     uv_close((uv_handle_t *) &ztx->w_async, free_ztx);
     uv_close((uv_handle_t *)&ztx->deadline_timer, NULL);
     uv_close((uv_handle_t *)&ztx->prepper, NULL);
+    loop_monitor_stop(ztx);
 }
 
 int ziti_shutdown(ziti_context ztx) {
@@ -864,6 +1037,8 @@ void ziti_dump(ziti_context ztx, int (*printer)(void *arg, const char *fmt, ...)
             printer(ctx, "\t%s: online[%c] %s\n", detail->id, detail->is_online ? 'Y' : 'N', url);
         }
     }
+    printer(ctx, "Single-flight requests:\t%lu (%lu coalesced)\n",
+            ztx->ctrl.req_count, ztx->ctrl.coalesced_count);
     printer(ctx, "Config types:\n");
     for (int i = 0; ztx->opts.config_types && ztx->opts.config_types[i]; i++) {
         printer(ctx, "\t%s\n", ztx->opts.config_types[i]);
@@ -994,6 +1169,117 @@ void ziti_dump(ziti_context ztx, int (*printer)(void *arg, const char *fmt, ...)
     printer(ctx, "\n==================\n\n");
 }
 
+static void json_string(string_buf_t *out, const char *str) {
+    if (str == NULL) {
+        string_buf_append(out, "null");
+        return;
+    }
+
+    string_buf_append_byte(out, '"');
+    for (const char *p = str; *p; p++) {
+        unsigned char c = (unsigned char) *p;
+        if (c == '"' || c == '\\') {
+            string_buf_append_byte(out, '\\');
+            string_buf_append_byte(out, (char) c);
+        } else if (c < 0x20) {
+            string_buf_fmt(out, "\\u%04x", c);
+        } else {
+            string_buf_append_byte(out, (char) c);
+        }
+    }
+    string_buf_append_byte(out, '"');
+}
+
+static void json_conn(string_buf_t *out, ziti_connection conn, ziti_connection parent, uint64_t now) {
+    string_buf_fmt(out, "{\"id\":%u,\"marker\":", conn->conn_id);
+    json_string(out, conn->marker);
+    string_buf_fmt(out, ",\"type\":\"%s\",\"parent\":", parent ? "accepted" : "transport");
+    if (parent) {
+        string_buf_fmt(out, "%u", parent->conn_id);
+    } else {
+        string_buf_append(out, "null");
+    }
+    string_buf_append(out, ",\"service\":");
+    json_string(out, conn->service);
+    string_buf_fmt(out, ",\"state\":\"%s\",\"channel\":%d", ziti_conn_state(conn), FIELD_OR_ELSE(conn->channel, id, -1));
+    string_buf_fmt(out, ",\"age_ms\":%" PRIu64 ",\"idle_ms\":%" PRIu64
+                        ",\"sent\":%" PRIu64 ",\"received\":%" PRIu64 ",\"inbound_bytes\":%zu}",
+                   conn->start ? now - conn->start : 0, now - conn->last_activity,
+                   conn->sent, conn->received, buffer_available(conn->inbound));
+}
+
+int ziti_dump_json(ziti_context ztx, string_buf_t *out) {
+    if (ztx == NULL || out == NULL) return ZITI_INVALID_STATE;
+
+    uint64_t now = uv_now(ztx->loop);
+    bool enabled = ziti_is_enabled(ztx);
+    string_buf_fmt(out, "{\"id\":%u,\"enabled\":%s,\"uptime_ms\":%" PRIu64 ",\"identity\":",
+                   ztx->id, enabled ? "true" : "false", enabled ? now - ztx->start : 0);
+    if (ztx->identity_data) {
+        string_buf_append(out, "{\"name\":");
+        json_string(out, ztx->identity_data->name);
+        string_buf_append(out, ",\"id\":");
+        json_string(out, ztx->identity_data->id);
+        string_buf_append_byte(out, '}');
+    } else {
+        string_buf_append(out, "null");
+    }
+
+    string_buf_append(out, ",\"controller\":{\"url\":");
+    json_string(out, ztx_controller(ztx));
+    string_buf_append(out, ",\"version\":");
+    json_string(out, ztx->ctrl.version.version);
+    string_buf_fmt(out, ",\"ha\":%s,\"requests\":%lu,\"coalesced\":%lu}",
+                   ztx->ctrl.is_ha ? "true" : "false", ztx->ctrl.req_count, ztx->ctrl.coalesced_count);
+
+    string_buf_fmt(out, ",\"services\":%zu,\"sessions\":%zu",
+                   model_map_size(&ztx->services), model_map_size(&ztx->sessions));
+
+    string_buf_append(out, ",\"channels\":[");
+    const char *er;
+    ziti_channel_t *ch;
+    bool first = true;
+    MODEL_MAP_FOREACH(er, ch, &ztx->channels) {
+        string_buf_fmt(out, "%s{\"id\":%u,\"name\":", first ? "" : ",", ch->id);
+        json_string(out, ch->name);
+        string_buf_append(out, ",\"url\":");
+        json_string(out, ch->url);
+        string_buf_append(out, ",\"version\":");
+        json_string(out, ch->version);
+        string_buf_fmt(out, ",\"connected\":%s,\"latency_ms\":%" PRIu64
+                            ",\"out_q\":%zu,\"out_q_bytes\":%zu,\"pool_in_use\":%zu,\"pool_capacity\":%zu"
+                            ",\"reconnects\":%u}",
+                       ziti_channel_is_connected(ch) ? "true" : "false", ch->latency,
+                       ch->out_q, ch->out_q_bytes, pool_in_use(ch->in_msg_pool), pool_capacity(ch->in_msg_pool),
+                       ch->reconnect_count);
+        first = false;
+    }
+
+    string_buf_append(out, "],\"connections\":[");
+    const char *id;
+    ziti_connection conn;
+    first = true;
+    MODEL_MAP_FOREACH(id, conn, &ztx->connections) {
+        if (conn->type == Transport && conn->parent == NULL) {
+            if (!first) string_buf_append_byte(out, ',');
+            json_conn(out, conn, NULL, now);
+            first = false;
+        }
+
+        if (conn->type == Server) {
+            model_map_iter it = model_map_iterator(&conn->server.children);
+            while (it != NULL) {
+                if (!first) string_buf_append_byte(out, ',');
+                json_conn(out, model_map_it_value(it), conn, now);
+                first = false;
+                it = model_map_it_next(it);
+            }
+        }
+    }
+    string_buf_append(out, "]}");
+    return ZITI_OK;
+}
+
 int ziti_conn_init(ziti_context ztx, ziti_connection *conn, void *data) {
     struct ziti_ctx *ctx = ztx;
     NEWP(c, struct ziti_conn);
@@ -1023,12 +1309,15 @@ const char *ziti_conn_source_identity(ziti_connection conn) {
 
 
 void ziti_send_event(ziti_context ztx, const ziti_event_t *e) {
-    if (ztx->opts.events & e->type) {
-        CALL_CB(ztx->opts.event_cb, ztx, e);
+    if ((ztx->opts.events & e->type) && ztx->opts.event_cb) {
+        uint64_t start = ztx_cb_start(ztx);
+        ztx->opts.event_cb(ztx, e);
+        ztx_cb_done(ztx, ztx_event_cb, (void *) ztx->opts.event_cb, start);
     }
 }
 
 void ztx_config_update(ziti_context ztx) {
+    ztx_cache_update(ztx);
     ziti_send_event(ztx, &(ziti_event_t){
             .type = ZitiConfigEvent,
             .cfg = {
@@ -1064,7 +1353,7 @@ static void service_cb(ziti_service *s, const ziti_error *err, void *ctx) {
     }
 
     CALL_CB((ziti_service_cb)req->cb, req->ztx, s, rc, req->cb_ctx);
-    free(req);
+    ziti_free(req);
 }
 
 int ziti_service_available(ziti_context ztx, const char *service, ziti_service_cb cb, void *ctx) {
@@ -1090,7 +1379,7 @@ static void term_cb(ziti_terminator_array terminators, const ziti_error *err, vo
     CALL_CB((ziti_terminator_cb)r->cb, r->ztx, (const ziti_terminator * const *) terminators,
             err ? err->err : ZITI_OK, r->cb_ctx);
     free_ziti_terminator_array(&terminators);
-    free(r);
+    ziti_free(r);
 }
 
 static void term_srv_cb(ziti_context ztx, const ziti_service *s, int err, void *ctx) {
@@ -1098,7 +1387,7 @@ static void term_srv_cb(ziti_context ztx, const ziti_service *s, int err, void *
     if (err || s == NULL) {
         CALL_CB((ziti_terminator_cb)req->cb, req->ztx, NULL,
                 err ? err : ZITI_SERVICE_UNAVAILABLE , req->cb_ctx);
-        free(req);
+        ziti_free(req);
         return;
     }
 
@@ -1192,7 +1481,7 @@ static void set_posture_query_defaults(ziti_service *service) {
             //if the controller doesn't support
             if (service->posture_query_set[posture_set_idx]->posture_queries[posture_query_idx]->timeoutRemaining == NULL) {
                 //free done by model_free
-                model_number *timeoutRemaining = calloc(1, sizeof(*timeoutRemaining));
+                model_number *timeoutRemaining = ziti_calloc(1, sizeof(*timeoutRemaining));
                 *timeoutRemaining = -1;
                 service->posture_query_set[posture_set_idx]->posture_queries[posture_query_idx]->timeoutRemaining = timeoutRemaining;
             }
@@ -1290,6 +1579,10 @@ static void update_services(ziti_service_array services, const ziti_error *error
     ziti_services_refresh(ztx, false);
 
     if (error) {
+        model_map_clear(&ztx->pending_fps, ziti_free);
+        // list was not applied: next poll fetches it again
+        FREE(ztx->last_update);
+        ziti_ctrl_reset_services_etag(ztx_get_controller(ztx));
         ZTX_LOG(ERROR, "failed to get service updates err[%s/%s] from ctrl[%s]", error->code, error->message,
                 ztx_controller(ztx));
         if (error->err == ZITI_AUTHENTICATION_FAILED) {
@@ -1299,14 +1592,28 @@ static void update_services(ziti_service_array services, const ziti_error *error
             ZTX_LOG(VERBOSE, "api session partially authenticated, waiting for api session state change");
             return;
         } else {
-            FREE(ztx->last_update);
             update_ctrl_status(ztx, ZITI_CONTROLLER_UNAVAILABLE, error->message);
         }
         return;
     }
     update_ctrl_status(ztx, ZITI_OK, NULL);
 
+    process_services(ztx, services, &ztx->pending_fps);
+    ziti_ctrl_commit_services_etag(ztx_get_controller(ztx));
+
+    // fingerprints now describe the current list
+    model_map_clear(&ztx->service_fps, ziti_free);
+    ztx->service_fps = ztx->pending_fps;
+    ztx->pending_fps = (model_map){0};
+
+    // controller data replaced cached services
+    ztx->warm_start = false;
+    ztx_prefetch_sessions(ztx);
+}
 
+// services skipped by the fingerprint filter are unchanged,
+// [listed] has names of all services in the list, NULL if services is the full list
+static void process_services(ziti_context ztx, ziti_service_array services, const model_map *listed) {
     ZTX_LOG(VERBOSE, "processing service updates");
 
     model_map updates = {0};
@@ -1318,16 +1625,16 @@ static void update_services(ziti_service_array services, const ziti_error *error
         set_service_posture_policy_map(services[idx]);
         model_map_set(&updates, services[idx]->name, services[idx]);
     }
-    free(services);
+    ziti_free(services);
 
     size_t current_size = model_map_size(&ztx->services);
     size_t chIdx = 0, addIdx = 0, remIdx = 0;
     ziti_event_t ev = {
             .type = ZitiServiceEvent,
             .service = {
-                    .removed = calloc(current_size + 1, sizeof(ziti_service *)),
-                    .changed = calloc(current_size + 1, sizeof(ziti_service *)),
-                    .added = calloc(idx + 1, sizeof(ziti_service *)),
+                    .removed = ziti_calloc(current_size + 1, sizeof(ziti_service *)),
+                    .changed = ziti_calloc(current_size + 1, sizeof(ziti_service *)),
+                    .added = ziti_calloc(idx + 1, sizeof(ziti_service *)),
             }
     };
 
@@ -1342,9 +1649,12 @@ static void update_services(ziti_service_array services, const ziti_error *error
             } else {
                 // no changes detected, just discard it
                 free_ziti_service(updt);
-                free(updt);
+                ziti_free(updt);
             }
 
+            it = model_map_it_next(it);
+        } else if (listed && model_map_get(listed, model_map_it_key(it))) {
+            // fingerprint unchanged: was not parsed
             it = model_map_it_next(it);
         } else {
             // service was removed
@@ -1355,7 +1665,7 @@ static void update_services(ziti_service_array services, const ziti_error *error
             ziti_session *session = model_map_remove(&ztx->sessions, s->id);
             if (session) {
                 free_ziti_session(session);
-                free(session);
+                ziti_free(session);
             }
             it = model_map_it_remove(it);
         }
@@ -1392,6 +1702,7 @@ static void update_services(ziti_service_array services, const ziti_error *error
                 ztx->services_loaded ? "false" : "true", addIdx, remIdx, chIdx);
         ziti_send_event(ztx, &ev);
         ztx->services_loaded = true;
+        ztx_cache_update(ztx);
     } else {
         ZTX_LOG(VERBOSE, "no services added, changed, or removed");
     }
@@ -1403,9 +1714,9 @@ static void update_services(ziti_service_array services, const ziti_error *error
         free_ziti_service_ptr(s);
     }
 
-    free(ev.service.removed);
-    free(ev.service.added);
-    free(ev.service.changed);
+    ziti_free(ev.service.removed);
+    ziti_free(ev.service.added);
+    ziti_free(ev.service.changed);
 
     model_map_clear(&updates, NULL);
     model_map_clear(&ztx->service_forced_updates, NULL);
@@ -1430,6 +1741,23 @@ static void set_service_posture_policy_map(ziti_service *service) {
     FREE(service->posture_query_set);
 }
 
+// parse only new services, and those whose JSON changed since the last refresh
+static bool service_changed(const char *id, const char *name, uint64_t fingerprint, void *ctx) {
+    ziti_context ztx = ctx;
+    if (name == NULL) {
+        return true;
+    }
+
+    uint64_t *fp = ziti_malloc(sizeof(*fp));
+    *fp = fingerprint;
+    ziti_free(model_map_set(&ztx->pending_fps, name, fp));
+
+    uint64_t *curr = model_map_get(&ztx->service_fps, name);
+    return fingerprint == 0 || curr == NULL || *curr != fingerprint ||
+           model_map_get(&ztx->services, name) == NULL ||
+           (id && model_map_get(&ztx->service_forced_updates, id) != NULL);
+}
+
 static void check_service_update(ziti_service_update *update, const ziti_error *err, void *ctx) {
     ziti_context ztx = ctx;
 
@@ -1440,15 +1768,21 @@ static void check_service_update(ziti_service_update *update, const ziti_error *
         if (err->err != ZITI_DISABLED) {
             ziti_services_refresh(ztx, false);
         }
+    } else if (update == NULL) {
+        ZTX_LOG(VERBOSE, "not updating: service updates not modified");
+        ziti_services_refresh(ztx, false);
     } else if (ztx->last_update == NULL || strcmp(ztx->last_update, update->last_change) != 0) {
         ZTX_LOG(VERBOSE, "ztx last_update = %s", update->last_change);
         FREE(ztx->last_update);
         ztx->last_update = (char*)update->last_change;
-        ziti_ctrl_get_services(ztx_get_controller(ztx), update_services, ztx);
+        model_map_clear(&ztx->pending_fps, ziti_free);
+        ziti_ctrl_get_services_filtered(ztx_get_controller(ztx), service_changed, update_services, ztx);
 
     } else {
         ZTX_LOG(VERBOSE, "not updating: last_update is same previous (%s == %s)", update->last_change,
                 ztx->last_update);
+        // services are current
+        ziti_ctrl_commit_services_etag(ztx_get_controller(ztx));
         free_ziti_service_update(update);
         ziti_services_refresh(ztx, false);
     }
@@ -1498,7 +1832,6 @@ static void edge_routers_cb(ziti_edge_router_array ers, const ziti_error *err, v
     }
 
     if (ztx->closing) {
-        free_ziti_edge_router_array(&ers);
         return;
     }
 
@@ -1526,12 +1859,8 @@ static void edge_routers_cb(ziti_edge_router_array ers, const ziti_error *err, v
             ch = model_map_get(&ztx->channels, er->name);
             ziti_channel_set_url(ch, er->protocols.tls);
         }
-
-        free_ziti_edge_router(er);
-        free(er);
         erp++;
     }
-    free(ers);
 
     model_map_iter it = model_map_iterator(&curr_routers);
     while (it != NULL) {
@@ -1556,6 +1885,9 @@ static void edge_routers_cb(ziti_edge_router_array ers, const ziti_error *err, v
         MODEL_MAP_FOREACH(serv, session, &ztx->sessions) {
             session->refresh = true;
         }
+        // prefetched sessions are refreshed now, rest on the next dial
+        ztx_prefetch_sessions(ztx);
+        ztx_cache_update(ztx);
     }
 }
 
@@ -1627,10 +1959,9 @@ static void ca_bundle_cb(char *pkcs7, const ziti_error *err, void *ctx) {
         if (ztx->config.id.ca == NULL || strcmp(new_pem, ztx->config.id.ca) != 0) {
             ztx->tlsCtx->set_ca_bundle(ztx->tlsCtx, new_pem, strlen(new_pem));
             char *old_ca = (char*)ztx->config.id.ca;
-            free(old_ca);
+            ziti_free(old_ca);
 
-            ztx->config.id.ca = new_pem;
-            new_pem = NULL;
+            ztx->config.id.ca = ziti_strndup(new_pem, pem_size);
 
             ztx_config_update(ztx);
         }
@@ -1639,8 +1970,8 @@ static void ca_bundle_cb(char *pkcs7, const ziti_error *err, void *ctx) {
     }
 
     error:
-    free(pkcs7);
-    free(new_pem);
+    ziti_free(pkcs7);
+    free(new_pem); // allocated by tlsuv
     if (new_bundle) {
         new_bundle->free(new_bundle);
     }
@@ -1815,26 +2146,10 @@ void ziti_on_channel_event(ziti_channel_t *ch, ziti_router_status status, int er
     }
 
     if (status == EdgeRouterConnected) {
+        ztx_resume_waiting(ztx);
+
         uint32_t conn_id;
         ziti_connection conn;
-        // move all ids to a list
-        model_list ids = {0};
-        MODEL_MAP_FOR(it, ztx->waiting_connections) {
-            model_list_append(&ids, model_map_it_value(it));
-        }
-
-        model_map_clear(&ztx->waiting_connections, NULL);
-
-        model_list_iter id_it = model_list_iterator(&ids);
-        while(id_it != NULL) {
-            conn_id = (uint32_t)(uintptr_t)model_list_it_element(id_it);
-            conn = model_map_getl(&ztx->connections, (long)conn_id);
-            if (conn != NULL) {
-                process_connect(conn, NULL);
-            }
-            id_it = model_list_it_remove(id_it);
-        }
-
         MODEL_MAP_FOREACH(conn_id, conn, &ztx->connections) {
             if (conn->type == Server) {
                 update_bindings(conn);
@@ -1843,37 +2158,45 @@ void ziti_on_channel_event(ziti_channel_t *ch, ziti_router_status status, int er
     }
 }
 
-static void ztx_work_async(uv_async_t *ar) {
-    ziti_context ztx = ar->data;
-    ztx_work_q work;
-    STAILQ_INIT(&work);
+// re-run connect sequence for connections waiting for a channel or authentication
+static void ztx_resume_waiting(ziti_context ztx) {
+    // move all ids to a list
+    model_list ids = {0};
+    MODEL_MAP_FOR(it, ztx->waiting_connections) {
+        model_list_append(&ids, model_map_it_value(it));
+    }
 
-    struct ztx_work_s *w;
-    uv_mutex_lock(&ztx->w_lock);
-    work = ztx->w_queue;
-    STAILQ_INIT(&ztx->w_queue);
-    uv_mutex_unlock(&ztx->w_lock);
+    model_map_clear(&ztx->waiting_connections, NULL);
 
-    while (!STAILQ_EMPTY(&work)) {
-        w = STAILQ_FIRST(&work);
-        STAILQ_REMOVE_HEAD(&work, _next);
+    model_list_iter id_it = model_list_iterator(&ids);
+    while(id_it != NULL) {
+        uint32_t conn_id = (uint32_t)(uintptr_t)model_list_it_element(id_it);
+        ziti_connection conn = model_map_getl(&ztx->connections, (long)conn_id);
+        if (conn != NULL) {
+            process_connect(conn, NULL);
+        }
+        id_it = model_list_it_remove(id_it);
+    }
+}
 
-        w->w(ztx, w->w_data);
+static void run_ztx_work(void *elem, void *ctx) {
+    struct ztx_work_s *w = elem;
+    w->w(ctx, w->w_data);
+}
 
-        free(w);
-    }
+static void ztx_work_async(uv_async_t *ar) {
+    ziti_context ztx = ar->data;
+    mpsc_queue_drain(ztx->w_queue, run_ztx_work, ztx);
 }
 
 void ziti_queue_work(ziti_context ztx, ztx_work_f w, void *data) {
-    NEWP(wrk, struct ztx_work_s);
+    struct ztx_work_s *wrk = mpsc_queue_alloc(ztx->w_queue);
     wrk->w = w;
     wrk->w_data = data;
 
-    uv_mutex_trylock(&ztx->w_lock);
-    STAILQ_INSERT_TAIL(&ztx->w_queue, wrk, _next);
-    uv_mutex_unlock(&ztx->w_lock);
-
-    uv_async_send(&ztx->w_async);
+    if (mpsc_queue_push(ztx->w_queue, wrk)) {
+        uv_async_send(&ztx->w_async);
+    }
 }
 
 static void copy_oidc(ziti_context ztx, const ziti_jwt_signer *oidc) {
@@ -1887,15 +2210,15 @@ static void copy_oidc(ziti_context ztx, const ziti_jwt_signer *oidc) {
         return;
     }
 
-    ztx->config.id.oidc = calloc(1, sizeof(*oidc));
-    ztx->config.id.oidc->client_id = strdup(oidc->client_id);
-    ztx->config.id.oidc->provider_url = strdup(oidc->provider_url);
+    ztx->config.id.oidc = ziti_calloc(1, sizeof(*oidc));
+    ztx->config.id.oidc->client_id = ziti_strdup(oidc->client_id);
+    ztx->config.id.oidc->provider_url = ziti_strdup(oidc->provider_url);
     if (oidc->audience) {
-        ztx->config.id.oidc->audience = strdup(oidc->audience);
+        ztx->config.id.oidc->audience = ziti_strdup(oidc->audience);
     }
     const char *scope;
     MODEL_LIST_FOREACH(scope, oidc->scopes) {
-        model_list_append(&ztx->config.id.oidc->scopes, strdup(scope));
+        model_list_append(&ztx->config.id.oidc->scopes, ziti_strdup(scope));
     }
 }
 
@@ -1908,8 +2231,9 @@ int ziti_context_init(ziti_context *ztx, const ziti_config *config) {
         return ZITI_INVALID_CONFIG;
     }
 
-    ziti_context ctx = calloc(1, sizeof(*ctx));
+    ziti_context ctx = ziti_calloc(1, sizeof(*ctx));
     ctx->id = ++ztx_seq;
+    ctx->metrics = metrics_registry_new();
 
     const char *cfg_ca = config->id.ca;
     if (cfg_ca == NULL) {
@@ -1932,28 +2256,28 @@ int ziti_context_init(ziti_context *ztx, const ziti_config *config) {
             ctx->config.id.ca = ca;
         }
     } else {
-        ctx->config.id.ca = strdup(cfg_ca);
+        ctx->config.id.ca = ziti_strdup(cfg_ca);
     }
 
     if (config->cfg_source) {
-        ctx->config.cfg_source = strdup(config->cfg_source);
+        ctx->config.cfg_source = ziti_strdup(config->cfg_source);
     }
     const char *url;
     if (config->controller_url) {
-        ctx->config.controller_url = strdup(config->controller_url);
+        ctx->config.controller_url = ziti_strdup(config->controller_url);
     }
 
     bool found = ctx->config.controller_url == NULL;
     MODEL_LIST_FOREACH(url, (config->controllers)) {
-        model_list_append(&ctx->config.controllers, strdup(url));
+        model_list_append(&ctx->config.controllers, ziti_strdup(url));
         found = found || strncmp(ctx->config.controller_url, url, strlen(ctx->config.controller_url)) == 0;
     }
     if (!found) {
-        model_list_append(&ctx->config.controllers, strdup(ctx->config.controller_url));
+        model_list_append(&ctx->config.controllers, ziti_strdup(ctx->config.controller_url));
     }
 
-    if (config->id.key) ctx->config.id.key = strdup(config->id.key);
-    if (config->id.cert) ctx->config.id.cert = strdup(config->id.cert);
+    if (config->id.key) ctx->config.id.key = ziti_strdup(config->id.key);
+    if (config->id.cert) ctx->config.id.cert = ziti_strdup(config->id.cert);
     copy_oidc(ctx, config->id.oidc);
 
     ctx->opts = default_options;
@@ -1973,6 +2297,9 @@ int ziti_context_set_options(ziti_context ztx, const ziti_options *options) {
         copy_opt(refresh_interval);
         copy_opt(metrics_type);
         copy_opt(api_page_size);
+        copy_opt(api_max_page_size);
+        copy_opt(session_prefetch);
+        copy_opt(loop_stall_threshold_ms);
         copy_opt(event_cb);
         copy_opt(events);
         copy_opt(app_ctx);
@@ -1981,6 +2308,7 @@ int ziti_context_set_options(ziti_context ztx, const ziti_options *options) {
         copy_opt(pq_os_cb);
         copy_opt(pq_process_cb);
         copy_opt(cert_extension_window);
+        copy_opt(cache_path);
 
 #undef copy_opt
     }
@@ -1998,10 +2326,9 @@ int ziti_context_run(ziti_context ztx, uv_loop_t *loop) {
     uv_timer_init(loop, &ztx->deadline_timer);
     ztx->deadline_timer.data = ztx;
 
-    STAILQ_INIT(&ztx->w_queue);
+    ztx->w_queue = mpsc_queue_new(sizeof(struct ztx_work_s), ZTX_WORK_QUEUE_SIZE);
     uv_async_init(loop, &ztx->w_async, ztx_work_async);
     ztx->w_async.data = ztx;
-    uv_mutex_init(&ztx->w_lock);
 
     ziti_queue_work(ztx, ziti_init_async, NULL);
 
@@ -2158,7 +2485,7 @@ static void cert_verify_cb(void *r, const ziti_error *err, void *ctx) {
     if (req->new_cert) req->new_cert->free(req->new_cert);
     free_ziti_api_session_ptr(req->session);
     free_ziti_extend_cert_authenticator_resp_ptr(req->cert_resp);
-    free(req);
+    ziti_free(req);
 }
 
 static void cert_extend_cb(ziti_extend_cert_authenticator_resp *resp, const ziti_error *err, void *ctx) {
@@ -2167,7 +2494,7 @@ static void cert_extend_cb(ziti_extend_cert_authenticator_resp *resp, const ziti
     if (err) {
         ZTX_LOG(ERROR, "failed to extend identity certificate: %s", err->message);
         free_ziti_api_session_ptr(req->session);
-        free(req);
+        ziti_free(req);
         return;
     }
 
@@ -2176,7 +2503,7 @@ static void cert_extend_cb(ziti_extend_cert_authenticator_resp *resp, const ziti
         ZTX_LOG(ERROR, "failed to parse new certificate");
         free_ziti_extend_cert_authenticator_resp_ptr(resp);
         free_ziti_api_session_ptr(req->session);
-        free(req);
+        ziti_free(req);
         return;
     }
 
@@ -2204,6 +2531,8 @@ static void api_session_cb(ziti_api_session *api_sess, const ziti_error *err, vo
                 it = model_map_it_next(it);
             }
         }
+        // replace evicted sessions before dials need them
+        ztx_prefetch_sessions(ztx);
 
         if (ztx->id_creds.cert == NULL) {
             goto done;
@@ -2276,5 +2605,5 @@ static void api_session_cb(ziti_api_session *api_sess, const ziti_error *err, vo
 
     done:
     free_ziti_api_session_ptr(api_sess);
-    free(csr);
+    free(csr); // allocated by tlsuv
 }
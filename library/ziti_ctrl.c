@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_ctrl
+
 #include <inttypes.h>
 #include <stdlib.h>
 
@@ -23,6 +25,8 @@
 
 
 #define DEFAULT_PAGE_SIZE 25
+#define DEFAULT_MAX_PAGE_SIZE 500
+#define PAGING_WINDOW 4
 #define ZITI_CTRL_KEEPALIVE 0
 #define ZITI_CTRL_TIMEOUT 15000
 // one minute in millis
@@ -89,6 +93,12 @@ ctrl->url ? ctrl->url : "<unset>", ##__VA_ARGS__)
 #define MAKE_RESP(ctrl, cb, parser, ctx) prepare_resp(ctrl, (ctrl_resp_cb_t)(cb), (body_parse_fn)(parser), ctx)
 
 typedef struct ctrl_resp ctrl_resp_t;
+
+struct ctrl_page {
+    unsigned int offset;
+    unsigned int limit;
+    json_object *data;
+};
 typedef void (*ctrl_cb_t)(void *, const ziti_error *, ctrl_resp_t *);
 typedef void (*ctrl_resp_cb_t)(void *, const ziti_error *, void *);
 typedef int (*body_parse_fn)(void *, json_object *);
@@ -114,7 +124,36 @@ struct ctrl_resp {
     unsigned int total;
     unsigned int recd;
 
+    // after the first page, the rest is requested concurrently:
+    // each page has its own ctrl_resp pointing to the parent request
+    struct ctrl_resp *parent;
+    unsigned int page_idx;
+    struct ctrl_page *pages;
+    unsigned int page_count;
+    unsigned int page_cap;
+    unsigned int page_limit;
+    unsigned int next_offset;
+    unsigned int next_page;
+    unsigned int in_flight;
+    ziti_error page_err;
+
+    // single-flight: identical requests wait for the one on the wire
+    char *flight_key;
+    struct ctrl_resp *waiters;
+    struct ctrl_resp *next_waiter;
+
+    // list elements are passed through the filter before parsing
+    ziti_ctrl_list_filter list_filter;
+    // fingerprints list elements as the body is received
+    struct list_scan *list_scan;
+
+    // conditional request: ETag is stored here, 304 completes with no result
+    char **etag;
+    bool not_modified;
+
     body_parse_fn body_parse_func;
+    // transient result: parsed into the arena, released after the callback
+    model_arena *arena;
     ctrl_resp_cb_t resp_cb;
 
     void *ctx;
@@ -131,6 +170,8 @@ static struct ctrl_resp *prepare_resp(ziti_controller *ctrl, ctrl_resp_cb_t cb,
 
 static void ctrl_paging_req(struct ctrl_resp *resp);
 
+static void ctrl_paging_start(struct ctrl_resp *resp, const resp_meta *meta);
+
 static void ctrl_default_cb(void *s, const ziti_error *e, struct ctrl_resp *resp);
 
 static void ctrl_body_cb(tlsuv_http_req_t *req, char *b, ssize_t len);
@@ -146,6 +187,227 @@ start_request(tlsuv_http_t *http, const char *method, const char *path, tlsuv_ht
     return tlsuv_http_req(http, method, path, cb, resp);
 }
 
+#define FNV1A_OFFSET 0xcbf29ce484222325ULL
+#define FNV1A_STEP(h, c) (((h) ^ (uint8_t) (c)) * 0x100000001b3ULL)
+
+static uint64_t fnv1a_hash(const char *data, size_t len) {
+    uint64_t h = FNV1A_OFFSET;
+    for (size_t i = 0; i < len; i++) {
+        h = FNV1A_STEP(h, data[i]);
+    }
+    return h;
+}
+
+// hashes raw bytes of each element of the top level "data" array, as body chunks arrive
+struct list_scan {
+    unsigned int depth;
+    bool in_str;
+    bool esc;
+    bool in_data;
+    bool in_el;
+    bool el_scalar;
+    // last string seen at depth 1, the key of the value that follows
+    char key[8];
+    size_t key_len;
+    uint64_t h;
+    uint64_t *fps;
+    size_t count;
+    size_t cap;
+};
+
+static void list_scan_element_end(struct list_scan *s) {
+    if (s->count == s->cap) {
+        s->cap = s->cap ? s->cap * 2 : 64;
+        s->fps = ziti_realloc(s->fps, s->cap * sizeof(uint64_t));
+    }
+    s->fps[s->count++] = s->h;
+    s->in_el = false;
+}
+
+static void list_scan_feed(struct list_scan *s, const char *b, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = b[i];
+        if (s->in_str) {
+            if (s->in_el) {
+                s->h = FNV1A_STEP(s->h, c);
+            }
+            if (s->esc) {
+                s->esc = false;
+            } else if (c == '\\') {
+                s->esc = true;
+            } else if (c == '"') {
+                s->in_str = false;
+                continue;
+            }
+            if (s->depth == 1 && s->key_len < sizeof(s->key)) {
+                s->key[s->key_len] = c;
+            }
+            s->key_len++;
+            continue;
+        }
+
+        bool ws = c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        if (s->in_data && s->depth == 2) {
+            if (s->in_el && s->el_scalar && (ws || c == ',' || c == ']')) {
+                list_scan_element_end(s);
+            }
+            if (!s->in_el) {
+                if (ws || c == ',') {
+                    continue;
+                }
+                if (c != ']') {
+                    s->in_el = true;
+                    s->el_scalar = c != '{' && c != '[';
+                    s->h = FNV1A_OFFSET;
+                }
+            }
+        }
+
+        if (s->in_el) {
+            s->h = FNV1A_STEP(s->h, c);
+        }
+        switch (c) {
+            case '"':
+                s->in_str = true;
+                s->key_len = 0;
+                break;
+            case '[':
+                if (s->depth == 1 && s->key_len == 4 && memcmp(s->key, "data", 4) == 0) {
+                    s->in_data = true;
+                }
+                // fall through
+            case '{':
+                s->depth++;
+                break;
+            case ']':
+            case '}':
+                if (s->depth > 0) {
+                    s->depth--;
+                }
+                if (s->in_el && s->depth == 2) {
+                    list_scan_element_end(s);
+                } else if (s->in_data && s->depth == 1) {
+                    s->in_data = false;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void list_scan_free(struct list_scan *s) {
+    if (s) {
+        ziti_free(s->fps);
+        ziti_free(s);
+    }
+}
+
+static void free_fingerprint(json_object *UNUSED(o), void *fp) {
+    ziti_free(fp);
+}
+
+// attach fingerprints to list elements, so that they follow elements when pages are merged
+static void list_scan_apply(struct list_scan *s, json_object *list) {
+    if (json_object_get_type(list) != json_type_array || json_object_array_length(list) != s->count) {
+        return;
+    }
+
+    for (size_t idx = 0; idx < s->count; idx++) {
+        uint64_t *fp = ziti_malloc(sizeof(*fp));
+        *fp = s->fps[idx];
+        json_object_set_userdata(json_object_array_get_idx(list, idx), fp, free_fingerprint);
+    }
+}
+
+// key is method, path and body hash
+static bool ctrl_flight_join(struct ctrl_resp *resp, const char *method, const char *path,
+                             const char *body, size_t body_len) {
+    ziti_controller *ctrl = resp->ctrl;
+    uint64_t h = fnv1a_hash(body, body_len);
+
+    char key[1280];
+    snprintf(key, sizeof(key), "%s %s %016" PRIx64, method, path, h);
+
+    ctrl->req_count++;
+    struct ctrl_resp *leader = model_map_get(&ctrl->inflight, key);
+    if (leader) {
+        ctrl->coalesced_count++;
+        CTRL_LOG(VERBOSE, "joining in-flight %s[%s]", method, path);
+        resp->next_waiter = leader->waiters;
+        leader->waiters = resp;
+        return true;
+    }
+
+    resp->flight_key = ziti_strdup(key);
+    model_map_set(&ctrl->inflight, key, resp);
+    return false;
+}
+
+static int ctrl_parse_body(struct ctrl_resp *resp, json_object *json, void **obj) {
+    model_string_pool *prev_pool = model_string_pool_use(resp->ctrl->strings);
+    model_arena *prev_arena = model_arena_use(resp->arena);
+    int rc = resp->body_parse_func(obj, json);
+    model_arena_use(prev_arena);
+    model_string_pool_use(prev_pool);
+    return rc;
+}
+
+// drop list elements rejected by the filter, so they are not parsed
+static void ctrl_filter_list(struct ctrl_resp *resp) {
+    ziti_controller *ctrl = resp->ctrl;
+    if (resp->list_filter == NULL || json_object_get_type(resp->resp_json) != json_type_array) {
+        return;
+    }
+
+    json_object *list = resp->resp_json;
+    size_t count = json_object_array_length(list);
+    resp->resp_json = json_object_new_array();
+    for (size_t idx = 0; idx < count; idx++) {
+        json_object *el = json_object_array_get_idx(list, idx);
+        const uint64_t *fp = json_object_get_userdata(el);
+        const char *id = json_object_get_string(json_object_object_get(el, "id"));
+        const char *name = json_object_get_string(json_object_object_get(el, "name"));
+        if (resp->list_filter(id, name, fp ? *fp : 0, resp->ctx)) {
+            json_object_array_add(resp->resp_json, json_object_get(el));
+        }
+    }
+    CTRL_LOG(VERBOSE, "parsing %zd of %zd list elements",
+             json_object_array_length(resp->resp_json), count);
+    json_object_put(list);
+}
+
+// every waiter gets its own copy parsed from the shared response
+static void ctrl_flight_land(struct ctrl_resp *resp, json_object *json, const ziti_error *err) {
+    ziti_controller *ctrl = resp->ctrl;
+    if (resp->flight_key == NULL) {
+        return;
+    }
+
+    model_map_remove(&ctrl->inflight, resp->flight_key);
+    FREE(resp->flight_key);
+
+    struct ctrl_resp *w = resp->waiters;
+    resp->waiters = NULL;
+    while (w) {
+        struct ctrl_resp *next = w->next_waiter;
+        void *obj = NULL;
+        ziti_error parse_err = {
+                .err = ZITI_INVALID_STATE,
+                .code = "INVALID_CONTROLLER_RESPONSE",
+                .message = "unexpected response JSON",
+        };
+        const ziti_error *e = err;
+        if (e == NULL && w->body_parse_func && json) {
+            if (ctrl_parse_body(w, json, &obj) < 0) {
+                e = &parse_err;
+            }
+        }
+        w->ctrl_cb(e ? NULL : obj, e, w);
+        w = next;
+    }
+}
+
 static const char *find_header(tlsuv_http_resp_t *r, const char *name) {
     tlsuv_http_hdr *h;
     LIST_FOREACH(h, &r->headers, _next) {
@@ -181,7 +443,7 @@ static void ctrl_resp_cb(tlsuv_http_resp_t *r, void *data) {
                 const char *next_ep = ctrl_next_ep(ctrl, ctrl->url);
                 if (next_ep != NULL) {
                     FREE(ctrl->url);
-                    ctrl->url = strdup(next_ep);
+                    ctrl->url = ziti_strdup(next_ep);
                     CTRL_LOG(INFO, "switching to endpoint[%s]", ctrl->url);
                     tlsuv_http_set_url(ctrl->client, next_ep);
                     internal_get_version(ctrl);
@@ -195,16 +457,32 @@ static void ctrl_resp_cb(tlsuv_http_resp_t *r, void *data) {
                 .message = (char *) uv_strerror(r->code),
         };
 
+        ctrl_flight_land(resp, NULL, &err);
         (resp->ctrl_cb ? resp->ctrl_cb : ctrl_default_cb)(NULL, &err, resp);
     } else {
         CTRL_LOG(VERBOSE, "received headers %s[%s]", r->req->method, r->req->path);
         r->body_cb = ctrl_body_cb;
 
+        if (resp->etag) {
+            const char *etag = find_header(r, "etag");
+            if (r->code == 304) {
+                CTRL_LOG(VERBOSE, "not modified %s[%s]", r->req->method, r->req->path);
+                resp->not_modified = true;
+            } else if (etag) {
+                FREE(*resp->etag);
+                *resp->etag = ziti_strdup(etag);
+            }
+        }
+
         const char *hv;
         if ((hv = find_header(r, "content-type")) != NULL &&
             strncmp(hv, "application/json", strlen("application/json")) == 0) {
             resp->resp_content = ctrl_content_json;
             resp->content_proc = json_tokener_new();
+            if (resp->list_filter || (resp->parent && resp->parent->list_filter)) {
+                list_scan_free(resp->list_scan);
+                resp->list_scan = ziti_calloc(1, sizeof(struct list_scan));
+            }
         } else {
             resp->resp_content = ctrl_content_text;
             resp->content_proc = new_string_buf();
@@ -216,7 +494,7 @@ static void ctrl_resp_cb(tlsuv_http_resp_t *r, void *data) {
         const char *new_addr = find_header(r, "ziti-ctrl-address");
         if (new_addr) {
             FREE(resp->new_address);
-            resp->new_address = strdup(new_addr);
+            resp->new_address = ziti_strdup(new_addr);
         }
 
         const char *instance_id = find_header(r, "ziti-instance-id");
@@ -224,7 +502,7 @@ static void ctrl_resp_cb(tlsuv_http_resp_t *r, void *data) {
         if (instance_id &&
             (resp->ctrl->instance_id == NULL || strcmp(instance_id, resp->ctrl->instance_id) != 0)) {
             FREE(resp->ctrl->instance_id);
-            resp->ctrl->instance_id = strdup(instance_id);
+            resp->ctrl->instance_id = ziti_strdup(instance_id);
         }
     }
 }
@@ -249,7 +527,7 @@ static void ctrl_default_cb(void *s, const ziti_error *e, struct ctrl_resp *resp
             detail = alloc_ziti_controller_detail();
         }
         FREE(detail->name);
-        detail->name = strdup(ctrl->url);
+        detail->name = ziti_strdup(ctrl->url);
         model_map_set(&ctrl->endpoints, detail->name, detail);
 
         tlsuv_http_set_url(ctrl->client, ctrl->url);
@@ -263,7 +541,12 @@ static void ctrl_default_cb(void *s, const ziti_error *e, struct ctrl_resp *resp
         resp->resp_cb(s, e, resp->ctx);
     }
 
+    model_arena_free(resp->arena);
+    list_scan_free(resp->list_scan);
     FREE(resp->new_address);
+    if (resp->paging) {
+        ziti_free((char *) resp->base_path);
+    }
     if (resp->resp_json != NULL) {
         json_object_put(resp->resp_json);
     }
@@ -275,7 +558,7 @@ static void ctrl_default_cb(void *s, const ziti_error *e, struct ctrl_resp *resp
             FREE(resp->content_proc);
         }
     }
-    free(resp);
+    ziti_free(resp);
 }
 
 static void internal_ctrl_list_cb(ziti_controller_detail_array arr, const ziti_error *err, void *ctx) {
@@ -327,7 +610,7 @@ static void internal_ctrl_list_cb(ziti_controller_detail_array arr, const ziti_e
         CTRL_LOG(VERBOSE, "no ctrl list change");
         model_map_clear(&new_eps, (void (*)(void *)) free_ziti_controller_detail_ptr);
     }
-    free(arr);
+    ziti_free(arr);
 }
 
 static void internal_version_cb(ziti_version *v, ziti_error *e, struct ctrl_resp *resp) {
@@ -359,7 +642,7 @@ static void internal_version_cb(ziti_version *v, ziti_error *e, struct ctrl_resp
         ctrl->is_ha = ziti_has_capability(&ctrl->version, ziti_ctrl_caps.HA_CONTROLLER);
 
         // data was moved to ctrl.version
-        free(v);
+        ziti_free(v);
         v = &ctrl->version;
     }
 
@@ -412,11 +695,11 @@ static void ctrl_logout_cb(void *s, ziti_error *e, struct ctrl_resp *resp) {
 static void ctrl_service_cb(ziti_service **services, ziti_error *e, struct ctrl_resp *resp) {
     ziti_service *s = services != NULL ? services[0] : NULL;
     ctrl_default_cb(s, e, resp);
-    free(services);
+    ziti_free(services);
 }
 
 static void free_body_cb(tlsuv_http_req_t * UNUSED(req), char *body, ssize_t UNUSED(len)) {
-    free(body);
+    ziti_free(body);
 }
 
 static void ctrl_body_cb(tlsuv_http_req_t *req, char *b, ssize_t len) {
@@ -428,6 +711,9 @@ static void ctrl_body_cb(tlsuv_http_req_t *req, char *b, ssize_t len) {
             if (resp->content == NULL) {
                 CTRL_LOG(VERBOSE, "HTTP RESPONSE: %.*s", (int)len, b);
                 resp->content = json_tokener_parse_ex(resp->content_proc, b, (int) len);
+                if (resp->list_scan) {
+                    list_scan_feed(resp->list_scan, b, (size_t) len);
+                }
                 if (resp->content == NULL && json_tokener_get_error(resp->content_proc) != json_tokener_continue) {
                     CTRL_LOG(WARN, "parsing error: %s",
                              json_tokener_error_desc(json_tokener_get_error(resp->content_proc)));
@@ -439,16 +725,28 @@ static void ctrl_body_cb(tlsuv_http_req_t *req, char *b, ssize_t len) {
         } else {
             string_buf_appendn(resp->content_proc, b, len);
         }
+    } else if (len == UV_EOF && resp->not_modified) {
+        if (resp->resp_content == ctrl_content_json) {
+            json_tokener_free(resp->content_proc);
+            json_object_put(resp->content);
+            resp->content = NULL;
+        } else {
+            string_buf_free(resp->content_proc);
+            ziti_free(resp->content_proc);
+        }
+        resp->content_proc = NULL;
+        resp->ctrl_cb(NULL, NULL, resp);
     } else if (len == UV_EOF) {
         void *resp_obj = NULL;
+        json_object *flight_json = NULL;
         uv_timeval64_t now;
         uv_gettimeofday(&now);
 
         ziti_error error = {};
         if (resp->resp_content == ctrl_content_text) {
-            if (resp->body_parse_func) {
-                error.code = strdup("INVALID_CONTROLLER_RESPONSE");
-                error.message = strdup("received non-JSON response");
+            if (resp->body_parse_func || resp->parent) {
+                error.code = ziti_strdup("INVALID_CONTROLLER_RESPONSE");
+                error.message = ziti_strdup("received non-JSON response");
             } else {
                 resp_obj = string_buf_to_string(resp->content_proc, NULL);
             }
@@ -458,39 +756,44 @@ static void ctrl_body_cb(tlsuv_http_req_t *req, char *b, ssize_t len) {
             json_object *err_json = json_object_object_get(resp->content, "error");
             if (err_json) {
                 if (ziti_error_from_json(&error, err_json) != 0) {
-                    error.code = strdup("INVALID_CONTROLLER_RESPONSE");
-                    error.message = strdup(json_object_get_string(err_json));
+                    error.code = ziti_strdup("INVALID_CONTROLLER_RESPONSE");
+                    error.message = ziti_strdup(json_object_get_string(err_json));
                 }
             }
             resp_meta meta = {0};
             resp_meta_from_json(&meta, json_object_object_get(resp->content, "meta"));
             json_object *data = json_object_object_get(resp->content, "data");
             data = json_object_get(data);
+            if (resp->list_scan) {
+                list_scan_apply(resp->list_scan, data);
+                list_scan_free(resp->list_scan);
+                resp->list_scan = NULL;
+            }
             json_object_put(resp->content);
             resp->content = NULL;
 
-            if (resp->paging) {
-                bool last_page = meta.pagination.total <=
-                                 meta.pagination.offset + meta.pagination.limit;
+            if (resp->parent) {
+                // one of concurrent pages, merged by the parent
+                resp->resp_json = data;
+                resp->limit = (unsigned int) meta.pagination.limit;
+            } else if (resp->paging) {
+                // controller may cap the limit, count what it actually sent
+                unsigned int count = json_object_get_type(data) == json_type_array ?
+                                     (unsigned int) json_object_array_length(data) : 0;
+                bool last_page = count == 0 || meta.pagination.total <= meta.pagination.offset + count;
                 if (json_object_get_type(data) == json_type_array) {
-                    resp->recd += json_object_array_length(data);
-                    if (resp->resp_json == NULL) {
-                        resp->resp_json = data;
-                    } else {
-                        for (int idx = 0; idx < json_object_array_length(data); idx++) {
-                            json_object *o = json_object_array_get_idx(data, idx);
-                            json_object_array_add(resp->resp_json, json_object_get(o));
-                        }
-                        json_object_put(data);
-                        data = NULL;
-                    }
+                    resp->recd += count;
+                    resp->resp_json = data;
                     CTRL_LOG(DEBUG, "received %d/%d for paging request GET[%s]",
                              resp->recd, (int)meta.pagination.total, resp->base_path);
+                } else {
+                    json_object_put(data);
                 }
-                if (!last_page) {
+                if (!last_page && error.code == NULL) {
                     json_tokener_free(resp->content_proc);
                     resp->content_proc = NULL;
-                    ctrl_paging_req(resp);
+                    ctrl_paging_start(resp, &meta);
+                    free_resp_meta(&meta);
                     return;
                 }
                 uint64_t elapsed = (now.tv_sec * 1000000 + now.tv_usec) - (resp->all_start.tv_sec * 1000000 + resp->all_start.tv_usec);
@@ -503,12 +806,17 @@ static void ctrl_body_cb(tlsuv_http_req_t *req, char *b, ssize_t len) {
                          req->method, req->path, elapsed / 1000000, (elapsed / 1000) % 1000);
                 resp->resp_json = data;
             }
-            
+
+            if (resp->flight_key) {
+                flight_json = json_object_get(resp->resp_json);
+            }
+            ctrl_filter_list(resp);
             if (resp->body_parse_func && resp->resp_json != NULL) {
-                if (resp->body_parse_func(&resp_obj, resp->resp_json) < 0) {
+                int parse_rc = ctrl_parse_body(resp, resp->resp_json, &resp_obj);
+                if (parse_rc < 0) {
                     CTRL_LOG(ERROR, "error parsing response data for req[%s]", req->path);
-                    error.code = strdup("INVALID_CONTROLLER_RESPONSE");
-                    error.message = strdup("unexpected response JSON");
+                    error.code = ziti_strdup("INVALID_CONTROLLER_RESPONSE");
+                    error.message = ziti_strdup("unexpected response JSON");
                 }
                 json_object_put(resp->resp_json);
                 resp->resp_json = NULL;
@@ -524,6 +832,8 @@ static void ctrl_body_cb(tlsuv_http_req_t *req, char *b, ssize_t len) {
             CTRL_LOG(ERROR, "API request[%s] failed code[%s] message[%s]",
                      req->path, error.code, error.message);
         }
+        ctrl_flight_land(resp, flight_json, error.err != ZITI_OK ? &error : NULL);
+        json_object_put(flight_json);
         if (error.err != ZITI_OK) {
             resp->ctrl_cb(NULL, &error, resp);
         } else {
@@ -551,6 +861,7 @@ static void ctrl_body_cb(tlsuv_http_req_t *req, char *b, ssize_t len) {
             err.err = ZITI_DISABLED;
             err.code = "CONTEXT_DISABLED";
         }
+        ctrl_flight_land(resp, NULL, &err);
         resp->resp_cb(NULL, &err, resp);
     }
 }
@@ -613,23 +924,25 @@ int ziti_ctrl_init(uv_loop_t *loop, ziti_controller *ctrl, model_list *urls, tls
         return ZITI_INVALID_CONFIG;
     }
     ctrl->page_size = DEFAULT_PAGE_SIZE;
+    ctrl->max_page_size = DEFAULT_MAX_PAGE_SIZE;
     ctrl->loop = loop;
+    ctrl->strings = model_string_pool_new();
     memset(&ctrl->version, 0, sizeof(ctrl->version));
 
     const char *ep;
     MODEL_LIST_FOREACH(ep, *urls) {
         ziti_controller_detail *detail = alloc_ziti_controller_detail();
-        detail->name = strdup(ep);
+        detail->name = ziti_strdup(ep);
         model_map_set(&ctrl->endpoints, ep, detail);
     }
 
     const char *initial_ep = ctrl_next_ep(ctrl, NULL);
-    ctrl->url = strdup(initial_ep);
+    ctrl->url = ziti_strdup(initial_ep);
 
-    ctrl->client = calloc(1, sizeof(tlsuv_http_t));
+    ctrl->client = ziti_calloc(1, sizeof(tlsuv_http_t));
     if (tlsuv_http_init(loop, ctrl->client, ctrl->url) != 0) {
-        if (tlsuv_http_close(ctrl->client, (tlsuv_http_close_cb) free) != 0) {
-            free(ctrl->client);
+        if (tlsuv_http_close(ctrl->client, (tlsuv_http_close_cb) ziti_free) != 0) {
+            ziti_free(ctrl->client);
         }
         ctrl->client = NULL;
         return ZITI_INVALID_CONFIG;
@@ -664,7 +977,7 @@ int ziti_ctrl_set_token(ziti_controller *ctrl, const char *token) {
     ctrl->has_token = true;
     tlsuv_http_header(ctrl->client, "Authorization", header);
 
-    free(header);
+    ziti_free(header);
     delete_string_buf(b);
 
     if (ctrl->is_ha) {
@@ -678,6 +991,10 @@ void ziti_ctrl_set_page_size(ziti_controller *ctrl, unsigned int size) {
     ctrl->page_size = size;
 }
 
+void ziti_ctrl_set_max_page_size(ziti_controller *ctrl, unsigned int size) {
+    ctrl->max_page_size = size;
+}
+
 void ziti_ctrl_set_callbacks(ziti_controller *ctrl, void *ctx,
                              ziti_ctrl_redirect_cb redirect_cb,
                              ziti_ctrl_change_cb change_cb) {
@@ -687,7 +1004,7 @@ void ziti_ctrl_set_callbacks(ziti_controller *ctrl, void *ctx,
 }
 
 static void on_http_close(tlsuv_http_t *clt) {
-    free(clt);
+    ziti_free(clt);
 }
 
 int ziti_ctrl_cancel(ziti_controller *ctrl) {
@@ -702,6 +1019,10 @@ int ziti_ctrl_close(ziti_controller *ctrl) {
     model_map_clear(&ctrl->endpoints, (void (*)(void *)) free_ziti_controller_detail_ptr);
     FREE(ctrl->url);
     FREE(ctrl->instance_id);
+    ziti_ctrl_reset_services_etag(ctrl);
+    model_map_clear(&ctrl->inflight, NULL);
+    model_string_pool_free(ctrl->strings);
+    ctrl->strings = NULL;
     if (ctrl->client) {
         tlsuv_http_close(ctrl->client, on_http_close);
     }
@@ -804,7 +1125,7 @@ void ziti_ctrl_login_ext_jwt(ziti_controller *ctrl, const char *jwt,
     tlsuv_http_req_query(req, 1, &(tlsuv_http_pair){"method", "ext-jwt"});
     tlsuv_http_req_data(req, body, body_len, free_body_cb);
 
-    free(auth_hdr);
+    ziti_free(auth_hdr);
     string_buf_free(auth);
     FREE(auth);
 }
@@ -908,13 +1229,36 @@ void ziti_ctrl_get_services_update(ziti_controller *ctrl, void (*cb)(ziti_servic
     if(!verify_api_session(ctrl, (void (*)(void *, const ziti_error *, void *)) cb, ctx)) return;
 
     struct ctrl_resp *resp = MAKE_RESP(ctrl, cb, ziti_service_update_ptr_from_json, ctx);
-    start_request(ctrl->client, "GET", "/current-api-session/service-updates", ctrl_resp_cb, resp);
+    resp->etag = &ctrl->pending_services_etag;
+    tlsuv_http_req_t *req = start_request(ctrl->client, "GET", "/current-api-session/service-updates", ctrl_resp_cb, resp);
+    if (ctrl->services_etag) {
+        tlsuv_http_req_header(req, "If-None-Match", ctrl->services_etag);
+    }
+}
+
+void ziti_ctrl_commit_services_etag(ziti_controller *ctrl) {
+    if (ctrl->pending_services_etag) {
+        FREE(ctrl->services_etag);
+        ctrl->services_etag = ctrl->pending_services_etag;
+        ctrl->pending_services_etag = NULL;
+    }
+}
+
+void ziti_ctrl_reset_services_etag(ziti_controller *ctrl) {
+    FREE(ctrl->services_etag);
+    FREE(ctrl->pending_services_etag);
 }
 
 void ziti_ctrl_get_services(ziti_controller *ctrl, void (*cb)(ziti_service_array, const ziti_error *, void *), void *ctx) {
+    ziti_ctrl_get_services_filtered(ctrl, NULL, cb, ctx);
+}
+
+void ziti_ctrl_get_services_filtered(ziti_controller *ctrl, ziti_ctrl_list_filter filter,
+                                     void (*cb)(ziti_service_array, const ziti_error *, void *), void *ctx) {
     if(!verify_api_session(ctrl, (void (*)(void *, const ziti_error *, void *)) cb, ctx)) return;
 
     struct ctrl_resp *resp = MAKE_RESP(ctrl, cb, ziti_service_array_from_json, ctx);
+    resp->list_filter = filter;
 
     resp->paging = true;
     resp->base_path = "/services?configTypes=all";
@@ -926,6 +1270,8 @@ void ziti_ctrl_current_edge_routers(ziti_controller *ctrl, void (*cb)(ziti_edge_
     if(!verify_api_session(ctrl, (void (*)(void *, const ziti_error *, void *)) cb, ctx)) return;
 
     struct ctrl_resp *resp = MAKE_RESP(ctrl, cb, ziti_edge_router_array_from_json, ctx);
+    // polled on every refresh, and only used to update channels
+    resp->arena = model_arena_new(0);
     resp->paging = true;
     resp->base_path = "/current-identity/edge-routers";
     ctrl_paging_req(resp);
@@ -946,6 +1292,7 @@ ziti_ctrl_get_service(ziti_controller *ctrl, const char *service_name, void (*cb
 
     struct ctrl_resp *resp = MAKE_RESP(ctrl, cb, ziti_service_array_from_json, ctx);
     resp->ctrl_cb = (ctrl_cb_t) ctrl_service_cb;
+    if (ctrl_flight_join(resp, "GET", "/services", name_clause, strlen(name_clause))) return;
 
     tlsuv_http_req_t *req = start_request(ctrl->client, "GET", "/services", ctrl_resp_cb, resp);
     tlsuv_http_req_query(req, 1, &(tlsuv_http_pair){
@@ -978,6 +1325,8 @@ void ziti_ctrl_get_session(
     snprintf(req_path, sizeof(req_path), "/sessions/%s", session_id);
 
     struct ctrl_resp *resp = MAKE_RESP(ctrl, cb, ziti_session_ptr_from_json, ctx);
+    if (ctrl_flight_join(resp, "GET", req_path, NULL, 0)) return;
+
     tlsuv_http_req_t *req = start_request(ctrl->client, "GET", req_path, ctrl_resp_cb, resp);
     tlsuv_http_req_header(req, "Content-Type", "application/json");
 }
@@ -988,13 +1337,17 @@ void ziti_ctrl_create_session(
 
     if (!verify_api_session(ctrl, (void (*)(void *, const ziti_error *, void *)) cb, ctx)) return;
 
-    char *content = malloc(128);
+    char *content = ziti_malloc(128);
     size_t len = snprintf(content, 128,
                           "{\"serviceId\": \"%s\", \"type\": \"%s\"}",
                           service_id, ziti_session_types.name(type));
 
     struct ctrl_resp *resp = MAKE_RESP(ctrl, cb, ziti_session_ptr_from_json, ctx);
-    resp->ctrl = ctrl;
+    if (ctrl_flight_join(resp, "POST", "/sessions", content, len)) {
+        ziti_free(content);
+        return;
+    }
+
     tlsuv_http_req_t *req = start_request(ctrl->client, "POST", "/sessions", ctrl_resp_cb, resp);
     tlsuv_http_req_header(req, "Content-Type", "application/json");
     tlsuv_http_req_data(req, content, len, free_body_cb);
@@ -1038,7 +1391,7 @@ ziti_ctrl_enroll(ziti_controller *ctrl, ziti_enrollment_method method, const cha
                  const char *name,
                  void (*cb)(ziti_enrollment_resp *, const ziti_error *, void *),
                  void *ctx) {
-    char *csr_copy = csr ? strdup(csr) : NULL;
+    char *csr_copy = csr ? ziti_strdup(csr) : NULL;
 
     struct ctrl_resp *resp = MAKE_RESP(ctrl, cb, ziti_enrollment_resp_ptr_from_json, ctx);
 
@@ -1080,7 +1433,7 @@ void ziti_pr_post(ziti_controller *ctrl, char *body, size_t body_len,
 
     tlsuv_http_req_t *req = start_request(ctrl->client, "POST", "/posture-response", ctrl_resp_cb, resp);
     tlsuv_http_req_header(req, "Content-Type", "application/json");
-    char *copy = strdup(body);
+    char *copy = ziti_strdup(body);
     tlsuv_http_req_data(req, copy, body_len, free_body_cb);
 }
 
@@ -1092,26 +1445,216 @@ void ziti_pr_post_bulk(ziti_controller *ctrl, char *body, size_t body_len,
 
     tlsuv_http_req_t *req = start_request(ctrl->client, "POST", "/posture-response-bulk", ctrl_resp_cb, resp);
     tlsuv_http_req_header(req, "Content-Type", "application/json");
-    char *copy = strdup(body);
+    char *copy = ziti_strdup(body);
     tlsuv_http_req_data(req, copy, body_len, free_body_cb);
 }
 
+static void ctrl_page_get(struct ctrl_resp *resp, unsigned int limit, unsigned int offset) {
+    ziti_controller *ctrl = resp->ctrl;
+    const char *base_path = resp->parent ? resp->parent->base_path : resp->base_path;
+    char query = strchr(base_path, '?') ? '&' : '?';
+    char path[256];
+    snprintf(path, sizeof(path), "%s%climit=%u&offset=%u", base_path, query, limit, offset);
+    CTRL_LOG(VERBOSE, "requesting %s", path);
+    start_request(ctrl->client, "GET", path, ctrl_resp_cb, resp);
+}
+
 static void ctrl_paging_req(struct ctrl_resp *resp) {
     ziti_controller *ctrl = resp->ctrl;
     if (resp->limit == 0) {
         resp->limit = ctrl->page_size;
     }
-    if (resp->recd == 0) {
-        uv_gettimeofday(&resp->all_start);
-        CTRL_LOG(DEBUG, "starting paging request GET[%s]", resp->base_path);
+    // base path may be on caller's stack, and it is needed for the rest of the pages
+    resp->base_path = ziti_strdup(resp->base_path);
+    uv_gettimeofday(&resp->all_start);
+    CTRL_LOG(DEBUG, "starting paging request GET[%s]", resp->base_path);
+    ctrl_page_get(resp, resp->limit, 0);
+}
+
+static int page_offset_cmp(const void *a, const void *b) {
+    const struct ctrl_page *pa = a;
+    const struct ctrl_page *pb = b;
+    return (pa->offset > pb->offset) - (pa->offset < pb->offset);
+}
+
+static void ctrl_paging_done(struct ctrl_resp *resp) {
+    ziti_controller *ctrl = resp->ctrl;
+
+    // pages that came back short were completed by pages appended later
+    if (resp->pages) {
+        qsort(resp->pages, resp->page_count, sizeof(struct ctrl_page), page_offset_cmp);
     }
-    char query = strchr(resp->base_path, '?') ? '&' : '?';
-    char path[128];
-    snprintf(path, sizeof(path), "%s%climit=%d&offset=%d", resp->base_path, query, resp->limit, resp->recd);
-    CTRL_LOG(VERBOSE, "requesting %s", path);
-    start_request(resp->ctrl->client, "GET", path, ctrl_resp_cb, resp);
+    for (unsigned int i = 0; i < resp->page_count; i++) {
+        json_object *page = resp->pages[i].data;
+        if (page == NULL) continue;
+
+        if (resp->page_err.err == ZITI_OK && json_object_get_type(page) == json_type_array) {
+            for (size_t idx = 0; idx < json_object_array_length(page); idx++) {
+                json_object *o = json_object_array_get_idx(page, idx);
+                json_object_array_add(resp->resp_json, json_object_get(o));
+            }
+            resp->recd += json_object_array_length(page);
+        }
+        json_object_put(page);
+    }
+    FREE(resp->pages);
+
+    if (resp->page_err.err != ZITI_OK) {
+        CTRL_LOG(ERROR, "paging request GET[%s] failed code[%s] message[%s]",
+                 resp->base_path, resp->page_err.code, resp->page_err.message);
+        ziti_error err = resp->page_err;
+        resp->page_err = (ziti_error){0};
+        resp->ctrl_cb(NULL, &err, resp);
+        free_ziti_error(&err);
+        return;
+    }
+
+    uv_timeval64_t now;
+    uv_gettimeofday(&now);
+    uint64_t elapsed = (now.tv_sec * 1000000 + now.tv_usec) - (resp->all_start.tv_sec * 1000000 + resp->all_start.tv_usec);
+    CTRL_LOG(DEBUG, "completed paging request GET[%s] (%u items in %u pages) in %" PRIu64 ".%03" PRIu64 " s",
+             resp->base_path, resp->recd, resp->page_count + 1, elapsed / 1000000, (elapsed / 1000) % 1000);
+
+    void *resp_obj = NULL;
+    ziti_error error = {};
+    ctrl_filter_list(resp);
+    if (resp->body_parse_func) {
+        int parse_rc = ctrl_parse_body(resp, resp->resp_json, &resp_obj);
+        if (parse_rc < 0) {
+            CTRL_LOG(ERROR, "error parsing response data for req[%s]", resp->base_path);
+            error.code = ziti_strdup("INVALID_CONTROLLER_RESPONSE");
+            error.message = ziti_strdup("unexpected response JSON");
+            error.err = code_to_error(error.code);
+        }
+        json_object_put(resp->resp_json);
+        resp->resp_json = NULL;
+    }
+
+    if (error.err != ZITI_OK) {
+        resp->ctrl_cb(NULL, &error, resp);
+    } else {
+        resp->ctrl_cb(resp_obj, NULL, resp);
+    }
+    free_ziti_error(&error);
+}
+
+static void ctrl_page_cb(void *obj, const ziti_error *e, struct ctrl_resp *page);
+
+static void ctrl_paging_add(struct ctrl_resp *resp, unsigned int offset, unsigned int limit) {
+    if (resp->page_count == resp->page_cap) {
+        resp->page_cap = resp->page_cap ? resp->page_cap * 2 : PAGING_WINDOW;
+        resp->pages = ziti_realloc(resp->pages, resp->page_cap * sizeof(struct ctrl_page));
+    }
+    resp->pages[resp->page_count++] = (struct ctrl_page){
+            .offset = offset,
+            .limit = limit,
+    };
 }
 
+static void ctrl_paging_next(struct ctrl_resp *resp) {
+    while (resp->page_err.err == ZITI_OK && resp->in_flight < PAGING_WINDOW) {
+        if (resp->next_page == resp->page_count) {
+            if (resp->next_offset >= resp->total) {
+                break;
+            }
+            unsigned int limit = resp->total - resp->next_offset;
+            if (limit > resp->page_limit) {
+                limit = resp->page_limit;
+            }
+            ctrl_paging_add(resp, resp->next_offset, limit);
+            resp->next_offset += limit;
+        }
+
+        NEWP(page, struct ctrl_resp);
+        page->ctrl = resp->ctrl;
+        page->parent = resp;
+        page->page_idx = resp->next_page++;
+        page->ctrl_cb = ctrl_page_cb;
+        page->resp_cb = (ctrl_resp_cb_t) ctrl_page_cb;
+        page->ctx = page;
+        resp->in_flight++;
+        ctrl_page_get(page, resp->pages[page->page_idx].limit, resp->pages[page->page_idx].offset);
+    }
+
+    // on error, wait for outstanding pages before completing
+    if (resp->in_flight == 0 &&
+        (resp->page_err.err != ZITI_OK ||
+         (resp->next_page == resp->page_count && resp->next_offset >= resp->total))) {
+        ctrl_paging_done(resp);
+    }
+}
+
+static void ctrl_page_cb(void *UNUSED(obj), const ziti_error *e, struct ctrl_resp *page) {
+    struct ctrl_resp *resp = page->parent;
+    ziti_controller *ctrl = resp->ctrl;
+    resp->in_flight--;
+
+    if (e) {
+        if (resp->page_err.err == ZITI_OK) {
+            resp->page_err.err = e->err;
+            resp->page_err.http_code = e->http_code;
+            resp->page_err.code = e->code ? ziti_strdup(e->code) : NULL;
+            resp->page_err.message = e->message ? ziti_strdup(e->message) : NULL;
+        }
+    } else {
+        struct ctrl_page *p = &resp->pages[page->page_idx];
+        p->data = page->resp_json;
+        page->resp_json = NULL;
+
+        unsigned int count = json_object_get_type(p->data) == json_type_array ?
+                             (unsigned int) json_object_array_length(p->data) : 0;
+        if (count > 0 && count < p->limit) {
+            // controller capped the limit: use it for the rest, and fetch what this page missed
+            unsigned int cap = page->limit > 0 && page->limit < p->limit ? page->limit : count;
+            if (cap < resp->page_limit) {
+                CTRL_LOG(DEBUG, "paging request GET[%s]: page size capped at %u", resp->base_path, cap);
+                resp->page_limit = cap;
+            }
+            unsigned int offset = p->offset + count;
+            unsigned int limit = p->limit - count;
+            ctrl_paging_add(resp, offset, limit);
+        }
+    }
+
+    if (resp->new_address == NULL) {
+        resp->new_address = page->new_address;
+        page->new_address = NULL;
+    }
+    FREE(page->new_address);
+    list_scan_free(page->list_scan);
+    if (page->resp_json) {
+        json_object_put(page->resp_json);
+    }
+    if (page->content_proc) {
+        if (page->resp_content == ctrl_content_json) {
+            json_tokener_free(page->content_proc);
+        } else {
+            string_buf_free(page->content_proc);
+            ziti_free(page->content_proc);
+        }
+    }
+    ziti_free(page);
+
+    ctrl_paging_next(resp);
+}
+
+// first page revealed the total count:
+// request the rest in larger pages, a few at a time, and merge them in offset order
+static void ctrl_paging_start(struct ctrl_resp *resp, const resp_meta *meta) {
+    ziti_controller *ctrl = resp->ctrl;
+    if (resp->resp_json == NULL) {
+        resp->resp_json = json_object_new_array();
+    }
+
+    resp->total = (unsigned int) meta->pagination.total;
+    resp->next_offset = (unsigned int) meta->pagination.offset + resp->recd;
+    resp->page_limit = ctrl->max_page_size > resp->limit ? ctrl->max_page_size : resp->limit;
+
+    unsigned int remaining = resp->total - resp->next_offset;
+    CTRL_LOG(DEBUG, "paging request GET[%s]: requesting %u more items in pages of %u", resp->base_path,
+             remaining, resp->page_limit);
+    ctrl_paging_next(resp);
+}
 
 void ziti_ctrl_login_mfa(ziti_controller *ctrl, char *body, size_t body_len, void(*cb)(void *, const ziti_error *, void *), void *ctx) {
     if (!verify_api_session(ctrl, cb, ctx)) { return; }
@@ -1240,7 +1783,7 @@ void ziti_ctrl_create_api_certificate(ziti_controller *ctrl, const char *csr_pem
 }
 
 static struct ctrl_resp *prepare_resp(ziti_controller *ctrl, ctrl_resp_cb_t cb, body_parse_fn parser, void *ctx) {
-    struct ctrl_resp *resp = calloc(1, sizeof(struct ctrl_resp));
+    struct ctrl_resp *resp = ziti_calloc(1, sizeof(struct ctrl_resp));
     resp->body_parse_func = parser;
     resp->resp_cb = cb;
     resp->ctx = ctx;
@@ -88,7 +88,7 @@ int verify_controller_jwt(const struct tlsuv_certificate_s *cert, void *ctx) {
     return rc;
 }
 
-#define s_copy(s) ((s) ? strdup(s) : NULL)
+#define s_copy(s) ((s) ? ziti_strdup(s) : NULL)
 
 
 int ziti_enroll(const ziti_enroll_opts *opts, uv_loop_t *loop,
@@ -135,12 +135,12 @@ int ziti_enroll(const ziti_enroll_opts *opts, uv_loop_t *loop,
         char *p = buf;
         int r = load_file(opts->token, strlen(opts->token), &p, &len);
         if (r == 0) {
-            er->opts.token = calloc(1, len + 1);
+            er->opts.token = ziti_calloc(1, len + 1);
             memcpy((char*)er->opts.token, buf, len);
         } else if (r == UV_EBADF) {
 
         } else {
-            er->opts.token = strdup(opts->token);
+            er->opts.token = ziti_strdup(opts->token);
         }
 
         rc = start_enrollment(er);
@@ -160,7 +160,7 @@ static void network_jwt_cb(ziti_network_jwt_array arr, const ziti_error *err, vo
         return;
     }
 
-    er->opts.token = strdup(arr[0]->token);
+    er->opts.token = ziti_strdup(arr[0]->token);
     free_ziti_network_jwt_array(&arr);
 
     int rc = start_enrollment(er);
@@ -253,8 +253,8 @@ static int start_enrollment(struct ziti_enroll_req *er) {
         er->cfg.id.cert = s_copy(er->opts.cert);
     }
 
-    er->cfg.controller_url = strdup(er->enrollment.controller);
-    model_list_append(&er->cfg.controllers, strdup(er->enrollment.controller));
+    er->cfg.controller_url = ziti_strdup(er->enrollment.controller);
+    model_list_append(&er->cfg.controllers, ziti_strdup(er->enrollment.controller));
     ziti_ctrl_init(er->loop, &er->controller, &er->cfg.controllers, er->tls);
 
     ziti_ctrl_get_well_known_certs(&er->controller, well_known_certs_cb, er);
@@ -272,14 +272,14 @@ static void free_enroll_req(struct ziti_enroll_req * er) {
 
         free_ziti_enrollment_jwt_header(&er->jwt_header);
         free_ziti_enrollment_jwt(&er->enrollment);
-        free(er->sig);
+        free(er->sig); // allocated by tlsuv
         free_ziti_config(&er->cfg);
-        free((char*)er->opts.key);
-        free((char*)er->opts.cert);
-        free((char*)er->opts.token);
-        free((char*)er->opts.name);
-        free((char*)er->opts.url);
-        free(er);
+        ziti_free((char*)er->opts.key);
+        ziti_free((char*)er->opts.cert);
+        ziti_free((char*)er->opts.token);
+        ziti_free((char*)er->opts.name);
+        ziti_free((char*)er->opts.url);
+        ziti_free(er);
     }
 }
 
@@ -326,11 +326,14 @@ static void enroll_ott(struct ziti_enroll_req *er) {
             }
             er->cfg.id.key = keyname_ref;
         } else {
+            char *pem = NULL;
             if (er->tls->generate_key(&er->pk) != 0 ||
-                er->pk->to_pem( er->pk, (char **) &er->cfg.id.key, &len)) {
+                er->pk->to_pem( er->pk, &pem, &len)) {
                 complete_request(er, ZITI_KEY_GENERATION_FAILED);
                 return;
             }
+            er->cfg.id.key = ziti_strndup(pem, len);
+            free(pem);
         }
     } else if (er->pk == NULL) {
         // key should've been loaded already
@@ -378,13 +381,14 @@ static void well_known_certs_cb(char *base64_encoded_pkcs7, const ziti_error *er
     char *ca_pem = NULL;
     if (er->tls->parse_pkcs7_certs(&chain, base64_encoded_pkcs7, strlen(base64_encoded_pkcs7)) != 0 ||
         chain->to_pem(chain, 1, &ca_pem, &total_pem_len) != 0) {
-        free(base64_encoded_pkcs7);
+        ziti_free(base64_encoded_pkcs7);
         complete_request(er, ZITI_PKCS7_ASN1_PARSING_FAILED);
         return;
     }
-    free(base64_encoded_pkcs7);
+    ziti_free(base64_encoded_pkcs7);
     chain->free(chain);
-    er->cfg.id.ca = ca_pem;
+    er->cfg.id.ca = ziti_strndup(ca_pem, total_pem_len);
+    free(ca_pem);
 
     ZITI_LOG(DEBUG, "CA PEM len = %zd", total_pem_len);
     ZITI_LOG(TRACE, "CA PEM:\n%s", er->cfg.id.ca);
@@ -427,7 +431,7 @@ static void enroll_cb(ziti_enrollment_resp *resp, const ziti_error *err, void *e
     }
 
     ZITI_LOG(DEBUG, "successfully enrolled with controller %s", er->controller.url);
-    er->cfg.id.cert = resp->cert ? strdup(resp->cert) : strdup(er->opts.cert);
+    er->cfg.id.cert = resp->cert ? ziti_strdup(resp->cert) : ziti_strdup(er->opts.cert);
 
     complete_request(er, ZITI_OK);
     free_ziti_enrollment_resp_ptr(resp);
@@ -12,10 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define ZITI_ALLOC_TAG ziti_alloc_connection
+
 #include <ziti/ziti_src.h>
 #include <ziti/ziti_log.h>
 #include <string.h>
 
+#include "alloc.h"
+
 /**
  * Inherits from uv_lint_t and used to register as source link for `um_http`,
  * sening HTTP traffic over a Ziti connection.
@@ -68,12 +72,12 @@ int ziti_src_init(uv_loop_t *l, tlsuv_src_t *st, const char *svc, ziti_context z
     st->connect = ziti_src_connect;
     st->connect_cb = NULL;
     st->release = ziti_src_release;
-    st->link = malloc(sizeof(ziti_link_t));
+    st->link = ziti_malloc(sizeof(ziti_link_t));
     uv_link_init(st->link, &ziti_link_methods);
 
     ziti_link_t *zl = (ziti_link_t *) st->link;
     if (svc) {
-        zl->service = strdup(svc);
+        zl->service = ziti_strdup(svc);
     }
     else
         zl->service = NULL;
@@ -97,7 +101,7 @@ ziti_src_connect(tlsuv_src_t *src, const char *host, const char *port, tlsuv_src
             return ZITI_SERVICE_UNAVAILABLE;
         }
 
-        zl->service = strdup(s->name);
+        zl->service = ziti_strdup(s->name);
     }
 
     ZITI_LOG(TRACE, "service %s", zl->service);
@@ -130,8 +134,8 @@ ziti_src_connect(tlsuv_src_t *src, const char *host, const char *port, tlsuv_src
 
 static void ziti_src_release(tlsuv_src_t *src) {
     ziti_link_t *zl = (ziti_link_t *) src->link;
-    free(zl->service);
-    free(src->link);
+    ziti_free(zl->service);
+    ziti_free(src->link);
 }
 
 static void zlnf_conn_cb(ziti_connection conn, int status) {
@@ -173,7 +177,7 @@ static ssize_t zlnf_data_cb(ziti_connection conn, const uint8_t *data, ssize_t l
 static void zlnf_write_cb(ziti_connection conn, ssize_t status, void *ctx) {
     struct zl_write_req_s *req = ctx;
     req->cb((uv_link_t *) req->zl, (int) status, req->arg);
-    free(req);
+    ziti_free(req);
 }
 
 static int zl_read_start(uv_link_t *l) {
@@ -185,7 +189,7 @@ static int zl_write(uv_link_t *link, uv_link_t *source,
     uv_stream_t *send_handle, uv_link_write_cb cb, void *arg) {
 
     ziti_link_t *zl = (ziti_link_t *)link;
-    struct zl_write_req_s *req = malloc(sizeof(struct zl_write_req_s));
+    struct zl_write_req_s *req = ziti_malloc(sizeof(struct zl_write_req_s));
     req->zl = zl;
     req->cb = cb;
     req->arg = arg;
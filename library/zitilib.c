@@ -13,8 +13,12 @@
 // limitations under the License.
 
 
+#define ZITI_ALLOC_TAG ziti_alloc_bridge
+
 #include <tlsuv/queue.h>
+#include <ctype.h>
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <uv.h>
@@ -27,8 +31,12 @@ typedef uint16_t in_port_t;
 #include <afunix.h>
 #endif
 #else
+#include <poll.h>
 #include <unistd.h>
 #define SOCKET_ERROR (-1)
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
 #endif
 
 #include <ziti/zitilib.h>
@@ -36,6 +44,7 @@ typedef uint16_t in_port_t;
 #include <ziti/ziti_log.h>
 #include <assert.h>
 #include "zt_internal.h"
+#include "mpsc_queue.h"
 #include "util/future.h"
 
 static bool is_blocking(ziti_socket_t s);
@@ -56,23 +65,35 @@ typedef struct queue_elem_s {
     loop_work_cb cb;
     void *arg;
     future_t *f;
-    LIST_ENTRY(queue_elem_s) _next;
 } queue_elem_t;
 
+#define ZITI_LIB_MAX_THREADS 64
+#define LOOP_QUEUE_SIZE 256
+
+// loop thread: contexts (and their sockets) are pinned to one of these
+typedef struct lib_loop_s {
+    uv_loop_t *loop;
+    uv_thread_t thread;
+    uv_async_t q_async;
+    mpsc_queue_t *loop_q;
+} lib_loop_t;
+
 static void internal_init();
 
+static future_t *schedule_on(lib_loop_t *ll, loop_work_cb cb, void *arg, bool wait);
 static future_t *schedule_on_loop(loop_work_cb cb, void *arg, bool wait);
 
 static void do_shutdown(void *args, future_t *f, uv_loop_t *l);
 static void do_timeout_cleanup(void *args, future_t *f, uv_loop_t *l);
 
 static uv_once_t init;
-static uv_loop_t *lib_loop;
-static uv_thread_t lib_thread;
+static int lib_threads;
+static lib_loop_t lib_loops[ZITI_LIB_MAX_THREADS];
+static unsigned int next_loop;
 static uv_key_t err_key;
-static uv_mutex_t q_mut;
-static uv_async_t q_async;
-static LIST_HEAD(loop_queue, queue_elem_s) loop_q;
+
+// guards ziti_contexts, ziti_sockets, and resolve maps shared between loop threads and callers
+static uv_mutex_t lib_lock;
 
 static future_t *child_init_future;
 
@@ -92,11 +113,18 @@ struct sockaddr_un {
 typedef struct ztx_wrap {
     ziti_options opts;
     ziti_context ztx;
+    lib_loop_t *loop;
     future_t *auth_future;
 
     future_t *services_loaded;
     model_map intercepts;
     char **signers;
+
+    // service lookup indexes, updated with service events on the wrap's loop
+    model_map svc_names;        // case-folded name => service name
+    model_map host_index;       // case-folded intercept hostname => model_list of service names
+    model_map domain_index;     // case-folded wildcard domain (*.example.com => example.com) => model_list of service names
+    model_list cidr_intercepts; // services intercepting CIDR addresses
 } ztx_wrap_t;
 
 struct backlog_entry_s {
@@ -113,6 +141,12 @@ typedef struct ziti_sock_s {
     future_t *f;
     ziti_context ztx;
     ziti_connection conn;
+    lib_loop_t *loop;
+    struct direct_io_s *direct; // set for Ziti_direct_socket()
+
+    // dial completion for Ziti_connect_many(), otherwise [f] is used
+    struct connect_batch_s *batch;
+    size_t batch_idx;
 
     char *service;
     bool server;
@@ -130,9 +164,14 @@ void Ziti_lib_init(void) {
     uv_once(&init, internal_init);
 }
 
+void Ziti_lib_init_ex(int threads) {
+    lib_threads = threads;
+    uv_once(&init, internal_init);
+}
+
 ZITI_FUNC
 uv_thread_t Ziti_lib_thread() {
-    return lib_thread;
+    return lib_loops[0].thread;
 }
 
 int Ziti_last_error() {
@@ -148,30 +187,221 @@ static void free_wrap(ztx_wrap_t *w) {
     if (w == NULL) return;
 
     for (int i = 0; w->signers && w->signers[i]; i++) {
-        free((void*)w->signers[i]);
+        ziti_free((void*)w->signers[i]);
     }
-    free(w->signers);
+    ziti_free(w->signers);
     FREE(w);
 }
 
-static ztx_wrap_t *find_handle(ziti_handle_t handle) {
+// must be called with lib_lock held
+static ztx_wrap_t *find_handle_locked(ziti_handle_t handle) {
     if (handle == ZITI_INVALID_HANDLE) return NULL;
 
     ztx_wrap_t *w;
     const char *id;
     MODEL_MAP_FOREACH(id, w, &ziti_contexts) {
-        if (w->ztx->id == handle) {
+        if (w->ztx && w->ztx->id == handle) {
             return w;
         }
     }
     return NULL;
 }
 
+// wrap is owned by its loop thread: only call this on that loop
+static ztx_wrap_t *find_handle(ziti_handle_t handle) {
+    uv_mutex_lock(&lib_lock);
+    ztx_wrap_t *w = find_handle_locked(handle);
+    uv_mutex_unlock(&lib_lock);
+    return w;
+}
+
+// loop owning the context, unknown handles are sent to the first loop to fail there
+static lib_loop_t *handle_loop(ziti_handle_t handle) {
+    uv_mutex_lock(&lib_lock);
+    ztx_wrap_t *w = find_handle_locked(handle);
+    lib_loop_t *ll = w ? w->loop : &lib_loops[0];
+    uv_mutex_unlock(&lib_lock);
+    return ll;
+}
+
+static ziti_handle_t *context_handles(size_t *count) {
+    uv_mutex_lock(&lib_lock);
+    ziti_handle_t *handles = ziti_calloc(model_map_size(&ziti_contexts) + 1, sizeof(ziti_handle_t));
+    size_t i = 0;
+    ztx_wrap_t *w;
+    const char *id;
+    MODEL_MAP_FOREACH(id, w, &ziti_contexts) {
+        if (w->ztx) {
+            handles[i++] = w->ztx->id;
+        }
+    }
+    uv_mutex_unlock(&lib_lock);
+    *count = i;
+    return handles;
+}
+
+static void await_services(void) {
+    size_t count = 0;
+    uv_mutex_lock(&lib_lock);
+    future_t **loaded = ziti_calloc(model_map_size(&ziti_contexts) + 1, sizeof(future_t *));
+    ztx_wrap_t *w;
+    const char *id;
+    MODEL_MAP_FOREACH(id, w, &ziti_contexts) {
+        loaded[count++] = w->services_loaded;
+    }
+    uv_mutex_unlock(&lib_lock);
+
+    for (size_t i = 0; i < count; i++) {
+        await_future(loaded[i], NULL);
+    }
+    ziti_free(loaded);
+}
+
+static ziti_sock_t *sock_get(ziti_socket_t fd) {
+    uv_mutex_lock(&lib_lock);
+    ziti_sock_t *s = model_map_get_key(&ziti_sockets, &fd, sizeof(fd));
+    uv_mutex_unlock(&lib_lock);
+    return s;
+}
+
+static void sock_set(ziti_sock_t *zs) {
+    uv_mutex_lock(&lib_lock);
+    model_map_set_key(&ziti_sockets, &zs->fd, sizeof(zs->fd), zs);
+    uv_mutex_unlock(&lib_lock);
+}
+
+// remove socket entry only if it still belongs to `zs`:
+// fd may have been reused by another socket after it was closed
+static void sock_remove(ziti_sock_t *zs) {
+    uv_mutex_lock(&lib_lock);
+    if (model_map_get_key(&ziti_sockets, &zs->fd, sizeof(zs->fd)) == zs) {
+        model_map_remove_key(&ziti_sockets, &zs->fd, sizeof(zs->fd));
+    }
+    uv_mutex_unlock(&lib_lock);
+}
+
+static lib_loop_t *sock_loop(ziti_socket_t fd) {
+    uv_mutex_lock(&lib_lock);
+    ziti_sock_t *s = model_map_get_key(&ziti_sockets, &fd, sizeof(fd));
+    lib_loop_t *ll = s && s->loop ? s->loop : &lib_loops[0];
+    uv_mutex_unlock(&lib_lock);
+    return ll;
+}
+
+// returns [buf] or heap copy if [s] does not fit
+static char *lower_copy(char *buf, size_t size, const char *s) {
+    size_t len = strlen(s);
+    char *out = len < size ? buf : ziti_malloc(len + 1);
+    for (size_t i = 0; i <= len; i++) {
+        out[i] = (char) tolower((unsigned char) s[i]);
+    }
+    return out;
+}
+
+static void index_add(model_map *idx, const char *key, const char *service) {
+    char buf[256];
+    char *k = lower_copy(buf, sizeof(buf), key);
+    model_list *l = model_map_get(idx, k);
+    if (l == NULL) {
+        l = ziti_calloc(1, sizeof(model_list));
+        model_map_set(idx, k, l);
+    }
+    model_list_append(l, ziti_strdup(service));
+    if (k != buf) ziti_free(k);
+}
+
+static void list_remove_name(model_list *l, const char *service) {
+    model_list_iter it = model_list_iterator(l);
+    while (it != NULL) {
+        char *name = (char *) model_list_it_element(it);
+        if (strcmp(name, service) == 0) {
+            ziti_free(name);
+            it = model_list_it_remove(it);
+        } else {
+            it = model_list_it_next(it);
+        }
+    }
+}
+
+static void index_remove(model_map *idx, const char *key, const char *service) {
+    char buf[256];
+    char *k = lower_copy(buf, sizeof(buf), key);
+    model_list *l = model_map_get(idx, k);
+    if (l != NULL) {
+        list_remove_name(l, service);
+        if (model_list_size(l) == 0) {
+            model_map_remove(idx, k);
+            ziti_free(l);
+        }
+    }
+    if (k != buf) ziti_free(k);
+}
+
+static void index_intercept(ztx_wrap_t *wrap, const char *service, const ziti_intercept_cfg_v1 *intercept, bool add) {
+    if (intercept == NULL) return;
+
+    bool cidr = false;
+    const ziti_address *a;
+    MODEL_LIST_FOREACH(a, intercept->addresses) {
+        if (a->type == ziti_address_cidr) {
+            cidr = true;
+            continue;
+        }
+
+        const char *host = a->addr.hostname;
+        // same wildcard rule as ziti_address_match()
+        model_map *idx = host[0] == '*' ? &wrap->domain_index : &wrap->host_index;
+        if (host[0] == '*') {
+            if (host[1] == '\0') continue;
+            host += 2;
+        }
+
+        if (add) {
+            index_add(idx, host, service);
+        } else {
+            index_remove(idx, host, service);
+        }
+    }
+
+    list_remove_name(&wrap->cidr_intercepts, service);
+    if (cidr && add) {
+        model_list_append(&wrap->cidr_intercepts, ziti_strdup(service));
+    }
+}
+
+static void set_intercept(ztx_wrap_t *wrap, const char *service, ziti_intercept_cfg_v1 *intercept) {
+    ziti_intercept_cfg_v1 *old = model_map_set(&wrap->intercepts, service, intercept);
+    index_intercept(wrap, service, old, false);
+    index_intercept(wrap, service, intercept, true);
+
+    free_ziti_intercept_cfg_v1(old);
+    ziti_free(old);
+}
+
+static void free_list_ptr(void *l) {
+    model_list_clear(l, ziti_free);
+    ziti_free(l);
+}
+
+static void clear_service_index(ztx_wrap_t *wrap) {
+    model_map_clear(&wrap->svc_names, ziti_free);
+    model_map_clear(&wrap->host_index, free_list_ptr);
+    model_map_clear(&wrap->domain_index, free_list_ptr);
+    model_list_clear(&wrap->cidr_intercepts, ziti_free);
+}
+
 static void process_service_event(ztx_wrap_t *wrap, const struct ziti_service_event *ev) {
+    char buf[256];
     for (int i = 0; ev->removed && ev->removed[i] != NULL; i++) {
-        ziti_intercept_cfg_v1 *intercept = model_map_remove(&wrap->intercepts, ev->removed[i]->name);
+        const char *name = ev->removed[i]->name;
+        ziti_intercept_cfg_v1 *intercept = model_map_remove(&wrap->intercepts, name);
+        index_intercept(wrap, name, intercept, false);
         free_ziti_intercept_cfg_v1(intercept);
         FREE(intercept);
+
+        char *k = lower_copy(buf, sizeof(buf), name);
+        ziti_free(model_map_remove(&wrap->svc_names, k));
+        if (k != buf) ziti_free(k);
     }
 
     for (int i = 0; ev->changed && ev->changed[i] != NULL; i++) {
@@ -179,7 +409,8 @@ static void process_service_event(ztx_wrap_t *wrap, const struct ziti_service_ev
         ziti_intercept_cfg_v1 *intercept = alloc_ziti_intercept_cfg_v1();
 
         if (ziti_service_get_config(s, ZITI_INTERCEPT_CFG_V1, intercept, (parse_service_cfg_f) parse_ziti_intercept_cfg_v1) == ZITI_OK) {
-            intercept = model_map_set(&wrap->intercepts, s->name, intercept);
+            set_intercept(wrap, s->name, intercept);
+            continue;
         }
 
         free_ziti_intercept_cfg_v1(intercept);
@@ -188,15 +419,21 @@ static void process_service_event(ztx_wrap_t *wrap, const struct ziti_service_ev
 
     for (int i = 0; ev->added && ev->added[i] != NULL; i++) {
         ziti_service *s = ev->added[i];
+        char *k = lower_copy(buf, sizeof(buf), s->name);
+        ziti_free(model_map_set(&wrap->svc_names, k, ziti_strdup(s->name)));
+        if (k != buf) ziti_free(k);
+
         ziti_intercept_cfg_v1 *intercept = alloc_ziti_intercept_cfg_v1();
         ziti_client_cfg_v1 clt_cfg = {0};
 
         if (ziti_service_get_config(s, ZITI_INTERCEPT_CFG_V1, intercept, (parse_service_cfg_f) parse_ziti_intercept_cfg_v1) == ZITI_OK) {
-            intercept = model_map_set(&wrap->intercepts, s->name, intercept);
+            set_intercept(wrap, s->name, intercept);
+            continue;
         } else if (ziti_service_get_config(s, ZITI_CLIENT_CFG_V1, &clt_cfg, (parse_service_cfg_f) parse_ziti_client_cfg_v1) == ZITI_OK) {
             ziti_intercept_from_client_cfg(intercept, &clt_cfg);
-            intercept = model_map_set(&wrap->intercepts, s->name, intercept);
+            set_intercept(wrap, s->name, intercept);
             free_ziti_client_cfg_v1(&clt_cfg);
+            continue;
         }
 
         free_ziti_intercept_cfg_v1(intercept);
@@ -262,7 +499,9 @@ static void on_ctx_event(ziti_context ztx, const ziti_event_t *ev) {
 
 static void load_ziti_ctx(void *arg, future_t *f, uv_loop_t *l) {
     int rc = 0;
+    uv_mutex_lock(&lib_lock);
     struct ztx_wrap *wrap = model_map_get(&ziti_contexts, arg);
+    uv_mutex_unlock(&lib_lock);
 
     if (wrap) {
         ZITI_LOG(WARN, "already loading ztx[%d]", wrap->ztx->id);
@@ -280,8 +519,9 @@ static void load_ziti_ctx(void *arg, future_t *f, uv_loop_t *l) {
     rc = ziti_context_init(&ztx, &cfg);
     if (rc != ZITI_OK) goto error;
 
-    wrap = calloc(1, sizeof(struct ztx_wrap));
+    wrap = ziti_calloc(1, sizeof(struct ztx_wrap));
     wrap->ztx = ztx;
+    wrap->loop = l->data;
     rc = ziti_context_set_options(ztx, &(ziti_options){
             .app_ctx = wrap,
             .event_cb = on_ctx_event,
@@ -295,7 +535,9 @@ static void load_ziti_ctx(void *arg, future_t *f, uv_loop_t *l) {
     rc = ziti_context_run(ztx, l);
     if (rc != ZITI_OK) goto error;
 
+    uv_mutex_lock(&lib_lock);
     model_map_set(&ziti_contexts, arg, wrap);
+    uv_mutex_unlock(&lib_lock);
 
 error:
 
@@ -304,17 +546,26 @@ error:
     if (rc != ZITI_OK) {
         fail_future(f, rc);
         ZITI_LOG(WARN, "fail to load identity file[%s]: %d/%s", (const char *) arg, rc, ziti_errorstr(rc));
-        free(wrap);
+        ziti_free(wrap);
         return;
     }
 
 }
 
+// identity that is already loaded(or loading) stays on its loop, new ones are assigned round-robin
+static lib_loop_t *identity_loop(const char *identity) {
+    uv_mutex_lock(&lib_lock);
+    ztx_wrap_t *w = model_map_get(&ziti_contexts, identity);
+    lib_loop_t *ll = w ? w->loop : &lib_loops[next_loop++ % lib_threads];
+    uv_mutex_unlock(&lib_lock);
+    return ll;
+}
+
 int Ziti_load_context(ziti_handle_t *h, const char *identity) {
     if (h == NULL || identity == NULL) {
         return ZITI_INVALID_STATE;
     }
-    future_t *f = schedule_on_loop(load_ziti_ctx, (void *) identity, true);
+    future_t *f = schedule_on(identity_loop(identity), load_ziti_ctx, (void *) identity, true);
     void *res;
     int err = await_future(f, &res);
     set_error(err);
@@ -339,7 +590,8 @@ int Ziti_load_context_with_timeout(ziti_handle_t *h, const char *identity, int t
         return ZITI_INVALID_STATE;
     }
 
-    future_t *f = schedule_on_loop(load_ziti_ctx, (void *) identity, true);
+    lib_loop_t *ll = identity_loop(identity);
+    future_t *f = schedule_on(ll, load_ziti_ctx, (void *) identity, true);
     void *res;
     int err;
 
@@ -352,7 +604,7 @@ int Ziti_load_context_with_timeout(ziti_handle_t *h, const char *identity, int t
             // Schedule cleanup on the looper thread to ensure thread safety
             // Don't wait for cleanup to complete - it will happen asynchronously
             // If the process is terminated (SIGTERM), uv_stop() will cancel all pending operations
-            schedule_on_loop(do_timeout_cleanup, (void *)identity, false);
+            schedule_on(ll, do_timeout_cleanup, (void *)identity, false);
 
             err = ZITI_TIMEOUT;
         }
@@ -538,26 +790,270 @@ static int connect_socket(ziti_socket_t clt_sock, ziti_socket_t *ziti_sock) {
     return 0;
 }
 
+#if !_WIN32
+#define DIRECT_RING_SIZE 64
+
+struct direct_chunk_s {
+    uint8_t *data;
+    size_t len;
+    size_t off;
+};
+
+// SPSC ring, head is advanced by consumer, tail by producer
+struct direct_ring_s {
+    atomic_size_t head;
+    atomic_size_t tail;
+    struct direct_chunk_s slots[DIRECT_RING_SIZE];
+};
+
+struct direct_io_s {
+    ziti_socket_t notify_fd; // write side of readiness notification, same as socket fd with eventfd
+    struct direct_ring_s rx; // loop -> app
+    struct direct_ring_s tx; // app -> loop
+    size_t tx_sent;          // loop only: next tx slot to pass to ziti_write()
+
+    atomic_bool rx_stalled;
+    atomic_bool tx_scheduled;
+    atomic_bool tx_waiting;
+    atomic_int rx_status;    // ZITI_EOF or error: no more data is coming
+    atomic_int tx_status;
+
+    // socket registration, app calls in progress, and scheduled loop work each hold a reference
+    atomic_uint refs;
+
+    uv_mutex_t lock;
+    uv_cond_t tx_cond;
+};
+
+// first status sticks, e.g. EBADF after close is not replaced by connection errors
+static void direct_set_status(atomic_int *status, int err) {
+    int ok = 0;
+    atomic_compare_exchange_strong(status, &ok, err);
+}
+
+static size_t ring_used(struct direct_ring_s *r) {
+    return atomic_load(&r->tail) - atomic_load(&r->head);
+}
+
+static void direct_notify(struct direct_io_s *d) {
+#if defined(__linux__)
+    uint64_t one = 1;
+    if (write(d->notify_fd, &one, sizeof(one)) < 0) {}
+#else
+    char b = 1;
+    if (write(d->notify_fd, &b, sizeof(b)) < 0) {}
+#endif
+}
+
+static void direct_clear_notify(ziti_socket_t fd) {
+#if defined(__linux__)
+    uint64_t count;
+    if (read(fd, &count, sizeof(count)) < 0) {}
+#else
+    char b[64];
+    while (read(fd, b, sizeof(b)) > 0) {}
+#endif
+}
+
+static void direct_tx_wakeup(struct direct_io_s *d) {
+    if (atomic_load(&d->tx_waiting)) {
+        uv_mutex_lock(&d->lock);
+        uv_cond_signal(&d->tx_cond);
+        uv_mutex_unlock(&d->lock);
+    }
+}
+
+// socket descriptor is the readiness signal, it stays open until the connection is closed
+// and the last reference is released: app threads still polling it never see a reused fd
+static void direct_free(ziti_sock_t *zs) {
+    struct direct_io_s *d = zs->direct;
+    if (d->notify_fd != zs->fd) {
+        close(d->notify_fd);
+    }
+    close(zs->fd);
+
+    for (size_t i = atomic_load(&d->rx.head); i != atomic_load(&d->rx.tail); i++) {
+        ziti_free(d->rx.slots[i % DIRECT_RING_SIZE].data);
+    }
+    for (size_t i = atomic_load(&d->tx.head); i != atomic_load(&d->tx.tail); i++) {
+        ziti_free(d->tx.slots[i % DIRECT_RING_SIZE].data);
+    }
+    uv_cond_destroy(&d->tx_cond);
+    uv_mutex_destroy(&d->lock);
+    ziti_free(d);
+    ziti_free(zs->service);
+    ziti_free(zs);
+}
+
+static void direct_ref(ziti_sock_t *zs) {
+    atomic_fetch_add(&zs->direct->refs, 1);
+}
+
+static void direct_unref(ziti_sock_t *zs) {
+    if (atomic_fetch_sub(&zs->direct->refs, 1) == 1) {
+        direct_free(zs);
+    }
+}
+
+static void on_direct_close(ziti_connection conn) {
+    direct_unref(ziti_conn_data(conn));
+}
+
+// socket is already unregistered: fail and wake app threads still using it, last one frees it
+static void direct_release(ziti_sock_t *zs) {
+    struct direct_io_s *d = zs->direct;
+    atomic_store(&d->rx_status, EBADF);
+    atomic_store(&d->tx_status, EBADF);
+    uv_mutex_lock(&d->lock);
+    uv_cond_broadcast(&d->tx_cond);
+    uv_mutex_unlock(&d->lock);
+    direct_notify(d);
+
+    if (zs->conn) {
+        ziti_close(zs->conn, on_direct_close);
+    } else {
+        direct_unref(zs);
+    }
+}
+
+static ssize_t on_direct_data(ziti_connection conn, const uint8_t *data, ssize_t len) {
+    ziti_sock_t *zs = ziti_conn_data(conn);
+    struct direct_io_s *d = zs->direct;
+
+    if (len < 0) {
+        ZITI_LOG(DEBUG, "direct fd[%d] conn[%d] rx done: %zd/%s", zs->fd, conn->conn_id, len, ziti_errorstr((int) len));
+        direct_set_status(&d->rx_status, (int) len);
+        if (len != ZITI_EOF) {
+            direct_set_status(&d->tx_status, (int) len);
+            direct_tx_wakeup(d);
+        }
+        direct_notify(d);
+        return 0;
+    }
+
+    if (ring_used(&d->rx) == DIRECT_RING_SIZE) {
+        // pause delivery, reader resumes data callback after it frees a slot, unless it did it just now
+        atomic_store(&d->rx_stalled, true);
+        if (ring_used(&d->rx) == DIRECT_RING_SIZE) {
+            ziti_conn_set_data_cb(conn, NULL);
+            return 0;
+        }
+        atomic_store(&d->rx_stalled, false);
+    }
+
+    size_t tail = atomic_load_explicit(&d->rx.tail, memory_order_relaxed);
+    struct direct_chunk_s *c = &d->rx.slots[tail % DIRECT_RING_SIZE];
+    c->data = ziti_malloc(len);
+    memcpy(c->data, data, len);
+    c->len = len;
+    c->off = 0;
+
+    bool was_empty = tail == atomic_load(&d->rx.head);
+    atomic_store(&d->rx.tail, tail + 1);
+    if (was_empty) {
+        direct_notify(d);
+    }
+    return len;
+}
+
+static void direct_resume(void *arg, future_t *f, uv_loop_t *l) {
+    ziti_sock_t *zs = arg;
+    if (zs->conn && atomic_load(&zs->direct->rx_status) == 0) {
+        ziti_conn_set_data_cb(zs->conn, on_direct_data);
+    }
+    direct_unref(zs);
+}
+
+static void on_direct_write(ziti_connection conn, ssize_t status, void *ctx) {
+    ziti_sock_t *zs = ctx;
+    struct direct_io_s *d = zs->direct;
+
+    // writes complete in order
+    size_t head = atomic_load_explicit(&d->tx.head, memory_order_relaxed);
+    struct direct_chunk_s *c = &d->tx.slots[head % DIRECT_RING_SIZE];
+    ziti_free(c->data);
+    c->data = NULL;
+    atomic_store(&d->tx.head, head + 1);
+
+    if (status < 0) {
+        direct_set_status(&d->tx_status, (int) status);
+    }
+    direct_tx_wakeup(d);
+}
+
+static void direct_flush(void *arg, future_t *f, uv_loop_t *l) {
+    ziti_sock_t *zs = arg;
+    struct direct_io_s *d = zs->direct;
+
+    atomic_store(&d->tx_scheduled, false);
+    size_t tail = atomic_load_explicit(&d->tx.tail, memory_order_acquire);
+    while (d->tx_sent != tail && atomic_load(&d->tx_status) == 0) {
+        struct direct_chunk_s *c = &d->tx.slots[d->tx_sent % DIRECT_RING_SIZE];
+        int rc = zs->conn ? ziti_write(zs->conn, c->data, c->len, on_direct_write, zs) : ZITI_INVALID_STATE;
+        if (rc != ZITI_OK) {
+            ZITI_LOG(WARN, "direct fd[%d] write failed: %d/%s", zs->fd, rc, ziti_errorstr(rc));
+            direct_set_status(&d->tx_status, rc);
+            direct_tx_wakeup(d);
+            break;
+        }
+        d->tx_sent++;
+    }
+    direct_unref(zs);
+}
+
+static size_t direct_read(ziti_sock_t *zs, uint8_t *buf, size_t len) {
+    struct direct_io_s *d = zs->direct;
+    size_t head = atomic_load_explicit(&d->rx.head, memory_order_relaxed);
+    size_t total = 0;
+
+    while (total < len && head != atomic_load_explicit(&d->rx.tail, memory_order_acquire)) {
+        struct direct_chunk_s *c = &d->rx.slots[head % DIRECT_RING_SIZE];
+        size_t n = c->len - c->off;
+        if (n > len - total) n = len - total;
+
+        memcpy(buf + total, c->data + c->off, n);
+        c->off += n;
+        total += n;
+
+        if (c->off == c->len) {
+            ziti_free(c->data);
+            c->data = NULL;
+            atomic_store(&d->rx.head, ++head);
+            if (atomic_exchange(&d->rx_stalled, false)) {
+                direct_ref(zs);
+                schedule_on(zs->loop, direct_resume, zs, false);
+            }
+        }
+    }
+
+    // reset readiness once drained, re-check in case loop pushed more in the meantime
+    if (head == atomic_load(&d->rx.tail)) {
+        direct_clear_notify(zs->fd);
+        if (head != atomic_load(&d->rx.tail)) {
+            direct_notify(d);
+        }
+    }
+    return total;
+}
+#endif
+
 // make sure old ziti_sock_t instance does not interfere with
-// the new/reused socket fd
-static void check_socket(void *arg, future_t *f, uv_loop_t *l) {
-    ziti_socket_t fd = (ziti_socket_t) (uintptr_t) arg;
+// the new/reused socket fd, stale instance is released by its loop (see sock_remove)
+static void check_socket(ziti_socket_t fd) {
     ZITI_LOG(VERBOSE, "checking client fd[%d]", fd);
+    uv_mutex_lock(&lib_lock);
     ziti_sock_t *s = model_map_remove_key(&ziti_sockets, &fd, sizeof(fd));
+    uv_mutex_unlock(&lib_lock);
     if (s) {
         ZITI_LOG(VERBOSE, "stale ziti_sock_t[fd=%d]", fd);
-        s->fd = SOCKET_ERROR;
     }
-    complete_future(f, NULL, 0);
 }
 
 ziti_socket_t Ziti_socket(int type) {
     ziti_socket_t fd = socket(AF_INET, type, 0);
     set_error(fd < 0 ? errno : 0);
     if (fd > 0) {
-        future_t *f = schedule_on_loop(check_socket, (void *) (uintptr_t) fd, true);
-        await_future(f, NULL);
-        destroy_future(f);
+        check_socket(fd);
     }
     return fd;
 }
@@ -565,20 +1061,26 @@ ziti_socket_t Ziti_socket(int type) {
 static void close_work(void *arg, future_t *f, uv_loop_t *l) {
     ziti_socket_t fd = (ziti_socket_t) (uintptr_t) arg;
     ZITI_LOG(DEBUG, "closing client fd[%d]", fd);
+    uv_mutex_lock(&lib_lock);
     ziti_sock_t *s = model_map_remove_key(&ziti_sockets, &fd, sizeof(fd));
+    uv_mutex_unlock(&lib_lock);
 #if _WIN32
     closesocket(fd);
 #else
-    close(fd);
+    if (s && s->direct) {
+        direct_release(s);
+    } else {
+        close(fd);
+    }
 #endif
     complete_future(f, NULL, 0);
 }
 
 int Ziti_close(ziti_socket_t fd) {
-    ziti_sock_t *s = model_map_get_key(&ziti_sockets, &fd, sizeof(fd));
+    ziti_sock_t *s = sock_get(fd);
     if (s) {
         ZITI_LOG(DEBUG, "closing ziti socket[%d]", fd);
-        future_t *f = schedule_on_loop(close_work, (void *) (uintptr_t) fd, true);
+        future_t *f = schedule_on(sock_loop(fd), close_work, (void *) (uintptr_t) fd, true);
         await_future(f, NULL);
         destroy_future(f);
         return 0;
@@ -586,6 +1088,164 @@ int Ziti_close(ziti_socket_t fd) {
     return -1;
 }
 
+#if !_WIN32
+ziti_socket_t Ziti_direct_socket(void) {
+    int fds[2];
+#if defined(__linux__)
+    fds[0] = fds[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fds[0] < 0) {
+        set_error(errno);
+        return SOCKET_ERROR;
+    }
+#else
+    if (pipe(fds) != 0) {
+        set_error(errno);
+        return SOCKET_ERROR;
+    }
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+#endif
+    check_socket(fds[0]);
+
+    NEWP(d, struct direct_io_s);
+    d->notify_fd = fds[1];
+    uv_mutex_init(&d->lock);
+    uv_cond_init(&d->tx_cond);
+    atomic_init(&d->refs, 1);
+
+    NEWP(zs, ziti_sock_t);
+    zs->fd = fds[0];
+    zs->ziti_fd = SOCKET_ERROR;
+    zs->direct = d;
+    sock_set(zs);
+
+    set_error(0);
+    return zs->fd;
+}
+
+// takes a reference under the lock: concurrent Ziti_close() cannot free the socket while caller uses it
+static ziti_sock_t *direct_sock(ziti_socket_t fd) {
+    uv_mutex_lock(&lib_lock);
+    ziti_sock_t *zs = model_map_get_key(&ziti_sockets, &fd, sizeof(fd));
+    if (zs && zs->direct) {
+        direct_ref(zs);
+    }
+    uv_mutex_unlock(&lib_lock);
+
+    if (zs == NULL || zs->direct == NULL) {
+        set_error(EBADF);
+        return NULL;
+    }
+    if (zs->conn == NULL) {
+        direct_unref(zs);
+        set_error(ENOTCONN);
+        return NULL;
+    }
+    return zs;
+}
+
+static ssize_t direct_done(ziti_sock_t *zs, ssize_t rc) {
+    direct_unref(zs);
+    return rc;
+}
+
+ssize_t Ziti_send(ziti_socket_t fd, const void *buf, size_t len, int flags) {
+    ziti_sock_t *zs = direct_sock(fd);
+    if (zs == NULL) return -1;
+
+    struct direct_io_s *d = zs->direct;
+    size_t tail = atomic_load_explicit(&d->tx.tail, memory_order_relaxed);
+    if (tail - atomic_load(&d->tx.head) == DIRECT_RING_SIZE && atomic_load(&d->tx_status) == 0) {
+        if (flags & MSG_DONTWAIT) {
+            set_error(EWOULDBLOCK);
+            return direct_done(zs, -1);
+        }
+
+        uv_mutex_lock(&d->lock);
+        atomic_store(&d->tx_waiting, true);
+        while (tail - atomic_load(&d->tx.head) == DIRECT_RING_SIZE && atomic_load(&d->tx_status) == 0) {
+            uv_cond_wait(&d->tx_cond, &d->lock);
+        }
+        atomic_store(&d->tx_waiting, false);
+        uv_mutex_unlock(&d->lock);
+    }
+
+    int status = atomic_load(&d->tx_status);
+    if (status != 0) {
+        set_error(status);
+        return direct_done(zs, -1);
+    }
+
+    if (len == 0) {
+        set_error(0);
+        return direct_done(zs, 0);
+    }
+
+    struct direct_chunk_s *c = &d->tx.slots[tail % DIRECT_RING_SIZE];
+    c->data = ziti_malloc(len);
+    memcpy(c->data, buf, len);
+    c->len = len;
+    c->off = 0;
+    atomic_store_explicit(&d->tx.tail, tail + 1, memory_order_release);
+
+    // one loop wakeup flushes everything queued so far
+    if (!atomic_exchange(&d->tx_scheduled, true)) {
+        direct_ref(zs);
+        schedule_on(zs->loop, direct_flush, zs, false);
+    }
+    set_error(0);
+    return direct_done(zs, (ssize_t) len);
+}
+
+ssize_t Ziti_recv(ziti_socket_t fd, void *buf, size_t len, int flags) {
+    ziti_sock_t *zs = direct_sock(fd);
+    if (zs == NULL) return -1;
+
+    struct direct_io_s *d = zs->direct;
+    for (;;) {
+        size_t n = direct_read(zs, buf, len);
+        if (n > 0 || len == 0) {
+            set_error(0);
+            return direct_done(zs, (ssize_t) n);
+        }
+
+        int status = atomic_load(&d->rx_status);
+        if (status != 0) {
+            if (status != EBADF && ring_used(&d->rx) > 0) continue;
+
+            set_error(status == ZITI_EOF ? 0 : status);
+            return direct_done(zs, status == ZITI_EOF ? 0 : -1);
+        }
+
+        if (flags & MSG_DONTWAIT) {
+            set_error(EWOULDBLOCK);
+            return direct_done(zs, -1);
+        }
+
+        struct pollfd pfd = {
+                .fd = fd,
+                .events = POLLIN,
+        };
+        poll(&pfd, 1, -1);
+    }
+}
+#else
+ziti_socket_t Ziti_direct_socket(void) {
+    set_error(ENOTSUP);
+    return SOCKET_ERROR;
+}
+
+ssize_t Ziti_send(ziti_socket_t fd, const void *buf, size_t len, int flags) {
+    set_error(ENOTSUP);
+    return -1;
+}
+
+ssize_t Ziti_recv(ziti_socket_t fd, void *buf, size_t len, int flags) {
+    set_error(ENOTSUP);
+    return -1;
+}
+#endif
+
 struct conn_req_s {
     ziti_socket_t fd;
 
@@ -600,56 +1260,145 @@ struct conn_req_s {
 static void on_bridge_close(void *ctx) {
     ziti_sock_t *zs = ctx;
     ZITI_LOG(DEBUG, "closed conn for socket(%d)", zs->fd);
-    model_map_remove_key(&ziti_sockets, &zs->fd, sizeof(zs->fd));
+    sock_remove(zs);
 #if _WIN32
     closesocket(zs->ziti_fd);
 #else
     close(zs->ziti_fd);
 #endif
-    free(zs->service);
-    free(zs);
+    ziti_free(zs->service);
+    ziti_free(zs);
+}
+
+struct connect_batch_s {
+    ziti_connect_req *reqs;
+    size_t count;
+    bool *started;            // accessed only by batch steps, which run one after another
+    atomic_size_t pending;    // incomplete requests + running step chain
+
+    ziti_handle_t *handles;   // contexts to visit, one loop hop each
+    size_t handle_count;
+    size_t step;
+
+    future_t *done;           // blocking submission
+    ziti_socket_t notify_fd;  // write side of completion notification
+};
+
+static void batch_release(struct connect_batch_s *b) {
+    if (atomic_fetch_sub(&b->pending, 1) != 1) {
+        return;
+    }
+
+    if (b->done) {
+        complete_future(b->done, NULL, 0);
+        return;
+    }
+
+#if !_WIN32
+    if (b->notify_fd != SOCKET_ERROR) {
+#if !defined(__linux__)
+        close(b->notify_fd);
+#endif
+    }
+#endif
+    ziti_free(b->handles);
+    ziti_free(b->started);
+    ziti_free(b);
+}
+
+static void batch_complete(struct connect_batch_s *b, size_t idx, int status) {
+    b->reqs[idx].status = status;
+#if !_WIN32
+    if (b->notify_fd != SOCKET_ERROR) {
+#if defined(__linux__)
+        uint64_t one = 1;
+        if (write(b->notify_fd, &one, sizeof(one)) < 0) {}
+#else
+        char one = 1;
+        if (write(b->notify_fd, &one, sizeof(one)) < 0) {}
+#endif
+    }
+#endif
+    batch_release(b);
+}
+
+static void sock_connect_done(ziti_sock_t *zs, int status) {
+    if (zs->batch) {
+        struct connect_batch_s *b = zs->batch;
+        zs->batch = NULL;
+        batch_complete(b, zs->batch_idx, status);
+    } else if (status == 0) {
+        complete_future(zs->f, zs->conn, 0);
+    } else {
+        fail_future(zs->f, status);
+    }
 }
 
 static void on_ziti_connect(ziti_connection conn, int status) {
     ziti_sock_t *zs = ziti_conn_data(conn);
+    if (zs->direct) {
+        if (status == ZITI_OK) {
+            ZITI_LOG(DEBUG, "direct fd[%d]->conn[%d]->service[%s] connected", zs->fd, conn->conn_id, zs->service);
+            sock_connect_done(zs, 0);
+        } else {
+            ZITI_LOG(WARN, "failed to establish ziti connection: %d(%s)", status, ziti_errorstr(status));
+            ziti_close(zs->conn, NULL);
+            zs->conn = NULL;
+            sock_connect_done(zs, status);
+        }
+        return;
+    }
+
     if (status == ZITI_OK) {
         int rc = connect_socket(zs->fd, &zs->ziti_fd);
         if (rc != 0) {
             ZITI_LOG(ERROR, "failed to connect client socket: %d/%s", rc, strerror(rc));
-            fail_future(zs->f, rc);
+            sock_connect_done(zs, rc);
             return;
         }
 
         ZITI_LOG(DEBUG, "bridge connected to ziti fd[%d]->ziti_fd[%d]->conn[%d]->service[%s]",
                  zs->fd, zs->ziti_fd, zs->conn->conn_id, zs->service);
         ziti_conn_bridge_fds(conn, (uv_os_fd_t) zs->ziti_fd, (uv_os_fd_t) zs->ziti_fd, on_bridge_close, zs);
-        complete_future(zs->f, conn, 0);
+        sock_connect_done(zs, 0);
     } else {
         ZITI_LOG(WARN, "failed to establish ziti connection: %d(%s)", status, ziti_errorstr(status));
-        fail_future(zs->f, status);
+        sock_connect_done(zs, status);
         ziti_close(zs->conn, NULL);
         on_bridge_close(zs);
     }
 }
 
+static void match_candidates(ztx_wrap_t *wrap, model_list *candidates, ziti_protocol proto,
+                             const ziti_address *addr, uint16_t port, const char **best, int *score) {
+    if (candidates == NULL) return;
+
+    const char *service;
+    MODEL_LIST_FOREACH(service, *candidates) {
+        ziti_intercept_cfg_v1 *intercept = model_map_get(&wrap->intercepts, service);
+        if (intercept == NULL) { continue; }
+
+        int match = ziti_intercept_match2(intercept, proto, addr, port);
+        if (match == -1) { continue; }
+
+        if (*score == -1 || *score > match) {
+            *best = service;
+            *score = match;
+        }
+        if (match == 0) { return; }
+    }
+}
+
 static const char* find_service(ztx_wrap_t *wrap, int type, const char *host, uint16_t port) {
     ZITI_LOG(DEBUG, "looking up %d:%s:%d", type, host, port);
-    const char *service;
-    ziti_intercept_cfg_v1 *intercept;
+    char buf[256];
+    char *key = lower_copy(buf, sizeof(buf), host);
 
     // check for service matching host
-    ziti_service *s = model_map_get(&wrap->ztx->services, host);
-    if (s != NULL) {
+    const char *best = model_map_get(&wrap->svc_names, key);
+    if (best != NULL) {
         ZITI_LOG(DEBUG, "hostname matches service name %s", host);
-        service = s->name;
-        return service;
-    }
-
-    MODEL_MAP_FOREACH(service, s, &wrap->ztx->services) {
-        if (strcasecmp(service, host) == 0) {
-            ZITI_LOG(DEBUG, "hostname matches service name %s", host);
-            return service;
-        }
+        goto done;
     }
 
     ziti_protocol proto = 0;
@@ -663,22 +1412,31 @@ static const char* find_service(ztx_wrap_t *wrap, int type, const char *host, ui
         case 0: // resolve case: any protocol can be used to assign IP address to host
             break;
         default:
-            return NULL;
+            goto done;
     }
 
-    int score = -1;
-    const char *best = NULL;
-    MODEL_MAP_FOREACH(service, intercept, &wrap->intercepts) {
-        int match = ziti_intercept_match(intercept, proto, host, port);
-        if (match == -1) { continue; }
-
-        if (match == 0) { return service; }
+    // parse once, then only check intercepts that can match the address
+    ziti_address addr;
+    if (parse_ziti_address_str(&addr, host) < 0) {
+        goto done;
+    }
 
-        if (score == -1 || score > match) {
-            best = service;
-            score = match;
+    int score = -1;
+    if (addr.type == ziti_address_cidr) {
+        match_candidates(wrap, &wrap->cidr_intercepts, proto, &addr, port, &best, &score);
+    } else {
+        match_candidates(wrap, model_map_get(&wrap->host_index, key), proto, &addr, port, &best, &score);
+        // wildcard domains: every dot-separated suffix of the hostname, including itself
+        for (const char *domain = key; domain != NULL && score != 0; ) {
+            match_candidates(wrap, model_map_get(&wrap->domain_index, domain), proto, &addr, port, &best, &score);
+            domain = strchr(domain, '.');
+            if (domain) domain++;
         }
     }
+    free_ziti_address(&addr);
+
+done:
+    if (key != buf) ziti_free(key);
     return best;
 }
 
@@ -718,15 +1476,19 @@ const char *fmt_identity(const ziti_intercept_cfg_v1 *intercept, const char* pro
     return identity;
 }
 
-static void do_ziti_connect(struct conn_req_s *req, future_t *f, uv_loop_t *l) {
+/**
+ * start dial on the loop owning [wrap], completion is reported to [f] or to [batch] at [idx]
+ * @return 0 if dial was started, ENOENT if [wrap] has no service for the address, or other error
+ */
+static int start_connect(ztx_wrap_t *wrap, struct conn_req_s *req, future_t *f,
+                         struct connect_batch_s *batch, size_t idx) {
     ZITI_LOG(DEBUG, "connecting fd[%d] to %s:%d", req->fd, req->host, req->port);
-    ziti_sock_t *zs = model_map_get_key(&ziti_sockets, &req->fd, sizeof(req->fd));
-    if (zs != NULL) {
+    ziti_sock_t *zs = sock_get(req->fd);
+    // direct socket is registered when it is created
+    if (zs != NULL && (zs->direct == NULL || zs->conn != NULL)) {
         ZITI_LOG(WARN, "socket %lu already connecting/connected", (unsigned long) req->fd);
-        fail_future(f, EALREADY);
-        return;
+        return EALREADY;
     }
-    ztx_wrap_t *wrap = find_handle(req->ziti_handle);
 
     int proto = 0;
     socklen_t optlen = sizeof(proto);
@@ -743,29 +1505,33 @@ static void do_ziti_connect(struct conn_req_s *req, future_t *f, uv_loop_t *l) {
         host = req->host;
     }
 
+    const char *proto_str = proto == SOCK_DGRAM ? "udp" : "tcp";
     ziti_intercept_cfg_v1 *intercept = NULL;
-    if (wrap == NULL) {
-        MODEL_MAP_FOR(it, ziti_contexts) {
-            wrap = model_map_it_value(it);
-            const char *service_name = find_service(wrap, proto, host, req->port);
-
-            if (service_name != NULL) {
-                req->service = service_name;
-                intercept = model_map_get(&wrap->intercepts, service_name);
-                break;
-            }
-            wrap = NULL;
+    if (wrap != NULL && req->service == NULL) {
+        // address dial: only this loop's context is checked, caller tries the next one
+        const char *service_name = find_service(wrap, proto, host, req->port);
+        if (service_name == NULL) {
+            ZITI_LOG(DEBUG, "ztx[%d] has no service for target address[%s:%s:%d]",
+                     req->ziti_handle, proto_str, req->host, req->port);
+            return ENOENT;
         }
+        req->service = service_name;
+        intercept = model_map_get(&wrap->intercepts, service_name);
     }
 
-    const char *proto_str = proto == SOCK_DGRAM ? "udp" : "tcp";
     if (wrap != NULL && req->service != NULL) {
-        zs = calloc(1, sizeof(*zs));
-        zs->fd = req->fd;
+        if (zs == NULL) {
+            zs = ziti_calloc(1, sizeof(*zs));
+            zs->fd = req->fd;
+        }
         zs->f = f;
-        zs->service = strdup(req->service);
+        zs->batch = batch;
+        zs->batch_idx = idx;
+        ziti_free(zs->service);
+        zs->service = ziti_strdup(req->service);
+        zs->loop = wrap->loop;
 
-        model_map_set_key(&ziti_sockets, &zs->fd, sizeof(zs->fd), zs);
+        sock_set(zs);
 
         ziti_conn_init(wrap->ztx, &zs->conn, zs);
         char app_data[1024];
@@ -785,41 +1551,196 @@ static void do_ziti_connect(struct conn_req_s *req, future_t *f, uv_loop_t *l) {
         ZITI_LOG(DEBUG, "connecting fd[%d] to service[%s]", zs->fd, req->service);
         ZITI_LOG(VERBOSE, "appdata[%.*s]", (int)opts.app_data_sz, (char*)opts.app_data);
         ZITI_LOG(VERBOSE, "identity[%s]", opts.identity);
-        ziti_dial_with_options(zs->conn, req->service, &opts, on_ziti_connect, NULL);
-    } else {
-        ZITI_LOG(WARN, "no service for target address[%s:%s:%d]", proto_str, req->host, req->port);
-        fail_future(f, ECONNREFUSED);
+#if !_WIN32
+        ziti_data_cb data_cb = zs->direct ? on_direct_data : NULL;
+#else
+        ziti_data_cb data_cb = NULL;
+#endif
+        ziti_dial_with_options(zs->conn, req->service, &opts, on_ziti_connect, data_cb);
+        return 0;
     }
+
+    ZITI_LOG(WARN, "no service for target address[%s:%s:%d]", proto_str, req->host, req->port);
+    return ECONNREFUSED;
 }
 
-int Ziti_connect_addr(ziti_socket_t socket, const char *host, unsigned int port) {
-    if (host == NULL) { return EINVAL; }
-    if (port == 0 || port > UINT16_MAX) { return EINVAL; }
+static void do_ziti_connect(struct conn_req_s *req, future_t *f, uv_loop_t *l) {
+    ztx_wrap_t *wrap = find_handle(req->ziti_handle);
+    int rc = start_connect(wrap, req, f, NULL, 0);
+    if (rc != 0) {
+        fail_future(f, rc);
+    }
+}
 
-    await_future(child_init_future, NULL);
+// visit one context: start dials addressed to it, and try matching not yet started address dials
+static void connect_batch_step(void *arg, future_t *f, uv_loop_t *l) {
+    struct connect_batch_s *b = arg;
+    ziti_handle_t h = b->handles[b->step];
+    ztx_wrap_t *wrap = find_handle(h);
 
-    const char *id;
-    ztx_wrap_t *wrap;
-    MODEL_MAP_FOREACH(id, wrap, &ziti_contexts) {
-        await_future(wrap->services_loaded, NULL);
+    for (size_t i = 0; wrap && i < b->count; i++) {
+        ziti_connect_req *r = &b->reqs[i];
+        bool addr_dial = r->ztx == ZITI_INVALID_HANDLE;
+        if (b->started[i] || (!addr_dial && r->ztx != h)) {
+            continue;
+        }
+
+        struct conn_req_s req = {
+                .fd = r->socket,
+                .ziti_handle = h,
+                .service = addr_dial ? NULL : r->service,
+                .terminator = r->terminator,
+                .host = r->host,
+                .port = (uint16_t) r->port,
+        };
+        int rc = start_connect(wrap, &req, NULL, b, i);
+        if (rc == ENOENT && addr_dial) {
+            continue;
+        }
+
+        b->started[i] = true;
+        if (rc != 0) {
+            batch_complete(b, i, rc);
+        }
     }
 
-    struct conn_req_s req = {
-            .ziti_handle = ZITI_INVALID_HANDLE,
-            .fd = socket,
-            .host = host,
-            .port = port,
-    };
+    if (++b->step < b->handle_count) {
+        schedule_on(handle_loop(b->handles[b->step]), connect_batch_step, b, false);
+        return;
+    }
+
+    for (size_t i = 0; i < b->count; i++) {
+        if (!b->started[i]) {
+            batch_complete(b, i, b->reqs[i].ztx == ZITI_INVALID_HANDLE ? ECONNREFUSED : EINVAL);
+        }
+    }
+    batch_release(b);
+}
+
+int Ziti_connect_many(ziti_connect_req *reqs, size_t count, ziti_socket_t *notify_fd) {
+    if (reqs == NULL && count > 0) {
+        set_error(EINVAL);
+        return -1;
+    }
+
+    bool addr_dials = false;
+    for (size_t i = 0; i < count; i++) {
+        ziti_connect_req *r = &reqs[i];
+        r->status = EINPROGRESS;
+        if (r->ztx == ZITI_INVALID_HANDLE) {
+            addr_dials = true;
+            if (r->host == NULL || r->port == 0 || r->port > UINT16_MAX) {
+                set_error(EINVAL);
+                return -1;
+            }
+        } else if (r->service == NULL) {
+            set_error(EINVAL);
+            return -1;
+        }
+    }
+
+    if (addr_dials) {
+        await_future(child_init_future, NULL);
+        await_services();
+    }
+
+    NEWP(b, struct connect_batch_s);
+    b->reqs = reqs;
+    b->count = count;
+    b->started = ziti_calloc(count + 1, sizeof(bool));
+    b->handles = context_handles(&b->handle_count);
+    b->notify_fd = SOCKET_ERROR;
+    atomic_init(&b->pending, count + 1);
+
+    if (notify_fd) {
+#if _WIN32
+        set_error(ENOTSUP);
+        ziti_free(b->handles);
+        ziti_free(b->started);
+        ziti_free(b);
+        return -1;
+#elif defined(__linux__)
+        b->notify_fd = *notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+        int fds[2];
+        if (pipe(fds) == 0) {
+            fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+            *notify_fd = fds[0];
+            b->notify_fd = fds[1];
+        }
+#endif
+        if (b->notify_fd == SOCKET_ERROR) {
+            set_error(errno);
+            ziti_free(b->handles);
+            ziti_free(b->started);
+            ziti_free(b);
+            return -1;
+        }
+    } else {
+        b->done = new_future();
+    }
+
+    if (b->handle_count == 0) {
+        // nothing to dial through: fail everything right away
+        b->handles = ziti_realloc(b->handles, sizeof(ziti_handle_t));
+        b->handles[0] = ZITI_INVALID_HANDLE;
+        b->handle_count = 1;
+    }
+
+    future_t *done = b->done;
+    schedule_on(handle_loop(b->handles[0]), connect_batch_step, b, false);
+    if (done == NULL) {
+        set_error(0);
+        return 0;
+    }
+
+    await_future(done, NULL);
+    destroy_future(done);
 
+    int failed = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (reqs[i].status != 0) failed++;
+    }
+    ziti_free(b->handles);
+    ziti_free(b->started);
+    ziti_free(b);
+    set_error(failed ? reqs[0].status : 0);
+    return failed;
+}
 
-    future_t *f = schedule_on_loop((loop_work_cb) do_ziti_connect, &req, true);
+int Ziti_connect_addr(ziti_socket_t socket, const char *host, unsigned int port) {
+    if (host == NULL) { return EINVAL; }
+    if (port == 0 || port > UINT16_MAX) { return EINVAL; }
+
+    await_future(child_init_future, NULL);
+    await_services();
+
+    // each context is searched on its own loop, first one with matching service makes the dial
+    size_t count;
+    ziti_handle_t *handles = context_handles(&count);
+    int err = ECONNREFUSED;
+    for (size_t i = 0; i < count; i++) {
+        struct conn_req_s req = {
+                .ziti_handle = handles[i],
+                .fd = socket,
+                .host = host,
+                .port = port,
+        };
 
-    int err = 0;
-    if (f) {
+        future_t *f = schedule_on(handle_loop(handles[i]), (loop_work_cb) do_ziti_connect, &req, true);
         err = await_future(f, NULL);
-        set_error(err);
         destroy_future(f);
+        if (err != ENOENT) {
+            break;
+        }
+        err = ECONNREFUSED;
     }
+    ziti_free(handles);
+
+    if (err == ECONNREFUSED) {
+        ZITI_LOG(WARN, "no service for target address[%s:%u]", host, port);
+    }
+    set_error(err);
     return err ? -1 : 0;
 }
 
@@ -832,10 +1753,10 @@ int Ziti_connect(ziti_socket_t socket, ziti_handle_t zh, const char *service, co
             .fd = socket,
             .ziti_handle = zh,
             .service = service,
-            .terminator = terminator ? strdup(terminator) : NULL,
+            .terminator = terminator ? ziti_strdup(terminator) : NULL,
     };
 
-    future_t *f = schedule_on_loop((loop_work_cb) do_ziti_connect, &req, true);
+    future_t *f = schedule_on(handle_loop(zh), (loop_work_cb) do_ziti_connect, &req, true);
     int err = await_future(f, NULL);
     set_error(err);
     destroy_future(f);
@@ -883,8 +1804,8 @@ static void on_ziti_accept(ziti_connection client, int status) {
         model_list_push(&pending->parent->accept_q, pending->accept_f);
 
         ziti_close(client, NULL);
-        free(pending->caller_id);
-        free(pending);
+        ziti_free(pending->caller_id);
+        ziti_free(pending);
         return;
     }
 
@@ -895,8 +1816,8 @@ static void on_ziti_accept(ziti_connection client, int status) {
         ZITI_LOG(WARN, "failed to connect client socket[%d]: %d", fd, rc);
         fail_future(pending->accept_f, rc);
         ziti_close(client, NULL);
-        free(pending->caller_id);
-        free(pending);
+        ziti_free(pending->caller_id);
+        ziti_free(pending);
         return;
     }
 
@@ -905,8 +1826,9 @@ static void on_ziti_accept(ziti_connection client, int status) {
     NEWP(zs, ziti_sock_t);
     zs->fd = fd;
     zs->ziti_fd = ziti_fd;
+    zs->loop = pending->parent->loop;
     ziti_conn_set_data(client, zs);
-    model_map_set_key(&ziti_sockets, &zs->fd, sizeof(zs->fd), zs);
+    sock_set(zs);
     ziti_conn_bridge_fds(client, (uv_os_fd_t) zs->ziti_fd, (uv_os_fd_t) zs->ziti_fd, on_bridge_close, zs);
     NEWP(si, struct sock_info_s);
     si->fd = zs->fd;
@@ -914,7 +1836,7 @@ static void on_ziti_accept(ziti_connection client, int status) {
 
     ZITI_LOG(DEBUG, "completing accept future[%p] with fd[%d]", pending->accept_f, fd);
     complete_future(pending->accept_f, si, 0);
-    free(pending);
+    ziti_free(pending);
 }
 
 static void on_ziti_client(ziti_connection server, ziti_connection client, int status, const ziti_client_ctx *clt_ctx) {
@@ -932,7 +1854,7 @@ static void on_ziti_client(ziti_connection server, ziti_connection client, int s
     NEWP(pending, struct backlog_entry_s);
     pending->parent = server_sock;
     pending->conn = client;
-    pending->caller_id = strdup(clt_ctx->caller_id);
+    pending->caller_id = ziti_strdup(clt_ctx->caller_id);
 
     future_t *accept_f = model_list_pop(&server_sock->accept_q);
     if (accept_f) {
@@ -945,8 +1867,8 @@ static void on_ziti_client(ziti_connection server, ziti_connection client, int s
         if (ziti_accept(client, on_ziti_accept, NULL) != ZITI_OK) {
             ZITI_LOG(WARN, "ziti_accept() failed unexpectedly");
             ziti_close(client, NULL);
-            free(pending->caller_id);
-            free(pending);
+            ziti_free(pending->caller_id);
+            ziti_free(pending);
             model_list_push(&server_sock->accept_q, accept_f);
             return;
         }
@@ -970,11 +1892,11 @@ static void on_ziti_bind(ziti_connection server, int status) {
     if (status != ZITI_OK) {
         ZITI_LOG(WARN, "failed to bind fd[%d] to service[%s] err[%d/%s]", zs->fd, zs->service, status, ziti_errorstr(status));
         fail_future(zs->f, status);
-        free(zs->service);
-        free(zs);
+        ziti_free(zs->service);
+        ziti_free(zs);
     } else {
         connect_socket(zs->fd, &zs->ziti_fd);
-        model_map_set_key(&ziti_sockets, &zs->fd, sizeof(zs->fd), zs);
+        sock_set(zs);
 
         ZITI_LOG(DEBUG, "successfully bound fd[%d] to service[%s]", zs->fd, zs->service);
         complete_future(zs->f, server, 0);
@@ -989,16 +1911,17 @@ static void do_ziti_bind(struct conn_req_s *req, future_t *f, uv_loop_t *l) {
         return;
     }
 
-    ziti_sock_t *zs = model_map_get_key(&ziti_sockets, &req->fd, sizeof(req->fd));
+    ziti_sock_t *zs = sock_get(req->fd);
     if (zs) {
         fail_future(f, EALREADY);
         return;
     }
 
-    zs = calloc(1, sizeof(*zs));
+    zs = ziti_calloc(1, sizeof(*zs));
     zs->fd = req->fd;
-    zs->service = strdup(req->service);
+    zs->service = ziti_strdup(req->service);
     zs->f = f;
+    zs->loop = wrap->loop;
 
     ZITI_LOG(DEBUG, "requesting bind fd[%d] to service[%s@%s]", zs->fd, req->terminator ? req->terminator : "", req->service);
     ziti_listen_opts opts = {
@@ -1020,7 +1943,7 @@ int Ziti_bind(ziti_socket_t socket, ziti_handle_t zh, const char *service, const
             .terminator = terminator,
     };
 
-    future_t *f = schedule_on_loop((loop_work_cb) do_ziti_bind, &req, true);
+    future_t *f = schedule_on(handle_loop(zh), (loop_work_cb) do_ziti_bind, &req, true);
     int err = await_future(f, NULL);
     set_error(err);
     destroy_future(f);
@@ -1034,7 +1957,7 @@ struct listen_req_s {
 
 static void do_ziti_listen(void *arg, future_t *f, uv_loop_t *l) {
     struct listen_req_s *req = arg;
-    ziti_sock_t *zs = model_map_get_key(&ziti_sockets, &req->fd, sizeof(req->fd));
+    ziti_sock_t *zs = sock_get(req->fd);
     if (zs == NULL) {
         fail_future(f, EBADF);
     } else {
@@ -1052,7 +1975,7 @@ int Ziti_listen(ziti_socket_t socket, int backlog) {
     }
 
     struct listen_req_s req = {.fd = socket, .backlog = backlog};
-    future_t *f = schedule_on_loop(do_ziti_listen, &req, true);
+    future_t *f = schedule_on(sock_loop(socket), do_ziti_listen, &req, true);
 
     int err = await_future(f, NULL);
     set_error(err);
@@ -1062,7 +1985,7 @@ int Ziti_listen(ziti_socket_t socket, int backlog) {
 
 static void do_ziti_accept(void *r, future_t *f, uv_loop_t *l) {
     ziti_socket_t server_fd = (ziti_socket_t) (uintptr_t) r;
-    ziti_sock_t *zs = model_map_get_key(&ziti_sockets, &server_fd, sizeof(server_fd));
+    ziti_sock_t *zs = sock_get(server_fd);
     if (zs == NULL) {
         ZITI_LOG(WARN, "fd[%d] is not a ziti socket", server_fd);
         fail_future(f, EINVAL);
@@ -1090,8 +2013,8 @@ static void do_ziti_accept(void *r, future_t *f, uv_loop_t *l) {
 
         ZITI_LOG(DEBUG, "failed to accept: client conn[%d] gone? [%d/%s]", conn->conn_id, rc, ziti_errorstr(rc));
         ziti_close(conn, NULL);
-        free(pending->caller_id);
-        free(pending);
+        ziti_free(pending->caller_id);
+        ziti_free(pending);
     }
 
     // no pending connections
@@ -1111,7 +2034,7 @@ static void do_ziti_accept(void *r, future_t *f, uv_loop_t *l) {
 }
 
 ziti_socket_t Ziti_accept(ziti_socket_t server, char *caller, int caller_len) {
-    future_t *f = schedule_on_loop(do_ziti_accept, (void *) (uintptr_t) server, true);
+    future_t *f = schedule_on(sock_loop(server), do_ziti_accept, (void *) (uintptr_t) server, true);
     ZITI_LOG(DEBUG, "fd[%d] waiting for future[%p]", server, f);
     ziti_socket_t clt = -1;
     struct sock_info_s *si;
@@ -1125,8 +2048,8 @@ ziti_socket_t Ziti_accept(ziti_socket_t server, char *caller, int caller_len) {
         }
         ZITI_LOG(DEBUG, "fd[%d] future[%p] completed with caller %.*s", server, f, caller_len, caller);
 
-        free(si->peer);
-        free(si);
+        ziti_free(si->peer);
+        ziti_free(si);
         char b;
 
         recv(server, &b, 1, 0);
@@ -1140,13 +2063,21 @@ ziti_socket_t Ziti_accept(ziti_socket_t server, char *caller, int caller_len) {
 
 
 void Ziti_lib_shutdown(void) {
-    future_t *f = schedule_on_loop(do_shutdown, NULL, true);
-    await_future(f, NULL);
-    uv_thread_join(&lib_thread);
+    future_t *f[ZITI_LIB_MAX_THREADS];
+    for (int i = 0; i < lib_threads; i++) {
+        f[i] = schedule_on(&lib_loops[i], do_shutdown, &lib_loops[i], true);
+    }
+    for (int i = 0; i < lib_threads; i++) {
+        await_future(f[i], NULL);
+        uv_thread_join(&lib_loops[i].thread);
+        destroy_future(f[i]);
+        mpsc_queue_free(lib_loops[i].loop_q);
+        lib_loops[i].loop_q = NULL;
+    }
     uv_once_t child_once = UV_ONCE_INIT;
     memcpy(&init, &child_once, sizeof(child_once));
     uv_key_delete(&err_key);
-    destroy_future(f);
+    lib_threads = 0;
 }
 
 static void looper(void *arg) {
@@ -1157,42 +2088,35 @@ static void looper(void *arg) {
 }
 
 future_t *schedule_on_loop(loop_work_cb cb, void *arg, bool wait) {
+    return schedule_on(&lib_loops[0], cb, arg, wait);
+}
+
+future_t *schedule_on(lib_loop_t *ll, loop_work_cb cb, void *arg, bool wait) {
     future_t *f = NULL;
     if (wait) {
         f = new_future();
     }
 
-    queue_elem_t *el = calloc(1, sizeof(queue_elem_t));
+    queue_elem_t *el = mpsc_queue_alloc(ll->loop_q);
     el->cb = cb;
     el->arg = arg;
     el->f = f;
 
-    uv_mutex_lock(&q_mut);
-    LIST_INSERT_HEAD(&loop_q, el, _next);
-    uv_mutex_unlock(&q_mut);
-    uv_async_send(&q_async);
+    if (mpsc_queue_push(ll->loop_q, el)) {
+        uv_async_send(&ll->q_async);
+    }
 
     return f;
 }
 
-void process_on_loop(uv_async_t *async) {
-    LIST_HEAD(loop_queue, queue_elem_s) q = {0};
-
-    // drain q
-    uv_mutex_lock(&q_mut);
-    while (!LIST_EMPTY(&loop_q)) {
-        queue_elem_t *el = LIST_FIRST(&loop_q);
-        LIST_REMOVE(el, _next);
-        LIST_INSERT_HEAD(&q, el, _next);
-    }
-    uv_mutex_unlock(&q_mut);
+static void run_queue_elem(void *elem, void *loop) {
+    queue_elem_t *el = elem;
+    el->cb(el->arg, el->f, loop);
+}
 
-    while (!LIST_EMPTY(&q)) {
-        queue_elem_t *el = LIST_FIRST(&q);
-        LIST_REMOVE(el, _next);
-        el->cb(el->arg, el->f, async->loop);
-        free(el);
-    }
+void process_on_loop(uv_async_t *async) {
+    lib_loop_t *ll = async->data;
+    mpsc_queue_drain(ll->loop_q, run_queue_elem, async->loop);
 }
 
 static void child_load_contexts(void *load_list, future_t *f, uv_loop_t *l) {
@@ -1207,22 +2131,31 @@ static void child_load_contexts(void *load_list, future_t *f, uv_loop_t *l) {
     complete_future(f, NULL, 0);
 }
 
+static void init_loop(lib_loop_t *ll) {
+    ll->loop = uv_loop_new();
+    ll->loop->data = ll;
+    uv_async_init(ll->loop, &ll->q_async, process_on_loop);
+    ll->q_async.data = ll;
+}
+
 static void child_init() {
-    lib_loop = uv_loop_new();
-    memset(&loop_q, 0, sizeof(loop_q));
-    ziti_log_init(lib_loop, -1, NULL);
-    uv_async_init(lib_loop, &q_async, process_on_loop);
+    for (int i = 0; i < lib_threads; i++) {
+        init_loop(&lib_loops[i]);
+    }
+    ziti_log_init(lib_loops[0].loop, -1, NULL);
 
     model_map_iter it = model_map_iterator(&ziti_contexts);
-    model_list *idents = calloc(1, sizeof(*idents));
+    model_list *idents = ziti_calloc(1, sizeof(*idents));
     while (it) {
         const char *ident = model_map_it_key(it);
-        model_list_append(idents, strdup(ident));
+        model_list_append(idents, ziti_strdup(ident));
         it = model_map_it_remove(it);
     }
 
     child_init_future = schedule_on_loop(child_load_contexts, idents, true);
-    uv_thread_create(&lib_thread, looper, lib_loop);
+    for (int i = 0; i < lib_threads; i++) {
+        uv_thread_create(&lib_loops[i].thread, looper, lib_loops[i].loop);
+    }
 }
 
 
@@ -1230,29 +2163,62 @@ static void internal_init() {
 #if defined(PTHREAD_ONCE_INIT)
 //    pthread_atfork(NULL, NULL, child_init);
 #endif
+    if (lib_threads <= 0) {
+        const char *env = getenv("ZITI_LIB_THREADS");
+        lib_threads = env ? (int) strtol(env, NULL, 10) : 1;
+    }
+    if (lib_threads <= 0) {
+        lib_threads = 1;
+    } else if (lib_threads > ZITI_LIB_MAX_THREADS) {
+        lib_threads = ZITI_LIB_MAX_THREADS;
+    }
+
     init_in4addr_loopback();
     uv_key_create(&err_key);
-    uv_mutex_init(&q_mut);
-    lib_loop = uv_loop_new();
-    ziti_log_init(lib_loop, -1, NULL);
-    uv_async_init(lib_loop, &q_async, process_on_loop);
-    uv_thread_create(&lib_thread, looper, lib_loop);
+    uv_mutex_init(&lib_lock);
+    for (int i = 0; i < lib_threads; i++) {
+        lib_loops[i].loop_q = mpsc_queue_new(sizeof(queue_elem_t), LOOP_QUEUE_SIZE);
+        init_loop(&lib_loops[i]);
+    }
+    ziti_log_init(lib_loops[0].loop, -1, NULL);
+    ZITI_LOG(DEBUG, "starting %d loop thread(s)", lib_threads);
+    for (int i = 0; i < lib_threads; i++) {
+        uv_thread_create(&lib_loops[i].thread, looper, lib_loops[i].loop);
+    }
 }
 
+// shutdown contexts pinned to this loop and stop it
 void do_shutdown(void *args, future_t *f, uv_loop_t *l) {
-    model_map_iter *it = model_map_iterator(&ziti_contexts);
+    lib_loop_t *ll = args;
+    model_list owned = {0};
+
+    uv_mutex_lock(&lib_lock);
+    model_map_iter it = model_map_iterator(&ziti_contexts);
     while (it) {
         ztx_wrap_t *w = model_map_it_value(it);
-        it = model_map_it_remove(it);
+        if (w->loop == ll) {
+            model_list_append(&owned, w);
+            it = model_map_it_remove(it);
+        } else {
+            it = model_map_it_next(it);
+        }
+    }
+    uv_mutex_unlock(&lib_lock);
+
+    ztx_wrap_t *w;
+    MODEL_LIST_FOREACH(w, owned) {
         if (w->ztx) {
             ziti_shutdown(w->ztx);
         }
         model_map_clear(&w->intercepts, (void (*)(void *)) free_ziti_intercept_cfg_v1_ptr);
+        clear_service_index(w);
     }
+    model_list_clear(&owned, NULL);
+
     complete_future(f, NULL, 0);
-    uv_close((uv_handle_t *) &q_async, NULL);
+    uv_close((uv_handle_t *) &ll->q_async, NULL);
 
-    uv_stop(q_async.loop);
+    uv_stop(l);
 }
 
 void do_timeout_cleanup(void *args, future_t *f, uv_loop_t *l) {
@@ -1263,12 +2229,16 @@ void do_timeout_cleanup(void *args, future_t *f, uv_loop_t *l) {
     }
 
     // Find the context that was being loaded
+    uv_mutex_lock(&lib_lock);
     ztx_wrap_t *wrap = model_map_get(&ziti_contexts, identity);
     if (wrap && wrap->ztx) {
-        ZITI_LOG(DEBUG, "Cleaning up timed out context ztx[%d]", wrap->ztx->id);
-
         // Remove from contexts map first to prevent further access
         model_map_remove(&ziti_contexts, identity);
+    }
+    uv_mutex_unlock(&lib_lock);
+
+    if (wrap && wrap->ztx) {
+        ZITI_LOG(DEBUG, "Cleaning up timed out context ztx[%d]", wrap->ztx->id);
 
         // Shutdown the context properly - this will set closing=true and handle cleanup
         ziti_shutdown(wrap->ztx);
@@ -1311,70 +2281,139 @@ int Ziti_enroll_identity(const char *jwt, const char *key, const char *cert, cha
     return rc;
 }
 
-static model_map host_to_ip;
-static model_map ip_to_host;
+#define ADDR_BASE 0x64400000 // 100.64.0.0
+
+static model_map host_to_ip; // case-folded hostname => address
+
+// addresses are assigned sequentially: reverse lookup is an index into this table
+static char **assigned_hosts;
+static size_t assigned_count;
+static size_t assigned_cap;
 
-static in_addr_t addr_counter = 0x64400000; // 100.64.0.0
-static void resolve_cb(void *r, future_t *f) {
+// runs on the loop owning req->ziti_handle
+static void resolve_cb(void *r, future_t *f, uv_loop_t *l) {
     struct conn_req_s *req = r;
 
-    ZITI_LOG(DEBUG, "resolving %s", req->host);
-    in_addr_t ip = (in_addr_t)(intptr_t)model_map_get(&host_to_ip, req->host);
-    if (ip == 0) {
-        const char *service_name;
-        MODEL_MAP_FOR(it, ziti_contexts) {
-            ztx_wrap_t *wrap = model_map_it_value(it);
-            service_name = find_service(wrap, 0, req->host, req->port);
-            if (service_name) {
-                ZITI_LOG(DEBUG, "%s:%d => %s", req->host, req->port, service_name);
-                break;
-            }
-        }
+    ztx_wrap_t *wrap = find_handle(req->ziti_handle);
+    const char *service_name = wrap ? find_service(wrap, 0, req->host, req->port) : NULL;
+    if (service_name == NULL) {
+        fail_future(f, EAI_NONAME);
+        return;
+    }
 
-        if (service_name == NULL) {
-            fail_future(f, EAI_NONAME);
-            return;
-        }
+    ZITI_LOG(DEBUG, "%s:%d => %s", req->host, req->port, service_name);
+    complete_future(f, NULL, 0);
+}
+
+static in_addr_t resolve_host(const char *hostname, in_port_t port) {
+    ZITI_LOG(DEBUG, "resolving %s", hostname);
+    char buf[256];
+    char *host = lower_copy(buf, sizeof(buf), hostname);
+
+    uv_mutex_lock(&lib_lock);
+    in_addr_t ip = (in_addr_t)(intptr_t)model_map_get(&host_to_ip, host);
+    uv_mutex_unlock(&lib_lock);
+    if (ip != 0) {
+        goto done;
+    }
+
+    size_t count;
+    ziti_handle_t *handles = context_handles(&count);
+    int err = EAI_NONAME;
+    for (size_t i = 0; i < count && err != 0; i++) {
+        struct conn_req_s req = {
+                .ziti_handle = handles[i],
+                .host = hostname,
+                .port = port,
+        };
+        future_t *f = schedule_on(handle_loop(handles[i]), resolve_cb, &req, true);
+        err = await_future(f, NULL);
+        destroy_future(f);
+    }
+    ziti_free(handles);
 
-        ip = htonl(++addr_counter);
-        ZITI_LOG(DEBUG, "assigned %s => %x", req->host, ip);
-        model_map_set(&host_to_ip, req->host, (void *) (uintptr_t) ip);
-        model_map_set_key(&ip_to_host, &ip, sizeof(ip), strdup(req->host));
+    if (err != 0) {
+        goto done;
     }
 
-    complete_future(f, (void *) (uintptr_t) ip, 0);
+    uv_mutex_lock(&lib_lock);
+    // another thread could have resolved the same host in the meantime
+    ip = (in_addr_t)(intptr_t)model_map_get(&host_to_ip, host);
+    if (ip == 0) {
+        if (assigned_count == assigned_cap) {
+            assigned_cap = assigned_cap ? assigned_cap * 2 : 64;
+            assigned_hosts = ziti_realloc(assigned_hosts, assigned_cap * sizeof(char *));
+        }
+        // reverse lookup reports the name as the application spelled it first
+        assigned_hosts[assigned_count++] = ziti_strdup(hostname);
+        ip = htonl(ADDR_BASE + (in_addr_t) assigned_count);
+        ZITI_LOG(DEBUG, "assigned %s => %x", hostname, ip);
+        model_map_set(&host_to_ip, host, (void *) (uintptr_t) ip);
+    }
+    uv_mutex_unlock(&lib_lock);
+
+done:
+    if (host != buf) ziti_free(host);
+    return ip;
 }
 
 ZITI_FUNC
+// entries are allocated by Ziti_resolve() with ziti_calloc()
 void Ziti_freeaddrinfo(struct addrinfo *addrlist) {
-    uv_freeaddrinfo(addrlist);
+    while (addrlist) {
+        struct addrinfo *next = addrlist->ai_next;
+        ziti_free(addrlist->ai_canonname);
+        ziti_free(addrlist->ai_addr);
+        ziti_free(addrlist);
+        addrlist = next;
+    }
 }
 
-static bool is_internal(const char *host) {
-    // refuse resolving controller/router addresses here
-    // this way Ziti context can operate even if resolve was high-jacked (e.g. notify)
-    MODEL_MAP_FOR(it, ziti_contexts) {
-        ztx_wrap_t *wrap = model_map_it_value(it);
-        if (wrap->ztx == NULL) continue;
+// runs on the context's loop: controller URL and channels are owned by it
+static void internal_cb(void *r, future_t *f, uv_loop_t *l) {
+    struct conn_req_s *req = r;
 
-        const char *ctrl = ziti_get_controller(wrap->ztx);
-        struct tlsuv_url_s url;
-        tlsuv_parse_url(&url, ctrl);
+    ztx_wrap_t *wrap = find_handle(req->ziti_handle);
+    if (wrap == NULL || wrap->ztx == NULL) {
+        fail_future(f, ZITI_NOT_FOUND);
+        return;
+    }
 
-        if (strncmp(host, url.hostname, url.hostname_len) == 0) {
-            return true;
-        }
+    const char *ctrl = ziti_get_controller(wrap->ztx);
+    struct tlsuv_url_s url;
+    if (ctrl && tlsuv_parse_url(&url, ctrl) == 0 && url.hostname &&
+        strncmp(req->host, url.hostname, url.hostname_len) == 0) {
+        complete_future(f, NULL, 0);
+        return;
+    }
 
-        if (wrap->ztx) {
-            MODEL_MAP_FOR(chit, wrap->ztx->channels) {
-                ziti_channel_t *ch = model_map_it_value(chit);
-                if (strcmp(ch->host, host) == 0) {
-                    return true;
-                }
-            }
+    MODEL_MAP_FOR(chit, wrap->ztx->channels) {
+        ziti_channel_t *ch = model_map_it_value(chit);
+        if (strcmp(ch->host, req->host) == 0) {
+            complete_future(f, NULL, 0);
+            return;
         }
     }
-    return false;
+    fail_future(f, ZITI_NOT_FOUND);
+}
+
+static bool is_internal(const char *host) {
+    // refuse resolving controller/router addresses here
+    // this way Ziti context can operate even if resolve was high-jacked (e.g. notify)
+    size_t count;
+    ziti_handle_t *handles = context_handles(&count);
+    bool internal = false;
+    for (size_t i = 0; i < count && !internal; i++) {
+        struct conn_req_s req = {
+                .ziti_handle = handles[i],
+                .host = host,
+        };
+        future_t *f = schedule_on(handle_loop(handles[i]), internal_cb, &req, true);
+        internal = await_future(f, NULL) == 0;
+        destroy_future(f);
+    }
+    ziti_free(handles);
+    return internal;
 }
 
 ZITI_FUNC
@@ -1404,11 +2443,11 @@ int Ziti_resolve(const char *host, const char *port, const struct addrinfo *hint
 
     in_port_t portnum = port ? (in_port_t) strtol(port, NULL, 10) : 0;
     ZITI_LOG(DEBUG, "host[%s] port[%s]", host, port);
-    struct addrinfo *res = calloc(1, sizeof(struct addrinfo));
+    struct addrinfo *res = ziti_calloc(1, sizeof(struct addrinfo));
     res->ai_socktype = socktype;
     res->ai_protocol = proto;
 
-    struct sockaddr_in *addr4 = calloc(1, sizeof(struct sockaddr_in6));
+    struct sockaddr_in *addr4 = ziti_calloc(1, sizeof(struct sockaddr_in6));
     int rc = 0;
     if ((rc = uv_ip4_addr(host, portnum, addr4)) == 0) {
         ZITI_LOG(DEBUG, "host[%s] port[%s] rc = %d", host, port, rc);
@@ -1429,26 +2468,16 @@ int Ziti_resolve(const char *host, const char *port, const struct addrinfo *hint
         return 0;
     }
 
-    MODEL_MAP_FOR(it, ziti_contexts) {
-        ztx_wrap_t *ztx = model_map_it_value(it);
-        await_future(ztx->services_loaded, NULL);
-    }
-
-    struct conn_req_s req = {
-            .ziti_handle = ZITI_INVALID_HANDLE,
-            .host = host,
-            .port = portnum,
-    };
+    await_services();
 
-    future_t *f = schedule_on_loop((loop_work_cb) resolve_cb, &req, true);
-    uintptr_t result;
-    int err = await_future(f, (void **) &result);
+    in_addr_t result = resolve_host(host, portnum);
+    int err = result == 0 ? EAI_NONAME : 0;
     set_error(err);
 
     if (err == 0) {
         addr4->sin_family = AF_INET;
         addr4->sin_port = htons(portnum);
-        addr4->sin_addr.s_addr = (in_addr_t)result;
+        addr4->sin_addr.s_addr = result;
 
         res->ai_family = AF_INET;
         res->ai_addr = (struct sockaddr *) addr4;
@@ -1457,31 +2486,37 @@ int Ziti_resolve(const char *host, const char *port, const struct addrinfo *hint
         res->ai_addrlen = sizeof(*addr4);
         *addrlist = res;
     } else {
-        free(res);
-        free(addr4);
+        ziti_free(res);
+        ziti_free(addr4);
     }
-    destroy_future(f);
 
     return err == 0 ? 0 : -1;
 }
 
 int Ziti_check_socket(ziti_socket_t fd) {
+    uv_mutex_lock(&lib_lock);
     ziti_sock_t *sock = model_map_get_key(&ziti_sockets, &fd, sizeof(fd));
-    if (sock == NULL) return 0;
-    if (sock->server) return 2;
-    return 1;
+    int rc = sock == NULL ? 0 : sock->server ? 2 : 1;
+    uv_mutex_unlock(&lib_lock);
+    return rc;
 }
 
 ZITI_FUNC
 const char *Ziti_lookup(in_addr_t addr) {
-    const char *hostname = model_map_get_key(&ip_to_host, &addr, sizeof(addr));
+    uint32_t idx = ntohl(addr) - (ADDR_BASE + 1);
+    const char *hostname = NULL;
+    uv_mutex_lock(&lib_lock);
+    if (idx < assigned_count) {
+        hostname = assigned_hosts[idx];
+    }
+    uv_mutex_unlock(&lib_lock);
     return hostname;
 }
 
 ZITI_FUNC
 void Ziti_free(void *o) {
     if (o) {
-        free(o);
+        ziti_free(o);
     }
 }
 
@@ -1501,15 +2536,15 @@ static void signers_cb(ziti_context ztx, int rc, ziti_jwt_signer_array arr, void
     ztx_wrap_t *w = req->wrap;
     int i;
     for (i = 0; w->signers && w->signers[i]; i++) {
-        free((void*)w->signers[i]);
+        ziti_free((void*)w->signers[i]);
     }
-    free(w->signers);
+    ziti_free(w->signers);
 
     for (i = 0; arr && arr[i]; i++);
 
-    char **signers = calloc(i + 1, sizeof(char*));
+    char **signers = ziti_calloc(i + 1, sizeof(char*));
     for (i = 0; arr && arr[i]; i++) {
-        signers[i] = strdup(arr[i]->name);
+        signers[i] = ziti_strdup(arr[i]->name);
     }
 
     req->wrap->signers = signers;
@@ -1534,7 +2569,7 @@ const char * const *  Ziti_get_ext_signers(ziti_handle_t handle) {
             .ziti_handle = handle,
     };
 
-    future_t *f = schedule_on_loop(get_signers, &req, true);
+    future_t *f = schedule_on(handle_loop(handle), get_signers, &req, true);
     const char * const * signers = NULL;
     int err = await_future(f, (void **) &signers);
     destroy_future(f);
@@ -1554,7 +2589,7 @@ static void on_ext_login(ziti_context ztx, const char *url, void *ctx) {
     if (url == NULL) {
         fail_future(f, EINVAL);
     } else {
-        char *login_url = strdup(url);
+        char *login_url = ziti_strdup(url);
         complete_future(f, login_url, 0);
     }
 }
@@ -1602,7 +2637,7 @@ char* Ziti_login_external(ziti_handle_t ztx, const char *signer_name) {
             .signer_name = signer_name,
     };
 
-    future_t *f = schedule_on_loop(set_ext_signer, &req, true);
+    future_t *f = schedule_on(handle_loop(ztx), set_ext_signer, &req, true);
 
     int err = await_future(f, NULL);
     destroy_future(f);
@@ -1612,7 +2647,7 @@ char* Ziti_login_external(ziti_handle_t ztx, const char *signer_name) {
         return NULL;
     }
 
-    f = schedule_on_loop(start_ext_login, &req, true);
+    f = schedule_on(handle_loop(ztx), start_ext_login, &req, true);
     char *login_url = NULL;
     err = await_future(f, (void **) &login_url);
     set_error(err);
@@ -1664,7 +2699,7 @@ int Ziti_login_totp(ziti_handle_t ztx, const char *code) {
             .code = code,
     };
 
-    future_t *f = schedule_on_loop(do_totp_login, &req, true);
+    future_t *f = schedule_on(handle_loop(ztx), do_totp_login, &req, true);
     int err = await_future(f, NULL);
     return err;
 }
@@ -1692,7 +2727,7 @@ static void wait_for_auth_cb(void *arg, future_t *f, uv_loop_t *l) {
 }
 
 int Ziti_wait_for_auth(ziti_handle_t ztx, int timeout_ms) {
-    future_t *f = schedule_on_loop(wait_for_auth_cb, (void *)(uintptr_t)ztx, true);
+    future_t *f = schedule_on(handle_loop(ztx), wait_for_auth_cb, (void *)(uintptr_t)ztx, true);
     int err = await_future_timed(f, NULL, timeout_ms);
     destroy_future(f);
     if(err == UV_ETIMEDOUT) {
@@ -0,0 +1,172 @@
+//
+// 	Copyright NetFoundry Inc.
+//
+// 	Licensed under the Apache License, Version 2.0 (the "License");
+// 	you may not use this file except in compliance with the License.
+// 	You may obtain a copy of the License at
+//
+// 	https://www.apache.org/licenses/LICENSE-2.0
+//
+// 	Unless required by applicable law or agreed to in writing, software
+// 	distributed under the License is distributed on an "AS IS" BASIS,
+// 	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// 	See the License for the specific language governing permissions and
+// 	limitations under the License.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+
+#include "zt_internal.h"
+#include "utils.h"
+
+// batch up changes arriving together (services, routers, controllers)
+#define CACHE_SAVE_DELAY 1000
+
+// older cache is more likely to send dials to removed services and routers than to help
+#define CACHE_MAX_AGE (7 * 24 * 60 * 60)
+
+static size_t array_count(void **arr) {
+    size_t count = 0;
+    while (arr && arr[count]) count++;
+    return count;
+}
+
+int ztx_cache_load(ziti_context ztx, ziti_bootstrap_cache *cache) {
+    const char *path = ztx->opts.cache_path;
+    if (path == NULL) {
+        return ZITI_CONFIG_NOT_FOUND;
+    }
+
+    char *content = NULL;
+    size_t len = 0;
+    int rc = load_file(path, 0, &content, &len);
+    if (rc != 0) {
+        ZTX_LOG(DEBUG, "no bootstrap cache[%s]: %s", path, uv_strerror(rc));
+        return ZITI_CONFIG_NOT_FOUND;
+    }
+
+    if (parse_ziti_bootstrap_cache(cache, content, len) < 0) {
+        ZTX_LOG(WARN, "ignoring invalid bootstrap cache[%s]", path);
+        free_ziti_bootstrap_cache(cache);
+        ziti_free(content);
+        return ZITI_INVALID_CONFIG;
+    }
+    ziti_free(content);
+
+    uv_timeval64_t now;
+    uv_gettimeofday(&now);
+    if (cache->saved_at.tv_sec == 0 || now.tv_sec - cache->saved_at.tv_sec > CACHE_MAX_AGE) {
+        ZTX_LOG(INFO, "ignoring stale bootstrap cache[%s] saved at %ld", path, (long) cache->saved_at.tv_sec);
+        free_ziti_bootstrap_cache(cache);
+        return ZITI_INVALID_CONFIG;
+    }
+
+    ZTX_LOG(INFO, "loaded bootstrap cache[%s]: %zd controllers, %zd services, %zd edge routers", path,
+            model_list_size(&cache->controllers),
+            array_count((void **) cache->services), array_count((void **) cache->edge_routers));
+    return ZITI_OK;
+}
+
+static void cache_save_cb(void *ctx) {
+    ztx_cache_save(ctx);
+}
+
+void ztx_cache_update(ziti_context ztx) {
+    if (ztx->opts.cache_path == NULL || ztx->cache_deadline.expire_cb != NULL) {
+        return;
+    }
+    ztx_set_deadline(ztx, CACHE_SAVE_DELAY, &ztx->cache_deadline, cache_save_cb, ztx);
+}
+
+static int write_file(const char *path, const char *content, size_t len) {
+    size_t tmp_len = strlen(path) + sizeof(".tmp");
+    char *tmp = ziti_malloc(tmp_len);
+    snprintf(tmp, tmp_len, "%s.tmp", path);
+
+    uv_fs_t req;
+    int rc = uv_fs_open(NULL, &req, tmp, O_WRONLY | O_CREAT | O_TRUNC, 0600, NULL);
+    uv_fs_req_cleanup(&req);
+    if (rc >= 0) {
+        uv_file f = rc;
+        uv_buf_t buf = uv_buf_init((char *) content, (unsigned int) len);
+        rc = uv_fs_write(NULL, &req, f, &buf, 1, 0, NULL);
+        uv_fs_req_cleanup(&req);
+        uv_fs_close(NULL, &req, f, NULL);
+        uv_fs_req_cleanup(&req);
+
+        if (rc >= 0 && (size_t) rc != len) {
+            rc = UV_EIO;
+        }
+    }
+
+    // replace atomically: readers never see a partial cache
+    if (rc >= 0) {
+        rc = uv_fs_rename(NULL, &req, tmp, path, NULL);
+        uv_fs_req_cleanup(&req);
+    }
+
+    if (rc < 0) {
+        uv_fs_unlink(NULL, &req, tmp, NULL);
+        uv_fs_req_cleanup(&req);
+    }
+    ziti_free(tmp);
+    return rc < 0 ? rc : 0;
+}
+
+void ztx_cache_save(ziti_context ztx) {
+    const char *path = ztx->opts.cache_path;
+    clear_deadline(&ztx->cache_deadline);
+    if (path == NULL) {
+        return;
+    }
+
+    // cache model only borrows context data for serialization
+    ziti_bootstrap_cache cache = {
+            .controllers = ztx->config.controllers,
+    };
+
+    size_t idx = 0;
+    const char *name;
+    ziti_service *s;
+    cache.services = ziti_calloc(model_map_size(&ztx->services) + 1, sizeof(ziti_service *));
+    MODEL_MAP_FOREACH(name, s, &ztx->services) {
+        cache.services[idx++] = s;
+    }
+
+    idx = 0;
+    ziti_channel_t *ch;
+    ziti_edge_router *routers = ziti_calloc(model_map_size(&ztx->channels) + 1, sizeof(ziti_edge_router));
+    cache.edge_routers = ziti_calloc(model_map_size(&ztx->channels) + 1, sizeof(ziti_edge_router *));
+    MODEL_MAP_FOREACH(name, ch, &ztx->channels) {
+        routers[idx].name = ch->name;
+        routers[idx].protocols.tls = ch->url;
+        cache.edge_routers[idx] = &routers[idx];
+        idx++;
+    }
+
+    uv_timeval64_t now;
+    uv_gettimeofday(&now);
+    cache.saved_at.tv_sec = (long) now.tv_sec;
+    cache.saved_at.tv_usec = now.tv_usec;
+
+    size_t len;
+    char *json = ziti_bootstrap_cache_to_json(&cache, 0, &len);
+    ziti_free(cache.services);
+    ziti_free(cache.edge_routers);
+    ziti_free(routers);
+
+    if (json == NULL) {
+        ZTX_LOG(WARN, "failed to serialize bootstrap cache");
+        return;
+    }
+
+    int rc = write_file(path, json, len);
+    if (rc != 0) {
+        ZTX_LOG(WARN, "failed to write bootstrap cache[%s]: %s", path, uv_strerror(rc));
+    } else {
+        ZTX_LOG(DEBUG, "saved bootstrap cache[%s]", path);
+    }
+    ziti_free(json);
+}
@@ -39,6 +39,7 @@ public:
         add_option("--bind,-b", bindings, "bind service <name:host:port>");
         add_option("--bind-udp,-B", udp_bindings, "bind udp service <name:host:port>");
         add_option("--proxy,-p", proxy, "proxy url");
+        add_option("--metrics-port", metrics_port, "serve Prometheus metrics on http://127.0.0.1:<port>/metrics (JSON state on /dump)");
 
         final_callback([this] {
             this->execute();
@@ -53,6 +54,7 @@ private:
     std::vector<std::string> bindings;
     std::vector<std::string> udp_bindings;
     std::string proxy;
+    int metrics_port = 0;
 
     void execute() const {
         run_opts opts{};
@@ -68,6 +70,7 @@ private:
             model_list_append(&opts.udp_bindings, udp.c_str());
         }
         if (!proxy.empty()) opts.proxy = this->proxy.c_str();
+        opts.metrics_port = this->metrics_port;
         int rc = run_proxy(&opts);
         ::exit(rc);
     }
@@ -22,6 +22,7 @@
 
 #include <utils.h>
 #include <ziti/ziti.h>
+#include <ziti/ziti_buffer.h>
 #include "proxy.h"
 
 #if(_WIN32)
@@ -36,6 +37,7 @@
 static int report_metrics = -1;
 static uv_timer_t report_timer;
 static uv_timer_t shutdown_timer;
+static uv_tcp_t metrics_server;
 
 static void signal_cb(uv_signal_t *s, int signum);
 
@@ -111,7 +113,7 @@ static void shutdown_timer_cb(uv_timer_t *t) {
 
 static void free_listener(struct listener *l) {
     free(l->service_name);
-    free(l);
+    ziti_free(l);
 }
 
 static void process_stop(uv_loop_t *loop, struct proxy_app_ctx *app_ctx) {
@@ -137,6 +139,11 @@ static void process_stop(uv_loop_t *loop, struct proxy_app_ctx *app_ctx) {
         uv_close((uv_handle_t *) &report_timer, NULL);
     }
 
+    if (uv_is_active((const uv_handle_t *) &metrics_server)) {
+        ZITI_LOG(INFO, "stopping metrics server");
+        uv_close((uv_handle_t *) &metrics_server, NULL);
+    }
+
     ZITI_LOG(INFO, "stopping signal handlers");
     for (int i = 0; i < sizeof(signals)/sizeof(signals[0]); i++) {
         uv_close((uv_handle_t *) &signals[i].sig, NULL);
@@ -228,8 +235,8 @@ static void close_cb(uv_handle_t *h) {
         ziti_close(clt->ziti_conn, NULL);
     }
     LIST_REMOVE(clt, next);
-    free(clt);
-    free(h);
+    ziti_free(clt);
+    ziti_free(h);
 }
 
 static void on_ziti_close(ziti_connection conn) {
@@ -246,7 +253,7 @@ static void on_ziti_close(ziti_connection conn) {
 }
 
 static void on_bridge_close(uv_handle_t *handle) {
-    uv_close(handle, (uv_close_cb) free);
+    uv_close(handle, (uv_close_cb) ziti_free);
 }
 
 void on_ziti_connect(ziti_connection conn, int status) {
@@ -290,8 +297,9 @@ static void on_client(uv_stream_t *server, int status) {
     c->data = clt;
 
     CATCH(ziti) {
-        free(clt);
         ZITI_LOG(ERROR, "closing client [%s]", clt->addr_s);
+        // close_cb unlinks and frees the client
+        c->data = clt;
         uv_close((uv_handle_t *) c, close_cb);
     }
 
@@ -317,7 +325,7 @@ static void update_listener(ziti_service *service, int status, struct listener *
         TRY(uv, uv_ip4_addr("0.0.0.0", l->port, addr));
         TRY(uv, uv_tcp_bind(&l->server, (const struct sockaddr *) addr, 0));
         TRY(uv, uv_listen((uv_stream_t *) &l->server, 5, on_client));
-        free(addr);
+        ziti_free(addr);
     } else {
         if (uv_is_active((const uv_handle_t *) &l->server)) {
             ZITI_LOG(WARN, "service %s is not available. stopping listener[%d]", l->service_name, l->port);
@@ -349,11 +357,11 @@ static void on_ziti_accept(ziti_connection clt, int status) {
         } else {
             ZITI_LOG(WARN, "failed to bridge ziti connection and backend handle");
             ziti_close(clt, NULL);
-            uv_close(s, (uv_close_cb) free);
+            uv_close(s, (uv_close_cb) ziti_free);
         }
     } else {
         ziti_close(clt, NULL);
-        uv_close(s, (uv_close_cb) free);
+        uv_close(s, (uv_close_cb) ziti_free);
     }
 }
 
@@ -368,10 +376,10 @@ static void on_tcp_connect(uv_connect_t *conn_req, int status) {
         uv_getnameinfo_t name;
         uv_getnameinfo(conn_req->handle->loop, &name, NULL, b->addr->ai_addr, NI_NUMERICHOST);
         ZITI_LOG(WARN, "failed to establish connection to tcp:%s:%s", name.host, name.service);
-        uv_close((uv_handle_t *) conn_req->handle, (uv_close_cb) free);
+        uv_close((uv_handle_t *) conn_req->handle, (uv_close_cb) ziti_free);
         ziti_close(clt, NULL);
     }
-    free(conn_req);
+    ziti_free(conn_req);
 }
 
 static void binding_client_cb(ziti_connection srv, ziti_connection clt, int status, const ziti_client_ctx *clt_ctx) {
@@ -390,8 +398,8 @@ static void binding_client_cb(ziti_connection srv, ziti_connection clt, int stat
                 conn_req->data = clt;
                 if (uv_tcp_connect(conn_req, tcp, b->addr->ai_addr, on_tcp_connect) != 0) {
                     ziti_close(clt, NULL);
-                    uv_close((uv_handle_t *) tcp, (uv_close_cb) free);
-                    free(conn_req);
+                    uv_close((uv_handle_t *) tcp, (uv_close_cb) ziti_free);
+                    ziti_free(conn_req);
                 }
                 break;
             }
@@ -444,7 +452,7 @@ static void on_ziti_event(ziti_context ztx, const ziti_event_t *event) {
         case ZitiConfigEvent: {
             char *cfg = ziti_config_to_json(event->cfg.config, 0, NULL);
             printf("new config:\n%s\n\n", cfg);
-            free(cfg);
+            ziti_free(cfg);
             break;
         }
 
@@ -585,7 +593,7 @@ void mfa_prompt(struct mfa_work *mfa_wr) {
     prompt_stdin(code, 9);
 
     if (strlen(code) > 0) {
-        mfa_wr->code = strdup(code);
+        mfa_wr->code = ziti_strdup(code);
     } else {
         ZITI_LOG(ERROR, "no mfa token provided, exiting");
         exit(1);
@@ -644,7 +652,7 @@ static void ext_auth_done(uv_work_t *wr, int status) {
     struct proxy_app_ctx *pxy = wr->data;
 
     ziti_ext_auth(pxy->ziti, ext_url_launch, NULL);
-    free(wr);
+    ziti_free(wr);
 }
 
 void ext_auth_event_handler(ziti_context ztx, const char *name) {
@@ -662,6 +670,118 @@ void ext_auth_event_handler(ziti_context ztx, const char *name) {
 
 static struct proxy_app_ctx app_ctx = {0};
 
+// minimal HTTP endpoint for metrics scraping: GET /metrics
+struct metrics_client {
+    uv_tcp_t tcp;
+    uv_write_t wr;
+    char req[2048];
+    size_t req_len;
+    char *resp;
+};
+
+static void metrics_client_close_cb(uv_handle_t *h) {
+    struct metrics_client *mc = (struct metrics_client *) h;
+    ziti_free(mc->resp);
+    ziti_free(mc);
+}
+
+static void metrics_alloc(uv_handle_t *h, size_t suggested, uv_buf_t *b) {
+    struct metrics_client *mc = (struct metrics_client *) h;
+    *b = uv_buf_init(mc->req + mc->req_len, sizeof(mc->req) - mc->req_len - 1);
+}
+
+static void metrics_write_cb(uv_write_t *wr, int status) {
+    uv_close((uv_handle_t *) wr->handle, metrics_client_close_cb);
+}
+
+static void metrics_read(uv_stream_t *s, ssize_t len, const uv_buf_t *b) {
+    struct metrics_client *mc = (struct metrics_client *) s;
+    if (len == 0) return;
+    if (len < 0 || mc->req_len + len >= sizeof(mc->req) - 1) {
+        uv_close((uv_handle_t *) s, metrics_client_close_cb);
+        return;
+    }
+
+    mc->req_len += len;
+    mc->req[mc->req_len] = '\0';
+    // wait for complete request head
+    if (strstr(mc->req, "\r\n\r\n") == NULL) return;
+    uv_read_stop(s);
+
+    const char *status = "200 OK";
+    ziti_metrics_format fmt = ziti_metrics_prometheus;
+    const char *content_type = "text/plain; version=0.0.4; charset=utf-8";
+    if (strstr(mc->req, "application/openmetrics-text") != NULL) {
+        fmt = ziti_metrics_openmetrics;
+        content_type = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+    }
+
+    string_buf_t *body = new_string_buf();
+    if (strncmp(mc->req, "GET /dump ", strlen("GET /dump ")) == 0) {
+        content_type = "application/json";
+        if (app_ctx.ziti != NULL) {
+            ziti_dump_json(app_ctx.ziti, body);
+        }
+    } else if (strncmp(mc->req, "GET /metrics ", strlen("GET /metrics ")) != 0) {
+        status = "404 Not Found";
+        content_type = "text/plain";
+    } else if (app_ctx.ziti != NULL) {
+        ziti_metrics_write(app_ctx.ziti, fmt, (int (*)(void *, const char *, ...)) string_buf_fmt, body);
+    }
+    size_t body_len;
+    char *content = string_buf_to_string(body, &body_len);
+    delete_string_buf(body);
+
+    string_buf_t *resp = new_string_buf();
+    string_buf_fmt(resp, "HTTP/1.1 %s\r\n"
+                         "Content-Type: %s\r\n"
+                         "Content-Length: %zu\r\n"
+                         "Connection: close\r\n\r\n", status, content_type, body_len);
+    string_buf_append(resp, content);
+    ziti_free(content);
+
+    size_t resp_len;
+    mc->resp = string_buf_to_string(resp, &resp_len);
+    delete_string_buf(resp);
+
+    uv_buf_t out = uv_buf_init(mc->resp, (unsigned int) resp_len);
+    if (uv_write(&mc->wr, s, &out, 1, metrics_write_cb) != 0) {
+        uv_close((uv_handle_t *) s, metrics_client_close_cb);
+    }
+}
+
+static void on_metrics_client(uv_stream_t *server, int status) {
+    if (status != 0) {
+        ZITI_LOG(WARN, "metrics server error: %s", uv_strerror(status));
+        return;
+    }
+
+    NEWP(mc, struct metrics_client);
+    uv_tcp_init(server->loop, &mc->tcp);
+    if (uv_accept(server, (uv_stream_t *) &mc->tcp) != 0 ||
+        uv_read_start((uv_stream_t *) &mc->tcp, metrics_alloc, metrics_read) != 0) {
+        uv_close((uv_handle_t *) &mc->tcp, metrics_client_close_cb);
+    }
+}
+
+static int start_metrics_server(uv_loop_t *loop, int port) {
+    struct sockaddr_in addr;
+    uv_ip4_addr("127.0.0.1", port, &addr);
+    uv_tcp_init(loop, &metrics_server);
+    int rc = uv_tcp_bind(&metrics_server, (const struct sockaddr *) &addr, 0);
+    if (rc == 0) {
+        rc = uv_listen((uv_stream_t *) &metrics_server, 5, on_metrics_client);
+    }
+    if (rc != 0) {
+        ZITI_LOG(ERROR, "failed to start metrics server on port[%d]: %s", port, uv_strerror(rc));
+        uv_close((uv_handle_t *) &metrics_server, NULL);
+        return rc;
+    }
+    uv_unref((uv_handle_t *) &metrics_server);
+    ZITI_LOG(INFO, "serving metrics on http://127.0.0.1:%d/metrics", port);
+    return 0;
+}
+
 static void stopper_alloc(uv_handle_t *h, size_t i, uv_buf_t *pBuf) {
     static char buf[1024];
     *pBuf = uv_buf_init(buf, sizeof(buf));
@@ -859,6 +979,9 @@ int run_proxy(struct run_opts *opts) {
         uv_timer_start(&report_timer, reporter_cb, report_metrics * 1000, report_metrics * 1000);
         uv_unref((uv_handle_t *) &report_timer);
     }
+    if (opts->metrics_port > 0) {
+        start_metrics_server(loop, opts->metrics_port);
+    }
     ZITI_LOG(INFO, "starting event loop");
     uv_run(loop, UV_RUN_DEFAULT);
 
@@ -876,7 +999,7 @@ int run_proxy(struct run_opts *opts) {
     if (close_rc != 0) {
         uv_print_active_handles(loop, stderr);
     }
-    free(loop);
+    ziti_free(loop);
     exit(excode);
 }
 
@@ -28,6 +28,7 @@ struct run_opts {
     model_list bindings;
     model_list udp_bindings;
     const char *proxy;
+    int metrics_port;
 };
 
 #if __cplusplus
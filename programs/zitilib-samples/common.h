@@ -70,7 +70,7 @@ static inline ziti_handle_t init_context(const char *identity) {
         char *url = Ziti_login_external(ztx, signers[idx]);
 
         printf("Use your browser to open this URL: %s\n", url);
-        free(url);
+        ziti_mem_free(url);
         rc = Ziti_wait_for_auth(ztx, 60000); // wait for a minute
     }
 
@@ -0,0 +1,112 @@
+// Copyright (c) 2025.  NetFoundry Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// writes benchmark results as JSON to $ZITI_BENCH_JSON (default: ziti_bench.json)
+
+#include <catch2/catch_all.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <ziti/ziti.h>
+
+namespace {
+
+struct bench_result {
+    std::string test;
+    std::string name;
+    size_t samples;
+    uint64_t iterations;
+    // nanoseconds per iteration
+    double mean;
+    double mean_low;
+    double mean_high;
+    double std_dev;
+};
+
+std::string json_string(const std::string &s) {
+    std::string out = "\"";
+    for (char c: s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            out += esc;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+class bench_json_listener : public Catch::EventListenerBase {
+public:
+    using Catch::EventListenerBase::EventListenerBase;
+
+    void testCaseStarting(const Catch::TestCaseInfo &info) override {
+        test = info.name;
+    }
+
+    void benchmarkEnded(const Catch::BenchmarkStats<> &stats) override {
+        results.push_back({
+                test, stats.info.name,
+                stats.samples.size(), static_cast<uint64_t>(stats.info.iterations),
+                stats.mean.point.count(), stats.mean.lower_bound.count(), stats.mean.upper_bound.count(),
+                stats.standardDeviation.point.count(),
+        });
+    }
+
+    void testRunEnded(const Catch::TestRunStats &) override {
+        if (results.empty()) return;
+
+        const char *path = std::getenv("ZITI_BENCH_JSON");
+        if (path == nullptr || *path == '\0') {
+            path = "ziti_bench.json";
+        }
+
+        FILE *out = fopen(path, "w");
+        if (out == nullptr) {
+            fprintf(stderr, "failed to write benchmark results to %s\n", path);
+            return;
+        }
+
+        const ziti_version *ver = ziti_get_version();
+        fprintf(out, "{\"timestamp\":%lld,\"version\":%s,\"revision\":%s,\"benchmarks\":[",
+                static_cast<long long>(time(nullptr)),
+                json_string(ver->version).c_str(), json_string(ver->revision).c_str());
+        for (size_t i = 0; i < results.size(); i++) {
+            auto &r = results[i];
+            fprintf(out, "%s\n{\"test\":%s,\"name\":%s,\"samples\":%zu,\"iterations\":%llu,"
+                         "\"mean_ns\":%.1f,\"mean_low_ns\":%.1f,\"mean_high_ns\":%.1f,\"std_dev_ns\":%.1f}",
+                    i == 0 ? "" : ",", json_string(r.test).c_str(), json_string(r.name).c_str(),
+                    r.samples, static_cast<unsigned long long>(r.iterations),
+                    r.mean, r.mean_low, r.mean_high, r.std_dev);
+        }
+        fprintf(out, "\n]}\n");
+        fclose(out);
+    }
+
+private:
+    std::string test;
+    std::vector<bench_result> results;
+};
+
+}
+
+CATCH_REGISTER_LISTENER(bench_json_listener)
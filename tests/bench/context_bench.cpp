@@ -0,0 +1,95 @@
+// Copyright (c) 2025.  NetFoundry Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <string>
+#include <vector>
+
+#include "zt_internal.h"
+
+// bare context: just enough state for lookups and deadlines, no controller or channels
+static ziti_context bench_context() {
+    auto ztx = (ziti_context) calloc(1, sizeof(struct ziti_ctx));
+    ztx->loop = uv_default_loop();
+    LIST_INIT(&ztx->deadlines);
+    return ztx;
+}
+
+TEST_CASE("service lookup", "[bench]") {
+    const int count = 5000;
+    ziti_context ztx = bench_context();
+
+    char json[512];
+    for (int i = 0; i < count; i++) {
+        snprintf(json, sizeof(json),
+                 R"({"id":"svc-id-%d","name":"service-%d","permissions":["Dial"],)"
+                 R"("config":{"intercept.v1":{"protocols":["tcp"],"addresses":["svc%d.ziti","100.64.%d.%d/32"],)"
+                 R"("portRanges":[{"low":%d,"high":%d}]}}})",
+                 i, i, i, i / 250, i % 250, 1000 + i, 1000 + i);
+        ziti_service *s = nullptr;
+        REQUIRE(parse_ziti_service_ptr(&s, json, strlen(json)) > 0);
+        model_map_set(&ztx->services, s->name, s);
+    }
+
+    ziti_address hostname;
+    parse_ziti_address_str(&hostname, "svc4999.ziti");
+    BENCHMARK("ziti_service_for_addr(hostname, 5k)") {
+        return ziti_service_for_addr(ztx, ziti_protocols.tcp, &hostname, 1000 + count - 1);
+    };
+
+    ziti_address ip;
+    parse_ziti_address_str(&ip, "100.64.10.10");
+    BENCHMARK("ziti_service_for_addr(ip, 5k)") {
+        return ziti_service_for_addr(ztx, ziti_protocols.tcp, &ip, 3510);
+    };
+
+    BENCHMARK("ziti_service_for_addr(miss, 5k)") {
+        return ziti_service_for_addr(ztx, ziti_protocols.udp, &ip, 3510);
+    };
+
+    model_map_clear(&ztx->services, (void (*)(void *)) free_ziti_service_ptr);
+    free(ztx);
+}
+
+static void deadline_cb(void *) {}
+
+TEST_CASE("deadlines", "[bench]") {
+    ziti_context ztx = bench_context();
+
+    // connection timeouts spread over a minute
+    std::vector<deadline_t> deadlines(1000);
+    for (size_t i = 0; i < deadlines.size(); i++) {
+        do_ztx_set_deadline(ztx, (i * 7919) % 60000, &deadlines[i], deadline_cb, "deadline_cb", nullptr);
+    }
+
+    size_t idx = 0;
+    BENCHMARK("ztx_set_deadline(reset, 1k pending)") {
+        idx = (idx + 1) % deadlines.size();
+        do_ztx_set_deadline(ztx, (idx * 104729) % 60000, &deadlines[idx], deadline_cb, "deadline_cb", nullptr);
+        return LIST_FIRST(&ztx->deadlines);
+    };
+
+    deadline_t d = {};
+    BENCHMARK("ztx_set_deadline/clear_deadline(1k pending)") {
+        do_ztx_set_deadline(ztx, 30000, &d, deadline_cb, "deadline_cb", nullptr);
+        clear_deadline(&d);
+        return d.expire_cb;
+    };
+
+    for (auto &dl: deadlines) {
+        clear_deadline(&dl);
+    }
+    free(ztx);
+}
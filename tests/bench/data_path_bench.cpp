@@ -0,0 +1,180 @@
+// Copyright (c) 2025.  NetFoundry Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <sodium.h>
+
+#include <cstring>
+#include <vector>
+
+#include "alloc.h"
+#include "message.h"
+#include "buffer.h"
+#include "pool.h"
+
+TEST_CASE("message framing", "[bench]") {
+    uint32_t conn_id = 42;
+    uint32_t seq = 1;
+    const hdr_t headers[] = {
+            var_header(ConnIdHeader, conn_id),
+            var_header(SeqHeader, seq),
+    };
+    std::vector<uint8_t> body(16 * 1024, 0x5a);
+
+    pool_t *pool = pool_new(sizeof(message) + 0x20000, 32, (void (*)(void *)) message_free);
+
+    BENCHMARK("message_new(16KiB)") {
+        message *m = message_new(pool, ContentTypeData, headers, 2, body.size());
+        memcpy(m->body, body.data(), body.size());
+        pool_return_obj(m);
+        return m;
+    };
+
+    BENCHMARK("message_new(unpooled)") {
+        message *m = message_new(nullptr, ContentTypeData, headers, 2, body.size());
+        pool_return_obj(m);
+        return m;
+    };
+
+    message *m = message_new(pool, ContentTypeData, headers, 2, body.size());
+    BENCHMARK("parse_hdrs") {
+        hdr_t *hdrs = nullptr;
+        int count = parse_hdrs(m->headers, m->header.headers_len, &hdrs);
+        ziti_free(hdrs);
+        return count;
+    };
+
+    uint8_t wire[HEADER_SIZE];
+    BENCHMARK("header_to_buffer") {
+        header_to_buffer(&m->header, wire);
+        return wire[HEADER_SIZE - 1];
+    };
+
+    BENCHMARK("header_from_buffer") {
+        header_t h;
+        header_from_buffer(&h, m->msgbufp);
+        return h.body_len;
+    };
+    pool_return_obj(m);
+
+    pool_destroy(pool);
+}
+
+TEST_CASE("buffer", "[bench]") {
+    const size_t chunk = 16 * 1024;
+    std::vector<uint8_t> data(chunk, 0x5a);
+
+    BENCHMARK("buffer_append_copy/get_next(16KiB)") {
+        buffer *b = new_buffer();
+        for (int i = 0; i < 8; i++) {
+            buffer_append_copy(b, data.data(), data.size());
+        }
+
+        uint8_t *p;
+        size_t total = 0;
+        ssize_t len;
+        while ((len = buffer_get_next(b, 4096, &p)) > 0) {
+            total += len;
+        }
+        free_buffer(b);
+        return total;
+    };
+
+    BENCHMARK("buffer_append/get_next(16KiB)") {
+        buffer *b = new_buffer();
+        for (int i = 0; i < 8; i++) {
+            // buffer takes ownership, same as data read off the channel
+            auto copy = (uint8_t *) ziti_malloc(data.size());
+            memcpy(copy, data.data(), data.size());
+            buffer_append(b, copy, data.size());
+        }
+
+        uint8_t *p;
+        size_t total = 0;
+        ssize_t len;
+        while ((len = buffer_get_next(b, 4096, &p)) > 0) {
+            total += len;
+        }
+        free_buffer(b);
+        return total;
+    };
+}
+
+TEST_CASE("pool", "[bench]") {
+    pool_t *pool = pool_new(256, 64, nullptr);
+
+    BENCHMARK("pool_alloc_obj/return") {
+        void *obj = pool_alloc_obj(pool);
+        pool_return_obj(obj);
+        return obj;
+    };
+
+    BENCHMARK("pool_alloc_obj/return(x32)") {
+        void *objs[32];
+        for (auto &o: objs) {
+            o = pool_alloc_obj(pool);
+        }
+        for (auto &o: objs) {
+            pool_return_obj(o);
+        }
+        return objs[0];
+    };
+
+    pool_destroy(pool);
+}
+
+TEST_CASE("secretstream", "[bench]") {
+    REQUIRE(sodium_init() != -1);
+
+    const size_t chunk = 16 * 1024;
+    std::vector<uint8_t> plain(chunk, 0x5a);
+    std::vector<uint8_t> cipher(chunk + crypto_secretstream_xchacha20poly1305_ABYTES);
+    std::vector<uint8_t> out(chunk);
+
+    uint8_t key[crypto_secretstream_xchacha20poly1305_KEYBYTES];
+    uint8_t header[crypto_secretstream_xchacha20poly1305_HEADERBYTES];
+    crypto_secretstream_xchacha20poly1305_keygen(key);
+
+    crypto_secretstream_xchacha20poly1305_state tx;
+    crypto_secretstream_xchacha20poly1305_init_push(&tx, header, key);
+
+    BENCHMARK("push(16KiB)") {
+        unsigned long long clen;
+        crypto_secretstream_xchacha20poly1305_push(&tx, cipher.data(), &clen,
+                                                   plain.data(), plain.size(), nullptr, 0, 0);
+        return clen;
+    };
+
+    BENCHMARK_ADVANCED("pull(16KiB)")(Catch::Benchmark::Chronometer meter) {
+        // every pull needs a fresh stream matching a single push
+        crypto_secretstream_xchacha20poly1305_state push_st;
+        crypto_secretstream_xchacha20poly1305_init_push(&push_st, header, key);
+        unsigned long long clen;
+        crypto_secretstream_xchacha20poly1305_push(&push_st, cipher.data(), &clen,
+                                                   plain.data(), plain.size(), nullptr, 0, 0);
+
+        std::vector<crypto_secretstream_xchacha20poly1305_state> states(meter.runs());
+        for (auto &st: states) {
+            crypto_secretstream_xchacha20poly1305_init_pull(&st, header, key);
+        }
+        meter.measure([&](int i) {
+            unsigned long long mlen;
+            uint8_t tag;
+            return crypto_secretstream_xchacha20poly1305_pull(&states[i], out.data(), &mlen, &tag,
+                                                              cipher.data(), clen, nullptr, 0);
+        });
+    };
+}
@@ -0,0 +1,641 @@
+// Copyright (c) 2025.  NetFoundry Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mock_router.h"
+
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "alloc.h"
+#include "endian_internal.h"
+#include "message.h"
+
+#define READ_CHUNK (64 * 1024)
+
+struct link_s;
+
+struct conn_end {
+    link_s *link;
+    uint32_t conn_id;
+};
+
+// Dial sent to the bound connection, waiting for DialSuccess
+struct pending_dial {
+    conn_end dialer;
+    uint32_t connect_seq;
+    uint32_t rt_conn_id;
+};
+
+struct mock_router_s {
+    uv_loop_t *loop;
+    mock_router_mode mode;
+    uv_tcp_t server;
+    SSL_CTX *ssl_ctx;
+    std::string url;
+    std::string ca;
+
+    std::set<link_s *> links;
+    // token -> bound connection
+    std::map<std::string, conn_end> bindings;
+    uint32_t next_conn_id;
+    int open_handles;
+};
+
+struct link_s {
+    mock_router_s *router;
+    uv_tcp_t tcp;
+    SSL *ssl;
+    BIO *in;
+    BIO *out;
+    bool closing;
+
+    // decrypted bytes, not framed yet
+    std::vector<uint8_t> inbound;
+    uint32_t seq;
+
+    // local conn_id -> other end of circuit (itself in echo mode)
+    std::map<uint32_t, conn_end> circuits;
+    // Dial seq -> dial request
+    std::map<uint32_t, pending_dial> dials;
+};
+
+struct msg_view {
+    header_t header;
+    hdr_t *hdrs;
+    int nhdrs;
+    const uint8_t *body;
+};
+
+static void close_link(link_s *l);
+
+static bool get_hdr(const msg_view &m, uint32_t id, const uint8_t **val, uint32_t *len) {
+    for (int i = 0; i < m.nhdrs; i++) {
+        if (m.hdrs[i].header_id == id) {
+            *val = m.hdrs[i].value;
+            *len = m.hdrs[i].length;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool get_int32_hdr(const msg_view &m, uint32_t id, uint32_t *v) {
+    const uint8_t *val;
+    uint32_t len;
+    if (!get_hdr(m, id, &val, &len) || len != sizeof(*v)) {
+        return false;
+    }
+    memcpy(v, val, sizeof(*v));
+    *v = le32toh(*v);
+    return true;
+}
+
+static void send_msg(link_s *l, uint32_t content, const hdr_t *hdrs, int nhdrs, const uint8_t *body, uint32_t len) {
+    if (l->closing) {
+        return;
+    }
+
+    message *m = message_new(nullptr, content, hdrs, nhdrs, len);
+    if (len > 0) {
+        memcpy(m->body, body, len);
+    }
+    message_set_seq(m, &l->seq);
+    // memory BIO takes all of it
+    if (SSL_write(l->ssl, m->msgbufp, (int) m->msgbuflen) <= 0) {
+        fprintf(stderr, "mock_router: TLS write failed\n");
+    }
+    pool_return_obj(m);
+}
+
+static void send_reply(link_s *l, uint32_t content, uint32_t reply_for, uint32_t conn_id,
+                       const uint8_t *body, uint32_t len) {
+    uint32_t reply_to = htole32(reply_for);
+    uint32_t id = htole32(conn_id);
+    hdr_t hdrs[] = {
+            var_header(ReplyForHeader, reply_to),
+            var_header(ConnIdHeader, id),
+    };
+    send_msg(l, content, hdrs, conn_id ? 2 : 1, body, len);
+}
+
+// re-address message to the other end of the circuit
+static void forward_msg(const conn_end &to, const msg_view &m) {
+    std::vector<hdr_t> hdrs(m.hdrs, m.hdrs + m.nhdrs);
+    uint32_t id = htole32(to.conn_id);
+    for (auto &h: hdrs) {
+        if (h.header_id == ConnIdHeader) {
+            h = var_header(ConnIdHeader, id);
+        }
+    }
+    send_msg(to.link, m.header.content, hdrs.data(), (int) hdrs.size(), m.body, m.header.body_len);
+}
+
+static void send_closed(const conn_end &to, const char *reason) {
+    uint32_t id = htole32(to.conn_id);
+    hdr_t hdrs[] = {
+            var_header(ConnIdHeader, id),
+    };
+    send_msg(to.link, ContentTypeStateClosed, hdrs, 1, (const uint8_t *) reason, (uint32_t) strlen(reason));
+}
+
+static void on_hello(link_s *l, const msg_view &m) {
+    uint8_t success = 1;
+    uint32_t reply_to = htole32(m.header.seq);
+    const char version[] = "mock-router";
+    hdr_t hdrs[] = {
+            var_header(ReplyForHeader, reply_to),
+            var_header(ResultSuccessHeader, success),
+            header(HelloVersionHeader, sizeof(version) - 1, version),
+    };
+    send_msg(l, ContentTypeResultType, hdrs, 3, nullptr, 0);
+}
+
+static void on_latency(link_s *l, const msg_view &m) {
+    const uint8_t *ts;
+    uint32_t ts_len;
+    uint32_t reply_to = htole32(m.header.seq);
+    hdr_t hdrs[] = {
+            var_header(ReplyForHeader, reply_to),
+            {},
+    };
+    int nhdrs = 1;
+    if (get_hdr(m, LatencyProbeTime, &ts, &ts_len)) {
+        hdrs[nhdrs++] = header(LatencyProbeTime, ts_len, ts);
+    }
+    send_msg(l, ContentTypeResultType, hdrs, nhdrs, nullptr, 0);
+}
+
+static void on_connect(link_s *l, const msg_view &m, uint32_t conn_id) {
+    mock_router_s *r = l->router;
+    std::string token((const char *) m.body, m.header.body_len);
+
+    auto b = r->bindings.find(token);
+    if (r->mode == mock_router_echo || b == r->bindings.end()) {
+        l->circuits[conn_id] = conn_end{l, conn_id};
+        send_reply(l, ContentTypeStateConnected, m.header.seq, conn_id, nullptr, 0);
+        return;
+    }
+
+    const conn_end &host = b->second;
+    pending_dial dial = {
+            conn_end{l, conn_id}, m.header.seq, r->next_conn_id++,
+    };
+
+    uint32_t bind_id = htole32(host.conn_id);
+    uint32_t rt_id = htole32(dial.rt_conn_id);
+    std::vector<hdr_t> hdrs = {
+            var_header(ConnIdHeader, bind_id),
+            var_header(RouterProvidedConnId, rt_id),
+    };
+    const uint8_t *val;
+    uint32_t len;
+    if (get_hdr(m, CallerIdHeader, &val, &len)) {
+        hdrs.push_back(header(CallerIdHeader, len, val));
+    }
+    if (get_hdr(m, AppDataHeader, &val, &len)) {
+        hdrs.push_back(header(AppDataHeader, len, val));
+    }
+    if (get_hdr(m, PublicKeyHeader, &val, &len)) {
+        hdrs.push_back(header(PublicKeyHeader, len, val));
+    }
+    send_msg(host.link, ContentTypeDial, hdrs.data(), (int) hdrs.size(), nullptr, 0);
+    host.link->dials[host.link->seq] = dial;
+}
+
+static void on_dial_result(link_s *l, const msg_view &m) {
+    uint32_t reply_to;
+    if (!get_int32_hdr(m, ReplyForHeader, &reply_to)) {
+        return;
+    }
+
+    auto it = l->dials.find(reply_to);
+    if (it == l->dials.end()) {
+        return;
+    }
+    pending_dial dial = it->second;
+    l->dials.erase(it);
+
+    if (m.header.content == ContentTypeDialSuccess) {
+        l->circuits[dial.rt_conn_id] = dial.dialer;
+        dial.dialer.link->circuits[dial.dialer.conn_id] = conn_end{l, dial.rt_conn_id};
+        send_reply(dial.dialer.link, ContentTypeStateConnected, dial.connect_seq, dial.dialer.conn_id, nullptr, 0);
+    } else {
+        send_reply(dial.dialer.link, ContentTypeStateClosed, dial.connect_seq, dial.dialer.conn_id,
+                   m.body, m.header.body_len);
+    }
+}
+
+static void on_closed(link_s *l, uint32_t conn_id) {
+    auto it = l->circuits.find(conn_id);
+    if (it == l->circuits.end()) {
+        return;
+    }
+
+    conn_end peer = it->second;
+    l->circuits.erase(it);
+    if (peer.link != l || peer.conn_id != conn_id) {
+        peer.link->circuits.erase(peer.conn_id);
+        send_closed(peer, "closed by peer");
+    }
+}
+
+static void dispatch(link_s *l, const msg_view &m) {
+    mock_router_s *r = l->router;
+    uint32_t conn_id = 0;
+    get_int32_hdr(m, ConnIdHeader, &conn_id);
+
+    switch (m.header.content) {
+        case ContentTypeHelloType:
+            on_hello(l, m);
+            break;
+
+        case ContentTypeLatencyType:
+            on_latency(l, m);
+            break;
+
+        case ContentTypeUpdateToken:
+            send_reply(l, ContentTypeUpdateTokenSuccess, m.header.seq, 0, nullptr, 0);
+            break;
+
+        case ContentTypeConnect:
+            on_connect(l, m, conn_id);
+            break;
+
+        case ContentTypeBind: {
+            std::string token((const char *) m.body, m.header.body_len);
+            r->bindings[token] = conn_end{l, conn_id};
+            send_reply(l, ContentTypeStateConnected, m.header.seq, conn_id, nullptr, 0);
+            break;
+        }
+
+        case ContentTypeUnbind: {
+            std::string token((const char *) m.body, m.header.body_len);
+            auto b = r->bindings.find(token);
+            if (b != r->bindings.end() && b->second.link == l) {
+                r->bindings.erase(b);
+            }
+            break;
+        }
+
+        case ContentTypeDialSuccess:
+        case ContentTypeDialFailed:
+            on_dial_result(l, m);
+            break;
+
+        case ContentTypeData: {
+            auto it = l->circuits.find(conn_id);
+            if (it != l->circuits.end()) {
+                forward_msg(it->second, m);
+            } else {
+                send_closed(conn_end{l, conn_id}, "unknown connection");
+            }
+            break;
+        }
+
+        case ContentTypeStateClosed:
+            on_closed(l, conn_id);
+            break;
+
+        default:
+            // posture responses, inspect results, etc.
+            break;
+    }
+}
+
+static void process_inbound(link_s *l) {
+    size_t offset = 0;
+    while (!l->closing && l->inbound.size() - offset >= HEADER_SIZE) {
+        msg_view m = {};
+        uint8_t *p = l->inbound.data() + offset;
+        header_from_buffer(&m.header, p);
+        if (m.header.magic.magint != EMPTY_HEADER.magic.magint) {
+            fprintf(stderr, "mock_router: invalid message header\n");
+            close_link(l);
+            return;
+        }
+
+        size_t total = HEADER_SIZE + m.header.headers_len + m.header.body_len;
+        if (l->inbound.size() - offset < total) {
+            break;
+        }
+
+        m.nhdrs = parse_hdrs(p + HEADER_SIZE, m.header.headers_len, &m.hdrs);
+        if (m.nhdrs < 0) {
+            fprintf(stderr, "mock_router: invalid message headers\n");
+            close_link(l);
+            return;
+        }
+        m.body = p + HEADER_SIZE + m.header.headers_len;
+
+        dispatch(l, m);
+        ziti_free(m.hdrs);
+        offset += total;
+    }
+    l->inbound.erase(l->inbound.begin(), l->inbound.begin() + (ptrdiff_t) offset);
+}
+
+static void on_write(uv_write_t *req, int status) {
+    free(req->data);
+    free(req);
+}
+
+// move TLS records produced by OpenSSL to the socket
+static void flush_link(link_s *l) {
+    size_t pending;
+    while (!l->closing && (pending = BIO_ctrl_pending(l->out)) > 0) {
+        auto buf = (char *) malloc(pending);
+        int len = BIO_read(l->out, buf, (int) pending);
+        if (len <= 0) {
+            free(buf);
+            break;
+        }
+
+        auto req = (uv_write_t *) calloc(1, sizeof(uv_write_t));
+        req->data = buf;
+        uv_buf_t b = uv_buf_init(buf, (unsigned int) len);
+        if (uv_write(req, (uv_stream_t *) &l->tcp, &b, 1, on_write) != 0) {
+            free(buf);
+            free(req);
+            close_link(l);
+        }
+    }
+}
+
+static void on_link_close(uv_handle_t *h) {
+    auto l = (link_s *) h->data;
+    mock_router_s *r = l->router;
+    SSL_free(l->ssl);
+    delete l;
+
+    if (--r->open_handles == 0) {
+        SSL_CTX_free(r->ssl_ctx);
+        delete r;
+    }
+}
+
+static void close_link(link_s *l) {
+    if (l->closing) {
+        return;
+    }
+
+    mock_router_s *r = l->router;
+    r->links.erase(l);
+
+    // drop everything referring to this link
+    for (auto &c: l->circuits) {
+        const conn_end &peer = c.second;
+        if (peer.link != l) {
+            peer.link->circuits.erase(peer.conn_id);
+            send_closed(peer, "router link closed");
+        }
+    }
+    for (auto it = r->bindings.begin(); it != r->bindings.end();) {
+        it = it->second.link == l ? r->bindings.erase(it) : std::next(it);
+    }
+    // connects waiting on this link for dial result
+    for (auto &d: l->dials) {
+        send_reply(d.second.dialer.link, ContentTypeStateClosed, d.second.connect_seq,
+                   d.second.dialer.conn_id, (const uint8_t *) "no terminator", 13);
+    }
+
+    std::vector<link_s *> others(r->links.begin(), r->links.end());
+    for (auto other: others) {
+        for (auto it = other->dials.begin(); it != other->dials.end();) {
+            it = it->second.dialer.link == l ? other->dials.erase(it) : std::next(it);
+        }
+        flush_link(other);
+    }
+
+    l->closing = true;
+    uv_close((uv_handle_t *) &l->tcp, on_link_close);
+}
+
+static void alloc_cb(uv_handle_t *, size_t, uv_buf_t *buf) {
+    buf->base = (char *) malloc(READ_CHUNK);
+    buf->len = READ_CHUNK;
+}
+
+static void on_read(uv_stream_t *s, ssize_t nread, const uv_buf_t *buf) {
+    auto l = (link_s *) s->data;
+
+    if (nread < 0) {
+        free(buf->base);
+        close_link(l);
+        return;
+    }
+
+    BIO_write(l->in, buf->base, (int) nread);
+    free(buf->base);
+
+    if (!SSL_is_init_finished(l->ssl)) {
+        int rc = SSL_do_handshake(l->ssl);
+        if (rc <= 0 && SSL_get_error(l->ssl, rc) != SSL_ERROR_WANT_READ) {
+            char err[256];
+            ERR_error_string_n(ERR_get_error(), err, sizeof(err));
+            fprintf(stderr, "mock_router: TLS handshake failed: %s\n", err);
+            flush_link(l);
+            close_link(l);
+            return;
+        }
+    }
+
+    if (SSL_is_init_finished(l->ssl)) {
+        uint8_t plain[READ_CHUNK];
+        int len;
+        while ((len = SSL_read(l->ssl, plain, sizeof(plain))) > 0) {
+            l->inbound.insert(l->inbound.end(), plain, plain + len);
+        }
+        int err = SSL_get_error(l->ssl, len);
+        if (err == SSL_ERROR_ZERO_RETURN || (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE)) {
+            close_link(l);
+            return;
+        }
+        process_inbound(l);
+    }
+
+    // messages may have been routed to other links
+    std::vector<link_s *> links(l->router->links.begin(), l->router->links.end());
+    for (auto link: links) {
+        flush_link(link);
+    }
+}
+
+static void on_client(uv_stream_t *server, int status) {
+    auto r = (mock_router_s *) server->data;
+    if (status < 0) {
+        return;
+    }
+
+    auto l = new link_s();
+    l->router = r;
+    uv_tcp_init(r->loop, &l->tcp);
+    l->tcp.data = l;
+    r->open_handles++;
+
+    if (uv_accept(server, (uv_stream_t *) &l->tcp) != 0) {
+        l->closing = true;
+        l->ssl = nullptr;
+        uv_close((uv_handle_t *) &l->tcp, on_link_close);
+        return;
+    }
+    uv_tcp_nodelay(&l->tcp, 1);
+
+    l->ssl = SSL_new(r->ssl_ctx);
+    l->in = BIO_new(BIO_s_mem());
+    l->out = BIO_new(BIO_s_mem());
+    SSL_set_bio(l->ssl, l->in, l->out);
+    SSL_set_accept_state(l->ssl);
+
+    r->links.insert(l);
+    uv_read_start((uv_stream_t *) &l->tcp, alloc_cb, on_read);
+}
+
+static int select_alpn(SSL *, const unsigned char **out, unsigned char *outlen,
+                       const unsigned char *in, unsigned int inlen, void *) {
+    static const unsigned char edge_alpn[] = "\x09ziti-edge";
+    if (SSL_select_next_proto((unsigned char **) out, outlen, edge_alpn, sizeof(edge_alpn) - 1, in, inlen) ==
+        OPENSSL_NPN_NEGOTIATED) {
+        return SSL_TLSEXT_ERR_OK;
+    }
+    return SSL_TLSEXT_ERR_NOACK;
+}
+
+static bool add_ext(X509 *crt, int nid, const char *value) {
+    X509V3_CTX ctx;
+    X509V3_set_ctx_nodb(&ctx);
+    X509V3_set_ctx(&ctx, crt, crt, nullptr, nullptr, 0);
+    X509_EXTENSION *ext = X509V3_EXT_conf_nid(nullptr, &ctx, nid, const_cast<char *>(value));
+    if (ext == nullptr) {
+        return false;
+    }
+    X509_add_ext(crt, ext, -1);
+    X509_EXTENSION_free(ext);
+    return true;
+}
+
+// self-signed certificate for 127.0.0.1, also used by clients as CA bundle
+static int init_tls(mock_router_s *r) {
+    EVP_PKEY *key = nullptr;
+    EVP_PKEY_CTX *kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    if (kctx == nullptr || EVP_PKEY_keygen_init(kctx) != 1 ||
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(kctx, NID_X9_62_prime256v1) != 1 ||
+        EVP_PKEY_keygen(kctx, &key) != 1) {
+        EVP_PKEY_CTX_free(kctx);
+        return -1;
+    }
+    EVP_PKEY_CTX_free(kctx);
+
+    X509 *crt = X509_new();
+    X509_set_version(crt, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(crt), 1);
+    X509_gmtime_adj(X509_getm_notBefore(crt), -60);
+    X509_gmtime_adj(X509_getm_notAfter(crt), 24 * 60 * 60);
+    X509_set_pubkey(crt, key);
+    X509_NAME *name = X509_get_subject_name(crt);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char *) "mock-router", -1, -1, 0);
+    X509_set_issuer_name(crt, name);
+
+    int rc = -1;
+    if (add_ext(crt, NID_basic_constraints, "critical,CA:TRUE") &&
+        add_ext(crt, NID_key_usage, "critical,digitalSignature,keyCertSign") &&
+        add_ext(crt, NID_subject_alt_name, "IP:127.0.0.1,DNS:localhost") &&
+        X509_sign(crt, key, EVP_sha256()) > 0) {
+
+        r->ssl_ctx = SSL_CTX_new(TLS_server_method());
+        SSL_CTX_use_certificate(r->ssl_ctx, crt);
+        SSL_CTX_use_PrivateKey(r->ssl_ctx, key);
+        SSL_CTX_set_alpn_select_cb(r->ssl_ctx, select_alpn, nullptr);
+
+        BIO *pem = BIO_new(BIO_s_mem());
+        PEM_write_bio_X509(pem, crt);
+        char *data;
+        long len = BIO_get_mem_data(pem, &data);
+        r->ca.assign(data, (size_t) len);
+        BIO_free(pem);
+        rc = 0;
+    }
+
+    X509_free(crt);
+    EVP_PKEY_free(key);
+    return rc;
+}
+
+int mock_router_start(uv_loop_t *loop, mock_router_mode mode, mock_router **router) {
+    auto r = new mock_router_s();
+    r->loop = loop;
+    r->mode = mode;
+    r->next_conn_id = 0x10000;
+
+    if (init_tls(r) != 0) {
+        fprintf(stderr, "mock_router: failed to create TLS context\n");
+        delete r;
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    uv_ip4_addr("127.0.0.1", 0, &addr);
+    uv_tcp_init(loop, &r->server);
+    r->server.data = r;
+    r->open_handles = 1;
+
+    int rc = uv_tcp_bind(&r->server, (const struct sockaddr *) &addr, 0);
+    if (rc == 0) {
+        rc = uv_listen((uv_stream_t *) &r->server, 128, on_client);
+    }
+    if (rc != 0) {
+        fprintf(stderr, "mock_router: failed to listen: %s\n", uv_strerror(rc));
+        mock_router_stop(r);
+        return rc;
+    }
+
+    int len = sizeof(addr);
+    uv_tcp_getsockname(&r->server, (struct sockaddr *) &addr, &len);
+    r->url = "tls://127.0.0.1:" + std::to_string(ntohs(addr.sin_port));
+
+    *router = r;
+    return 0;
+}
+
+const char *mock_router_url(const mock_router *router) {
+    return router->url.c_str();
+}
+
+const char *mock_router_ca(const mock_router *router) {
+    return router->ca.c_str();
+}
+
+static void on_server_close(uv_handle_t *h) {
+    auto r = (mock_router_s *) h->data;
+    if (--r->open_handles == 0) {
+        SSL_CTX_free(r->ssl_ctx);
+        delete r;
+    }
+}
+
+void mock_router_stop(mock_router *router) {
+    std::vector<link_s *> links(router->links.begin(), router->links.end());
+    for (auto l: links) {
+        close_link(l);
+    }
+    uv_close((uv_handle_t *) &router->server, on_server_close);
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2025.  NetFoundry Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ZITI_SDK_MOCK_ROUTER_H
+#define ZITI_SDK_MOCK_ROUTER_H
+
+#include <uv.h>
+
+typedef struct mock_router_s mock_router;
+
+enum mock_router_mode {
+    // data is sent back on the same connection
+    mock_router_echo,
+    // dials are routed to the connection bound with the same token, echo if there is none
+    mock_router_pair,
+};
+
+/**
+ * In-process edge router for data path testing without an OpenZiti network.
+ *
+ * Listens on 127.0.0.1 (ephemeral port) with a generated self-signed certificate,
+ * and speaks enough of the edge protocol for SDK channels:
+ * Hello, latency probes, Connect/Bind/Unbind, Dial/DialSuccess/DialFailed, Data and StateClosed.
+ * Session tokens are not validated, the token sent with Connect/Bind names the service.
+ */
+int mock_router_start(uv_loop_t *loop, enum mock_router_mode mode, mock_router **router);
+
+// edge router address, i.e. tls://127.0.0.1:<port>
+const char *mock_router_url(const mock_router *router);
+
+// router certificate (PEM), trust it as CA bundle
+const char *mock_router_ca(const mock_router *router);
+
+// closes listener and all client links, router is released once its handles are closed
+void mock_router_stop(mock_router *router);
+
+#endif //ZITI_SDK_MOCK_ROUTER_H
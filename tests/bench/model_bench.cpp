@@ -0,0 +1,97 @@
+// Copyright (c) 2025.  NetFoundry Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <ziti/model_collections.h>
+#include <ziti/ziti_model.h>
+
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+static std::string services_json(int count) {
+    std::string json = "[";
+    char entry[512];
+    for (int i = 0; i < count; i++) {
+        snprintf(entry, sizeof(entry),
+                 R"(%s{"id":"svc-id-%d","name":"service-%d","permissions":["Dial","Bind"],)"
+                 R"("encryptionRequired":true,"postureQueries":[],)"
+                 R"("config":{"intercept.v1":{"protocols":["tcp","udp"],"addresses":["svc%d.ziti"],)"
+                 R"("portRanges":[{"low":80,"high":443}]}}})",
+                 i == 0 ? "" : ",", i, i, i);
+        json += entry;
+    }
+    return json + "]";
+}
+
+TEST_CASE("model_map", "[bench]") {
+    auto size = GENERATE(1000, 100000, 1000000);
+
+    std::vector<std::string> keys;
+    keys.reserve(size);
+    model_map m = {nullptr};
+    for (int i = 0; i < size; i++) {
+        keys.push_back("key-" + std::to_string(i));
+        model_map_set(&m, keys.back().c_str(), &keys.back());
+    }
+
+    size_t idx = 0;
+    BENCHMARK("get(" + std::to_string(size) + ")") {
+        idx = (idx + 7919) % keys.size();
+        return model_map_get(&m, keys[idx].c_str());
+    };
+
+    BENCHMARK("set/remove(" + std::to_string(size) + ")") {
+        model_map_set(&m, "bench-key", &m);
+        return model_map_remove(&m, "bench-key");
+    };
+
+    BENCHMARK("iterate(" + std::to_string(size) + ")") {
+        size_t count = 0;
+        const char *k;
+        void *v;
+        MODEL_MAP_FOREACH(k, v, &m) {
+            count++;
+        }
+        return count;
+    };
+
+    model_map_clear(&m, nullptr);
+}
+
+TEST_CASE("service model", "[bench]") {
+    const int count = 10000;
+    std::string json = services_json(count);
+
+    BENCHMARK("parse_ziti_service_array(10k)") {
+        ziti_service_array arr = nullptr;
+        int rc = parse_ziti_service_array(&arr, json.c_str(), json.size());
+        free_ziti_service_array(&arr);
+        return rc;
+    };
+
+    ziti_service_array arr = nullptr;
+    REQUIRE(parse_ziti_service_array(&arr, json.c_str(), json.size()) > 0);
+    BENCHMARK("ziti_service_get_config(intercept.v1)") {
+        ziti_intercept_cfg_v1 cfg = {};
+        int rc = ziti_service_get_config(arr[count / 2], ZITI_INTERCEPT_CFG_V1, &cfg,
+                                         (parse_service_cfg_f) parse_ziti_intercept_cfg_v1);
+        free_ziti_intercept_cfg_v1(&cfg);
+        return rc;
+    };
+    free_ziti_service_array(&arr);
+}
@@ -0,0 +1,467 @@
+// Copyright (c) 2025.  NetFoundry Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// end-to-end data path throughput: N connections x M bytes through a real ziti_channel
+// to the in-process mock edge router, no controller or OpenZiti network required
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+
+#include "mock_router.h"
+#include "zt_internal.h"
+#include "endian_internal.h"
+#include "message.h"
+#include "metrics.h"
+
+#define ROUTER_NAME "mock-router"
+#define HOST_ROUTER_NAME "mock-router-host"
+#define SERVICE_TOKEN "bench-service"
+#define BIND_CONN_ID 0x7fff0000
+
+struct bench_conn;
+
+struct bench {
+    uv_loop_t *loop;
+    mock_router *router;
+    ziti_context ztx;
+    uv_timer_t timeout;
+
+    mock_router_mode mode;
+    size_t connections;
+    size_t bytes;
+    size_t msg_size;
+    size_t window;
+    const char *json_out;
+
+    std::vector<bench_conn> conns;
+    std::vector<uint8_t> payload;
+    std::vector<uint64_t> latencies; // ns
+
+    bool host_ready;
+    size_t completed;
+    uint64_t start;
+    uint64_t end;
+    int result;
+};
+
+struct bench_conn {
+    bench *b;
+    uint32_t id;
+    ziti_channel_t *ch;
+
+    uint32_t sent;
+    uint32_t received;
+    uint32_t total;
+    std::vector<uint64_t> sent_at;
+};
+
+static void finish(bench *b, int result);
+
+static ziti_channel_t *get_channel(bench *b, const char *name) {
+    return (ziti_channel_t *) model_map_get(&b->ztx->channels, name);
+}
+
+// just enough context for channels: no controller, session token is not checked by the mock router
+static ziti_context bench_context(uv_loop_t *loop, const char *ca) {
+    auto ztx = (ziti_context) ziti_calloc(1, sizeof(struct ziti_ctx));
+    ztx->loop = loop;
+    ztx->enabled = true;
+    ztx->auth_state = ZitiAuthStateFullyAuthenticated;
+    ztx->session_token = ziti_strdup("bench-session");
+    ztx->tlsCtx = default_tls_context(ca, strlen(ca));
+    ztx->metrics = metrics_registry_new();
+    LIST_INIT(&ztx->deadlines);
+
+    const char identity[] = R"({"id":"bench","name":"bench"})";
+    parse_ziti_identity_data_ptr(&ztx->identity_data, identity, strlen(identity));
+
+    uv_timer_init(loop, &ztx->deadline_timer);
+    ztx->deadline_timer.data = ztx;
+    uv_prepare_init(loop, &ztx->prepper);
+    ztx->prepper.data = ztx;
+    uv_prepare_start(&ztx->prepper, ztx_prepare);
+    return ztx;
+}
+
+static void free_bench_context(ziti_context ztx) {
+    ztx->tlsCtx->free_ctx(ztx->tlsCtx);
+    metrics_registry_free(ztx->metrics);
+    free_ziti_identity_data_ptr(ztx->identity_data);
+    ziti_free(ztx->session_token);
+    model_map_clear(&ztx->channels, nullptr);
+    ziti_free(ztx);
+}
+
+static void send_data(bench_conn *c) {
+    bench *b = c->b;
+    while (c->sent < c->total && c->sent - c->received < b->window) {
+        size_t offset = (size_t) c->sent * b->msg_size;
+        size_t len = std::min(b->msg_size, b->bytes - offset);
+
+        uint32_t conn_id = htole32(c->id);
+        uint32_t seq = htole32(c->sent);
+        hdr_t hdrs[] = {
+                var_header(ConnIdHeader, conn_id),
+                var_header(SeqHeader, seq),
+        };
+        message *m = message_new(nullptr, ContentTypeData, hdrs, 2, len);
+        memcpy(m->body, b->payload.data(), len);
+
+        c->sent_at[c->sent++] = uv_hrtime();
+        if (ziti_channel_send_message(c->ch, m, nullptr) != ZITI_OK) {
+            fprintf(stderr, "conn[%u] write failed\n", c->id);
+            finish(b, 1);
+            return;
+        }
+    }
+}
+
+static void on_conn_msg(void *ctx, message *m, int code) {
+    auto c = (bench_conn *) ctx;
+    bench *b = c->b;
+    if (m == nullptr) {
+        if (b->result < 0) {
+            fprintf(stderr, "conn[%u] channel closed: %s\n", c->id, ziti_errorstr(code));
+            finish(b, 1);
+        }
+        return;
+    }
+
+    uint32_t seq;
+    if (m->header.content == ContentTypeData && message_get_int32_header(m, SeqHeader, (int32_t *) &seq) &&
+        seq < c->sent) {
+        b->latencies.push_back(uv_hrtime() - c->sent_at[seq]);
+        c->received++;
+    } else if (m->header.content == ContentTypeStateClosed) {
+        fprintf(stderr, "conn[%u] closed by router: %.*s\n", c->id, (int) m->header.body_len, m->body);
+        finish(b, 1);
+    }
+    pool_return_obj(m);
+
+    if (b->result >= 0) {
+        return;
+    }
+
+    if (c->received == c->total) {
+        ziti_channel_rem_receiver(c->ch, c->id);
+        uint32_t conn_id = htole32(c->id);
+        hdr_t hdrs[] = {
+                var_header(ConnIdHeader, conn_id),
+        };
+        ziti_channel_send(c->ch, ContentTypeStateClosed, hdrs, 1, nullptr, 0, nullptr);
+
+        if (++b->completed == b->conns.size()) {
+            b->end = uv_hrtime();
+            finish(b, 0);
+        }
+    } else {
+        send_data(c);
+    }
+}
+
+static void on_connected(void *ctx, message *m, int code) {
+    auto c = (bench_conn *) ctx;
+    if (m == nullptr || m->header.content != ContentTypeStateConnected) {
+        fprintf(stderr, "conn[%u] failed to connect: %s\n", c->id,
+                m ? std::string((const char *) m->body, m->header.body_len).c_str() : ziti_errorstr(code));
+        finish(c->b, 1);
+        return;
+    }
+    send_data(c);
+}
+
+static void start_connections(bench *b) {
+    ziti_channel_t *ch = get_channel(b, ROUTER_NAME);
+    b->start = uv_hrtime();
+    for (auto &c: b->conns) {
+        c.ch = ch;
+        ziti_channel_add_receiver(ch, c.id, &c, on_conn_msg);
+
+        uint32_t conn_id = htole32(c.id);
+        uint32_t seq = 0;
+        hdr_t hdrs[] = {
+                var_header(ConnIdHeader, conn_id),
+                var_header(SeqHeader, seq),
+        };
+        ziti_channel_send_for_reply(ch, ContentTypeConnect, hdrs, 2,
+                                    (const uint8_t *) SERVICE_TOKEN, strlen(SERVICE_TOKEN), on_connected, &c);
+    }
+}
+
+// hosting side (pair mode): echo data back on the router provided connection
+static void on_hosted_msg(void *ctx, message *m, int code) {
+    auto b = (bench *) ctx;
+    if (m == nullptr) {
+        return;
+    }
+
+    int32_t conn_id;
+    if (m->header.content == ContentTypeData && message_get_int32_header(m, ConnIdHeader, &conn_id)) {
+        ziti_channel_t *ch = get_channel(b, HOST_ROUTER_NAME);
+        message *reply = message_new(nullptr, ContentTypeData, m->hdrs, m->nhdrs, m->header.body_len);
+        memcpy(reply->body, m->body, m->header.body_len);
+        ziti_channel_send_message(ch, reply, nullptr);
+    } else if (m->header.content == ContentTypeStateClosed &&
+               message_get_int32_header(m, ConnIdHeader, &conn_id)) {
+        ziti_channel_rem_receiver(get_channel(b, HOST_ROUTER_NAME), (uint32_t) conn_id);
+    }
+    pool_return_obj(m);
+}
+
+static void on_dial(void *ctx, message *m, int code) {
+    auto b = (bench *) ctx;
+    if (m == nullptr) {
+        return;
+    }
+
+    ziti_channel_t *ch = get_channel(b, HOST_ROUTER_NAME);
+    int32_t rt_conn_id;
+    if (m->header.content == ContentTypeDial && message_get_int32_header(m, RouterProvidedConnId, &rt_conn_id)) {
+        ziti_channel_add_receiver(ch, (uint32_t) rt_conn_id, b, on_hosted_msg);
+
+        uint32_t conn_id = htole32(BIND_CONN_ID);
+        uint32_t reply_for = htole32(m->header.seq);
+        uint32_t seq = 0;
+        hdr_t hdrs[] = {
+                var_header(ConnIdHeader, conn_id),
+                var_header(SeqHeader, seq),
+                var_header(ReplyForHeader, reply_for),
+        };
+        ziti_channel_send(ch, ContentTypeDialSuccess, hdrs, 3, nullptr, 0, nullptr);
+    }
+    pool_return_obj(m);
+}
+
+static void on_bound(void *ctx, message *m, int code) {
+    auto b = (bench *) ctx;
+    if (m == nullptr || m->header.content != ContentTypeStateConnected) {
+        fprintf(stderr, "failed to bind: %s\n", ziti_errorstr(code));
+        finish(b, 1);
+        return;
+    }
+    b->host_ready = true;
+    if (ziti_channel_is_connected(get_channel(b, ROUTER_NAME))) {
+        start_connections(b);
+    }
+}
+
+static void bind_service(bench *b) {
+    ziti_channel_t *ch = get_channel(b, HOST_ROUTER_NAME);
+    ziti_channel_add_receiver(ch, BIND_CONN_ID, b, on_dial);
+
+    uint32_t conn_id = htole32(BIND_CONN_ID);
+    uint32_t seq = 0;
+    uint8_t true_val = 1;
+    hdr_t hdrs[] = {
+            var_header(ConnIdHeader, conn_id),
+            var_header(SeqHeader, seq),
+            var_header(RouterProvidedConnId, true_val),
+    };
+    ziti_channel_send_for_reply(ch, ContentTypeBind, hdrs, 3,
+                                (const uint8_t *) SERVICE_TOKEN, strlen(SERVICE_TOKEN), on_bound, b);
+}
+
+static void on_ztx_event(ziti_context ztx, const ziti_event_t *ev) {
+    auto b = (bench *) ztx->opts.app_ctx;
+    if (ev->type != ZitiRouterEvent || ev->router.status != EdgeRouterConnected) {
+        return;
+    }
+
+    if (strcmp(ev->router.name, HOST_ROUTER_NAME) == 0) {
+        bind_service(b);
+    } else if (b->mode == mock_router_echo || b->host_ready) {
+        start_connections(b);
+    }
+}
+
+static double percentile(const std::vector<uint64_t> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t idx = std::min(sorted.size() - 1, (size_t) (p * (double) sorted.size()));
+    return (double) sorted[idx] / 1000.0;
+}
+
+static void report(bench *b) {
+    double secs = (double) (b->end - b->start) / 1e9;
+    size_t total_bytes = b->connections * b->bytes;
+    size_t total_msgs = b->latencies.size();
+    double mbps = (double) total_bytes / secs / 1e6;
+    double msgps = (double) total_msgs / secs;
+
+    std::vector<uint64_t> lat = b->latencies;
+    std::sort(lat.begin(), lat.end());
+    double p50 = percentile(lat, 0.50), p90 = percentile(lat, 0.90),
+            p99 = percentile(lat, 0.99), p999 = percentile(lat, 0.999);
+    double max = lat.empty() ? 0 : (double) lat.back() / 1000.0;
+
+    const char *mode = b->mode == mock_router_echo ? "echo" : "pair";
+    printf("mode: %s, connections: %zu, bytes/connection: %zu, message size: %zu, window: %zu\n",
+           mode, b->connections, b->bytes, b->msg_size, b->window);
+    printf("elapsed: %.3f s\n", secs);
+    printf("throughput: %.2f MB/s, %.0f messages/s\n", mbps, msgps);
+    printf("write-to-callback latency (us): p50=%.1f p90=%.1f p99=%.1f p99.9=%.1f max=%.1f\n",
+           p50, p90, p99, p999, max);
+
+    if (b->json_out) {
+        FILE *out = fopen(b->json_out, "w");
+        if (out == nullptr) {
+            fprintf(stderr, "failed to write results to %s\n", b->json_out);
+            return;
+        }
+        fprintf(out, "{\"mode\":\"%s\",\"connections\":%zu,\"bytes_per_connection\":%zu,\"message_size\":%zu,"
+                     "\"window\":%zu,\"elapsed_sec\":%.6f,\"mb_per_sec\":%.3f,\"messages_per_sec\":%.1f,"
+                     "\"latency_us\":{\"p50\":%.1f,\"p90\":%.1f,\"p99\":%.1f,\"p999\":%.1f,\"max\":%.1f}}\n",
+                mode, b->connections, b->bytes, b->msg_size, b->window, secs, mbps, msgps,
+                p50, p90, p99, p999, max);
+        fclose(out);
+    }
+}
+
+// runs outside of channel callbacks: closing the channel releases it
+static void shutdown_cb(uv_timer_t *t) {
+    auto b = (bench *) t->data;
+    for (const char *name: {ROUTER_NAME, HOST_ROUTER_NAME}) {
+        ziti_channel_t *ch = get_channel(b, name);
+        if (ch) {
+            ziti_channel_close(ch, ZITI_DISABLED);
+        }
+    }
+
+    b->ztx->enabled = false;
+    uv_close((uv_handle_t *) &b->ztx->deadline_timer, nullptr);
+    uv_close((uv_handle_t *) &b->ztx->prepper, nullptr);
+    uv_close((uv_handle_t *) &b->timeout, nullptr);
+    mock_router_stop(b->router);
+}
+
+static void finish(bench *b, int result) {
+    if (b->result >= 0) {
+        return;
+    }
+    b->result = result;
+    if (result == 0) {
+        report(b);
+    }
+    uv_timer_start(&b->timeout, shutdown_cb, 0, 0);
+}
+
+static void on_timeout(uv_timer_t *t) {
+    auto b = (bench *) t->data;
+    fprintf(stderr, "timed out: %zu of %zu connections completed\n", b->completed, b->conns.size());
+    finish(b, 1);
+}
+
+static size_t parse_size(const char *s) {
+    char *end;
+    size_t v = strtoull(s, &end, 10);
+    switch (*end) {
+        case 'k': case 'K': return v << 10;
+        case 'm': case 'M': return v << 20;
+        case 'g': case 'G': return v << 30;
+        default: return v;
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-c connections] [-b bytes per connection] [-s message size] [-w window]\n"
+                    "          [-m echo|pair] [-t timeout seconds] [-o results.json]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    bench b = {};
+    b.mode = mock_router_echo;
+    b.connections = 8;
+    b.bytes = 64 << 20;
+    b.msg_size = 16 << 10;
+    b.window = 16;
+    b.result = -1;
+    uint64_t timeout = 120;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:b:s:w:m:t:o:h")) != -1) {
+        switch (opt) {
+            case 'c': b.connections = strtoul(optarg, nullptr, 10); break;
+            case 'b': b.bytes = parse_size(optarg); break;
+            case 's': b.msg_size = parse_size(optarg); break;
+            case 'w': b.window = strtoul(optarg, nullptr, 10); break;
+            case 't': timeout = strtoull(optarg, nullptr, 10); break;
+            case 'o': b.json_out = optarg; break;
+            case 'm':
+                if (strcmp(optarg, "echo") == 0) {
+                    b.mode = mock_router_echo;
+                } else if (strcmp(optarg, "pair") == 0) {
+                    b.mode = mock_router_pair;
+                } else {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (b.connections == 0 || b.bytes == 0 || b.msg_size == 0 || b.window == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    b.loop = uv_default_loop();
+    if (mock_router_start(b.loop, b.mode, &b.router) != 0) {
+        return 1;
+    }
+
+    b.payload.resize(b.msg_size, 0x5a);
+    b.conns.resize(b.connections);
+    for (size_t i = 0; i < b.connections; i++) {
+        auto &c = b.conns[i];
+        c.b = &b;
+        c.id = (uint32_t) i + 1;
+        c.total = (uint32_t) ((b.bytes + b.msg_size - 1) / b.msg_size);
+        c.sent_at.resize(c.total);
+    }
+    b.latencies.reserve(b.connections * b.conns[0].total);
+
+    b.ztx = bench_context(b.loop, mock_router_ca(b.router));
+    b.ztx->opts.app_ctx = &b;
+    b.ztx->opts.events = ZitiRouterEvent;
+    b.ztx->opts.event_cb = on_ztx_event;
+
+    uv_timer_init(b.loop, &b.timeout);
+    b.timeout.data = &b;
+    uv_timer_start(&b.timeout, on_timeout, timeout * 1000, 0);
+
+    ziti_edge_router er = {};
+    er.protocols.tls = mock_router_url(b.router);
+    er.name = ROUTER_NAME;
+    ziti_channel_connect(b.ztx, &er);
+    if (b.mode == mock_router_pair) {
+        // separate channel for the hosting side
+        er.name = HOST_ROUTER_NAME;
+        ziti_channel_connect(b.ztx, &er);
+    }
+
+    uv_run(b.loop, UV_RUN_DEFAULT);
+    free_bench_context(b.ztx);
+    return b.result;
+}
@@ -0,0 +1,660 @@
+/*
+Copyright (c) 2025 NetFoundry, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "catch2_includes.hpp"
+
+#include <uv.h>
+#include <ziti/ziti.h>
+#include "ziti_ctrl.h"
+#include "zt_internal.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// minimal HTTP/1.1 controller: serves /version, paged /services, /sessions/<id>,
+// session creation and service updates with ETag
+struct mock_ctrl {
+    uv_loop_t *loop;
+    uv_tcp_t server;
+    std::vector<uv_tcp_t *> clients;
+    int total;
+    // largest page the controller returns, 0 for no cap
+    int max_limit;
+    uint64_t delay;
+    int requests;
+    std::map<std::string, int> hits;
+    // service IDs of created sessions
+    std::vector<std::string> created;
+    // number of /services requests to fail with 500
+    int fail_services;
+};
+
+struct mock_conn {
+    mock_ctrl *ctrl;
+    std::string in;
+};
+
+struct mock_reply {
+    uv_timer_t timer;
+    uv_write_t wr;
+    uv_stream_t *conn;
+    std::string out;
+};
+
+static int query_param(const std::string &path, const char *name, int def) {
+    auto p = path.find(std::string(name) + "=");
+    if (p == std::string::npos) return def;
+    return atoi(path.c_str() + p + strlen(name) + 1);
+}
+
+static std::string services_page(const mock_ctrl *ctrl, const std::string &path) {
+    int limit = query_param(path, "limit", 10);
+    int offset = query_param(path, "offset", 0);
+    if (ctrl->max_limit > 0 && limit > ctrl->max_limit) {
+        limit = ctrl->max_limit;
+    }
+
+    std::string data;
+    for (int i = offset; i < ctrl->total && i < offset + limit; i++) {
+        if (!data.empty()) data += ",";
+        data += R"({"id":"svc-)" + std::to_string(i) + R"(","name":"service-)" + std::to_string(i) + R"("})";
+    }
+    return R"({"meta":{"pagination":{"limit":)" + std::to_string(limit) +
+           R"(,"offset":)" + std::to_string(offset) +
+           R"(,"totalCount":)" + std::to_string(ctrl->total) +
+           R"(}},"data":[)" + data + "]}";
+}
+
+static void mock_send(uv_timer_t *t) {
+    auto reply = (mock_reply *) t->data;
+    uv_buf_t buf = uv_buf_init((char *) reply->out.data(), (unsigned int) reply->out.size());
+    reply->wr.data = reply;
+    uv_write(&reply->wr, reply->conn, &buf, 1, [](uv_write_t *wr, int) {
+        auto reply = (mock_reply *) wr->data;
+        uv_close((uv_handle_t *) &reply->timer, [](uv_handle_t *h) {
+            delete (mock_reply *) h->data;
+        });
+    });
+}
+
+static std::string json_field(const std::string &json, const std::string &name) {
+    auto p = json.find("\"" + name + "\"");
+    if (p == std::string::npos) return "";
+    p = json.find('"', json.find(':', p) + 1);
+    return json.substr(p + 1, json.find('"', p + 1) - p - 1);
+}
+
+static void mock_handle(uv_stream_t *s, const std::string &req, const std::string &content) {
+    auto conn = (mock_conn *) s->data;
+    auto ctrl = conn->ctrl;
+    ctrl->requests++;
+
+    auto path_start = req.find(' ') + 1;
+    auto path = req.substr(path_start, req.find(' ', path_start) - path_start);
+    ctrl->hits[path]++;
+
+    std::string status = "200 OK";
+    std::string headers = "Content-Type: application/json\r\n";
+    std::string body;
+    if (path == "/current-api-session/service-updates") {
+        if (req.find("If-None-Match: \"v1\"") != std::string::npos) {
+            status = "304 Not Modified";
+            headers.clear();
+        } else {
+            body = R"({"meta":{},"data":{"lastChangeAt":"2025-01-01T00:00:00Z"}})";
+        }
+        headers += "ETag: \"v1\"\r\n";
+    } else if (path.rfind("/version", 0) == 0) {
+        body = R"({"meta":{},"data":{"version":"v1.0.0"}})";
+    } else if (path.rfind("/services", 0) == 0 && ctrl->fail_services > 0) {
+        ctrl->fail_services--;
+        status = "500 Internal Server Error";
+        body = R"({"error":{"code":"UNHANDLED","message":"failed"}})";
+    } else if (path.rfind("/services", 0) == 0) {
+        body = services_page(ctrl, path);
+    } else if (path.rfind("/sessions/", 0) == 0) {
+        // session IDs are sess-<service ID>
+        auto id = path.substr(strlen("/sessions/"));
+        body = R"({"meta":{},"data":{"id":")" + id + R"(","token":"token-)" + id +
+               R"(","type":"Dial","serviceId":")" + id.substr(strlen("sess-")) + R"("}})";
+    } else if (path == "/sessions" && req.rfind("POST", 0) == 0) {
+        auto svc = json_field(content, "serviceId");
+        ctrl->created.push_back(svc);
+        body = R"({"meta":{},"data":{"id":"sess-)" + svc + R"(","token":"token-sess-)" + svc +
+               R"(","type":"Dial","serviceId":")" + svc + R"("}})";
+    } else {
+        body = R"({"error":{"code":"NOT_FOUND","message":"not found"}})";
+    }
+
+    auto reply = new mock_reply;
+    reply->conn = s;
+    reply->out = "HTTP/1.1 " + status + "\r\n" + headers +
+                 "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+    uv_timer_init(ctrl->loop, &reply->timer);
+    reply->timer.data = reply;
+    // equal delays keep responses in request order
+    uv_timer_start(&reply->timer, mock_send, ctrl->delay, 0);
+}
+
+static void mock_read(uv_stream_t *s, ssize_t len, const uv_buf_t *buf) {
+    auto conn = (mock_conn *) s->data;
+    if (len > 0) {
+        conn->in.append(buf->base, len);
+        size_t end;
+        while ((end = conn->in.find("\r\n\r\n")) != std::string::npos) {
+            auto req = conn->in.substr(0, end);
+            size_t content_len = 0;
+            auto cl = req.find("Content-Length: ");
+            if (cl == std::string::npos) cl = req.find("content-length: ");
+            if (cl != std::string::npos) {
+                content_len = strtoul(req.c_str() + cl + strlen("Content-Length: "), nullptr, 10);
+            }
+            if (conn->in.size() < end + 4 + content_len) {
+                break;
+            }
+            mock_handle(s, req, conn->in.substr(end + 4, content_len));
+            conn->in.erase(0, end + 4 + content_len);
+        }
+    } else if (len < 0) {
+        uv_read_stop(s);
+    }
+    free(buf->base);
+}
+
+static void mock_accept(uv_stream_t *server, int status) {
+    REQUIRE(status == 0);
+    auto ctrl = (mock_ctrl *) server->data;
+    auto clt = new uv_tcp_t;
+    uv_tcp_init(ctrl->loop, clt);
+    clt->data = new mock_conn{ctrl, ""};
+    REQUIRE(uv_accept(server, (uv_stream_t *) clt) == 0);
+    ctrl->clients.push_back(clt);
+    uv_read_start((uv_stream_t *) clt,
+                  [](uv_handle_t *, size_t size, uv_buf_t *buf) {
+                      *buf = uv_buf_init((char *) malloc(size), (unsigned int) size);
+                  },
+                  mock_read);
+}
+
+static int mock_start(mock_ctrl &ctrl) {
+    sockaddr_in addr{};
+    uv_ip4_addr("127.0.0.1", 0, &addr);
+    uv_tcp_init(ctrl.loop, &ctrl.server);
+    ctrl.server.data = &ctrl;
+    REQUIRE(uv_tcp_bind(&ctrl.server, (const sockaddr *) &addr, 0) == 0);
+    REQUIRE(uv_listen((uv_stream_t *) &ctrl.server, 16, mock_accept) == 0);
+
+    int len = sizeof(addr);
+    uv_tcp_getsockname(&ctrl.server, (sockaddr *) &addr, &len);
+    return ntohs(addr.sin_port);
+}
+
+static void mock_stop(mock_ctrl &ctrl) {
+    uv_close((uv_handle_t *) &ctrl.server, nullptr);
+    for (auto clt: ctrl.clients) {
+        uv_close((uv_handle_t *) clt, [](uv_handle_t *h) {
+            delete (mock_conn *) h->data;
+            delete (uv_tcp_t *) h;
+        });
+    }
+    ctrl.clients.clear();
+}
+
+// mock controller and a client controller on a private loop
+struct mock_env {
+    uv_loop_t loop{};
+    mock_ctrl mock{};
+    ziti_controller ctrl{};
+    // controller under test: [ctrl] or one owned by the caller (e.g. a context's)
+    ziti_controller *client;
+    uv_timer_t close_timer{};
+
+    explicit mock_env(int total, ziti_controller *c = nullptr) : client(c ? c : &ctrl) {
+        uv_loop_init(&loop);
+        mock.loop = &loop;
+        mock.total = total;
+        mock.delay = 5;
+        int port = mock_start(mock);
+
+        std::string url = "http://127.0.0.1:" + std::to_string(port);
+        model_list urls{};
+        model_list_append(&urls, (void *) url.c_str());
+        REQUIRE(ziti_ctrl_init(&loop, client, &urls, nullptr) == ZITI_OK);
+        model_list_clear(&urls, nullptr);
+        ziti_ctrl_set_token(client, "test-token");
+
+        uv_timer_init(&loop, &close_timer);
+        close_timer.data = this;
+    }
+
+    // shut down outside of the response callback
+    void stop() {
+        uv_timer_start(&close_timer, [](uv_timer_t *t) {
+            auto env = (mock_env *) t->data;
+            ziti_ctrl_close(env->client);
+            mock_stop(env->mock);
+            uv_close((uv_handle_t *) t, nullptr);
+        }, 0, 0);
+    }
+
+    void run() {
+        uv_run(&loop, UV_RUN_DEFAULT);
+        uv_loop_close(&loop);
+    }
+
+    // for requests without a completion callback: run until [done] holds or [timeout] ms pass
+    void run_until(const std::function<bool()> &done, uint64_t timeout = 5000) {
+        struct poller {
+            mock_env *env;
+            const std::function<bool()> &done;
+            uint64_t deadline;
+            uv_timer_t timer;
+        } p{this, done, uv_now(&loop) + timeout, {}};
+        uv_timer_init(&loop, &p.timer);
+        p.timer.data = &p;
+        uv_timer_start(&p.timer, [](uv_timer_t *t) {
+            auto p = (poller *) t->data;
+            if (p->done() || uv_now(t->loop) >= p->deadline) {
+                uv_close((uv_handle_t *) t, nullptr);
+                p->env->stop();
+            }
+        }, 5, 5);
+        run();
+    }
+};
+
+struct paging_result {
+    mock_env *env;
+    ziti_service_array services;
+    int err;
+    bool done;
+    int requests;
+};
+
+static uint64_t fetch_services(int total, unsigned int max_page_size, paging_result &result, int ctrl_max_limit = 0) {
+    mock_env env(total);
+    env.mock.max_limit = ctrl_max_limit;
+    if (max_page_size != 0) {
+        ziti_ctrl_set_max_page_size(&env.ctrl, max_page_size);
+    }
+
+    result.env = &env;
+    auto start = uv_hrtime();
+    ziti_ctrl_get_services(&env.ctrl, [](ziti_service_array arr, const ziti_error *err, void *ctx) {
+        auto r = (paging_result *) ctx;
+        r->err = err ? err->err : ZITI_OK;
+        r->services = arr;
+        r->done = true;
+        r->env->stop();
+    }, &result);
+
+    env.run();
+    auto elapsed = (uv_hrtime() - start) / 1000000;
+
+    REQUIRE(result.done);
+    result.env = nullptr;
+    result.requests = env.mock.requests;
+    return elapsed;
+}
+
+TEST_CASE("ctrl concurrent paging", "[ctrl]") {
+    const int total = 1234;
+
+    paging_result serial{};
+    // max page size equal to the first page: many small pages
+    auto serial_ms = fetch_services(total, 25, serial);
+
+    paging_result concurrent{};
+    auto concurrent_ms = fetch_services(total, 0, concurrent);
+
+    WARN("paged " << total << " services: "
+                  << serial_ms << "ms in " << serial.requests << " requests with small pages, "
+                  << concurrent_ms << "ms in " << concurrent.requests << " requests with large pages");
+    CHECK(concurrent.requests < serial.requests);
+
+    for (auto r: {&serial, &concurrent}) {
+        CHECK(r->err == ZITI_OK);
+        REQUIRE(r->services != nullptr);
+        int count = 0;
+        for (; r->services[count] != nullptr; count++) {
+            auto expected = "service-" + std::to_string(count);
+            REQUIRE(expected == r->services[count]->name);
+        }
+        CHECK(count == total);
+        free_ziti_service_array(&r->services);
+    }
+}
+
+TEST_CASE("ctrl paging with capped limit", "[ctrl]") {
+    const int total = 1234;
+    paging_result r{};
+    // controller returns at most 100 items, client asks for pages of 500
+    fetch_services(total, 0, r, 100);
+
+    CHECK(r.err == ZITI_OK);
+    REQUIRE(r.services != nullptr);
+    int count = 0;
+    for (; r.services[count] != nullptr; count++) {
+        auto expected = "service-" + std::to_string(count);
+        REQUIRE(expected == r.services[count]->name);
+    }
+    CHECK(count == total);
+    free_ziti_service_array(&r.services);
+}
+
+TEST_CASE("ctrl single-flight requests", "[ctrl]") {
+    const int callers = 10;
+    mock_env env(0);
+
+    struct waiter {
+        mock_env *env;
+        int *completed;
+        ziti_session *session;
+        int err;
+    };
+    int completed = 0;
+    std::vector<waiter> waiters(callers, waiter{&env, &completed, nullptr, -1});
+
+    for (auto &w: waiters) {
+        ziti_ctrl_get_session(&env.ctrl, "sess-1", [](ziti_session *s, const ziti_error *err, void *ctx) {
+            auto w = (waiter *) ctx;
+            w->session = s;
+            w->err = err ? err->err : ZITI_OK;
+            if (++(*w->completed) == callers) {
+                w->env->stop();
+            }
+        }, &w);
+    }
+    CHECK(env.ctrl.coalesced_count == callers - 1);
+
+    env.run();
+
+    CHECK(completed == callers);
+    CHECK(env.mock.hits["/sessions/sess-1"] == 1);
+    for (auto &w: waiters) {
+        CHECK(w.err == ZITI_OK);
+        REQUIRE(w.session != nullptr);
+        CHECK_THAT(w.session->token, Catch::Matchers::Equals("token-sess-1"));
+        // every caller owns its copy
+        free_ziti_session_ptr(w.session);
+    }
+}
+
+TEST_CASE("ctrl filtered service list", "[ctrl]") {
+    const int total = 40;
+    mock_env env(total);
+
+    struct result {
+        mock_env *env;
+        std::map<std::string, uint64_t> fingerprints;
+        ziti_service_array services;
+        int calls;
+    } r{&env};
+
+    auto filter = [](const char *id, const char *name, uint64_t fp, void *ctx) {
+        auto r = (result *) ctx;
+        r->fingerprints[name] = fp;
+        // only parse odd services
+        return atoi(id + strlen("svc-")) % 2 == 1;
+    };
+    ziti_ctrl_get_services_filtered(&env.ctrl, filter, [](ziti_service_array arr, const ziti_error *err, void *ctx) {
+        auto r = (result *) ctx;
+        CHECK(err == nullptr);
+        r->services = arr;
+        r->env->stop();
+    }, &r);
+
+    env.run();
+
+    CHECK(r.fingerprints.size() == total);
+    REQUIRE(r.services != nullptr);
+    int count = 0;
+    for (; r.services[count] != nullptr; count++) {
+        CHECK(r.services[count]->name == "service-" + std::to_string(2 * count + 1));
+    }
+    CHECK(count == total / 2);
+    CHECK(r.fingerprints["service-0"] != r.fingerprints["service-1"]);
+
+    // fingerprint is FNV-1a of the element exactly as the controller sent it
+    std::string raw = R"({"id":"svc-7","name":"service-7"})";
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (auto c: raw) {
+        h = (h ^ (uint8_t) c) * 0x100000001b3ULL;
+    }
+    CHECK(r.fingerprints["service-7"] == h);
+    free_ziti_service_array(&r.services);
+}
+
+struct updates_result {
+    mock_env *env;
+    int calls;
+    ziti_service_update *updates[2];
+};
+
+static void updates_cb(ziti_service_update *update, const ziti_error *err, void *ctx) {
+    auto r = (updates_result *) ctx;
+    CHECK(err == nullptr);
+    r->updates[r->calls++] = update;
+    if (r->calls == 1) {
+        // services applied: second poll is conditional
+        ziti_ctrl_commit_services_etag(&r->env->ctrl);
+        ziti_ctrl_get_services_update(&r->env->ctrl, updates_cb, r);
+    } else {
+        r->env->stop();
+    }
+}
+
+TEST_CASE("ctrl service updates not modified", "[ctrl]") {
+    mock_env env(0);
+    updates_result r{&env};
+
+    ziti_ctrl_get_services_update(&env.ctrl, updates_cb, &r);
+    env.run();
+
+    REQUIRE(r.calls == 2);
+    REQUIRE(r.updates[0] != nullptr);
+    CHECK_THAT(r.updates[0]->last_change, Catch::Matchers::Equals("2025-01-01T00:00:00Z"));
+    // 304: no update and no error
+    CHECK(r.updates[1] == nullptr);
+    CHECK(env.mock.hits["/current-api-session/service-updates"] == 2);
+    free_ziti_service_update_ptr(r.updates[0]);
+}
+
+// poll, fetch the list, commit the ETag only if the list was fetched, repeat
+struct refresh_result {
+    mock_env *env;
+    std::vector<bool> modified;
+    std::vector<int> list_errors;
+};
+
+static void refresh_poll(refresh_result *r);
+
+static void refresh_list_cb(ziti_service_array services, const ziti_error *err, void *ctx) {
+    auto r = (refresh_result *) ctx;
+    r->list_errors.push_back(err ? err->err : ZITI_OK);
+    if (err == nullptr) {
+        ziti_ctrl_commit_services_etag(&r->env->ctrl);
+        free_ziti_service_array(&services);
+    }
+    refresh_poll(r);
+}
+
+static void refresh_update_cb(ziti_service_update *update, const ziti_error *err, void *ctx) {
+    auto r = (refresh_result *) ctx;
+    CHECK(err == nullptr);
+    r->modified.push_back(update != nullptr);
+    if (update) {
+        free_ziti_service_update_ptr(update);
+        ziti_ctrl_get_services(&r->env->ctrl, refresh_list_cb, r);
+    } else {
+        r->env->stop();
+    }
+}
+
+static void refresh_poll(refresh_result *r) {
+    ziti_ctrl_get_services_update(&r->env->ctrl, refresh_update_cb, r);
+}
+
+TEST_CASE("ctrl service updates refresh after failed list", "[ctrl]") {
+    mock_env env(3);
+    env.mock.fail_services = 1;
+    refresh_result r{&env};
+
+    refresh_poll(&r);
+    env.run();
+
+    // ETag of the failed refresh is not used: second poll gets the update again
+    CHECK(r.modified == std::vector<bool>{true, true, false});
+    REQUIRE(r.list_errors.size() == 2);
+    CHECK(r.list_errors[0] != ZITI_OK);
+    CHECK(r.list_errors[1] == ZITI_OK);
+    CHECK(env.mock.hits["/current-api-session/service-updates"] == 3);
+}
+
+// bare context with its controller pointed at the mock
+struct prefetch_env {
+    ziti_context ztx;
+    mock_env *env;
+
+    explicit prefetch_env(int prefetch) {
+        ztx = (ziti_context) calloc(1, sizeof(struct ziti_ctx));
+        ztx->opts.session_prefetch = prefetch;
+        ztx->auth_state = ZitiAuthStateFullyAuthenticated;
+        env = new mock_env(0, &ztx->ctrl);
+        ztx->loop = &env->loop;
+    }
+
+    ~prefetch_env() {
+        model_map_clear(&ztx->services, (_free_f) free_ziti_service_ptr);
+        model_map_clear(&ztx->sessions, (_free_f) free_ziti_session_ptr);
+        model_list_clear(&ztx->dial_mru, ziti_mem_free);
+        delete env;
+        free(ztx);
+    }
+
+    void add_service(const std::string &id, unsigned int perms) {
+        auto json = R"({"id":")" + id + R"(","name":")" + id + R"("})";
+        ziti_service *s = nullptr;
+        REQUIRE(parse_ziti_service_ptr(&s, json.c_str(), json.size()) > 0);
+        s->perm_flags = perms;
+        model_map_set(&ztx->services, s->name, s);
+    }
+
+    ziti_session *add_session(const std::string &service, bool refresh) {
+        auto json = R"({"id":"sess-)" + service + R"(","token":"cached","type":"Dial","serviceId":")" + service + R"("})";
+        ziti_session *s = nullptr;
+        REQUIRE(parse_ziti_session_ptr(&s, json.c_str(), json.size()) > 0);
+        s->refresh = refresh;
+        model_map_set(&ztx->sessions, s->service_id, s);
+        return s;
+    }
+
+    const char *token(const char *service) {
+        auto s = (ziti_session *) model_map_get(&ztx->sessions, service);
+        return s ? s->token : nullptr;
+    }
+
+    std::vector<std::string> mru() {
+        std::vector<std::string> names;
+        const char *name;
+        MODEL_LIST_FOREACH(name, ztx->dial_mru) {
+            names.emplace_back(name);
+        }
+        return names;
+    }
+};
+
+TEST_CASE("session prefetch for dialable services", "[ctrl]") {
+    prefetch_env p(-1);
+    p.add_service("dial-new", ZITI_CAN_DIAL);
+    p.add_service("bind-only", ZITI_CAN_BIND);
+    p.add_service("dial-valid", ZITI_CAN_DIAL | ZITI_CAN_BIND);
+    p.add_service("dial-refresh", ZITI_CAN_DIAL);
+    auto valid = p.add_session("dial-valid", false);
+    p.add_session("dial-refresh", true);
+
+    ztx_prefetch_sessions(p.ztx);
+    p.env->run_until([&] {
+        auto refreshed = p.token("dial-refresh");
+        return p.token("dial-new") && refreshed && strcmp(refreshed, "cached") != 0;
+    });
+
+    // only the service without a session gets a new one
+    CHECK(p.env->mock.created == std::vector<std::string>{"dial-new"});
+    CHECK_THAT(p.token("dial-new"), Catch::Matchers::Equals("token-sess-dial-new"));
+    CHECK(p.token("bind-only") == nullptr);
+
+    // valid session is left alone
+    CHECK(model_map_get(&p.ztx->sessions, "dial-valid") == valid);
+    CHECK(p.env->mock.hits["/sessions/sess-dial-valid"] == 0);
+
+    // session marked for refresh is fetched again
+    CHECK(p.env->mock.hits["/sessions/sess-dial-refresh"] == 1);
+    CHECK_THAT(p.token("dial-refresh"), Catch::Matchers::Equals("token-sess-dial-refresh"));
+    auto refreshed = (ziti_session *) model_map_get(&p.ztx->sessions, "dial-refresh");
+    CHECK_FALSE(refreshed->refresh);
+}
+
+TEST_CASE("session prefetch for recently dialed services", "[ctrl]") {
+    prefetch_env p(2);
+    for (auto id: {"svc-a", "svc-b", "svc-c"}) {
+        p.add_service(id, ZITI_CAN_DIAL);
+    }
+
+    for (auto id: {"svc-a", "svc-b", "svc-c", "svc-a"}) {
+        ztx_record_dial(p.ztx, id);
+    }
+    CHECK(p.mru() == std::vector<std::string>{"svc-a", "svc-c"});
+
+    ztx_prefetch_sessions(p.ztx);
+    p.env->run_until([&] {
+        return p.token("svc-a") && p.token("svc-c");
+    });
+
+    auto created = p.env->mock.created;
+    std::sort(created.begin(), created.end());
+    CHECK(created == std::vector<std::string>{"svc-a", "svc-c"});
+    CHECK(p.token("svc-b") == nullptr);
+}
+
+TEST_CASE("session prefetch disabled", "[ctrl]") {
+    SECTION("not authenticated") {
+        prefetch_env p(-1);
+        p.ztx->auth_state = ZitiAuthStatePartiallyAuthenticated;
+        p.add_service("svc-a", ZITI_CAN_DIAL);
+
+        ztx_prefetch_sessions(p.ztx);
+        p.env->run_until([] { return false; }, 50);
+        CHECK(p.env->mock.created.empty());
+    }
+
+    SECTION("prefetch off") {
+        prefetch_env p(0);
+        p.add_service("svc-a", ZITI_CAN_DIAL);
+
+        ztx_record_dial(p.ztx, "svc-a");
+        CHECK(p.mru().empty());
+
+        ztx_prefetch_sessions(p.ztx);
+        p.env->run_until([] { return false; }, 50);
+        CHECK(p.env->mock.created.empty());
+    }
+}
@@ -15,6 +15,7 @@
 #include <cstring>
 #include "catch2_includes.hpp"
 #include <catch2/generators/catch_generators.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
 #include <ziti/model_support.h>
 #include <iostream>
@@ -247,6 +248,80 @@ TEST_CASE("test string escape", "[model]") {
     free_Bar(&bar);
 }
 
+TEST_CASE("test long string escape", "[model]") {
+    // escapes at every position around 16/32 byte scan blocks
+    std::string plain(70, 'x');
+    for (size_t pos = 0; pos < plain.size(); pos++) {
+        for (char c: {'"', '\\', '\n', '\x01', '\x1f'}) {
+            std::string msg = plain;
+            msg[pos] = c;
+            Bar bar = {};
+            bar.msg = msg.c_str();
+
+            char *out = Bar_to_json(&bar, MODEL_JSON_COMPACT, nullptr);
+            REQUIRE(out != nullptr);
+            Bar parsed;
+            REQUIRE(parse_Bar(&parsed, out, strlen(out)) > 0);
+            CHECK_THAT(parsed.msg, Equals(msg));
+            free_Bar(&parsed);
+            free(out);
+        }
+    }
+
+    // non-ASCII bytes are copied as is
+    Bar bar = {};
+    bar.msg = "\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 \xe4\xb8\x96\xe7\x95\x8c \xf0\x9f\x98\x80 0123456789abcdef";
+    char *out = Bar_to_json(&bar, MODEL_JSON_COMPACT, nullptr);
+    CHECK_THAT(out, Equals(std::string(R"({"num":0,"ok":false,"msg":")") + bar.msg + R"("})"));
+    free(out);
+}
+
+TEST_CASE("number to json", "[model]") {
+    auto v = GENERATE(as<model_number>{}, 0, 7, -7, 10, 99, 100, -100, 12345678901LL,
+                      INT64_MAX, INT64_MIN, INT64_MIN + 1);
+    Bar bar = {};
+    bar.num = v;
+    char *out = Bar_to_json(&bar, MODEL_JSON_COMPACT, nullptr);
+    CHECK_THAT(out, Equals(R"({"num":)" + std::to_string(v) + R"(,"ok":false})"));
+    free(out);
+}
+
+TEST_CASE("model serialization benchmark", "[.][benchmark]") {
+    std::string long_msg;
+    for (int i = 0; i < 64; i++) {
+        long_msg += "the quick brown fox jumps over the lazy dog ";
+        if (i % 8 == 0) long_msg += "\"quoted\"\n";
+    }
+
+    Bar bar;
+    REQUIRE(parse_Bar(&bar, BAR1, strlen(BAR1)) > 0);
+    ziti_mem_free((void *) bar.msg);
+    bar.msg = strdup(long_msg.c_str());
+
+    model_number nums[64];
+    model_number *num_ptrs[65] = {};
+    for (int i = 0; i < 64; i++) {
+        nums[i] = (model_number) i * 1000003 * (i % 2 ? -1 : 1);
+        num_ptrs[i] = &nums[i];
+    }
+    model_number **codes = bar.codes;
+    bar.codes = num_ptrs;
+
+    char out[16 * 1024];
+    BENCHMARK("Bar_to_json_r") {
+        return Bar_to_json_r(&bar, MODEL_JSON_COMPACT, out, sizeof(out));
+    };
+
+    BENCHMARK("Bar_to_json") {
+        char *json = Bar_to_json(&bar, 0, nullptr);
+        free(json);
+        return json;
+    };
+
+    bar.codes = codes;
+    free_Bar(&bar);
+}
+
 TEST_CASE("parse array", "[model]") {
     const char *json = R"([{
         "msg":"\thello\n\"world\"!"
@@ -644,6 +719,232 @@ TEST_CASE("map compare", "[model]") {
     free_Basket(&b2);
 }
 
+TEST_CASE("arena parse", "[model]") {
+    const char *json = "{"
+                       "\"bar\":" BAR1 ","
+                       "\"barp\":" BAR1 ","
+                       "\"bara\":[" BAR1 "," BAR2 "]"
+                       "}";
+
+    model_arena *arena = model_arena_new(1024);
+    Foo foo;
+    REQUIRE(parse_Foo_arena(&foo, json, strlen(json), arena) == strlen(json));
+    CHECK(model_arena_used(arena) > 0);
+
+    checkBar1(foo.bar);
+    REQUIRE(foo.barp != nullptr);
+    checkBar1(*foo.barp);
+    REQUIRE(foo.bar_arr != nullptr);
+    checkBar1(*foo.bar_arr[0]);
+    CHECK(foo.bar_arr[1]->num == -42);
+    CHECK(foo.bar_arr[2] == nullptr);
+    CHECK(model_list_size(&foo.bar.shoes) == 3);
+    CHECK_THAT((const char *) model_list_head(&foo.bar.shoes), Equals("sandals"));
+
+    // arena graph compares and serializes just like a heap graph
+    Foo heap_foo;
+    REQUIRE(parse_Foo(&heap_foo, json, strlen(json)) == strlen(json));
+    CHECK(cmp_Foo(&foo, &heap_foo) == 0);
+
+    char *j1 = Foo_to_json(&foo, MODEL_JSON_COMPACT, nullptr);
+    char *j2 = Foo_to_json(&heap_foo, MODEL_JSON_COMPACT, nullptr);
+    CHECK_THAT(j1, Equals(j2));
+    free(j1);
+    free(j2);
+    free_Foo(&heap_foo);
+
+    const char *basket_json = R"({
+  "fruits": { "orange": { "color": "orange", "count": 1 } },
+  "json_fruits": { "apple": { "color": "red", "count": 2 } },
+  "strings": { "one": "1", "two": "2" }
+})";
+    Basket b;
+    REQUIRE(parse_Basket_arena(&b, basket_json, strlen(basket_json), arena) > 0);
+    auto orange = (Fruit *) model_map_get(&b.fruits, "orange");
+    REQUIRE(orange != nullptr);
+    CHECK(orange->count == 1);
+    CHECK_THAT(orange->color, Equals("orange"));
+    CHECK_THAT((const char *) model_map_get(&b.strings, "two"), Equals("2"));
+
+    // removing from arena backed collection does not release memory
+    CHECK_THAT((const char *) model_map_remove(&b.strings, "one"), Equals("1"));
+    CHECK(model_map_size(&b.strings) == 1);
+
+    Bar *bars = nullptr;
+    const char *bad = "[" BAR1 ", 42]";
+    CHECK(model_parse_array_arena((void ***) &bars, bad, strlen(bad), get_Bar_meta(), arena) < 0);
+    CHECK(bars == nullptr);
+
+    model_arena_free(arena);
+}
+
+// custom parser allocating from the heap, not usable in arena mode
+typedef struct Blob_s {
+    char *data;
+} Blob;
+
+static int Blob_from_json(Blob *b, json_object *j, const type_meta *) {
+    b->data = strdup(json_object_get_string(j));
+    return 0;
+}
+
+static void Blob_free(Blob *b) {
+    free(b->data);
+}
+
+static const type_meta *get_Blob_meta() {
+    static type_meta meta = {
+            "Blob", sizeof(Blob), 0, nullptr,
+            nullptr, nullptr, (_free_f) Blob_free, (from_json_func) Blob_from_json, nullptr,
+    };
+    return &meta;
+}
+
+#define HOLDER_MODEL(xx, ...) \
+xx(blob, Blob, ptr, blob, __VA_ARGS__) \
+xx(bar, Bar, ptr, bar, __VA_ARGS__)
+
+DECLARE_MODEL(Holder, HOLDER_MODEL)
+
+IMPL_MODEL(Holder, HOLDER_MODEL)
+
+TEST_CASE("arena parse with custom parser", "[model]") {
+    const char *json = R"({"blob":"data"})";
+    Holder h;
+    REQUIRE(parse_Holder(&h, json, strlen(json)) == strlen(json));
+    REQUIRE(h.blob != nullptr);
+    CHECK_THAT(h.blob->data, Equals("data"));
+    free_Holder(&h);
+
+    model_arena *arena = model_arena_new(0);
+    CHECK(parse_Holder_arena(&h, json, strlen(json), arena) < 0);
+
+    // arena set for the thread applies to all model parsing functions
+    json_object *j = json_tokener_parse("{\"bar\":" BAR1 "}");
+    model_arena *prev = model_arena_use(arena);
+    size_t used = model_arena_used(arena);
+    REQUIRE(Holder_from_json(&h, j) == 0);
+    CHECK(model_arena_use(prev) == arena);
+    CHECK(model_arena_used(arena) > used);
+    REQUIRE(h.bar != nullptr);
+    checkBar1(*h.bar);
+    json_object_put(j);
+
+    model_arena_free(arena);
+}
+
+TEST_CASE("generated functions match field_meta path", "[model]") {
+    // same type without generated functions, forces generic field_meta interpretation
+    type_meta generic = *get_Foo_meta();
+    generic.comparer = nullptr;
+    generic.jsonifier = nullptr;
+    generic.destroyer = nullptr;
+    generic.from_json = nullptr;
+    REQUIRE(get_Foo_meta()->comparer != nullptr);
+
+    const char *json = "{"
+                       "\"bar\":" BAR1 ","
+                       "\"barp\":" BAR2 ","
+                       "\"bara\":[" BAR1 "," BAR2 "]"
+                       "}";
+
+    Foo gen_foo;
+    Foo gen_foo2;
+    Foo meta_foo;
+    REQUIRE(model_parse(&gen_foo, json, strlen(json), get_Foo_meta()) == strlen(json));
+    REQUIRE(model_parse(&gen_foo2, BAR1, strlen(BAR1), get_Foo_meta()) > 0);
+    REQUIRE(model_parse(&meta_foo, json, strlen(json), &generic) == strlen(json));
+
+    CHECK(model_cmp(&gen_foo, &meta_foo, get_Foo_meta()) == 0);
+    CHECK(model_cmp(&gen_foo, &meta_foo, &generic) == 0);
+    CHECK(model_cmp(&gen_foo, &gen_foo2, get_Foo_meta()) ==
+          model_cmp(&gen_foo, &gen_foo2, &generic));
+    CHECK(model_cmp(&gen_foo2, &gen_foo, get_Foo_meta()) ==
+          model_cmp(&gen_foo2, &gen_foo, &generic));
+
+    for (int flags : {0, MODEL_JSON_COMPACT}) {
+        char *j1 = model_to_json(&gen_foo, get_Foo_meta(), flags, nullptr);
+        char *j2 = model_to_json(&meta_foo, &generic, flags, nullptr);
+        CHECK_THAT(j1, Equals(j2));
+        free(j1);
+        free(j2);
+    }
+
+    model_free(&gen_foo, get_Foo_meta());
+    model_free(&gen_foo2, get_Foo_meta());
+    model_free(&meta_foo, &generic);
+}
+
+#define ROUTER_MODEL(xx, ...) \
+xx(name, model_istring, none, name, __VA_ARGS__) \
+xx(url, model_istring, none, url, __VA_ARGS__) \
+xx(tags, model_istring, array, tags, __VA_ARGS__) \
+xx(labels, model_istring, list, labels, __VA_ARGS__) \
+xx(attrs, model_istring, map, attrs, __VA_ARGS__)
+
+DECLARE_MODEL(Router, ROUTER_MODEL)
+IMPL_MODEL(Router, ROUTER_MODEL)
+
+TEST_CASE("interned strings", "[model]") {
+    const char *json = R"([
+{"name": "er1", "url": "tls://er1:443", "tags": ["public", "east"], "labels": ["public"], "attrs": {"region": "east"}},
+{"name": "er2", "url": "tls://er2:443", "tags": ["public", "east"], "labels": ["east"], "attrs": {"region": "east"}},
+{"name": "er1", "url": "tls://er1:443"}
+])";
+
+    model_string_pool *pool = model_string_pool_new();
+    model_string_pool *prev = model_string_pool_use(pool);
+
+    Router_array routers = nullptr;
+    REQUIRE(parse_Router_array(&routers, json, strlen(json)) > 0);
+    CHECK(model_string_pool_use(prev) == pool);
+
+    Router *r1 = routers[0];
+    Router *r2 = routers[1];
+    Router *r3 = routers[2];
+    CHECK_THAT(r1->name, Equals("er1"));
+    CHECK(r1->name == r3->name);
+    CHECK(r1->url == r3->url);
+    CHECK(r1->tags[0] == r2->tags[0]);
+    CHECK(r1->tags[1] == r2->tags[1]);
+    CHECK(model_list_head(&r1->labels) == r1->tags[0]);
+    CHECK(model_list_head(&r2->labels) == r1->tags[1]);
+    CHECK(model_map_get(&r1->attrs, "region") == r1->tags[1]);
+    // er1, er2, tls://er1:443, tls://er2:443, public, east
+    CHECK(model_string_pool_size(pool) == 6);
+
+    CHECK(cmp_Router(r1, r3) != 0);
+    char *j1 = Router_to_json(r1, MODEL_JSON_COMPACT, nullptr);
+    CHECK_THAT(j1, Equals(R"({"name":"er1","url":"tls://er1:443","tags":["public","east"],"labels":["public"],"attrs":{"region":"east"}})"));
+    free(j1);
+
+    // parsing without a pool still produces releasable strings
+    Router r4;
+    REQUIRE(parse_Router(&r4, R"({"name":"er2"})", strlen(R"({"name":"er2"})")) > 0);
+    CHECK(r4.name != r2->name);
+    CHECK(model_cmp(&r4.name, &r2->name, get_model_istring_meta()) == 0);
+    free_Router(&r4);
+
+    free_Router_ptr(r3);
+    routers[2] = nullptr;
+    CHECK(model_string_pool_size(pool) == 6);
+    free_Router_ptr(r2);
+    routers[1] = nullptr;
+    // er1, tls://er1:443, public, east
+    CHECK(model_string_pool_size(pool) == 4);
+
+    model_istring name = model_intern(pool, "er1");
+    CHECK(name == r1->name);
+
+    // interned strings outlive the pool
+    model_string_pool_free(pool);
+    CHECK_THAT(r1->name, Equals("er1"));
+    free_Router_ptr(r1);
+    CHECK_THAT(name, Equals("er1"));
+    model_istring_release(name);
+    free(routers);
+}
+
 TEST_CASE("parse-json-u-escape", "[model]") {
     const char *json = "{"
                        "\"bar\":{"
@@ -742,6 +1043,22 @@ TEST_CASE("parse model_list", "[model]") {
     model_list_clear(&list, (void (*)(void *)) (free_Fruit_ptr));
 }
 
+TEST_CASE("parse list with invalid element", "[model]") {
+    // second element fails on its last field
+    const char *json = "[" BAR1 R"(, {"msg": "partial", "errors": ["e"], "shoes": [42]}])";
+    model_list list = {0};
+    CHECK(parse_Bar_list(&list, json, strlen(json)) < 0);
+    CHECK(model_list_size(&list) == 0);
+
+    const char *strings = R"(["one", "two", 3])";
+    CHECK(model_parse_list(&list, strings, strlen(strings), get_model_string_meta()) < 0);
+    CHECK(model_list_size(&list) == 0);
+
+    char **arr = nullptr;
+    CHECK(model_parse_array((void ***) &arr, strings, strlen(strings), get_model_string_meta()) < 0);
+    CHECK(arr == nullptr);
+}
+
 TEST_CASE("lists model", "[model]") {
     const char *json = R"(
 {
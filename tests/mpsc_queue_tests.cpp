@@ -0,0 +1,222 @@
+/*
+Copyright (c) 2025 NetFoundry, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "catch2_includes.hpp"
+#include <mpsc_queue.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct work {
+    int producer;
+    int seq;
+};
+
+static void collect(void *elem, void *ctx) {
+    auto w = static_cast<work *>(elem);
+    static_cast<std::vector<work> *>(ctx)->push_back(*w);
+}
+
+TEST_CASE("mpsc queue fifo", "[util]") {
+    mpsc_queue_t *q = mpsc_queue_new(sizeof(work), 4);
+
+    // more than capacity: falls back to heap nodes
+    for (int i = 0; i < 10; i++) {
+        auto w = (work *) mpsc_queue_alloc(q);
+        REQUIRE(w != nullptr);
+        *w = {0, i};
+        bool wakeup = mpsc_queue_push(q, w);
+        CHECK(wakeup == (i == 0));
+    }
+
+    std::vector<work> out;
+    CHECK(mpsc_queue_drain(q, collect, &out) == 10);
+    REQUIRE(out.size() == 10);
+    for (int i = 0; i < 10; i++) {
+        CHECK(out[i].seq == i);
+    }
+
+    CHECK(mpsc_queue_drain(q, collect, &out) == 0);
+
+    // drain re-arms the wakeup
+    auto w = (work *) mpsc_queue_alloc(q);
+    *w = {0, 10};
+    CHECK(mpsc_queue_push(q, w));
+
+    mpsc_queue_free(q);
+}
+
+TEST_CASE("mpsc queue bounded alloc", "[util]") {
+    mpsc_queue_t *q = mpsc_queue_new(sizeof(work), 4);
+
+    std::vector<work *> taken;
+    work *w;
+    while ((w = (work *) mpsc_queue_try_alloc(q)) != nullptr) {
+        *w = {0, (int) taken.size()};
+        taken.push_back(w);
+    }
+    CHECK(taken.size() == 4);
+
+    for (auto t: taken) {
+        mpsc_queue_push(q, t);
+    }
+    std::vector<work> out;
+    CHECK(mpsc_queue_drain(q, collect, &out) == 4);
+
+    // drained nodes are available again
+    CHECK(mpsc_queue_try_alloc(q) != nullptr);
+
+    mpsc_queue_free(q);
+}
+
+TEST_CASE("mpsc queue multiple producers", "[util]") {
+    const int producers = 8;
+    const int count = 10000;
+    mpsc_queue_t *q = mpsc_queue_new(sizeof(work), 64);
+
+    std::atomic<int> done{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([q, p, &done] {
+            for (int i = 0; i < count; i++) {
+                auto w = (work *) mpsc_queue_alloc(q);
+                *w = {p, i};
+                mpsc_queue_push(q, w);
+            }
+            done++;
+        });
+    }
+
+    std::vector<work> out;
+    while (done < producers) {
+        mpsc_queue_drain(q, collect, &out);
+    }
+    mpsc_queue_drain(q, collect, &out);
+
+    for (auto &t: threads) {
+        t.join();
+    }
+
+    REQUIRE(out.size() == producers * count);
+    std::vector<int> last(producers, -1);
+    for (auto &w: out) {
+        CHECK(w.seq == last[w.producer] + 1);
+        last[w.producer] = w.seq;
+    }
+
+    mpsc_queue_free(q);
+}
+
+TEST_CASE("mpsc queue freelist wrap-around", "[util]") {
+    const int producers = 8;
+    const int count = 20000;
+    // few nodes: freelist ring wraps constantly while producers are taking nodes
+    mpsc_queue_t *q = mpsc_queue_new(sizeof(work), 4);
+
+    std::atomic<int> done{0};
+    std::atomic<bool> stalled{false};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([q, p, &done, &stalled] {
+            for (int i = 0; i < count && !stalled; i++) {
+                work *w;
+                long spins = 0;
+                while ((w = (work *) mpsc_queue_try_alloc(q)) == nullptr) {
+                    // a leaked freelist slot never comes back
+                    if (++spins > 100000000L) {
+                        stalled = true;
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+                if (w == nullptr) break;
+                *w = {p, i};
+                mpsc_queue_push(q, w);
+            }
+            done++;
+        });
+    }
+
+    std::vector<work> out;
+    while (done < producers) {
+        // let producers run on small machines
+        if (mpsc_queue_drain(q, collect, &out) == 0) {
+            std::this_thread::yield();
+        }
+    }
+    mpsc_queue_drain(q, collect, &out);
+
+    for (auto &t: threads) {
+        t.join();
+    }
+
+    REQUIRE_FALSE(stalled);
+    // node handed to two producers shows up as a lost or repeated element
+    REQUIRE(out.size() == producers * count);
+    std::vector<int> last(producers, -1);
+    for (auto &w: out) {
+        REQUIRE(w.seq == last[w.producer] + 1);
+        last[w.producer] = w.seq;
+    }
+
+    // all nodes are back in the freelist
+    std::vector<void *> taken;
+    void *n;
+    while ((n = mpsc_queue_try_alloc(q)) != nullptr) {
+        taken.push_back(n);
+    }
+    CHECK(taken.size() == 4);
+    for (auto t: taken) {
+        mpsc_queue_push(q, t);
+    }
+
+    mpsc_queue_free(q);
+}
+
+TEST_CASE("mpsc queue drain is bounded", "[util]") {
+    mpsc_queue_t *q = mpsc_queue_new(sizeof(work), 4);
+
+    struct requeue {
+        mpsc_queue_t *q;
+        int runs;
+    } r{q, 0};
+
+    auto w = (work *) mpsc_queue_alloc(q);
+    *w = {0, 0};
+    mpsc_queue_push(q, w);
+
+    // handler queues more work every time it runs
+    auto handler = [](void *elem, void *ctx) {
+        auto r = static_cast<requeue *>(ctx);
+        r->runs++;
+        auto next = (work *) mpsc_queue_alloc(r->q);
+        *next = {0, static_cast<work *>(elem)->seq + 1};
+        mpsc_queue_push(r->q, next);
+    };
+
+    for (int i = 1; i <= 3; i++) {
+        CHECK(mpsc_queue_drain(q, handler, &r) == 1);
+        CHECK(r.runs == i);
+    }
+
+    std::vector<work> out;
+    CHECK(mpsc_queue_drain(q, collect, &out) == 1);
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].seq == 3);
+
+    mpsc_queue_free(q);
+}
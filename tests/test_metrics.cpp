@@ -16,7 +16,9 @@ limitations under the License.
 
 #include "catch2_includes.hpp"
 #include <metrics.h>
+#include <cstdarg>
 #include <cstring>
+#include <string>
 #include <ziti/enums.h>
 
 
@@ -52,3 +54,133 @@ TEST_CASE("init-metrics", "[metrics]") {
     metrics_rate_close(&m1);
     metrics_rate_close(&m1);
 }
+
+TEST_CASE("rate idle catch-up", "[util]") {
+    auto type = GENERATE(EWMA_1m, MMA_1m, CMA_1m, INSTANT);
+    rate_t ticked;
+    rate_t caught_up;
+    memset(&ticked, 0, sizeof(ticked));
+    memset(&caught_up, 0, sizeof(caught_up));
+    metrics_rate_init(&ticked, (rate_type) type);
+    metrics_rate_init(&caught_up, (rate_type) type);
+
+    metrics_rate_update(&ticked, 1000);
+    metrics_rate_update(&caught_up, 1000);
+
+    // one tick per interval vs. single tick after a long gap
+    uint64_t step = metrics_tick_interval();
+    uint64_t start = caught_up.last_tick;
+    for (uint64_t i = 1; i <= 100; i++) {
+        metrics_rate_tick(&ticked, start + i * step);
+    }
+    metrics_rate_tick(&caught_up, start + 100 * step + step / 2);
+    CHECK(caught_up.last_tick == start + 100 * step);
+
+    double expected, actual;
+    REQUIRE(metrics_rate_get(&ticked, &expected) == 0);
+    REQUIRE(metrics_rate_get(&caught_up, &actual) == 0);
+    CHECK_THAT(actual, Catch::Matchers::WithinRel(expected, 1e-9));
+
+    metrics_rate_close(&ticked);
+    metrics_rate_close(&caught_up);
+}
+
+TEST_CASE("metrics registry", "[util]") {
+    auto reg = metrics_registry_new();
+
+    auto c = metrics_get(reg, ziti_metric_counter, "bytes_in", "service", "foo", nullptr, nullptr);
+    CHECK(c == metrics_get(reg, ziti_metric_counter, "bytes_in", "service", "foo", nullptr, nullptr));
+    CHECK(c != metrics_get(reg, ziti_metric_counter, "bytes_in", "service", "bar", nullptr, nullptr));
+    metric_add(c, 100);
+    metric_add(c, 23);
+
+    auto g = metrics_get(reg, ziti_metric_gauge, "queue", nullptr, nullptr, nullptr, nullptr);
+    metric_set(g, 7);
+
+    auto h = metrics_get(reg, ziti_metric_histogram, "latency", "router", "er1", nullptr, nullptr);
+    for (uint64_t v = 1; v <= 1000; v++) {
+        metric_record(h, v);
+    }
+
+    ziti_metrics_snapshot snap;
+    REQUIRE(metrics_snapshot(reg, &snap) == 0);
+    // sorted by name and labels
+    REQUIRE(snap.count == 4);
+    CHECK_THAT(snap.metrics[0].labels[0].value, Catch::Matchers::Equals("bar"));
+    CHECK(snap.metrics[0].value == 0);
+    CHECK_THAT(snap.metrics[1].labels[0].value, Catch::Matchers::Equals("foo"));
+    CHECK(snap.metrics[1].value == 123);
+
+    auto &lat = snap.metrics[2];
+    CHECK_THAT(lat.name, Catch::Matchers::Equals("latency"));
+    CHECK(lat.type == ziti_metric_histogram);
+    CHECK(lat.value == 1000);
+    CHECK(lat.sum == 500500);
+    CHECK(lat.min == 1);
+    CHECK(lat.max == 1000);
+    // within bucket precision (1/8)
+    CHECK(lat.p50 >= 500);
+    CHECK(lat.p50 <= 500 * 9 / 8);
+    CHECK(lat.p99 >= 990);
+    CHECK(lat.p99 <= 1000);
+
+    uint64_t total = 0;
+    uint64_t prev = 0;
+    for (size_t i = 0; i < lat.bucket_count; i++) {
+        CHECK((i == 0 || lat.buckets[i].upper_bound > prev));
+        prev = lat.buckets[i].upper_bound;
+        total += lat.buckets[i].count;
+    }
+    CHECK(total == 1000);
+
+    CHECK_THAT(snap.metrics[3].name, Catch::Matchers::Equals("queue"));
+    CHECK(snap.metrics[3].labels[0].name == nullptr);
+    CHECK(snap.metrics[3].value == 7);
+
+    ziti_metrics_snapshot_free(&snap);
+    metrics_registry_free(reg);
+}
+
+static int append_out(void *ctx, const char *fmt, ...) {
+    auto out = static_cast<std::string *>(ctx);
+    char line[1024];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    out->append(line);
+    return len;
+}
+
+TEST_CASE("metrics text exposition", "[util]") {
+    auto reg = metrics_registry_new();
+
+    metric_add(metrics_get(reg, ziti_metric_counter, "dial_failures", "service", "a\"b", "error", "timeout"), 2);
+    metric_set(metrics_get(reg, ziti_metric_gauge, "queue", nullptr, nullptr, nullptr, nullptr), 7);
+    auto h = metrics_get(reg, ziti_metric_histogram, "latency", "router", "er1", nullptr, nullptr);
+    metric_record(h, 1);
+    metric_record(h, 1);
+    metric_record(h, 100);
+
+    std::string out;
+    REQUIRE(metrics_write(reg, ziti_metrics_prometheus, append_out, &out) == 0);
+    CHECK_THAT(out, Catch::Matchers::Equals(
+            "# TYPE ziti_dial_failures counter\n"
+            "ziti_dial_failures{service=\"a\\\"b\",error=\"timeout\"} 2\n"
+            "# TYPE ziti_latency histogram\n"
+            "ziti_latency_bucket{router=\"er1\",le=\"1\"} 2\n"
+            "ziti_latency_bucket{router=\"er1\",le=\"103\"} 3\n"
+            "ziti_latency_bucket{router=\"er1\",le=\"+Inf\"} 3\n"
+            "ziti_latency_count{router=\"er1\"} 3\n"
+            "ziti_latency_sum{router=\"er1\"} 102\n"
+            "# TYPE ziti_queue gauge\n"
+            "ziti_queue 7\n"));
+
+    out.clear();
+    REQUIRE(metrics_write(reg, ziti_metrics_openmetrics, append_out, &out) == 0);
+    CHECK_THAT(out, Catch::Matchers::StartsWith(
+            "# TYPE ziti_dial_failures counter\n"
+            "ziti_dial_failures_total{service=\"a\\\"b\",error=\"timeout\"} 2\n"));
+
+    metrics_registry_free(reg);
+}
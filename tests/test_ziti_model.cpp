@@ -836,4 +836,40 @@ TEST_CASE("load cfg", "[model]") {
 
     REQUIRE(ziti_load_config(&cfg, non_identity_json) == ZITI_INVALID_CONFIG);
     free_ziti_config(&cfg);
-}
\ No newline at end of file
+}
+TEST_CASE("bootstrap cache round trip", "[model]") {
+    auto json = R"({
+  "controllers": ["https://ctrl1.local:1280", "https://ctrl2.local:1280"],
+  "services": [
+    {"id": "svc-id", "name": "my-service", "permissions": ["Dial"], "encryptionRequired": true,
+     "config": {"intercept.v1": {"protocols": ["tcp"], "addresses": ["my.service"], "portRanges": [{"low": 80, "high": 80}]}}}
+  ],
+  "edgeRouters": [
+    {"name": "er1", "supportedProtocols": {"tls": "tls://er1.local:3022"}}
+  ],
+  "savedAt": "2025-01-02T03:04:05.000000Z"
+})";
+
+    ziti_bootstrap_cache cache;
+    REQUIRE(parse_ziti_bootstrap_cache(&cache, json, strlen(json)) > 0);
+    CHECK(model_list_size(&cache.controllers) == 2);
+    REQUIRE(cache.services != nullptr);
+    REQUIRE(cache.services[0] != nullptr);
+    CHECK_THAT(cache.services[0]->name, Equals("my-service"));
+    CHECK(model_map_get(&cache.services[0]->config, "intercept.v1") != nullptr);
+    CHECK(cache.services[1] == nullptr);
+    REQUIRE(cache.edge_routers != nullptr);
+    CHECK_THAT(cache.edge_routers[0]->protocols.tls, Equals("tls://er1.local:3022"));
+
+    size_t len;
+    char *out = ziti_bootstrap_cache_to_json(&cache, 0, &len);
+    REQUIRE(out != nullptr);
+
+    ziti_bootstrap_cache copy;
+    REQUIRE(parse_ziti_bootstrap_cache(&copy, out, len) > 0);
+    CHECK(model_cmp(&cache, &copy, get_ziti_bootstrap_cache_meta()) == 0);
+
+    free(out);
+    free_ziti_bootstrap_cache(&cache);
+    free_ziti_bootstrap_cache(&copy);
+}
@@ -18,6 +18,15 @@
 #include "internal_model.h"
 #include "zt_internal.h"
 
+#include <json-c/json.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 #if _WIN32
 #include <io.h>
 #define dup2(o,n) _dup2(o,n)
@@ -92,4 +101,380 @@ TEST_CASE("check hostname/domainname") {
 
     printf("hostname = %s\n", info->hostname);
     printf("domain = %s\n", info->domain);
-}
\ No newline at end of file
+}
+static std::mutex log_lock;
+static std::vector<std::string> log_lines;
+static std::atomic<bool> log_paused{false};
+
+static void capture_log(int level, const char *loc, const char *msg, size_t msglen) {
+    while (log_paused) {
+        std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(log_lock);
+    log_lines.emplace_back(msg, msglen);
+}
+
+TEST_CASE("async logging", "[util]") {
+    log_lines.clear();
+    ziti_log_set_logger(capture_log);
+    const int producers = 4;
+    const int count = 1000;
+    // room for every message, nothing is dropped
+    REQUIRE(ziti_log_set_async(producers * count) == ZITI_OK);
+    uint64_t dropped = ziti_log_dropped();
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([p] {
+            for (int i = 0; i < count; i++) {
+                ziti_logger(INFO, "test", __FILE__, __LINE__, __func__, "%d:%d", p, i);
+            }
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+
+    // switching back to sync mode flushes queued records
+    REQUIRE(ziti_log_set_async(0) == ZITI_OK);
+    ziti_log_set_logger(nullptr);
+
+    CHECK(ziti_log_dropped() == dropped);
+    REQUIRE(log_lines.size() == producers * count);
+    std::vector<int> last(producers, -1);
+    for (auto &l: log_lines) {
+        int p, i;
+        REQUIRE(sscanf(l.c_str(), "%d:%d", &p, &i) == 2);
+        CHECK(i == last[p] + 1);
+        last[p] = i;
+    }
+}
+
+TEST_CASE("async logging overflow", "[util]") {
+    log_lines.clear();
+    ziti_log_set_logger(capture_log);
+    REQUIRE(ziti_log_set_async(4) == ZITI_OK);
+    uint64_t dropped = ziti_log_dropped();
+
+    // writer is stuck on the first record, so only queue capacity is accepted
+    log_paused = true;
+    for (int i = 0; i < 10; i++) {
+        ziti_logger(INFO, "test", __FILE__, __LINE__, __func__, "msg %d", i);
+    }
+    CHECK(ziti_log_dropped() - dropped == 6);
+    log_paused = false;
+
+    REQUIRE(ziti_log_set_async(0) == ZITI_OK);
+    ziti_log_set_logger(nullptr);
+
+    REQUIRE(log_lines.size() == 5);
+    CHECK(log_lines[3] == "msg 3");
+    CHECK_THAT(log_lines[4], Catch::Matchers::Equals("6 log messages dropped"));
+}
+
+TEST_CASE("log call site level", "[util]") {
+    ziti_log_set_logger(capture_log);
+    ziti_log_set_level(INFO, nullptr);
+
+    auto log_at_debug = [] {
+        log_lines.clear();
+        for (int i = 0; i < 3; i++) {
+            ZITI_LOG(DEBUG, "debug %d", i);
+        }
+        return log_lines.size();
+    };
+
+    CHECK(log_at_debug() == 0);
+
+    // level change invalidates cached call site level
+    ziti_log_set_level(DEBUG, "util_tests.cpp");
+    CHECK(log_at_debug() == 3);
+
+    ziti_log_set_level(ZITI_LOG_DEFAULT_LEVEL, "util_tests.cpp");
+    CHECK(log_at_debug() == 0);
+
+    ziti_log_set_logger(nullptr);
+}
+
+TEST_CASE("allocator hooks", "[util]") {
+    char *s = ziti_strndup("hello world", 5);
+    REQUIRE(s != nullptr);
+    CHECK_THAT(s, Catch::Matchers::Equals("hello"));
+    ziti_free(s);
+
+    auto p = static_cast<char *>(ziti_calloc(4, 16));
+    REQUIRE(p != nullptr);
+    p = static_cast<char *>(ziti_realloc(p, 128));
+    REQUIRE(p != nullptr);
+    CHECK(p[63] == 0);
+    ziti_free(p);
+
+    // SDK memory is already in use
+    ziti_allocator alloc = {malloc, calloc, realloc, free};
+    CHECK(ziti_set_allocator(&alloc) == ZITI_INVALID_STATE);
+    CHECK(ziti_alloc_tracking(true) == ZITI_INVALID_STATE);
+
+    int64_t live;
+    uint64_t count;
+    if (ziti_alloc_stats(ziti_alloc_model, &live, &count)) {
+        uint64_t before = count;
+        auto m = ziti_mem_alloc(100);
+        ziti_free(m);
+        ziti_alloc_stats(ziti_alloc_other, &live, &count);
+        CHECK(count > 0);
+        ziti_alloc_stats(ziti_alloc_model, &live, &count);
+        CHECK(count == before);
+    }
+}
+
+struct stall_report {
+    std::string source;
+    std::string callback;
+    uint64_t duration;
+};
+
+// bare context on a private loop with the stall monitor enabled
+struct monitor_env {
+    uv_loop_t loop{};
+    ziti_context ztx;
+    std::vector<stall_report> stalls;
+    uv_timer_t block{};
+    uv_timer_t done{};
+    unsigned int block_ms = 0;
+    bool in_callback = false;
+
+    explicit monitor_env(unsigned int threshold) {
+        uv_loop_init(&loop);
+        ztx = (ziti_context) calloc(1, sizeof(struct ziti_ctx));
+        ztx->loop = &loop;
+        ztx->metrics = metrics_registry_new();
+        ztx->opts.loop_stall_threshold_ms = threshold;
+        ztx->opts.events = ZitiLoopStallEvent;
+        ztx->opts.app_ctx = this;
+        ztx->opts.event_cb = [](ziti_context ztx, const ziti_event_t *ev) {
+            auto env = (monitor_env *) ztx->opts.app_ctx;
+            env->stalls.push_back({ev->stall.source, ev->stall.callback ? ev->stall.callback : "",
+                                   ev->stall.duration_ms});
+        };
+    }
+
+    ~monitor_env() {
+        metrics_registry_free(ztx->metrics);
+        free(ztx);
+    }
+
+    static void block_cb(uv_timer_t *t) {
+        auto env = (monitor_env *) t->data;
+        auto start = ztx_cb_start(env->ztx);
+        uv_sleep(env->block_ms);
+        if (env->in_callback) {
+            ztx_cb_done(env->ztx, ztx_data_cb, (void *) block_cb, start);
+        }
+        uv_close((uv_handle_t *) t, nullptr);
+    }
+
+    // block the loop for [ms] once the monitor has seen a full iteration,
+    // as an app data callback if [callback] is set
+    void run(unsigned int ms, bool callback) {
+        block_ms = ms;
+        in_callback = callback;
+        loop_monitor_start(ztx);
+        REQUIRE(ztx->loop_monitor != nullptr);
+
+        uv_timer_init(&loop, &block);
+        block.data = this;
+        uv_timer_start(&block, block_cb, 20, 0);
+
+        uv_timer_init(&loop, &done);
+        done.data = this;
+        uv_timer_start(&done, [](uv_timer_t *t) {
+            auto env = (monitor_env *) t->data;
+            loop_monitor_stop(env->ztx);
+            uv_close((uv_handle_t *) t, nullptr);
+        }, 20 + ms + 50, 0);
+
+        uv_run(&loop, UV_RUN_DEFAULT);
+        CHECK(uv_loop_close(&loop) == 0);
+    }
+};
+
+TEST_CASE("loop stall above threshold", "[util]") {
+    monitor_env env(100);
+
+    SECTION("loop") {
+        env.run(150, false);
+        REQUIRE(env.stalls.size() == 1);
+        CHECK(env.stalls[0].source == "loop");
+        CHECK(env.stalls[0].callback.empty());
+        CHECK(env.stalls[0].duration >= 100);
+    }
+
+    SECTION("app callback") {
+        env.run(150, true);
+        // reported against the callback only, not again for the loop iteration
+        REQUIRE(env.stalls.size() == 1);
+        CHECK(env.stalls[0].source == "data_cb");
+        CHECK_FALSE(env.stalls[0].callback.empty());
+        CHECK(env.stalls[0].duration >= 100);
+    }
+}
+
+TEST_CASE("loop stall below threshold", "[util]") {
+    monitor_env env(200);
+
+    SECTION("loop") {
+        env.run(20, false);
+    }
+
+    SECTION("app callback") {
+        env.run(20, true);
+    }
+
+    CHECK(env.stalls.empty());
+
+    // blocking time is still recorded
+    ziti_metrics_snapshot snap{};
+    REQUIRE(metrics_snapshot(env.ztx->metrics, &snap) == 0);
+    bool found = false;
+    for (size_t i = 0; i < snap.count; i++) {
+        if (strcmp(snap.metrics[i].name, "loop_busy_ms") == 0) {
+            found = true;
+            CHECK(snap.metrics[i].value > 0);
+        }
+    }
+    CHECK(found);
+    ziti_metrics_snapshot_free(&snap);
+}
+
+TEST_CASE("dump json", "[util]") {
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    uint64_t now = uv_now(&loop);
+
+    char ctrl_url[] = "https://ctrl.example:443";
+    auto ztx = (ziti_context) calloc(1, sizeof(struct ziti_ctx));
+    ztx->loop = &loop;
+    ztx->id = 7;
+    ztx->enabled = true;
+    ztx->start = now;
+    ztx->config.controller_url = ctrl_url;
+    const char *ident = R"({"id":"ident-1","name":"test \"identity\""})";
+    REQUIRE(parse_ziti_identity_data_ptr(&ztx->identity_data, ident, strlen(ident)) > 0);
+
+    char ch_name[] = "er-1";
+    char ch_url[] = "tls://er-1.example:3022";
+    auto ch = (ziti_channel_t *) calloc(1, sizeof(ziti_channel_t));
+    ch->id = 1;
+    ch->name = ch_name;
+    ch->url = ch_url;
+    ch->latency = 12;
+    ch->out_q = 2;
+    ch->out_q_bytes = 100;
+    ch->reconnect_count = 3;
+    model_map_set(&ztx->channels, ch->name, ch);
+
+    char svc[] = "svc-1";
+    auto conn = (ziti_connection) calloc(1, sizeof(struct ziti_conn));
+    conn->type = Transport;
+    conn->conn_id = 3;
+    conn->service = svc;
+    conn->channel = ch;
+    conn->start = now;
+    conn->last_activity = now;
+    conn->sent = 1024;
+    conn->received = 4096;
+    model_map_setl(&ztx->connections, (long) conn->conn_id, conn);
+
+    auto server = (ziti_connection) calloc(1, sizeof(struct ziti_conn));
+    server->type = Server;
+    server->conn_id = 4;
+    server->service = svc;
+    model_map_setl(&ztx->connections, (long) server->conn_id, server);
+
+    auto child = (ziti_connection) calloc(1, sizeof(struct ziti_conn));
+    child->type = Transport;
+    child->conn_id = 5;
+    child->service = svc;
+    child->parent = server;
+    child->channel = ch;
+    child->start = now;
+    child->last_activity = now;
+    model_map_setl(&server->server.children, (long) child->conn_id, child);
+
+    string_buf_t *buf = new_string_buf();
+    REQUIRE(ziti_dump_json(ztx, buf) == ZITI_OK);
+    char *out = string_buf_to_string(buf, nullptr);
+    delete_string_buf(buf);
+
+    json_object *j = json_tokener_parse(out);
+    INFO(out);
+    REQUIRE(j != nullptr);
+    REQUIRE(json_object_is_type(j, json_type_object));
+
+    auto field = [](json_object *o, const char *key) {
+        json_object *v = nullptr;
+        REQUIRE(json_object_object_get_ex(o, key, &v));
+        return v;
+    };
+
+    for (auto key: {"id", "enabled", "uptime_ms", "identity", "controller",
+                    "services", "sessions", "channels", "connections"}) {
+        CHECK(json_object_object_get_ex(j, key, nullptr));
+    }
+    CHECK(json_object_get_int(field(j, "id")) == 7);
+    CHECK(json_object_get_boolean(field(j, "enabled")));
+    CHECK_THAT(json_object_get_string(field(field(j, "identity"), "name")),
+               Catch::Matchers::Equals("test \"identity\""));
+    CHECK_THAT(json_object_get_string(field(field(j, "controller"), "url")),
+               Catch::Matchers::Equals(ctrl_url));
+    CHECK(json_object_get_type(field(field(j, "controller"), "version")) == json_type_null);
+    CHECK(json_object_get_int(field(j, "services")) == 0);
+
+    auto channels = field(j, "channels");
+    REQUIRE(json_object_array_length(channels) == 1);
+    auto jch = json_object_array_get_idx(channels, 0);
+    CHECK(json_object_get_int(field(jch, "id")) == 1);
+    CHECK_THAT(json_object_get_string(field(jch, "name")), Catch::Matchers::Equals("er-1"));
+    CHECK_THAT(json_object_get_string(field(jch, "url")), Catch::Matchers::Equals(ch_url));
+    CHECK_FALSE(json_object_get_boolean(field(jch, "connected")));
+    CHECK(json_object_get_int(field(jch, "latency_ms")) == 12);
+    CHECK(json_object_get_int(field(jch, "out_q")) == 2);
+    CHECK(json_object_get_int(field(jch, "out_q_bytes")) == 100);
+    CHECK(json_object_get_int(field(jch, "pool_in_use")) == 0);
+    CHECK(json_object_get_int(field(jch, "reconnects")) == 3);
+
+    // server connection itself is not listed, only its accepted connections
+    auto conns = field(j, "connections");
+    REQUIRE(json_object_array_length(conns) == 2);
+    std::map<int, json_object *> by_id;
+    for (size_t i = 0; i < json_object_array_length(conns); i++) {
+        auto c = json_object_array_get_idx(conns, i);
+        by_id[json_object_get_int(field(c, "id"))] = c;
+    }
+    REQUIRE(by_id.count(3) == 1);
+    REQUIRE(by_id.count(5) == 1);
+
+    auto jconn = by_id[3];
+    CHECK_THAT(json_object_get_string(field(jconn, "type")), Catch::Matchers::Equals("transport"));
+    CHECK(json_object_get_type(field(jconn, "parent")) == json_type_null);
+    CHECK_THAT(json_object_get_string(field(jconn, "service")), Catch::Matchers::Equals("svc-1"));
+    CHECK_THAT(json_object_get_string(field(jconn, "state")), Catch::Matchers::Equals("Initial"));
+    CHECK(json_object_get_int(field(jconn, "channel")) == 1);
+    CHECK(json_object_get_int64(field(jconn, "sent")) == 1024);
+    CHECK(json_object_get_int64(field(jconn, "received")) == 4096);
+    CHECK(json_object_get_int64(field(jconn, "inbound_bytes")) == 0);
+
+    auto jchild = by_id[5];
+    CHECK_THAT(json_object_get_string(field(jchild, "type")), Catch::Matchers::Equals("accepted"));
+    CHECK(json_object_get_int(field(jchild, "parent")) == 4);
+
+    json_object_put(j);
+    ziti_free(out);
+
+    model_map_clear(&server->server.children, free);
+    model_map_clear(&ztx->connections, free);
+    model_map_clear(&ztx->channels, free);
+    free_ziti_identity_data_ptr(ztx->identity_data);
+    free(ztx);
+    uv_loop_close(&loop);
+}
@@ -21,12 +21,30 @@
 
 #include <ziti/zitilib.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
 #if _WIN32
 #else
 #include <unistd.h>
 #include <sys/socket.h>
+#include <netdb.h>
+#include <netinet/in.h>
 #endif
 
+// more than one loop thread, so that work is scheduled across loops
+static const int LIB_THREADS = 4;
+
+// exported for zitify, not in the public header
+extern "C" {
+int Ziti_resolve(const char *host, const char *port, const struct addrinfo *hints, struct addrinfo **addrlist);
+void Ziti_freeaddrinfo(struct addrinfo *addrlist);
+const char *Ziti_lookup(uint32_t addr);
+}
+
 class testRunListener : public Catch::EventListenerBase {
 protected:
     static ziti_handle_t _ztx;
@@ -34,7 +52,7 @@ public:
     using Catch::EventListenerBase::EventListenerBase;
 
     void testRunStarting(Catch::TestRunInfo const &) override {
-        Ziti_lib_init();
+        Ziti_lib_init_ex(LIB_THREADS);
         const char *id = getenv("ZITI_TEST_IDENTITY");
         if (id) {
             int err = Ziti_load_context(&_ztx, id);
@@ -101,4 +119,174 @@ TEST_CASE("httpbin.ziti", "[zitilib]") {
 
     CHECK_THAT(resp, StartsWith("HTTP/1.1 200 OK"));
     CHECK_THAT(resp, ContainsSubstring(R"("title": "Sample Slide Show")"));
-}
\ No newline at end of file
+}
+#if !_WIN32
+TEST_CASE("direct socket not connected", "[zitilib]") {
+    ziti_socket_t sock = Ziti_direct_socket();
+    REQUIRE(sock != -1);
+    CHECK(Ziti_check_socket(sock) == 1);
+
+    char buf[16];
+    CHECK(Ziti_recv(sock, buf, sizeof(buf), MSG_DONTWAIT) == -1);
+    CHECK(Ziti_last_error() == ENOTCONN);
+    CHECK(Ziti_send(sock, "hello", 5, 0) == -1);
+    CHECK(Ziti_last_error() == ENOTCONN);
+
+    CHECK(Ziti_close(sock) == 0);
+}
+
+TEST_CASE("httpbin.ziti direct", "[zitilib]") {
+    ziti_socket_t sock = Ziti_direct_socket();
+    REQUIRE(Ziti_connect_addr(sock, "httpbin.ziti", 80) == 0);
+
+    auto req = "GET /json HTTP/1.1\r\n"
+               "Accept: */*\r\n"
+               "Connection: close\r\n"
+               "Host: httpbin.org\r\n"
+               "\r\n";
+    REQUIRE(Ziti_send(sock, req, strlen(req), 0) == (ssize_t) strlen(req));
+
+    char resp[1024];
+    size_t rlen = 0;
+    ssize_t r;
+    do {
+        r = Ziti_recv(sock, resp + rlen, sizeof(resp) - 1 - rlen, 0);
+        if (r < 0) {
+            fprintf(stderr, "failed to read: %d\n", Ziti_last_error());
+            break;
+        }
+        rlen += r;
+    } while (r > 0 && rlen < sizeof(resp) - 1);
+    resp[rlen] = '\0';
+
+    Ziti_close(sock);
+
+    CHECK_THAT(resp, StartsWith("HTTP/1.1 200 OK"));
+}
+
+TEST_CASE("direct socket closed while in use", "[zitilib]") {
+    ziti_socket_t sock = Ziti_direct_socket();
+    REQUIRE(Ziti_connect_addr(sock, "httpbin.ziti", 80) == 0);
+
+    // no request sent: receiver blocks waiting for a response
+    std::atomic<int> recv_err{0};
+    std::thread receiver([sock, &recv_err] {
+        char buf[1024];
+        if (Ziti_recv(sock, buf, sizeof(buf), 0) < 0) {
+            recv_err = Ziti_last_error();
+        }
+    });
+
+    // sender keeps the tx ring full and ends up waiting for a free slot
+    std::atomic<int> send_err{0};
+    std::atomic<bool> sending{false};
+    std::thread sender([sock, &send_err, &sending] {
+        std::vector<char> chunk(64 * 1024, 'x');
+        sending = true;
+        while (Ziti_send(sock, chunk.data(), chunk.size(), 0) > 0) {}
+        send_err = Ziti_last_error();
+    });
+
+    while (!sending) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    CHECK(Ziti_close(sock) == 0);
+
+    // both are woken up by close
+    receiver.join();
+    sender.join();
+    CHECK(recv_err == EBADF);
+    CHECK(send_err != 0);
+}
+#endif
+
+TEST_CASE("connect many", "[zitilib]") {
+    ziti_connect_req reqs[3] = {};
+    for (auto &r: reqs) {
+        r.socket = Ziti_socket(SOCK_STREAM);
+        r.ztx = ZITI_INVALID_HANDLE;
+        r.host = "httpbin.ziti";
+        r.port = 80;
+    }
+    reqs[2].host = "no-such-service.ziti";
+
+    CHECK(Ziti_connect_many(reqs, 3, nullptr) == 1);
+    CHECK(reqs[0].status == 0);
+    CHECK(reqs[1].status == 0);
+    CHECK(reqs[2].status == ECONNREFUSED);
+
+    for (auto &r: reqs) {
+        Ziti_close(r.socket);
+    }
+}
+
+#if !_WIN32
+static in_addr_t resolve_addr(const char *host) {
+    struct addrinfo *addrs = nullptr;
+    if (Ziti_resolve(host, "80", nullptr, &addrs) != 0 || addrs == nullptr) {
+        return 0;
+    }
+    in_addr_t ip = ((struct sockaddr_in *) addrs->ai_addr)->sin_addr.s_addr;
+    Ziti_freeaddrinfo(addrs);
+    return ip;
+}
+
+// runs before any other test resolves httpbin.ziti
+TEST_CASE("mixed-case hostnames", "[zitilib]") {
+    in_addr_t ip = resolve_addr("HttpBin.Ziti");
+    REQUIRE(ip != 0);
+    CHECK(resolve_addr("httpbin.ziti") == ip);
+    CHECK(resolve_addr("HTTPBIN.ZITI") == ip);
+
+    // reverse lookup keeps the spelling of the first resolve
+    CHECK_THAT(Ziti_lookup(ip), Equals("HttpBin.Ziti"));
+
+    ziti_socket_t sock = Ziti_socket(SOCK_STREAM);
+    CHECK(Ziti_connect_addr(sock, "HTTPBIN.ziti", 80) == 0);
+    Ziti_close(sock);
+}
+
+TEST_CASE("concurrent callers on multiple loop threads", "[zitilib]") {
+    const int callers = 8;
+    const int iterations = 50;
+    std::atomic<int> failures{0};
+    std::vector<in_addr_t> resolved(callers);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < callers; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < iterations; i++) {
+                struct addrinfo *addrs = nullptr;
+                // literal addresses never need a context
+                if (Ziti_resolve("127.0.0.1", "80", nullptr, &addrs) != 0 || addrs == nullptr) {
+                    failures++;
+                } else {
+                    Ziti_freeaddrinfo(addrs);
+                }
+
+                // checked against every context on its own loop
+                addrs = nullptr;
+                if (Ziti_resolve("httpbin.ziti", "80", nullptr, &addrs) == 0 && addrs) {
+                    resolved[t] = ((struct sockaddr_in *) addrs->ai_addr)->sin_addr.s_addr;
+                    Ziti_freeaddrinfo(addrs);
+                }
+
+                ziti_socket_t sock = Ziti_direct_socket();
+                if (sock == -1 || Ziti_close(sock) != 0) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+
+    CHECK(failures == 0);
+    // every caller got the same intercept address
+    for (auto ip: resolved) {
+        CHECK(ip == resolved[0]);
+    }
+}
+#endif
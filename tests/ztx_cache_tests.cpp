@@ -0,0 +1,204 @@
+/*
+Copyright (c) 2025 NetFoundry, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "catch2_includes.hpp"
+
+#include <uv.h>
+#include <ziti/ziti.h>
+#include "zt_internal.h"
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// cache file in the temp dir, removed when done
+struct cache_file {
+    std::string path;
+
+    cache_file() {
+        char dir[1024];
+        size_t len = sizeof(dir);
+        REQUIRE(uv_os_tmpdir(dir, &len) == 0);
+        static int seq = 0;
+        path = std::string(dir) + "/ziti-cache-test-" + std::to_string(uv_os_getpid()) +
+               "-" + std::to_string(seq++) + ".json";
+    }
+
+    ~cache_file() {
+        remove(path.c_str());
+    }
+
+    void write(const std::string &content) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << content;
+    }
+};
+
+static std::string saved_at(time_t age_secs) {
+    time_t t = time(nullptr) - age_secs;
+    char buf[64];
+    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S.000000Z", gmtime(&t));
+    return buf;
+}
+
+static std::string cache_json(const std::string &ctrl_url, time_t age_secs) {
+    return R"({
+  "controllers": [")" + ctrl_url + R"("],
+  "services": [
+    {"id": "svc-id", "name": "my-service", "permissions": ["Dial"], "encryptionRequired": true}
+  ],
+  "edgeRouters": [
+    {"name": "er1", "supportedProtocols": {"tls": "tls://127.0.0.1:1"}}
+  ],
+  "savedAt": ")" + saved_at(age_secs) + R"("
+})";
+}
+
+static const time_t DAY = 24 * 60 * 60;
+
+TEST_CASE("bootstrap cache load", "[model]") {
+    cache_file file;
+    auto ztx = (ziti_context) calloc(1, sizeof(struct ziti_ctx));
+    ztx->opts.cache_path = file.path.c_str();
+    ziti_bootstrap_cache cache{};
+
+    SECTION("missing") {
+        CHECK(ztx_cache_load(ztx, &cache) == ZITI_CONFIG_NOT_FOUND);
+    }
+
+    SECTION("fresh") {
+        file.write(cache_json("https://ctrl.local:1280", 60));
+        REQUIRE(ztx_cache_load(ztx, &cache) == ZITI_OK);
+        CHECK(model_list_size(&cache.controllers) == 1);
+        REQUIRE(cache.services != nullptr);
+        REQUIRE(cache.services[0] != nullptr);
+        CHECK_THAT(cache.services[0]->name, Catch::Matchers::Equals("my-service"));
+        REQUIRE(cache.edge_routers != nullptr);
+        CHECK_THAT(cache.edge_routers[0]->name, Catch::Matchers::Equals("er1"));
+    }
+
+    SECTION("corrupt") {
+        auto json = cache_json("https://ctrl.local:1280", 60);
+        file.write(json.substr(0, json.size() / 2));
+        CHECK(ztx_cache_load(ztx, &cache) == ZITI_INVALID_CONFIG);
+        CHECK(cache.services == nullptr);
+    }
+
+    SECTION("stale") {
+        file.write(cache_json("https://ctrl.local:1280", 30 * DAY));
+        CHECK(ztx_cache_load(ztx, &cache) == ZITI_INVALID_CONFIG);
+        CHECK(cache.services == nullptr);
+    }
+
+    SECTION("no timestamp") {
+        file.write(R"({"services": [{"id": "svc-id", "name": "my-service"}]})");
+        CHECK(ztx_cache_load(ztx, &cache) == ZITI_INVALID_CONFIG);
+        CHECK(cache.services == nullptr);
+    }
+
+    free_ziti_bootstrap_cache(&cache);
+    free(ztx);
+}
+
+struct warm_start_test {
+    uv_loop_t loop;
+    uv_timer_t timer;
+    ziti_context ztx;
+    std::vector<std::string> services;
+    bool authenticated;
+    bool has_router;
+    bool stopping;
+};
+
+static void warm_start_stop(uv_timer_t *t) {
+    auto test = (warm_start_test *) t->data;
+    if (test->stopping) return;
+
+    test->stopping = true;
+    test->has_router = model_map_get(&test->ztx->channels, "er1") != nullptr;
+    uv_close((uv_handle_t *) t, nullptr);
+    ziti_shutdown(test->ztx);
+}
+
+// runs a context with an unreachable controller: anything it publishes comes from the cache
+static void run_warm_start(warm_start_test &test, const cache_file &file, const char *ctrl_url) {
+    uv_loop_init(&test.loop);
+    uv_timer_init(&test.loop, &test.timer);
+    test.timer.data = &test;
+
+    ziti_config cfg;
+    std::string cfg_json = R"({"ztAPI": ")" + std::string(ctrl_url) + R"("})";
+    REQUIRE(ziti_load_config(&cfg, cfg_json.c_str()) == ZITI_OK);
+    REQUIRE(ziti_context_init(&test.ztx, &cfg) == ZITI_OK);
+    free_ziti_config(&cfg);
+
+    ziti_options opts{};
+    opts.app_ctx = &test;
+    opts.cache_path = file.path.c_str();
+    opts.events = ZitiServiceEvent;
+    opts.event_cb = [](ziti_context ztx, const ziti_event_t *ev) {
+        auto test = (warm_start_test *) ziti_app_ctx(ztx);
+        if (test->stopping) return;
+
+        for (int i = 0; ev->service.added && ev->service.added[i]; i++) {
+            test->services.emplace_back(ev->service.added[i]->name);
+        }
+        test->authenticated = ztx->auth_state == ZitiAuthStateFullyAuthenticated;
+        // routers are restored right after services
+        uv_timer_start(&test->timer, warm_start_stop, 0, 0);
+    };
+    REQUIRE(ziti_context_set_options(test.ztx, &opts) == ZITI_OK);
+    REQUIRE(ziti_context_run(test.ztx, &test.loop) == ZITI_OK);
+
+    // no service event expected for a rejected cache
+    uv_timer_start(&test.timer, warm_start_stop, 500, 0);
+    uv_run(&test.loop, UV_RUN_DEFAULT);
+    uv_loop_close(&test.loop);
+}
+
+TEST_CASE("warm start from bootstrap cache", "[model]") {
+    // nothing listens there
+    const char *ctrl_url = "https://127.0.0.1:1";
+    cache_file file;
+    warm_start_test test{};
+
+    SECTION("valid cache") {
+        file.write(cache_json(ctrl_url, 60));
+        run_warm_start(test, file, ctrl_url);
+
+        CHECK(test.services == std::vector<std::string>{"my-service"});
+        CHECK_FALSE(test.authenticated);
+        CHECK(test.has_router);
+    }
+
+    SECTION("corrupt cache") {
+        file.write("{\"services\": [{\"id\": ");
+        run_warm_start(test, file, ctrl_url);
+
+        CHECK(test.services.empty());
+        CHECK_FALSE(test.has_router);
+    }
+
+    SECTION("stale cache") {
+        file.write(cache_json(ctrl_url, 30 * DAY));
+        run_warm_start(test, file, ctrl_url);
+
+        CHECK(test.services.empty());
+        CHECK_FALSE(test.has_router);
+    }
+}